@@ -30,10 +30,12 @@
 
 #include "ActarSimDetectorConstruction.hh"
 #include "ActarSimPhysicsList.hh"
+#include "ActarSimRunManager.hh"
 #include "ActarSimPrimaryGeneratorAction.hh"
 #include "ActarSimRunAction.hh"
 #include "ActarSimEventAction.hh"
 #include "ActarSimSteppingAction.hh"
+#include "ActarSimStackingAction.hh"
 #include "ActarSimSteppingVerbose.hh"
 #include "ActarSimROOTAnalysis.hh"
 #include "ActarSimVisManager.hh"
@@ -49,12 +51,13 @@ int main(int argc,char** argv)
   G4VSteppingVerbose::SetInstance(new ActarSimSteppingVerbose);
 
   // Construct the default run manager
-  G4RunManager* runManager = new G4RunManager;
+  G4RunManager* runManager = new ActarSimRunManager;
 
   // set mandatory initialization classes
   ActarSimDetectorConstruction* detector = new ActarSimDetectorConstruction;
   runManager->SetUserInitialization(detector);
-  runManager->SetUserInitialization(new ActarSimPhysicsList);
+  ActarSimPhysicsList* physicsList = new ActarSimPhysicsList;
+  runManager->SetUserInitialization(physicsList);
 
   // histogramming
   //ActarSimROOTAnalysis *analysis = new ActarSimROOTAnalysis(detector);
@@ -70,11 +73,15 @@ int main(int argc,char** argv)
   visManager->Initialize();
 
   // set mandatory user action class
-  runManager->SetUserAction(new ActarSimPrimaryGeneratorAction);
-  runManager->SetUserAction(new ActarSimRunAction);
+  ActarSimPrimaryGeneratorAction* primaryaction = new ActarSimPrimaryGeneratorAction;
+  runManager->SetUserAction(primaryaction);
+  runManager->SetUserAction(new ActarSimRunAction(primaryaction,physicsList->GetRegionSettings()));
   ActarSimEventAction* eventaction = new ActarSimEventAction;
   runManager->SetUserAction(eventaction);
-  runManager->SetUserAction(new ActarSimSteppingAction(detector,eventaction));
+  ActarSimStackingAction* stackingaction = new ActarSimStackingAction;
+  runManager->SetUserAction(stackingaction);
+  runManager->SetUserAction(new ActarSimSteppingAction(detector,eventaction,stackingaction,
+							      physicsList->GetRegionSettings()));
 
   // Initialize G4 kernel -->Make it manually to allow the definition of
   //    commands in PreInit state (for instance to define the PhysicsList)
@@ -0,0 +1,62 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimAcceptanceFilter_h
+#define ActarSimAcceptanceFilter_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+
+class G4Event;
+class G4Navigator;
+class G4PrimaryParticle;
+class G4ParticleDefinition;
+class G4Material;
+class ActarSimRangeTable;
+
+class ActarSimAcceptanceFilter {
+private:
+  G4Navigator* navigator;                 ///< Navigator for the ray casting (not the tracking one)
+
+  std::vector<G4String> detectorNames;    ///< Sensitive detectors giving the acceptance
+  G4int minProducts;                      ///< Products in the acceptance needed to accept the event
+  G4double minGasLength;                  ///< Length in the gas giving the acceptance (0: not used)
+  G4bool energyLossFlag;                  ///< Charged products stop according to their range
+
+  std::vector<ActarSimRangeTable*> rangeTables; ///< One per particle and material crossed
+
+  G4int numberOfTried;                    ///< Events tested in the run
+  G4int numberOfAccepted;                 ///< Events accepted in the run
+
+  G4bool IsInAcceptance(const G4PrimaryParticle* particle, const G4ThreeVector& position);
+  ActarSimRangeTable* GetRangeTable(const G4ParticleDefinition* part, const G4Material* mat,
+				    G4double e);
+
+public:
+  ActarSimAcceptanceFilter();
+  ~ActarSimAcceptanceFilter();
+
+  G4bool Accept(const G4Event* anEvent);
+  void Count(G4bool accepted);
+  void Clear();
+  void ResetCounters(){numberOfTried = 0; numberOfAccepted = 0;}
+
+  void SetDetectorNames(G4String val);
+  void SetMinProducts(G4int val){minProducts = val;}
+  void SetMinGasLength(G4double val){minGasLength = val;}
+  void SetEnergyLossFlag(G4bool val){energyLossFlag = val;}
+
+  G4int GetNumberOfTried() const {return numberOfTried;}
+  G4int GetNumberOfAccepted() const {return numberOfAccepted;}
+  G4double GetEfficiency() const {
+    return (numberOfTried>0) ? (G4double)numberOfAccepted/numberOfTried : 0.;
+  }
+};
+#endif
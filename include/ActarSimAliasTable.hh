@@ -0,0 +1,34 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimAliasTable_h
+#define ActarSimAliasTable_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class ActarSimAliasTable {
+private:
+  std::vector<G4double> probability;  ///< Probability of keeping each bin
+  std::vector<G4int>    alias;        ///< Alternative bin if not kept
+
+public:
+  ActarSimAliasTable();
+  ~ActarSimAliasTable();
+
+  G4bool Build(const std::vector<G4double>& weights);
+  void Clear();
+
+  G4int Sample() const;
+  G4int Sample(G4double& fraction) const;
+
+  G4int GetSize() const {return (G4int)probability.size();}
+  G4bool IsEmpty() const {return probability.empty();}
+};
+#endif
@@ -26,6 +26,8 @@ private:
   G4UIcmdWithAString*   storeTracksCmd;              ///< Store the tracks in the output Tree
   G4UIcmdWithAString*   storeTrackHistosCmd;         ///< Store the tracks in Histograms
   G4UIcmdWithADoubleAndUnit* setMinStrideLengthCmd;  ///< Sets the minimum value for the stride length
+  G4UIcmdWithADoubleAndUnit* trackPosResolutionCmd;  ///< Sets the position resolution in the tracks tree
+  G4UIcmdWithADoubleAndUnit* trackEneResolutionCmd;  ///< Sets the energy resolution in the tracks tree
   G4UIcmdWithAString*   storeEventsCmd;              ///< Store the events in the output Tree
   G4UIcmdWithAString*   storeSimpleTracksCmd;        ///< Store the simple tracks in the output Tree
   G4UIcmdWithAString*   storeHistosCmd;              ///< Store histograms in the output Tree
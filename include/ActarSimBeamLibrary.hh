@@ -0,0 +1,96 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimBeamLibrary_h
+#define ActarSimBeamLibrary_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+
+class ActarSimBeamInfo;
+
+class ActarSimBeamLibrary {
+private:
+  G4String setting;              ///< Beam and gas setting of the trajectories
+  G4String loadedFile;           ///< File of the trajectories in memory
+  G4String failedFile;           ///< Last file which could not be used
+  G4double strideLength;         ///< Maximum length of a recorded stride
+  G4bool   recording;            ///< Steps are being recorded
+
+  // Trajectories, start point and state
+  std::vector<G4int>   firstStride;  ///< Position of the first stride
+  std::vector<G4float> xStart;       ///< Start X [mm]
+  std::vector<G4float> yStart;       ///< Start Y [mm]
+  std::vector<G4float> zStart;       ///< Start Z [mm]
+  std::vector<G4float> energyStart;  ///< Kinetic energy at start [MeV]
+  std::vector<G4float> timeStart;    ///< Time at start [ns]
+
+  // Strides, state at the end point
+  std::vector<G4float> xStride;      ///< End X [mm]
+  std::vector<G4float> yStride;      ///< End Y [mm]
+  std::vector<G4float> zStride;      ///< End Z [mm]
+  std::vector<G4float> energyStride; ///< Kinetic energy at the end [MeV]
+  std::vector<G4float> timeStride;   ///< Time at the end [ns]
+  std::vector<G4float> edepStride;   ///< Energy deposited in the stride [MeV]
+
+  // Trajectory being recorded
+  G4bool   openTrajectory;        ///< A trajectory has been started
+  G4bool   openStride;            ///< A stride has been started
+  G4ThreeVector strideStart;      ///< Start of the stride being recorded
+  G4ThreeVector strideEnd;        ///< End of the stride being recorded
+  G4double strideEnergy;          ///< Kinetic energy at strideEnd
+  G4double strideTime;            ///< Time at strideEnd
+  G4double strideEdep;            ///< Energy deposited in the stride
+
+  // Trajectory sampled for the present event
+  G4int    replayTrajectory;      ///< Trajectory (-1 if none)
+  G4int    replayStrides;         ///< Number of strides up to the vertex
+  G4double replayFraction;        ///< Fraction of the last stride before the vertex
+  G4int    particleID;            ///< PDG code of the beam ion, for the analysis
+
+  void CloseStride();
+  void GetStart(G4int trajectory, G4int stride, G4ThreeVector& pos,
+		G4double& energy, G4double& time) const;
+
+public:
+  ActarSimBeamLibrary();
+  ~ActarSimBeamLibrary();
+
+  void Clear();
+
+  void SetSetting(G4String val);
+  void AddStep(const G4ThreeVector& prePos, const G4ThreeVector& postPos,
+	       G4double preEnergy, G4double postEnergy,
+	       G4double preTime, G4double postTime);
+  void EndTrajectory();
+  G4bool Write(G4String name);
+
+  G4bool Load(G4String name, G4String requiredSetting);
+  G4bool IsLoaded(G4String name, G4String requiredSetting) const {
+    return name==loadedFile && requiredSetting==setting;
+  }
+
+  G4bool Sample(G4double zVertex, ActarSimBeamInfo* beamInfo);
+  void ClearReplay() {replayTrajectory = -1; replayStrides = 0;}
+  G4int GetReplayNumberOfStrides() const {return replayStrides;}
+  void GetReplayStride(G4int i, G4ThreeVector& prePos, G4ThreeVector& postPos,
+		       G4double& preTime, G4double& postTime,
+		       G4double& energy, G4double& edep) const;
+
+  void SetRecording(G4bool val) {recording = val;}
+  G4bool IsRecording() const {return recording;}
+  void SetStrideLength(G4double val) {strideLength = val;}
+  void SetParticleID(G4int val) {particleID = val;}
+  G4int GetParticleID() const {return particleID;}
+  G4int GetNumberOfTrajectories() const {return (G4int)firstStride.size();}
+  G4int GetNumberOfStrides() const {return (G4int)xStride.size();}
+  G4String GetSetting() const {return setting;}
+};
+#endif
@@ -0,0 +1,44 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimBeamPhaseSpace_h
+#define ActarSimBeamPhaseSpace_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "ActarSimAliasTable.hh"
+
+#include <vector>
+
+class ActarSimBeamPhaseSpace {
+private:
+  G4String fileName;              ///< File loaded (empty if none)
+
+  std::vector<G4double> x;        ///< Horizontal position [mm]
+  std::vector<G4double> xp;       ///< Horizontal angle x' [mrad]
+  std::vector<G4double> y;        ///< Vertical position [mm]
+  std::vector<G4double> yp;       ///< Vertical angle y' [mrad]
+  std::vector<G4double> energy;   ///< Kinetic energy [MeV]
+  std::vector<G4double> weight;   ///< Optional sixth column
+
+  ActarSimAliasTable weightTable; ///< Alias table for weighted sampling
+
+public:
+  ActarSimBeamPhaseSpace();
+  ~ActarSimBeamPhaseSpace();
+
+  G4bool Load(G4String name);
+  void Clear();
+
+  G4bool IsLoaded(G4String name) const {return !x.empty() && name==fileName;}
+  G4int GetNumberOfRows() const {return (G4int)x.size();}
+
+  G4int SampleRow() const;
+  void Sample(G4ThreeVector& position, G4ThreeVector& direction, G4double& kineticEnergy) const;
+};
+#endif
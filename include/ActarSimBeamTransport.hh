@@ -0,0 +1,44 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimBeamTransport_h
+#define ActarSimBeamTransport_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4ParticleDefinition;
+class G4Material;
+class ActarSimBeamInfo;
+class ActarSimRangeTable;
+
+class ActarSimBeamTransport {
+private:
+  ActarSimRangeTable* rangeTable;     ///< Range table of the last beam and gas
+  ActarSimRangeTable* ownRangeTable;  ///< Range table built here (not the ActarSim physics list)
+  G4bool stragglingFlag;              ///< Energy and angular straggling included
+  G4int nBins;                        ///< Number of energy bins of ownRangeTable
+
+  ActarSimRangeTable* FindRangeTable(const G4ParticleDefinition* ion, const G4Material* gas,
+				     G4double energy);
+
+public:
+  ActarSimBeamTransport();
+  ~ActarSimBeamTransport();
+
+  G4bool Transport(const G4ParticleDefinition* ion, const G4Material* gas,
+		   const G4ThreeVector& entrancePosition, const G4ThreeVector& entranceDirection,
+		   G4double entranceEnergy, G4double zVertex, ActarSimBeamInfo* beamInfo);
+  void Clear();
+
+  void SetStragglingFlag(G4bool val){stragglingFlag = val;}
+  void SetNumberOfBins(G4int val){nBins = val;}
+  G4bool GetStragglingFlag() const {return stragglingFlag;}
+  ActarSimRangeTable* GetRangeTable() const {return rangeTable;}
+};
+#endif
@@ -31,6 +31,8 @@ private:
   G4double* ANGAV; ///< First solution vector
   G4double* ANGAR; ///< Second solution vector
 
+  G4int verbose;   ///< Print the no-solution messages if positive
+
 public:
   ActarSimCinePrimGenerator();
   ~ActarSimCinePrimGenerator();
@@ -54,6 +56,7 @@ public:
   void SetTargetExcitationEnergy(G4double value){EN = value;}
   void SetProjectileExcitationEnergy(G4double value){ENI = value;}
   void SetThetaLabAngle(G4double value){TH = value;}
+  void SetVerbose(G4int value){verbose = value;}
 
   G4double GetS1(void){return S1;}
   G4double GetS2(void){return S2;}
@@ -0,0 +1,43 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimCrossSectionTable_h
+#define ActarSimCrossSectionTable_h 1
+
+#include "globals.hh"
+#include "ActarSimAliasTable.hh"
+
+#include <vector>
+
+class ActarSimCrossSectionTable {
+private:
+  G4String fileName;              ///< File loaded (empty if none)
+
+  std::vector<G4double> thetaCM;  ///< CM angles of the points [rad]
+  std::vector<G4double> density;  ///< dSigma/dOmega * sin(thetaCM) in the points
+  G4double integral;              ///< Integral of density over the angle
+  G4double totalCrossSection;     ///< 2 pi times the integral of density (file units)
+
+  ActarSimAliasTable binTable;    ///< Alias table for the intervals between points
+
+public:
+  ActarSimCrossSectionTable();
+  ~ActarSimCrossSectionTable();
+
+  G4bool Load(G4String name, G4bool perSolidAngle=true);
+  void Clear();
+
+  G4bool IsLoaded(G4String name) const {return !binTable.IsEmpty() && name==fileName;}
+
+  G4double SampleThetaCM() const;
+  G4double GetProbabilityDensity(G4double angle) const;
+
+  G4int GetNumberOfPoints() const {return (G4int)thetaCM.size();}
+  G4double GetTotalCrossSection() const {return totalCrossSection;}
+};
+#endif
@@ -25,6 +25,7 @@ private:
   Double_t energyOnGasPrim2;          ///< Energy deposited in the gas for second primary
   Double_t stepSumLengthOnGasPrim1;   ///< Sum of steps length in the gas for first primary
   Double_t stepSumLengthOnGasPrim2;   ///< Sum of steps length in the gas for second primary
+  Double_t weight;                    ///< Event weight (importance sampling of the reaction angle)
   Int_t    eventID;                   ///< Event number
   Int_t    runID;                     ///< Run number
 
@@ -42,6 +43,7 @@ public:
   Double_t GetEnergyOnGasPrim2(){return energyOnGasPrim2;}
   Double_t GetStepSumLengthOnGasPrim1(){return stepSumLengthOnGasPrim1;}
   Double_t GetStepSumLengthOnGasPrim2(){return stepSumLengthOnGasPrim2;}
+  Double_t GetWeight(){return weight;}
   Int_t GetEventID(){return eventID;}
   Int_t GetRunID(){return runID;}
 
@@ -55,9 +57,10 @@ public:
   void SetEnergyOnGasPrim2(Double_t energy){energyOnGasPrim2 = energy;}
   void SetStepSumLengthOnGasPrim1(Double_t step){stepSumLengthOnGasPrim1 = step;}
   void SetStepSumLengthOnGasPrim2(Double_t step){stepSumLengthOnGasPrim2 = step;}
+  void SetWeight(Double_t w){weight = w;}
   void SetEventID(Int_t ev){eventID = ev;}
   void SetRunID(Int_t ev){runID = ev;}
 
-  ClassDef(ActarSimData,1) //ROOT CINT
+  ClassDef(ActarSimData,2) //ROOT CINT
 };
 #endif
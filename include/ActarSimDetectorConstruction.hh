@@ -15,6 +15,8 @@
 #include "ActarSimUniformEMField.hh"
 #include "globals.hh"
 
+#include <vector>
+
 class G4Box;
 class G4Tubs;
 class G4LogicalVolume;
@@ -37,6 +39,9 @@ class ActarSimSilRingDetectorConstruction;
 class ActarSimSciDetectorConstruction;
 class ActarSimSciRingDetectorConstruction;
 class ActarSimPlaDetectorConstruction;
+class ActarSimSilSciFastModel;
+class ActarSimGeometryCache;
+class ActarSimMaterialRegistry;
 
 class ActarSimDetectorConstruction : public G4VUserDetectorConstruction {
 private:
@@ -47,6 +52,10 @@ private:
   ActarSimSciRingSD* sciRingSD;  ///< Pointer to scintillator ring sensitive detector
   ActarSimPlaSD* plaSD;          ///< Pointer to plastic sensitive detector
 
+  ActarSimSilSciFastModel* silSciFastModel; ///< Parameterized response of the Sil/Sci walls
+  ActarSimGeometryCache* geometryCache;     ///< GDML cache of the constructed geometry
+  ActarSimMaterialRegistry* materialRegistry; ///< Elements and gas materials
+
   G4Box* solidWorld;
 
   G4LogicalVolume* worldLog;      ///< Pointer to logic world
@@ -69,6 +78,8 @@ private:
   G4Material* chamberMaterial;   ///< Pointer to the chamber material
   G4Material* windowMaterial;    ///< Pointer to the window material
 
+  std::vector<G4LogicalVolume*> gasFilledVolumes; ///< Volumes built with the gas material
+
   ActarSimUniformEMField* emField; ///< Pointer to the uniform em. field
 
   G4ThreeVector eField;           ///< Electric field vector
@@ -111,6 +122,10 @@ private:
   G4VPhysicalVolume* ConstructSpecMAT();
   G4VPhysicalVolume* ConstructMAIKO();
   G4VPhysicalVolume* ConstructOthers();
+  G4VPhysicalVolume* ConstructLayout(G4int geo);
+  G4VPhysicalVolume* LoadCachedGeometry(const G4String& key, G4int geo);
+  void FindGasFilledVolumes();
+  void ConnectAnalysis();
 
 public:
   ActarSimDetectorConstruction();
@@ -153,12 +168,22 @@ public:
   ActarSimSciRingSD* GetSciRingSD(void){return sciRingSD;}
   ActarSimPlaSD* GetPlaSD(void){return plaSD;}
 
+  ActarSimSilSciFastModel* GetSilSciFastModel(void){return silSciFastModel;}
+  void AddToSilSciWalls(G4LogicalVolume*, const G4String& regionName);
+
+  ActarSimGeometryCache* GetGeometryCache(void){return geometryCache;}
+  ActarSimUniformEMField* GetEMField(void){return emField;}
+  G4String GetGeometryConfiguration(G4int geo);
+
+  ActarSimMaterialRegistry* GetMaterialRegistry(void){return materialRegistry;}
+
   ActarSimDetectorMessenger* GetDetectorMessenger(){return detectorMessenger;};
 
   G4LogicalVolume* GetWorldLogicalVolume(){return worldLog;}
   G4VPhysicalVolume* GetWorldPhysicalVolume(){return worldPhys;}
   G4LogicalVolume* GetChamberLogicalVolume(){return chamberLog;}
   G4VPhysicalVolume* GetChamberPhysicalVolume(){return chamberPhys;}
+  const std::vector<G4LogicalVolume*>& GetGasFilledVolumes() const {return gasFilledVolumes;}
 
   G4double GetWorldSizeX(void){return worldSizeX;}
   G4double GetWorldSizeY(void){return worldSizeY;}
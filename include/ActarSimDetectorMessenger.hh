@@ -29,6 +29,8 @@ private:
 
   G4UIdirectory*             ActarSimDir;             ///< Directory in messenger structure
   G4UIdirectory*             detDir;                  ///< Directory in messenger structure
+  G4UIdirectory*             silSciFastSimDir;        ///< Directory for the Sil/Sci parameterized response
+  G4UIdirectory*             geometryCacheDir;        ///< Directory for the geometry cache
   //G4UIcmdWith3VectorAndUnit* worldSizeCmd;
 
   G4UIcmdWithAString* MaikoGeoIncludedFlagCmd;        ///< Includes the Maiko geometry in the simulation (default off).
@@ -54,9 +56,20 @@ private:
 
   G4UIcmdWith3Vector*        eleFieldCmd;             ///< Define electric field.
   G4UIcmdWith3VectorAndUnit* magFieldCmd;             ///< Define magnetic field.
+  G4UIdirectory*             fieldDir;                ///< Directory for the field propagation
+  G4UIcmdWithAString*        fieldStepperCmd;         ///< Select the stepper of the field propagation.
+  G4UIcmdWithADoubleAndUnit* fieldDeltaChordCmd;      ///< Select the miss distance of the chords.
+  G4UIcmdWithADouble*        fieldMinEpsilonCmd;      ///< Select the minimum relative accuracy of the steps.
+  G4UIcmdWithADouble*        fieldMaxEpsilonCmd;      ///< Select the maximum relative accuracy of the steps.
   G4UIcmdWithoutParameter*   updateCmd;               ///< Update geometry.
   G4UIcmdWithoutParameter*   printCmd;                ///< Prints geometry.
 
+  G4UIcmdWithAString* silSciFastSimActiveCmd;         ///< Parameterized response of the silicons and scintillators (on/off).
+  G4UIcmdWithAString* silSciFastSimStragglingCmd;     ///< Straggling in the parameterized response (on/off).
+
+  G4UIcmdWithAString* geometryCacheActiveCmd;         ///< Geometry loaded from and saved to the GDML cache (on/off).
+  G4UIcmdWithAString* geometryCacheDirectoryCmd;      ///< Directory of the GDML cache.
+
 public:
   ActarSimDetectorMessenger(ActarSimDetectorConstruction* );
   ~ActarSimDetectorMessenger();
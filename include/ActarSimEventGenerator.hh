@@ -7,26 +7,89 @@
  * For the list of contributors see CREDITS.                       *
  ******************************************************************/
 
-#ifndef EVENTGENERATOR_H
-#define EVENTGENERATOR_H
+#ifndef ActarSimEventGenerator_h
+#define ActarSimEventGenerator_h 1
 
 #include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <condition_variable>
+#include <deque>
 #include <fstream>
-#include <iostream>
-#include <string>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class G4Event;
+class G4ParticleDefinition;
+class TFile;
+class TTree;
+
+/// One event of the external generator
+struct ActarSimEvGenEvent {
+  G4double weight;                ///< Event weight
+  std::vector<G4int> pdg;         ///< PDG code of each particle
+  std::vector<G4double> px;       ///< X component of the momentum [MeV/c]
+  std::vector<G4double> py;       ///< Y component of the momentum [MeV/c]
+  std::vector<G4double> pz;       ///< Z component of the momentum [MeV/c]
+};
 
 class ActarSimEventGenerator {
+private:
+  static const G4int maxParticles = 100;  ///< Maximum number of particles per event (ROOT files)
+
+  G4String fileName;                      ///< File opened (empty if none)
+  G4bool rootFormat;                      ///< ROOT tree (true) or ASCII (false) file
+  size_t prefetchSize;                    ///< Maximum number of events read ahead
+  G4long numberOfEventsRead;              ///< Events taken from the buffer
+  G4String errorMessage;                  ///< Reading error (written by the prefetch thread)
+
+  std::deque<ActarSimEvGenEvent> buffer;  ///< Events read ahead, not used yet
+  G4bool endOfFile;                       ///< No more events will be added to the buffer
+
+  //ASCII files, parsed in the prefetch thread
+  std::ifstream asciiFile;                ///< ASCII file
+  G4int lineNumber;                       ///< Last line parsed
+  std::thread prefetchThread;             ///< Thread parsing ahead of the tracking
+  std::mutex bufferMutex;                 ///< Protects the buffer, endOfFile and errorMessage
+  std::condition_variable bufferNotFull;  ///< Wakes up the prefetch thread
+  std::condition_variable bufferNotEmpty; ///< Wakes up the tracking thread
+  G4bool stopRequested;                   ///< Asks the prefetch thread to finish
+
+  //ROOT files, read in blocks in the calling thread
+  TFile* rootFile;                        ///< ROOT file
+  TTree* rootTree;                        ///< Tree "evgen"
+  G4long nextEntry;                       ///< Next tree entry to read
+  G4int treeN;                            ///< Branch "n"
+  G4int treePdg[maxParticles];            ///< Branch "pdg[n]"
+  G4double treePx[maxParticles];          ///< Branch "px[n]"
+  G4double treePy[maxParticles];          ///< Branch "py[n]"
+  G4double treePz[maxParticles];          ///< Branch "pz[n]"
+  G4double treeWeight;                    ///< Branch "weight" (optional)
+
+  std::map<G4int,G4ParticleDefinition*> definitions; ///< Particle definitions already found
+
+  G4bool OpenAscii();
+  G4bool OpenTree();
+  void PrefetchLoop();
+  G4bool ParseEvent(ActarSimEvGenEvent& event);
+  G4bool ReadLine(std::string& line);
+  void ReadTreeBlock();
+  G4bool TakeEvent(ActarSimEvGenEvent& event);
+  G4ParticleDefinition* FindDefinition(G4int pdg);
+
 public:
   ActarSimEventGenerator();
   ~ActarSimEventGenerator();
 
-  //    File *pFile;
-  G4double LabAngle_scatt[1000];            ///< LabAngle_scatt
-  G4double LabEnergy_scatt[1000];           ///< LabEnergy_scatt
-  G4double LabAngle_recoil[1000];           ///< LabAngle_recoil
-  G4double LabEnergy_recoil[1000];          ///< LabEnergy_recoil
-  G4double theta_xsec[5000];                ///< theta_xsec
-  G4double CrossSection_t[5000];            ///< CrossSection_t
-  G4double Icross_section[5000];            ///< Integrated matrix (cross section)
+  G4bool Open(G4String name);
+  void Close();
+  G4bool IsOpen(G4String name) const {return !fileName.empty() && name==fileName;}
+
+  G4bool GenerateEvent(G4Event* anEvent, const G4ThreeVector& position, G4double time);
+
+  void SetPrefetchSize(G4int val){prefetchSize = (val>0) ? val : 1;}
+  G4long GetNumberOfEventsRead() const {return numberOfEventsRead;}
 };
 #endif
@@ -0,0 +1,85 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimEventTracks_h
+#define ActarSimEventTracks_h 1
+
+#include "TROOT.h"  //for including Rtypes.h
+#include "TObject.h"
+
+#include <vector>
+
+class ActarSimTrack;
+
+class ActarSimEventTracks : public TObject {
+private:
+  Int_t eventID;                    ///< Event ID
+  Int_t runID;                      ///< Run ID
+  Double_t positionResolution;      ///< Position quantum [mm]
+  Double_t energyResolution;        ///< Energy quantum [MeV]
+
+  //Index, one entry per set of consecutive steps of a track
+  std::vector<Int_t> trackID;       ///< Track ID
+  std::vector<Int_t> parentTrackID; ///< Parent Track ID
+  std::vector<Int_t> firstStep;     ///< Position of the first step in the step arrays
+  std::vector<Int_t> xStart;        ///< X at the start of the first step [positionResolution]
+  std::vector<Int_t> yStart;        ///< Y at the start of the first step [positionResolution]
+  std::vector<Int_t> zStart;        ///< Z at the start of the first step [positionResolution]
+
+  //Steps, positions relative to the previous point of the same track
+  std::vector<Int_t> dx;            ///< X increment in the step [positionResolution]
+  std::vector<Int_t> dy;            ///< Y increment in the step [positionResolution]
+  std::vector<Int_t> dz;            ///< Z increment in the step [positionResolution]
+  std::vector<Float_t> energyStep;  ///< Energy deposited in the step [MeV], quantized
+
+  Int_t lastX;                      //! Last point stored, for AddStep()
+  Int_t lastY;                      //!
+  Int_t lastZ;                      //!
+  Int_t cursorStep;                 //! Last step decoded, for sequential GetStep()
+  Int_t cursorEntry;                //!
+  Int_t cursorX;                    //!
+  Int_t cursorY;                    //!
+  Int_t cursorZ;                    //!
+  Int_t cursorEventID;              //!
+  Int_t cursorRunID;                //!
+
+  Int_t Quantize(Double_t pos) const;
+
+public:
+  ActarSimEventTracks();
+  virtual ~ActarSimEventTracks();
+
+  void Reset();
+  void AddStep(Int_t track, Int_t parent,
+	       Double_t xPre, Double_t yPre, Double_t zPre,
+	       Double_t xPost, Double_t yPost, Double_t zPost,
+	       Double_t energy);
+
+  Int_t GetNumberOfSteps() const {return (Int_t)dx.size();}
+  Int_t GetNumberOfEntries() const {return (Int_t)trackID.size();}
+  Int_t GetEntryTrackID(Int_t i) const {return trackID[i];}
+  Int_t GetEntryParentTrackID(Int_t i) const {return parentTrackID[i];}
+  Int_t GetEntryFirstStep(Int_t i) const {return firstStep[i];}
+  Int_t GetEntryNumberOfSteps(Int_t i) const;
+
+  void GetStep(Int_t step, ActarSimTrack* aTrack);
+  void ResetCursor();
+
+  Int_t GetEventID() const {return eventID;}
+  Int_t GetRunID() const {return runID;}
+  Double_t GetPositionResolution() const {return positionResolution;}
+  Double_t GetEnergyResolution() const {return energyResolution;}
+
+  void SetEventID(Int_t ev){eventID = ev;}
+  void SetRunID(Int_t ev){runID = ev;}
+  void SetPositionResolution(Double_t res){positionResolution = res;}
+  void SetEnergyResolution(Double_t res){energyResolution = res;}
+
+  ClassDef(ActarSimEventTracks,1) //ROOT CINT
+};
+#endif
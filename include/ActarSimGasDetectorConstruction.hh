@@ -18,10 +18,12 @@ class G4VPhysicalVolume;
 class G4Material;
 class ActarSimGasDetectorMessenger;
 class ActarSimDetectorConstruction;
+class ActarSimGasFastModel;
 
 class ActarSimGasDetectorConstruction {
 private:
   G4Material* gasMaterial;            ///< Pointer to the gas material
+  G4String gasMaterialName;           ///< Name of the gas (or GasMix) of gasMaterial
   G4Material* beamShieldMaterial;     ///< Pointer to the beam shield material
 
   G4int NumberOfGasMix;               ///< Number of gases in the gas mix (maximum 10)
@@ -55,6 +57,7 @@ private:
   ActarSimGasDetectorMessenger* gasMessenger;    ///< Pointer to the Messenger
   //ActarSimDetectorMessenger* detectorMessenger;   //pointer to the Messenger
   ActarSimDetectorConstruction* detConstruction; ///< Pointer to the global detector construction
+  ActarSimGasFastModel* gasFastModel;            ///< Fast simulation of the ions in the gas
 
   G4VPhysicalVolume* ConstructGas(G4LogicalVolume*);
 
@@ -66,6 +69,7 @@ public:
 
   //void DefineGas ();
   void SetGasMaterial (G4String);
+  void UpdateGasMaterial();
   void SetGasMixture(G4int val){NumberOfGasMix = val;}
   void SetGasMixMaterial(G4int GasNum, G4String GasMat, G4double GasRatio) {
     gasMixMaterial[GasNum-1]=GasMat;
@@ -93,7 +97,11 @@ public:
   void SetOuterRadiusBeamShieldTub(G4double val){outerRadiusBeamShieldTub = val;}
   void SetLengthBeamShieldTub(G4double val){lengthBeamShieldTub = val;}
 
+  ActarSimGasFastModel* GetGasFastModel(){return gasFastModel;}
+  void AddToActiveGas(G4LogicalVolume*);
+
   G4Material* GetGasMaterial() {return gasMaterial;}
+  G4Material* GetBeamShieldMaterial() {return beamShieldMaterial;}
   G4double GetGasPressure(void){return gasPressure;}
   G4double GetGasTemperature(void){return gasTemperature;}
 
@@ -37,6 +37,7 @@ private:
 
   G4UIdirectory*             detDir;                      ///< Directory
   G4UIdirectory*             detDirMix;                   ///< Directory for gas mix
+  G4UIdirectory*             fastSimDir;                  ///< Directory for the fast simulation
 
   G4UIcmdWithAString*        gasMaterCmd;                 ///< Select Material of the Gas (for the Gas box and the Chamber).
   G4UIcmdWithADoubleAndUnit* gasPresCmd;                  ///< Select the Gas Pressure (for the Gas box and the Chamber).
@@ -60,6 +61,10 @@ private:
   G4UIcmdWithADoubleAndUnit* outerRadiusBeamShieldTubCmd; ///< Select the external radius of the Gas Tube.
   G4UIcmdWithADoubleAndUnit* lengthBeamShieldTubCmd;      ///< Select the half-length of the Gas Tube.
 
+  G4UIcmdWithAString*        fastSimActiveCmd;            ///< Fast simulation of the ions in the gas (on/off).
+  G4UIcmdWithADoubleAndUnit* fastSimStrideCmd;            ///< Length of the fast simulation strides.
+  G4UIcmdWithAString*        fastSimStragglingCmd;        ///< Straggling in the fast simulation (on/off).
+
   //For the gas mixture
   G4int fGasNumber;                                       ///< Gas mixture parameters: number
   G4String fGasMaterial;                                  ///< Gas mixture parameters: material
@@ -0,0 +1,62 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimGasFastModel_h
+#define ActarSimGasFastModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <map>
+
+class G4Material;
+class G4Navigator;
+class G4ParticleDefinition;
+class ActarSimGasSD;
+class ActarSimRangeTable;
+
+class ActarSimGasFastModel : public G4VFastSimulationModel {
+private:
+  ActarSimGasSD* gasSD;                 ///< Gas SD receiving the strides
+  G4bool activeFlag;                    ///< Model triggered (true) or full physics (false)
+  G4bool stragglingFlag;                ///< Energy and angular straggling included
+  G4double strideLength;                ///< Length of each stride
+  G4double minimumLength;               ///< Shorter paths are left to the full physics
+  G4int nBins;                          ///< Number of energy bins of the range tables
+
+  G4Navigator* navigator;               ///< Navigator for the boundaries (not the tracking one)
+  const G4Material* tableMaterial;      ///< Material of the range tables
+  std::map<const G4ParticleDefinition*,ActarSimRangeTable*> rangeTables; ///< One per ion
+
+  ActarSimRangeTable* GetRangeTable(const G4ParticleDefinition* ion, const G4Material* gas,
+				    G4double energy);
+  G4double DistanceToBoundary(const G4ThreeVector& position, const G4ThreeVector& direction,
+			      G4double maxLength);
+
+public:
+  ActarSimGasFastModel(G4String name);
+  ~ActarSimGasFastModel();
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle);
+  G4bool ModelTrigger(const G4FastTrack& fastTrack);
+  void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+  void ClearTables();
+
+  void SetGasSD(ActarSimGasSD* val){gasSD = val;}
+  void SetActiveFlag(G4bool val){activeFlag = val;}
+  void SetStragglingFlag(G4bool val){stragglingFlag = val;}
+  void SetStrideLength(G4double val){strideLength = val;}
+  void SetMinimumLength(G4double val){minimumLength = val;}
+  void SetNumberOfBins(G4int val){nBins = val; ClearTables();}
+
+  G4bool GetActiveFlag() const {return activeFlag;}
+  G4double GetStrideLength() const {return strideLength;}
+};
+#endif
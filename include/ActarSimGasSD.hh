@@ -14,11 +14,14 @@
 #include "ActarSimGasGeantHit.hh"
 
 class G4Step;
+class G4Track;
 class G4HCofThisEvent;
+class ActarSimSDFilter;
 
 class ActarSimGasSD : public G4VSensitiveDetector {
 private:
   ActarSimGasGeantHitsCollection* hitsCollection; ///< Geant step-like hits collect.
+  ActarSimSDFilter* stepFilter;  ///< Step filter evaluated before creating any hit
 
 public:
   ActarSimGasSD(G4String);
@@ -26,6 +29,12 @@ public:
 
   void Initialize(G4HCofThisEvent*);
   G4bool ProcessHits(G4Step*,G4TouchableHistory*);
+  G4bool ProcessStride(const G4Track* track,
+		       const G4ThreeVector& prePos, const G4ThreeVector& postPos,
+		       G4double preTime, G4double postTime,
+		       G4double preEnergy, G4double postEnergy);
   void EndOfEvent(G4HCofThisEvent*);
+
+  ActarSimSDFilter* GetStepFilter(){return stepFilter;}
 };
 #endif
@@ -0,0 +1,47 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimGeometryCache_h
+#define ActarSimGeometryCache_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <set>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+class ActarSimGeometryCache {
+private:
+  G4bool activeFlag;     ///< Geometry loaded from (and saved to) the cache
+  G4String directory;    ///< Directory of the cached GDML files
+
+  G4String GetFileName(const G4String& key) const;
+  void RestoreWall(G4LogicalVolume* envelope, const G4String& copyNumbers);
+  void RestoreVisAttributes(G4LogicalVolume* volume, const G4String& attributes);
+  void RestoreMaterials(G4LogicalVolume* volume, size_t existingMaterials,
+			std::set<G4LogicalVolume*>& visited);
+
+public:
+  ActarSimGeometryCache();
+  ~ActarSimGeometryCache();
+
+  static G4String GetKey(const G4String& configuration);
+
+  G4VPhysicalVolume* Load(const G4String& key,
+			  std::multimap<G4String,G4LogicalVolume*>& regionRoots);
+  G4bool Save(G4VPhysicalVolume* world, const G4String& key);
+
+  void SetActiveFlag(G4bool val){activeFlag = val;}
+  void SetDirectory(G4String val){directory = val;}
+
+  G4bool GetActiveFlag() const {return activeFlag;}
+  G4String GetDirectory() const {return directory;}
+};
+#endif
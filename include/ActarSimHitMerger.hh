@@ -0,0 +1,116 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimHitMerger
+/// Map from a pair of integer keys (trackID or detector name index,
+/// and detID) to the position of the merged hit in the ClonesArray.
+/// Open addressing with linear probing: the GeantHits of an event are
+/// merged in a single pass, without the nested searches. The table is
+/// kept between events and only the occupied slots are cleared.
+/////////////////////////////////////////////////////////////////
+
+#ifndef ActarSimHitMerger_h
+#define ActarSimHitMerger_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class ActarSimHitMerger {
+private:
+  std::vector<G4int> slotKey1;     ///< First key of each slot
+  std::vector<G4int> slotKey2;     ///< Second key of each slot
+  std::vector<G4int> slotIndex;    ///< Merged hit index of each slot (-1 if empty)
+  std::vector<G4int> usedSlots;    ///< Occupied slots, in insertion order
+  std::vector<G4String> names;     ///< Detector names seen (see GetNameIndex())
+  size_t mask;                     ///< Table size minus one (size is a power of two)
+
+  size_t Hash(G4int key1, G4int key2) const {
+    unsigned int h = (unsigned int)key1*2654435761u + (unsigned int)key2*2246822519u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    return (size_t)h & mask;
+  }
+
+  size_t FindSlot(G4int key1, G4int key2) const {
+    size_t slot = Hash(key1,key2);
+    while(slotIndex[slot]>=0 && (slotKey1[slot]!=key1 || slotKey2[slot]!=key2))
+      slot = (slot+1) & mask;
+    return slot;
+  }
+
+  void Resize(size_t size) {
+    std::vector<G4int> oldKey1(slotKey1), oldKey2(slotKey2), oldIndex(slotIndex);
+    std::vector<G4int> oldUsed(usedSlots);
+    slotKey1.assign(size,0);
+    slotKey2.assign(size,0);
+    slotIndex.assign(size,-1);
+    usedSlots.clear();
+    mask = size-1;
+    for(size_t i=0;i<oldUsed.size();i++){
+      size_t slot = FindSlot(oldKey1[oldUsed[i]],oldKey2[oldUsed[i]]);
+      slotKey1[slot] = oldKey1[oldUsed[i]];
+      slotKey2[slot] = oldKey2[oldUsed[i]];
+      slotIndex[slot] = oldIndex[oldUsed[i]];
+      usedSlots.push_back((G4int)slot);
+    }
+  }
+
+public:
+  ActarSimHitMerger():mask(0) {Resize(16);}
+  ~ActarSimHitMerger(){;}
+
+  /// Empties the map. The table grows (once) to keep the load below
+  /// one half for the expected number of keys
+  void Reset(G4int expectedKeys) {
+    for(size_t i=0;i<usedSlots.size();i++) slotIndex[usedSlots[i]] = -1;
+    usedSlots.clear();
+    size_t size = mask+1;
+    while(size < 2*(size_t)expectedKeys) size *= 2;
+    if(size != mask+1) Resize(size);
+  }
+
+  /// Returns the index of the merged hit with these keys, or -1
+  G4int Find(G4int key1, G4int key2) const {
+    return slotIndex[FindSlot(key1,key2)];
+  }
+
+  /// Returns the index of the merged hit with these keys, creating
+  /// it (with the next free index) if not found. isNew tells which
+  G4int FindOrInsert(G4int key1, G4int key2, G4bool& isNew) {
+    size_t slot = FindSlot(key1,key2);
+    if(slotIndex[slot]>=0) {
+      isNew = false;
+      return slotIndex[slot];
+    }
+    if(2*(usedSlots.size()+1) > mask+1) {
+      Resize(2*(mask+1));
+      slot = FindSlot(key1,key2);
+    }
+    isNew = true;
+    slotKey1[slot] = key1;
+    slotKey2[slot] = key2;
+    slotIndex[slot] = (G4int)usedSlots.size();
+    usedSlots.push_back((G4int)slot);
+    return slotIndex[slot];
+  }
+
+  /// Number of merged hits since the last Reset()
+  G4int GetEntries() const {return (G4int)usedSlots.size();}
+
+  /// Small integer identifying a detector name, to be used as a key.
+  /// The names are kept for the whole run (usually only one per detector)
+  G4int GetNameIndex(const G4String& name) {
+    for(size_t i=0;i<names.size();i++)
+      if(names[i]==name) return (G4int)i;
+    names.push_back(name);
+    return (G4int)names.size()-1;
+  }
+};
+#endif
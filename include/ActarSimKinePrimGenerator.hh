@@ -31,6 +31,7 @@ private:
   G4double* ANGAs;  ///< Lab angle and energy of scattered particle
   G4double* ANGAr;  ///< Lab angle and energy of recoiled particle
   G4bool    NoSolution; ///< Flag
+  G4int     verbose;    ///< Print the no-solution message if positive
 
 public:
   ActarSimKinePrimGenerator();
@@ -53,6 +54,7 @@ public:
   void SetANGAr(G4int place, G4double value){ANGAr[place] = value;}
 
   void SetNoSolution(G4bool value){NoSolution=value;}
+  void SetVerbose(G4int value){verbose = value;}
 
   G4double GetMassOfProjectile(void){return m1;}
   G4double GetMassOfTarget(void){return m2;}
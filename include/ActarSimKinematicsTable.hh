@@ -0,0 +1,59 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimKinematicsTable_h
+#define ActarSimKinematicsTable_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class ActarSimCinePrimGenerator;
+class ActarSimKinePrimGenerator;
+
+class ActarSimKinematicsTable {
+private:
+  G4int    nEnergies;              ///< Number of energy nodes
+  G4double energyMin;              ///< Energy of the first node
+  G4double energyStep;             ///< Distance between energy nodes
+  G4int    nAngles;                ///< Number of angle nodes, from 0 to pi
+
+  // Two solutions per node, index ((iEnergy*nAngles+iAngle)*2+solution)
+  std::vector<G4double> theta3;    ///< Lab angle of the scattered particle
+  std::vector<G4double> energy3;   ///< Lab kinetic energy of the scattered particle
+  std::vector<G4double> theta4;    ///< Lab angle of the recoil
+  std::vector<G4double> energy4;   ///< Lab kinetic energy of the recoil
+  std::vector<char>     valid;     ///< Solution found in the node
+
+  void Allocate(G4double eMin, G4double eMax, G4int nE, G4int nA);
+  G4bool Locate(G4double energy, G4double angle,
+		G4int& iE, G4double& fE, G4int& iA, G4double& fA) const;
+  G4bool IsValidBin(G4int iE, G4double fE, G4int iA) const;
+  G4double ScanValidRegion(G4double energy, G4double aMin, G4double aMax,
+			   G4double target, G4double& angle) const;
+
+public:
+  ActarSimKinematicsTable();
+  ~ActarSimKinematicsTable();
+
+  void BuildFromCine(ActarSimCinePrimGenerator* cine,
+		     G4double eMin, G4double eMax, G4int nE, G4int nA);
+  void BuildFromKine(ActarSimKinePrimGenerator* kine,
+		     G4double eMin, G4double eMax, G4int nE, G4int nA);
+  void Clear();
+
+  G4bool GetSolution(G4double energy, G4double angle, G4int solution,
+		     G4double& th3, G4double& e3, G4double& th4, G4double& e4) const;
+  G4int GetNumberOfSolutions(G4double energy, G4double angle) const;
+  G4bool SampleAngle(G4double energy, G4double aMin, G4double aMax, G4double& angle) const;
+  G4double GetValidLength(G4double energy, G4double aMin, G4double aMax) const;
+  G4bool IsValidAngle(G4double energy, G4double angle) const;
+
+  G4bool IsBuilt() const {return !valid.empty();}
+};
+#endif
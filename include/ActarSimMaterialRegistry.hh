@@ -0,0 +1,42 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimMaterialRegistry_h
+#define ActarSimMaterialRegistry_h 1
+
+#include "globals.hh"
+
+#include <map>
+
+class G4Element;
+class G4Material;
+
+class ActarSimMaterialRegistry {
+private:
+  std::map<G4String,G4Element*> elements;  ///< Elements created, by symbol
+  std::map<G4String,G4Material*> gases;    ///< Gas materials built, by key
+
+  G4String GetGasKey(const G4String& gas, G4double pressure, G4double temperature) const;
+  G4String GetNewMaterialName(const G4String& base, const G4String& key) const;
+  G4Material* BuildGas(const G4String& gas, const G4String& key,
+		       G4double pressure, G4double temperature);
+
+public:
+  ActarSimMaterialRegistry();
+  ~ActarSimMaterialRegistry();
+
+  G4Element* GetElement(const G4String& symbol);
+
+  G4bool IsGas(const G4String& gas) const;
+  G4Material* GetGas(const G4String& gas, G4double pressure, G4double temperature);
+  G4Material* GetGasMixture(G4int numberOfGases, const G4String* gas, const G4double* ratio,
+			    G4double pressure, G4double temperature);
+
+  G4int GetNumberOfGases() const {return gases.size();}
+};
+#endif
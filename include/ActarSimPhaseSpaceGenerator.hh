@@ -0,0 +1,73 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimPhaseSpaceGenerator_h
+#define ActarSimPhaseSpaceGenerator_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4LorentzVector.hh"
+
+#include <vector>
+
+class G4Event;
+class G4ParticleDefinition;
+
+/// Matrix element weight of the N-body phase space generator. The
+/// products are given in the center of mass frame; the weight must not
+/// be larger than GetMaximumWeight() (used in the unweighted mode)
+class ActarSimPhaseSpaceWeight {
+public:
+  virtual ~ActarSimPhaseSpaceWeight(){}
+  virtual G4double GetWeight(const std::vector<G4LorentzVector>& products) const = 0;
+  virtual G4double GetMaximumWeight() const {return 1.;}
+};
+
+class ActarSimPhaseSpaceGenerator {
+private:
+  std::vector<G4ParticleDefinition*> products; ///< Particles in the final state
+  std::vector<G4double> masses;                ///< Masses of the products
+  ActarSimPhaseSpaceWeight* matrixElement;     ///< Weight hook (not owned, 0 if none)
+  G4bool weightedFlag;                         ///< Weighted events (true) or unweighted (false)
+  G4int batchSize;                             ///< Events generated together (fixed beam energy)
+
+  G4double batchMass;                          ///< CM energy of the events in the batch
+  G4double batchBeta;                          ///< Velocity of the CM frame (along Z)
+  G4double maximumWeight;                      ///< Maximum phase space weight for batchMass
+  G4int eventsInBatch;                         ///< Events in the present batch (batchSize or 1)
+  G4int nextEvent;                             ///< Next event of the batch to use
+  G4int numberOfBatches;                       ///< Batches generated in the run
+
+  // batch storage, index body*eventsInBatch+event
+  std::vector<G4double> px;                    ///< Momentum x component
+  std::vector<G4double> py;                    ///< Momentum y component
+  std::vector<G4double> pz;                    ///< Momentum z component
+  std::vector<G4double> e;                     ///< Total energy
+  std::vector<G4double> weight;                ///< Event weight (normalized to the maximum)
+  std::vector<G4double> random;                ///< Random numbers of the batch
+
+  static G4double Pdk(G4double a, G4double b, G4double c);
+  void GenerateBatch();
+
+public:
+  ActarSimPhaseSpaceGenerator();
+  ~ActarSimPhaseSpaceGenerator();
+
+  G4bool SetProducts(G4String names);
+  G4int GetNumberOfProducts() const {return (G4int)products.size();}
+
+  void SetMatrixElement(ActarSimPhaseSpaceWeight* val){matrixElement = val; Clear();}
+  void SetWeightedFlag(G4bool val){weightedFlag = val;}
+  void SetBatchSize(G4int val){batchSize = (val>0) ? val : 1; Clear();}
+  void Clear();
+
+  G4bool GenerateEvent(G4Event* anEvent, const G4ThreeVector& position, G4double time,
+		       const G4ParticleDefinition* beam, G4double beamEnergy,
+		       const G4ParticleDefinition* target, G4bool fixedEnergy);
+};
+#endif
@@ -16,11 +16,15 @@
 
 class ActarSimPhysicsListMessenger;
 class ActarSimStepLimiterBuilder;
+class ActarSimPhysicsTableCache;
+class ActarSimRegionSettings;
+class ActarSimRangeTableService;
 class G4VPhysicsConstructor;
 
 class ActarSimPhysicsList: public G4VModularPhysicsList {
 private:
   void AddIonGasModels();
+  void AddFastSimulation();
 
   G4double cutForGamma;            ///< Cut energy parameter for gammas
   G4double cutForElectron;         ///< Cut energy parameter for gammas
@@ -34,6 +38,7 @@ private:
   G4bool   gnucIsRegisted;         ///< Register control parameter for library
   G4bool   gasIsRegisted;          ///< Register control parameter for library
   G4bool   stopIsRegisted;         ///< Register control parameter for library
+  G4bool   fastSimIsRegisted;      ///< Register control parameter for library
 
   ActarSimPhysicsListMessenger* pMessenger;  ///< Pointer to messenger
   ActarSimStepLimiterBuilder* steplimiter;   ///< Pointer to step limiter
@@ -41,6 +46,11 @@ private:
 
   G4VPhysicsConstructor*  emPhysicsList;     ///< Pointer to Physics list
 
+  G4String physicsNames;                     ///< Physics modules added, in order
+  ActarSimPhysicsTableCache* physicsTableCache; ///< Pointer to the physics table cache
+  ActarSimRegionSettings* regionSettings;       ///< Pointer to the cuts and step limits of the regions
+  ActarSimRangeTableService* rangeTableService; ///< Pointer to the range tables (G4EmCalculator)
+
 public:
   ActarSimPhysicsList();
   ~ActarSimPhysicsList();
@@ -60,5 +70,10 @@ public:
                                           const G4String& modname,
                                           const G4String& procname);
   void SetVerbose(G4int val);
+
+  G4String GetPhysicsConfiguration() const;
+  ActarSimPhysicsTableCache* GetPhysicsTableCache(){return physicsTableCache;}
+  ActarSimRegionSettings* GetRegionSettings(){return regionSettings;}
+  ActarSimRangeTableService* GetRangeTableService(){return rangeTableService;}
 };
 #endif
@@ -18,6 +18,8 @@ class G4UIdirectory;
 class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWithAString;
 class G4UIcmdWithAnInteger;
+class G4UIcommand;
+class G4UIcmdWithoutParameter;
 
 class ActarSimPhysicsListMessenger: public G4UImessenger {
 private:
@@ -32,6 +34,29 @@ private:
   G4UIcmdWithAString*        pListCmd;      ///< Add modula physics list
   G4UIcmdWithAString*        RmPListCmd;    ///< Remove all modula physics list
 
+  G4UIdirectory*             tableCacheDir;      ///< Directory of the physics table cache
+  G4UIcmdWithAString*        tableCacheActiveCmd;///< Activate the physics table cache
+  G4UIcmdWithAString*        tableCacheDirCmd;   ///< Select the physics table cache directory
+
+  G4UIdirectory*             regionDir;          ///< Directory of the region settings
+  G4UIcommand*               regionCutCmd;       ///< Set the cuts of a region
+  G4UIcommand*               regionStepMaxCmd;   ///< Set the maximum step length in a region
+  G4UIcmdWithAString*        regionReportCmd;    ///< Report the cost of each region at the end of the run
+
+  G4UIdirectory*             rangeDir;           ///< Directory of the range table service
+  G4UIcmdWithAString*        rangeParticleCmd;   ///< Add a particle to tabulate in the gas
+  G4UIcommand*               rangeIonCmd;        ///< Add an ion (Z, A) to tabulate in the gas
+  G4UIcmdWithoutParameter*   rangeClearCmd;      ///< Remove the particles and ions to tabulate
+  G4UIcmdWithAString*        rangeCacheCmd;      ///< Activate the disk cache of the range tables
+  G4UIcmdWithAString*        rangeDirCmd;        ///< Select the directory of the disk cache
+  G4UIcmdWithAString*        rangeExportCmd;     ///< Export the range tables as ROOT files
+  G4UIcmdWithAString*        rangeExportDirCmd;  ///< Select the directory of the ROOT files
+  G4UIcmdWithADoubleAndUnit* rangeMinEnergyCmd;  ///< Lower energy per nucleon of the tables
+  G4UIcmdWithADoubleAndUnit* rangeMaxEnergyCmd;  ///< Upper energy per nucleon of the tables
+  G4UIcmdWithAnInteger*      rangeBinsCmd;       ///< Nodes per decade of the tables
+
+  void RegionCommand(G4UIcommand* command, G4String newValues);
+
 public:
   ActarSimPhysicsListMessenger(ActarSimPhysicsList* );
   ~ActarSimPhysicsListMessenger();
@@ -0,0 +1,47 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimPhysicsTableCache_h
+#define ActarSimPhysicsTableCache_h 1
+
+#include "globals.hh"
+
+#include <set>
+#include <vector>
+
+class G4LogicalVolume;
+class G4Material;
+class G4VUserPhysicsList;
+
+class ActarSimPhysicsTableCache {
+private:
+  G4bool activeFlag;         ///< Physics tables retrieved from (and stored in) the cache
+  G4String directory;        ///< Directory of the cache
+  G4String tableDirectory;   ///< Directory of the tables of the current configuration
+  G4bool retrieveFlag;       ///< Retrieval of tableDirectory set in the physics list
+  G4bool storePending;       ///< Tables of the current configuration not in the cache
+
+  G4String GetConfiguration(const G4String& physicsConfiguration) const;
+  void AddMaterials(const G4LogicalVolume* volume, std::set<const G4LogicalVolume*>& visited,
+		    std::vector<const G4Material*>& materials) const;
+  void RemoveDirectory(const G4String& path) const;
+
+public:
+  ActarSimPhysicsTableCache();
+  ~ActarSimPhysicsTableCache();
+
+  void Prepare(G4VUserPhysicsList* physicsList, const G4String& physicsConfiguration);
+  void Store(G4VUserPhysicsList* physicsList);
+
+  void SetActiveFlag(G4bool val){activeFlag = val;}
+  void SetDirectory(G4String val){directory = val;}
+
+  G4bool GetActiveFlag() const {return activeFlag;}
+  G4String GetDirectory() const {return directory;}
+};
+#endif
@@ -20,12 +20,22 @@
 #include "G4ParticleMomentum.hh"
 #include "globals.hh"
 
-#include "ActarSimEventGenerator.hh"
-
 class G4Event;
 class ActarSimPrimaryGeneratorMessenger;
 class ActarSimDetectorConstruction;
 class ActarSimGasDetectorConstruction;
+class ActarSimReactionTable;
+class ActarSimKinematicsTable;
+class ActarSimCrossSectionTable;
+class ActarSimCinePrimGenerator;
+class ActarSimKinePrimGenerator;
+class ActarSimEulerTransformation;
+class ActarSimBeamTransport;
+class ActarSimBeamLibrary;
+class ActarSimAcceptanceFilter;
+class ActarSimEventGenerator;
+class ActarSimBeamPhaseSpace;
+class ActarSimPhaseSpaceGenerator;
 
 class ActarSimPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction {
 private:
@@ -33,7 +43,6 @@ private:
   G4ParticleTable* particleTable;                   ///< Pointer to the G4ParticleTable
   G4IonTable* ionTable;                             ///< Pointer to the G4IonTable
   ActarSimPrimaryGeneratorMessenger* gunMessenger;  ///< Pointer to messenger
-  //ActarSimEventGenerator *pReadEvGen;
 
   ActarSimGasDetectorConstruction* gasDetector;    ///< Pointer to gas detector constructor, to get some geometrical info
 
@@ -71,17 +80,37 @@ private:
   G4double  randomPhiMax;         ///< Maximum random phi angle in CINE
 
   G4String  beamInteractionFlag;          ///< Flag for beam interaction mode
+  G4String  fastBeamFlag;                 ///< Flag for the analytic beam transport to the vertex
+  G4String  fastBeamStragglingFlag;       ///< Flag for the straggling in the analytic beam transport
+  G4String  beamLibraryMode;              ///< Beam trajectory library: off, record or replay
+  G4String  beamLibraryFile;              ///< File of the beam trajectory library
+  G4String  beamPhaseSpaceFlag;           ///< Flag for a beam sampled from a phase space file
+  G4String  beamPhaseSpaceFile;           ///< Beam phase space file (x, x', y, y', E)
+  G4bool    beamPhaseSpaceFailed;         ///< Beam phase space file not valid (not read again in the run)
+  G4String  acceptanceFilterMode;         ///< Acceptance test of the reaction products: off, reject or resample
+  G4int     acceptanceMaxTries;           ///< Maximum number of reactions generated per event (resample)
   G4String  realisticBeamFlag;            ///< Flag for realistic beam interaction
-  G4String  reactionFromEvGenFlag;        ///< Flag for a reaction taken from the tabulated Ev Generator
-  G4String  reactionFromCrossSectionFlag; ///< Flag for a reaction taken from the Ev Generator+CINE
+  G4String  reactionFromEvGenFlag;        ///< Flag for a reaction taken from an external event generator
+  G4String  evGenFile;                    ///< File of the external event generator (ASCII or ROOT)
+  G4String  reactionFromCrossSectionFlag; ///< Flag for a KINE CM angle sampled from the cross section
   G4String  reactionFromFileFlag;         ///< Flag for a reaction taken from a file
   G4String  reactionFromCineFlag;         ///< Flag for a reaction calculated using Cine
   G4String  randomThetaFlag;              ///< Flag for a random theta angle in CINE
   G4String  randomPhiFlag;                ///< Flag for a random phi angle in CINE
   G4String  alphaSourceFlag;              ///< Flag for a alpha source emitter
   G4String  reactionFile;                 ///< File definition for a reaction
+  G4String  reactionFileWeightedFlag;     ///< Flag for sampling the reaction file rows with the cross section column
+  ActarSimReactionTable* reactionTable;   ///< Reaction file contents, loaded once
+  G4bool    reactionFileFailed;           ///< Reaction file not valid (not read again in the run)
+  G4String  crossSectionFile;             ///< Angular distribution file (CM angle, dSigma/dOmega)
+  ActarSimCrossSectionTable* crossSectionTable; ///< Angular distribution, loaded once
+  G4String  angularBiasFlag;              ///< Flag for the importance sampling of the reaction angle
+  G4String  angularBiasFile;              ///< Bias density file (angle, density per unit angle)
+  ActarSimCrossSectionTable* angularBiasTable;  ///< Bias density, loaded once
+  G4double  reactionWeight;               ///< Weight of the reaction products (importance sampling)
 
   G4String  reactionFromKineFlag;  ///< Flag for using KINE
+  G4String  reactionFromPhaseSpaceFlag; ///< Flag for the N-body phase space
   G4double  thetaCMAngle;          ///< Center of mass polar angle
   G4double  userThetaAngle;        ///< User theta angle
   G4double  userPhiAngle;          ///< User phi angle
@@ -96,11 +125,38 @@ private:
   G4ThreeVector vertexPosition;    ///< Position of the vertex
   G4String  randomPhiAngleFlag;    ///< Flag for a random phi angle
 
+  ActarSimCinePrimGenerator* cineGenerator;       ///< CINE calculation, kept for the whole run
+  ActarSimKinePrimGenerator* kineGenerator;       ///< KINE calculation, kept for the whole run
+  ActarSimEulerTransformation* eulerTransformer;  ///< Beam to lab frame transformation
+  ActarSimKinematicsTable* cineTable;             ///< CINE kinematics tabulated at the first event of the run
+  ActarSimKinematicsTable* kineTable;             ///< KINE kinematics tabulated at the first event of the run
+  ActarSimBeamTransport* beamTransport;           ///< Analytic beam transport (fastBeamFlag on)
+  ActarSimBeamLibrary* beamLibrary;               ///< Tracked beam trajectories (beamLibraryMode)
+  ActarSimAcceptanceFilter* acceptanceFilter;     ///< Acceptance test of the reaction products
+  ActarSimEventGenerator* eventGenerator;         ///< Reader of the external event generator file
+  ActarSimBeamPhaseSpace* beamPhaseSpace;         ///< Beam phase space, loaded once
+  ActarSimPhaseSpaceGenerator* phaseSpaceGenerator; ///< N-body phase space (breakup channels)
+
+  void BuildCineTable();
+  void BuildKineTable();
+  G4String GetBeamLibrarySetting();
+  void GenerateReaction(G4Event* anEvent);
+  void GenerateAcceptedReaction(G4Event* anEvent);
+  G4bool SampleBiasedAngle(G4bool fromCrossSection, G4double& angle);
+  G4bool LoadBeamPhaseSpace();
+  G4bool LoadReactionFile();
+  G4int CineKinematics(G4double thetaLab, G4double* energyScattered,
+		       G4double* thetaRecoil, G4double* energyRecoil);
+  G4bool KineKinematics(G4double thetaCM, G4double& thetaScattered, G4double& energyScattered,
+			G4double& thetaRecoil, G4double& energyRecoil);
+
 public:
   ActarSimPrimaryGeneratorAction();
   ~ActarSimPrimaryGeneratorAction();
 
   void GeneratePrimaries(G4Event* anEvent);
+  void BeginOfRunAction();
+  void EndOfRunAction();
 
   void SetReactionFromCineFlag(G4String val) { reactionFromCineFlag = val;}
   void SetIncidentIon(G4Ions* aIonDef) { incidentIon = aIonDef;}
@@ -118,6 +174,11 @@ public:
 
   // corresponding Kine part
   void SetReactionFromKineFlag(G4String val) { reactionFromKineFlag = val;}
+  void SetReactionFromPhaseSpaceFlag(G4String val) { reactionFromPhaseSpaceFlag = val;}
+  void SetPhaseSpaceProducts(G4String val);
+  void SetPhaseSpaceWeightedFlag(G4String val);
+  void SetPhaseSpaceBatchSize(G4int val);
+  ActarSimPhaseSpaceGenerator* GetPhaseSpaceGenerator() {return phaseSpaceGenerator;}
 
   void SetThetaCMAngle(G4double val){thetaCMAngle=val; beamDirectionFlag=0;}
   void SetUserThetaAngle(G4double val){userThetaAngle=val; beamDirectionFlag=0;}
@@ -180,17 +241,37 @@ public:
   }
 
   void SetBeamInteractionFlag(G4String val) { beamInteractionFlag = val;}
+  void SetFastBeamFlag(G4String val) { fastBeamFlag = val;}
+  void SetFastBeamStragglingFlag(G4String val) { fastBeamStragglingFlag = val;}
+  void SetBeamLibraryMode(G4String val);
+  void SetBeamLibraryFile(G4String val) { beamLibraryFile = val;}
+  void SetBeamPhaseSpaceFlag(G4String val) { beamPhaseSpaceFlag = val;}
+  void SetBeamPhaseSpaceFile(G4String val);
+  void SetBeamLibraryStrideLength(G4double val);
+
+  void SetAcceptanceFilterMode(G4String val) { acceptanceFilterMode = val;}
+  void SetAcceptanceMaxTries(G4int val) { acceptanceMaxTries = val;}
+  void SetAcceptanceDetectors(G4String val);
+  void SetAcceptanceMinProducts(G4int val);
+  void SetAcceptanceMinGasLength(G4double val);
+  void SetAcceptanceEnergyLossFlag(G4String val);
 
   void SetRealisticBeamFlag(G4String val) { realisticBeamFlag = val;}
   void SetReactionFromFileFlag(G4String val) { reactionFromFileFlag = val;}
 
   void SetReactionFromEvGenFlag(G4String val) { reactionFromEvGenFlag = val;}
+  void SetEvGenFile(G4String val);
+  void SetEvGenPrefetchSize(G4int val);
   void SetReactionFromCrossSectionFlag(G4String val) { reactionFromCrossSectionFlag = val;}
 
   void SetRandomThetaFlag(G4String val) { randomThetaFlag = val;}
   void SetRandomPhiFlag(G4String val) { randomPhiFlag = val;}
   void SetAlphaSourceFlag(G4String val) { alphaSourceFlag = val;}
-  void SetReactionFile(G4String val) { reactionFile = val;}
+  void SetReactionFile(G4String val);
+  void SetReactionFileWeightedFlag(G4String val) { reactionFileWeightedFlag = val;}
+  void SetCrossSectionFile(G4String val);
+  void SetAngularBiasFlag(G4String val) { angularBiasFlag = val;}
+  void SetAngularBiasFile(G4String val);
 
   //virtual void SetInitialValues();
 
@@ -38,11 +38,30 @@ private:
   G4UIcmdWithAString*          particleCmd;            ///< Select the incident particle.
   G4UIcmdWithAString*          realisticBeamCmd;       ///< Simulates beam emittance according to emittance parameters.
   G4UIcmdWithAString*          beamInteractionCmd;     ///< Simulates the beam energy loss in gas.
+  G4UIcmdWithAString*          fastBeamCmd;            ///< Analytic beam transport to the vertex
+  G4UIcmdWithAString*          fastBeamStragglingCmd;  ///< Straggling in the analytic beam transport
+  G4UIcmdWithAString*          beamLibraryModeCmd;     ///< Record or replay the beam trajectory library
+  G4UIcmdWithAString*          beamLibraryFileCmd;     ///< File of the beam trajectory library
+  G4UIcmdWithADoubleAndUnit*   beamLibraryStrideLengthCmd; ///< Stride length of the recorded beam trajectories
+  G4UIcmdWithAString*          beamPhaseSpaceCmd;      ///< Beam sampled from a phase space file
+  G4UIcmdWithAString*          beamPhaseSpaceFileCmd;  ///< Beam phase space file
+  G4UIcmdWithAString*          acceptanceFilterCmd;    ///< Acceptance test of the reaction products
+  G4UIcmdWithAString*          acceptanceDetectorsCmd; ///< Sensitive detectors giving the acceptance
+  G4UIcmdWithAnInteger*        acceptanceMinProductsCmd; ///< Products in the acceptance needed
+  G4UIcmdWithADoubleAndUnit*   acceptanceMinGasLengthCmd; ///< Length in the gas giving the acceptance
+  G4UIcmdWithAString*          acceptanceEnergyLossCmd; ///< Range of the products in the acceptance test
+  G4UIcmdWithAnInteger*        acceptanceMaxTriesCmd;  ///< Maximum number of reactions per event
   G4UIcmdWithAString*          reactionFromFileCmd;    ///< Select a reaction from an input file
-  G4UIcmdWithAString*          reactionFromCrossSectionCmd; ///< DO NOT USE. Simulates beam/target from the cross-sections. DO NOT USE.
-  G4UIcmdWithAString*          reactionFromEvGenCmd;   ///< DO NOT USE. Simulates beam/target from event generator. DO NOT USE.
+  G4UIcmdWithAString*          reactionFromCrossSectionCmd; ///< KINE CM angle sampled from the angular distribution file
+  G4UIcmdWithAString*          reactionFromEvGenCmd;   ///< Reaction products read from an external event generator file
+  G4UIcmdWithAString*          evGenFileCmd;           ///< Select the external event generator file
+  G4UIcmdWithAnInteger*        evGenPrefetchSizeCmd;   ///< Events of the external generator read ahead
   G4UIcmdWithAString*          reactionFromCineCmd;    ///< Select a reaction using Cine
   G4UIcmdWithAString*          reactionFileCmd;        ///< Select the reaction definition file.
+  G4UIcmdWithAString*          reactionFileWeightedCmd;///< Sample the reaction file rows with the cross section column
+  G4UIcmdWithAString*          crossSectionFileCmd;    ///< Select the angular distribution file
+  G4UIcmdWithAString*          angularBiasCmd;         ///< Importance sampling of the reaction angle
+  G4UIcmdWithAString*          angularBiasFileCmd;     ///< Select the bias density file
   G4UIcmdWithAString*          randomThetaCmd;         ///< Select a random Theta angle for the scattered particle.
   G4UIcmdWithAString*          randomPhiCmd;           ///< Select a random Phi angle for the scattered particle.
   G4UIcmdWithAString*          alphaSourceCmd;         ///< NOT VALIDATED. CHECK THIS COMMAND!
@@ -69,6 +88,11 @@ private:
 
   G4UIdirectory*               KineDir;                ///< Directory for CINE commands
   G4UIcmdWithAString*          reactionFromKineCmd;    ///< Select a reaction using Kine
+  G4UIcmdWithAString*          reactionFromPhaseSpaceCmd; ///< Select a breakup reaction using the N-body phase space
+  G4UIdirectory*               PhaseSpaceDir;          ///< Directory for the N-body phase space commands
+  G4UIcmdWithAString*          PhaseSpaceProductsCmd;  ///< Products of the breakup
+  G4UIcmdWithAString*          PhaseSpaceWeightedCmd;  ///< Weighted or unweighted phase space events
+  G4UIcmdWithAnInteger*        PhaseSpaceBatchSizeCmd; ///< Phase space events generated together
   G4UIcmdWithAString*          KineRandomThetaCmd;     ///< Randomize Theta_CM of outgoing particles
   G4UIcommand*                 KineRandomThetaRangeCmd; ///< Sets the limits in the Theta angle for the scattered particle.
   G4UIcmdWithAString*          KineRandomPhiAngleCmd;  ///< Randomize Lab Phi angles of out-going particles
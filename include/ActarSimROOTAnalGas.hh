@@ -24,9 +24,11 @@ class G4Step;
 #include "G4PrimaryParticle.hh"
 #include "ActarSimGasGeantHit.hh"
 
+#include <vector>
+
 class TH1D;
 class TH2D;
-class TH3D;
+class TH3F;
 class TTree;
 //class TBranch;
 class TFile;
@@ -34,7 +36,7 @@ class TClonesArray;
 class TProfile; // for hbeamEnergyAtRange, to get the energy loss as a function of the path length
 
 class ActarSimData;
-class ActarSimTrack;
+class ActarSimEventTracks;
 class ActarSimSimpleTrack;
 
 class ActarSimROOTAnalGas {
@@ -42,7 +44,8 @@ private:
   char* dirName;
 
   ActarSimData* theData;    ///< Pointer to data
-  ActarSimTrack* theTracks; ///< Pointer to tracks
+  ActarSimEventTracks* eventTracks; ///< Steps in the gas of the event (tracks tree)
+  G4bool storeTracks;               ///< storeTracksFlag, evaluated once per event
 
   ActarSimSimpleTrack** simpleTrack; ///< Pointer to simple tracks
   TClonesArray*  simpleTrackCA;      ///< ClonesArray for simple tracks
@@ -67,7 +70,15 @@ private:
 
   TH2D *htrackFromBeam;     ///< Histogram: tracks from beam direction
 
-  TH3D *htrack;             ///< Histogram: 3D track
+  TH3F *htrack;             ///< Histogram: 3D track
+
+  G4bool storeTrackHistos;          ///< storeTrackHistosFlag, evaluated once per event
+  std::vector<G4double> histoXPost; ///< Buffer of step X (post-step point) for the track histograms
+  std::vector<G4double> histoYPost; ///< Buffer of step Y (post-step point)
+  std::vector<G4double> histoZPost; ///< Buffer of step Z (post-step point)
+  std::vector<G4double> histoZPre;  ///< Buffer of step Z (pre-step point)
+  std::vector<G4double> histoEdep;  ///< Buffer of step energy deposit
+  std::vector<G4int> histoPrimary;  ///< Buffer of step primary (1 or 2, 0 for others)
 
   G4double minStrideLength; ///< Control of minimum simpleTrack stride length
 
@@ -107,6 +118,8 @@ public:
   void SetPrimPhi(G4double pp){primPhi = pp;}
 
   void SetMinStrideLength(G4double val) {minStrideLength = val;};
+  void SetTrackPositionResolution(G4double val);
+  void SetTrackEnergyResolution(G4double val);
 
   TClonesArray* getSimpleTrackCA(void){return simpleTrackCA;}
   void SetSimpleTrackCA(TClonesArray* CA) {simpleTrackCA = CA;}
@@ -120,5 +133,7 @@ public:
   void EndOfEventAction(const G4Event*);
 
   void UserSteppingAction(const G4Step*);
+
+  void FlushTrackHistos();
 };
 #endif
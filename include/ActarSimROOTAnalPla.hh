@@ -11,6 +11,7 @@
 #define ActarSimROOTAnalPla_h 1
 
 #include "ActarSimROOTAnalysis.hh"
+#include "ActarSimHitMerger.hh"
 
 class ActarSimPlaHit;
 class ActarSimPlaGeantHit;
@@ -42,7 +43,7 @@ private:
 
   TBranch* plaHitsBranch;      ///< Local branch for plastics
 
-  ActarSimPlaHit** thePlaHit;  ///< Pointer to the hits in the plastic
+  ActarSimHitMerger hitMerger; ///< (trackID,detID) to hit in the ClonesArray
   TClonesArray* plaHitCA;      ///< ClonesArray of the hits in the plastic
 
   //G4PrimaryParticle* primary;//Storing the primary for accesing during UserStep NOT USED
@@ -11,6 +11,7 @@
 #define ActarSimROOTAnalSci_h 1
 
 #include "ActarSimROOTAnalysis.hh"
+#include "ActarSimHitMerger.hh"
 
 class ActarSimSciHit;
 class ActarSimSciGeantHit;
@@ -42,7 +43,8 @@ private:
 
   TBranch* sciHitsBranch;     ///< Local branch for scintillators
 
-  ActarSimSciHit** theSciHit; ///< Pointer to the hits in the scintillators
+  ActarSimHitMerger hitMerger;          ///< Crystal (detName,detID) to hit in the ClonesArray
+  ActarSimHitMerger energeticCrystals;  ///< Crystals with some energy in the event
   TClonesArray* sciHitCA;     ///< ClonesArray of the hits in the scintillators
 
   //G4PrimaryParticle* primary;//Storing the primary for accesing during UserStep NOT USED
@@ -11,6 +11,7 @@
 #define ActarSimROOTAnalSciRing_h 1
 
 #include "ActarSimROOTAnalysis.hh"
+#include "ActarSimHitMerger.hh"
 
 class ActarSimSciRingHit;
 class ActarSimSciRingGeantHit;
@@ -42,7 +43,8 @@ private:
 
   TBranch* sciRingHitsBranch;         ///< Local branch for the scintillator ring hits
 
-  ActarSimSciRingHit** theSciRingHit; ///< Pointer to the hits in the scintillator ring
+  ActarSimHitMerger hitMerger;         ///< Crystal (detName,detID) to hit in the ClonesArray
+  ActarSimHitMerger energeticCrystals; ///< Crystals with some energy in the event
   TClonesArray* sciRingHitCA;         ///< ClonesArray of the hits in the scintillator ring
 
   G4int theRunID;                     ///< Run ID
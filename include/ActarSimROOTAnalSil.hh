@@ -11,6 +11,7 @@
 #define ActarSimROOTAnalSil_h 1
 
 #include "ActarSimROOTAnalysis.hh"
+#include "ActarSimHitMerger.hh"
 
 #include "ActarSimSilHit.hh"
 #include "ActarSimSilGeantHit.hh"
@@ -37,7 +38,7 @@ class ActarSimROOTAnalSil{
 private:
   char* dirName;
 
-  ActarSimSilHit** theSilHit;          ///< Pointer to the hits in the silicons
+  ActarSimHitMerger hitMerger;         ///< (trackID,detID) to hit in the ClonesArray
   TClonesArray* silHitCA;              ///< ClonesArray of the hits in the silicons
 
   TFile* simFile;                      ///< Local pointer to simFile
@@ -11,6 +11,7 @@
 #define ActarSimROOTAnalSilRing_h 1
 
 #include "ActarSimROOTAnalysis.hh"
+#include "ActarSimHitMerger.hh"
 
 #include "ActarSimSilRingHit.hh"
 #include "ActarSimSilRingGeantHit.hh"
@@ -37,7 +38,7 @@ class ActarSimROOTAnalSilRing{
 private:
   char* dirName;
 
-  ActarSimSilRingHit** theSilRingHit;  ///< Pointer to the hits in the silicon ring
+  ActarSimHitMerger hitMerger;         ///< (trackID,detID) to hit in the ClonesArray
   TClonesArray* silRingHitCA;          ///< ClonesArray of the hits in the silicon ring
 
   TFile* simFile;                      ///< Local pointer to simFile
@@ -47,6 +47,7 @@ class ActarSimDetectorConstruction;
 class ActarSimPrimaryGeneratorAction;
 class ActarSimPrimaryInfo;
 class ActarSimBeamInfo;
+class ActarSimBeamLibrary;
 
 class ActarSimData;
 class ActarSimTrack;
@@ -72,6 +73,7 @@ private:
   ActarSimROOTAnalPla* plaAnal;         ///< Pointer to detector specific (plastic) analysis class
 
   ActarSimBeamInfo* pBeamInfo;          ///< Pointer to beam information object
+  ActarSimBeamLibrary* beamLibrary;     ///< Beam trajectory library (owned by the primary generator)
 
   ActarSimAnalysisMessenger* analMessenger;  ///< Pointer to the corresponding messenger
 
@@ -124,6 +126,8 @@ public:
   //void SetTheTracks(ActarSimTrack* tr){theTracks = tr;}
 
   ActarSimBeamInfo* GetBeamInfo(){return pBeamInfo;}
+  ActarSimBeamLibrary* GetBeamLibrary(){return beamLibrary;}
+  void SetBeamLibrary(ActarSimBeamLibrary* lib){beamLibrary = lib;}
 
   G4int GetTheEventID(){return theEventID;}
   void SetTheEventID(G4int id){theEventID = id;}
@@ -166,6 +170,8 @@ public:
 
   void InitAnalysisForExistingDetectors();
   void SetMinStrideLength(Double_t value);
+  void SetTrackPositionResolution(Double_t value);
+  void SetTrackEnergyResolution(Double_t value);
 
   void Construct(const G4VPhysicalVolume*);
 
@@ -181,6 +187,7 @@ public:
 
   void BeginOfRunAction(const G4Run*);
   void EndOfRunAction(const G4Run*);
+  void StoreRunInfo(const G4String& name, const G4String& value);
 
   void BeginOfEventAction(const G4Event*);
   void EndOfEventAction(const G4Event*);
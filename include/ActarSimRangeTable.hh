@@ -0,0 +1,62 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimRangeTable_h
+#define ActarSimRangeTable_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class G4ParticleDefinition;
+class G4Material;
+
+class ActarSimRangeTable {
+private:
+  const G4ParticleDefinition* particle;  ///< Particle of the table
+  const G4Material* material;            ///< Material of the table
+
+  std::vector<G4double> energy;          ///< Kinetic energy nodes (log spaced)
+  std::vector<G4double> dedx;            ///< Total stopping power
+  std::vector<G4double> range;           ///< CSDA range
+  std::vector<G4double> time;            ///< Slowing down time from the first node
+  std::vector<G4double> straggling;      ///< Integral of dE/dedx^3 from the first node
+
+  G4bool Fill(const G4ParticleDefinition* part, const G4Material* mat,
+	      const std::vector<G4double>& energyNodes, const std::vector<G4double>& dedxNodes);
+  G4int FindBin(const std::vector<G4double>& values, G4double value) const;
+  G4double Interpolate(const std::vector<G4double>& values, G4double e) const;
+
+public:
+  ActarSimRangeTable();
+  ~ActarSimRangeTable();
+
+  G4bool Build(const G4ParticleDefinition* part, const G4Material* mat,
+	       G4double eMin, G4double eMax, G4int nBins);
+  G4bool Read(const G4ParticleDefinition* part, const G4Material* mat,
+	      const G4String& fileName, const G4String& header);
+  G4bool Write(const G4String& fileName, const G4String& header) const;
+  void Clear();
+
+  G4bool IsBuilt(const G4ParticleDefinition* part, const G4Material* mat, G4double e) const {
+    return !energy.empty() && part==particle && mat==material && e<=energy.back();
+  }
+
+  G4double GetDEDX(G4double e) const;
+  G4double GetRange(G4double e) const;
+  G4double GetEnergy(G4double r) const;
+  G4double GetTime(G4double e) const;
+  G4double GetStragglingIntegral(G4double e) const;
+
+  const G4ParticleDefinition* GetParticle() const {return particle;}
+  const G4Material* GetMaterial() const {return material;}
+  const std::vector<G4double>& GetEnergyNodes() const {return energy;}
+  const std::vector<G4double>& GetDEDXNodes() const {return dedx;}
+  const std::vector<G4double>& GetRangeNodes() const {return range;}
+};
+#endif
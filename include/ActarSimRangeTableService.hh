@@ -0,0 +1,73 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimRangeTableService_h
+#define ActarSimRangeTableService_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <vector>
+#include <utility>
+
+class G4ParticleDefinition;
+class G4Material;
+class ActarSimRangeTable;
+
+class ActarSimRangeTableService {
+private:
+  typedef std::pair<const G4ParticleDefinition*,const G4Material*> TableKey;
+  std::map<TableKey,ActarSimRangeTable*> tables;  ///< Tables built, by particle and material
+
+  G4String physicsConfiguration;     ///< Physics of the tables (physics list modules)
+
+  G4bool cacheFlag;                  ///< Tables read from (and written to) the disk cache
+  G4String directory;                ///< Directory of the disk cache
+  G4bool exportFlag;                 ///< Tables of the run written as ROOT files
+  G4String exportDirectory;          ///< Directory of the ROOT files
+
+  G4double minEnergyPerNucleon;      ///< Lower kinetic energy of the tables
+  G4double maxEnergyPerNucleon;      ///< Upper kinetic energy of the tables (extended if needed)
+  G4int binsPerDecade;               ///< Log spaced nodes per decade of energy
+
+  std::vector<G4String> particleNames;             ///< Particles tabulated at the run start
+  std::vector<std::pair<G4int,G4int> > ionZA;      ///< Ions (Z, A) tabulated at the run start
+
+  G4String GetConfiguration(const G4ParticleDefinition* part, const G4Material* mat,
+			    G4double eMin, G4double eMax, G4int nBins) const;
+  G4bool BuildTable(ActarSimRangeTable* table, const G4ParticleDefinition* part,
+		    const G4Material* mat, G4double energy);
+  void Export(const ActarSimRangeTable* table) const;
+
+public:
+  ActarSimRangeTableService();
+  ~ActarSimRangeTableService();
+
+  void BeginOfRun(const G4String& physicsConfig, const G4Material* gas);
+  ActarSimRangeTable* GetTable(const G4ParticleDefinition* part, const G4Material* mat,
+			       G4double energy);
+  void Clear();
+
+  void AddParticle(const G4String& name){particleNames.push_back(name);}
+  void AddIon(G4int Z, G4int A){ionZA.push_back(std::make_pair(Z,A));}
+  void ClearParticles(){particleNames.clear(); ionZA.clear();}
+
+  void SetCacheFlag(G4bool val){cacheFlag = val;}
+  void SetDirectory(G4String val){directory = val;}
+  void SetExportFlag(G4bool val){exportFlag = val;}
+  void SetExportDirectory(G4String val){exportDirectory = val;}
+  void SetMinEnergyPerNucleon(G4double val){minEnergyPerNucleon = val; Clear();}
+  void SetMaxEnergyPerNucleon(G4double val){maxEnergyPerNucleon = val; Clear();}
+  void SetBinsPerDecade(G4int val){binsPerDecade = val; Clear();}
+
+  G4bool GetCacheFlag() const {return cacheFlag;}
+  G4String GetDirectory() const {return directory;}
+  G4bool GetExportFlag() const {return exportFlag;}
+  G4String GetExportDirectory() const {return exportDirectory;}
+};
+#endif
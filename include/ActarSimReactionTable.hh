@@ -0,0 +1,63 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimReactionTable_h
+#define ActarSimReactionTable_h 1
+
+#include "globals.hh"
+#include "ActarSimAliasTable.hh"
+
+#include <vector>
+
+class ActarSimReactionTable {
+private:
+  G4String fileName;         ///< File loaded (empty if none)
+  G4bool   weighted;         ///< Sampling weighted with the cross section column
+
+  G4int ion1Z;               ///< Scattered ion Z
+  G4int ion1A;               ///< Scattered ion A
+  G4int ion1Charge;          ///< Scattered ion charge state
+  G4int ion2Z;               ///< Recoil ion Z
+  G4int ion2A;               ///< Recoil ion A
+  G4int ion2Charge;          ///< Recoil ion charge state
+
+  std::vector<G4double> theta1;       ///< Scattered ion angle [deg]
+  std::vector<G4double> energy1;      ///< Scattered ion energy [MeV]
+  std::vector<G4double> theta2;       ///< Recoil ion angle [deg]
+  std::vector<G4double> energy2;      ///< Recoil ion energy [MeV]
+  std::vector<G4double> crossSection; ///< Optional fifth column (weight)
+
+  ActarSimAliasTable weightTable;     ///< Alias table for weighted sampling
+
+public:
+  ActarSimReactionTable();
+  ~ActarSimReactionTable();
+
+  G4bool Load(G4String name, G4bool useWeights);
+  void Clear();
+
+  G4bool IsLoaded(G4String name, G4bool useWeights) const {
+    return !theta1.empty() && name==fileName && useWeights==weighted;
+  }
+
+  G4int GetNumberOfRows() const {return (G4int)theta1.size();}
+  G4int SampleRow() const;
+
+  G4double GetTheta1(G4int row) const {return theta1[row];}
+  G4double GetEnergy1(G4int row) const {return energy1[row];}
+  G4double GetTheta2(G4int row) const {return theta2[row];}
+  G4double GetEnergy2(G4int row) const {return energy2[row];}
+
+  G4int GetIon1Z() const {return ion1Z;}
+  G4int GetIon1A() const {return ion1A;}
+  G4int GetIon1Charge() const {return ion1Charge;}
+  G4int GetIon2Z() const {return ion2Z;}
+  G4int GetIon2A() const {return ion2A;}
+  G4int GetIon2Charge() const {return ion2Charge;}
+};
+#endif
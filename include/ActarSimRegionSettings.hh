@@ -0,0 +1,57 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimRegionSettings_h
+#define ActarSimRegionSettings_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <ctime>
+
+class G4Region;
+class G4Step;
+class G4UserLimits;
+
+class ActarSimRegionSettings {
+private:
+  /// Cost of the tracking in a region during a run
+  struct RegionCost {
+    G4long steps;
+    G4long tracks;
+    std::clock_t time;
+  };
+
+  std::map<G4String,G4double> cuts;               ///< Production cuts, by region name
+  std::map<G4String,G4double> maxSteps;           ///< Maximum step lengths, by region name
+  std::map<G4String,G4UserLimits*> userLimits;    ///< User limits created, by region name
+
+  G4bool reportFlag;                              ///< Cost report at the end of the run
+  std::map<const G4Region*,RegionCost> costs;     ///< Cost of the run, by region
+  const G4Region* lastRegion;                     ///< Region of the previous step
+  RegionCost* lastCost;                           ///< Cost of the region of the previous step
+  std::clock_t lastClock;                         ///< CPU clock at the previous step
+
+public:
+  ActarSimRegionSettings();
+  ~ActarSimRegionSettings();
+
+  static G4String GetRegionName(const G4String& region);
+
+  void SetCut(const G4String& region, G4double cut);
+  void SetMaxStep(const G4String& region, G4double step);
+  void Apply();
+
+  void SetReportFlag(G4bool val){reportFlag = val;}
+  G4bool GetReportFlag() const {return reportFlag;}
+
+  void BeginOfRunAction();
+  void UserSteppingAction(const G4Step* aStep);
+  void EndOfRunAction();
+};
+#endif
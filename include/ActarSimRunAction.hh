@@ -14,10 +14,17 @@
 #include "globals.hh"
 
 class G4Run;
+class ActarSimPrimaryGeneratorAction;
+class ActarSimRegionSettings;
 
 class ActarSimRunAction : public G4UserRunAction {
+private:
+  ActarSimPrimaryGeneratorAction* primaryGenerator;  ///< Pointer to the primary generator
+  ActarSimRegionSettings* regionSettings;            ///< Cost report of the regions
+
 public:
-  ActarSimRunAction();
+  ActarSimRunAction(ActarSimPrimaryGeneratorAction* gen=0,
+                    ActarSimRegionSettings* regions=0);
   ~ActarSimRunAction();
 
   void BeginOfRunAction(const G4Run*);
@@ -0,0 +1,28 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimRunManager_h
+#define ActarSimRunManager_h 1
+
+#include "G4RunManager.hh"
+
+class ActarSimScanDriver;
+
+class ActarSimRunManager : public G4RunManager {
+private:
+  ActarSimScanDriver* scanDriver;  ///< Pointer to the scan driver
+
+public:
+  ActarSimRunManager();
+  ~ActarSimRunManager();
+
+  void RunInitialization();
+
+  ActarSimScanDriver* GetScanDriver(){return scanDriver;}
+};
+#endif
@@ -0,0 +1,53 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimSDFilter_h
+#define ActarSimSDFilter_h 1
+
+#include "G4VSDFilter.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Step;
+class G4Track;
+class ActarSimSDFilterMessenger;
+
+class ActarSimSDFilter : public G4VSDFilter {
+private:
+  G4bool   filterActive;            ///< Filter evaluation on/off (default off)
+  G4int    maxParentID;             ///< Maximum parentID accepted (-1 means no cut)
+  G4double minKineticEnergy;        ///< Minimum kinetic energy (at the pre-step point) accepted
+  std::vector<G4int> acceptedPDG;   ///< PDG codes accepted (empty means all)
+  std::vector<G4int> rejectedPDG;   ///< PDG codes always rejected
+
+  ActarSimSDFilterMessenger* filterMessenger;  ///< Pointer to the messenger
+
+public:
+  ActarSimSDFilter(G4String);
+  ~ActarSimSDFilter();
+
+  G4bool Accept(const G4Step*) const;
+  G4bool Accept(const G4Track*, G4double kineticEnergy) const;
+
+  void SetFilterActive(G4bool val){filterActive = val;}
+  void SetMaxParentID(G4int val){maxParentID = val;}
+  void SetMinKineticEnergy(G4double val){minKineticEnergy = val;}
+  void AddAcceptedParticle(G4String);
+  void AddRejectedParticle(G4String);
+  void ClearParticles();
+
+  G4bool   IsFilterActive(){return filterActive;}
+  G4int    GetMaxParentID(){return maxParentID;}
+  G4double GetMinKineticEnergy(){return minKineticEnergy;}
+
+  void PrintFilterParameters();
+
+  static G4int ParticleNameToPDG(G4String);
+};
+#endif
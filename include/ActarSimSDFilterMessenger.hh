@@ -0,0 +1,40 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimSDFilterMessenger_h
+#define ActarSimSDFilterMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class ActarSimSDFilter;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+class ActarSimSDFilterMessenger: public G4UImessenger {
+private:
+  ActarSimSDFilter*          filter;              ///< Pointer to the SD filter
+  G4UIdirectory*             filterDir;           ///< Directory in messenger structure
+  G4UIcmdWithAString*        activeCmd;           ///< Turns on/off the filter
+  G4UIcmdWithAnInteger*      maxParentIDCmd;      ///< Maximum parentID accepted
+  G4UIcmdWithADoubleAndUnit* minEnergyCmd;        ///< Minimum kinetic energy accepted
+  G4UIcmdWithAString*        acceptParticleCmd;   ///< Adds a particle to the accepted list
+  G4UIcmdWithAString*        rejectParticleCmd;   ///< Adds a particle to the rejected list
+  G4UIcmdWithoutParameter*   clearParticlesCmd;   ///< Clears both particle lists
+  G4UIcmdWithoutParameter*   printCmd;            ///< Prints the filter parameters
+
+public:
+  ActarSimSDFilterMessenger(ActarSimSDFilter*, G4String);
+  ~ActarSimSDFilterMessenger();
+
+  void SetNewValue(G4UIcommand*, G4String);
+};
+#endif
@@ -0,0 +1,47 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimScanDriver_h
+#define ActarSimScanDriver_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class ActarSimScanMessenger;
+
+class ActarSimScanDriver {
+private:
+  /// Parameter of the scan: command (with the placeholder % for the
+  /// value), values and commands to apply after the value changes
+  struct ScanAxis {
+    G4String command;
+    std::vector<G4String> values;
+    std::vector<G4String> updates;
+  };
+
+  std::vector<ScanAxis> axes;        ///< Parameters of the scan, the last one changes faster
+  ActarSimScanMessenger* messenger;  ///< Pointer to the messenger
+
+  G4String GetCommand(G4int axis, G4int index) const;
+
+public:
+  ActarSimScanDriver();
+  ~ActarSimScanDriver();
+
+  void AddAxis(const G4String& command);
+  void AddValues(const G4String& values);
+  void AddUpdate(const G4String& command);
+  void Clear();
+  G4bool Load(const G4String& name);
+
+  G4int GetNumberOfPoints() const;
+  void BeamOn(G4int numberOfEvents);
+  void Print() const;
+};
+#endif
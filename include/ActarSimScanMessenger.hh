@@ -0,0 +1,41 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimScanMessenger_h
+#define ActarSimScanMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class ActarSimScanDriver;
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+class ActarSimScanMessenger: public G4UImessenger {
+private:
+  ActarSimScanDriver* scanDriver;      ///< Pointer to the scan driver
+
+  G4UIdirectory*             scanDir;      ///< Directory
+  G4UIcmdWithAString*        addAxisCmd;   ///< Adds a parameter to the scan
+  G4UIcmdWithAString*        addValuesCmd; ///< Adds values to the last parameter
+  G4UIcmdWithAString*        addUpdateCmd; ///< Adds an update command to the last parameter
+  G4UIcmdWithAString*        fileCmd;      ///< Reads the scan from a file
+  G4UIcmdWithoutParameter*   clearCmd;     ///< Removes all the parameters
+  G4UIcmdWithoutParameter*   printCmd;     ///< Prints the scan
+  G4UIcmdWithAnInteger*      beamOnCmd;    ///< Runs the scan
+
+public:
+  ActarSimScanMessenger(ActarSimScanDriver*);
+  ~ActarSimScanMessenger();
+
+  void SetNewValue(G4UIcommand*, G4String);
+};
+#endif
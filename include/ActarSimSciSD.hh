@@ -14,11 +14,15 @@
 #include "ActarSimSciGeantHit.hh"
 
 class G4Step;
+class G4Track;
+class G4VTouchable;
 class G4HCofThisEvent;
+class ActarSimSDFilter;
 
 class ActarSimSciSD : public G4VSensitiveDetector {
 private:
   ActarSimSciGeantHitsCollection* hitsCollection; ///< Geant step-like hits collect.
+  ActarSimSDFilter* stepFilter;  ///< Step filter evaluated before creating any hit
 
 public:
   ActarSimSciSD(G4String);
@@ -26,6 +30,12 @@ public:
 
   void Initialize(G4HCofThisEvent*);
   G4bool ProcessHits(G4Step*,G4TouchableHistory*);
+  G4bool ProcessFastStep(const G4Track* track,
+			 const G4ThreeVector& prePos, const G4ThreeVector& postPos,
+			 const G4VTouchable* postTouchable, G4double postTime,
+			 G4double preEnergy, G4double postEnergy);
   void EndOfEvent(G4HCofThisEvent*);
+
+  ActarSimSDFilter* GetStepFilter(){return stepFilter;}
 };
 #endif
@@ -15,10 +15,12 @@
 
 class G4Step;
 class G4HCofThisEvent;
+class ActarSimSDFilter;
 
 class ActarSimSilRingSD : public G4VSensitiveDetector {
 private:
   ActarSimSilRingGeantHitsCollection* hitsCollection; ///< Geant step-like hits collect.
+  ActarSimSDFilter* stepFilter;  ///< Step filter evaluated before creating any hit
 
 public:
   ActarSimSilRingSD(G4String);
@@ -27,5 +29,7 @@ public:
   void Initialize(G4HCofThisEvent*);
   G4bool ProcessHits(G4Step*,G4TouchableHistory*);
   void EndOfEvent(G4HCofThisEvent*);
+
+  ActarSimSDFilter* GetStepFilter(){return stepFilter;}
 };
 #endif
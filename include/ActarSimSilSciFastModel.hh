@@ -0,0 +1,60 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimSilSciFastModel_h
+#define ActarSimSilSciFastModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <map>
+#include <utility>
+
+class G4Material;
+class G4Navigator;
+class G4ParticleDefinition;
+class ActarSimSilSD;
+class ActarSimSciSD;
+class ActarSimRangeTable;
+
+class ActarSimSilSciFastModel : public G4VFastSimulationModel {
+private:
+  ActarSimSilSD* silSD;                 ///< Silicon SD
+  ActarSimSciSD* sciSD;                 ///< Scintillator SD
+  G4bool activeFlag;                    ///< Model triggered (true) or full physics (false)
+  G4bool stragglingFlag;                ///< Energy and angular straggling included
+  G4double minimumLength;               ///< Shorter paths are left to the full physics
+  G4int nBins;                          ///< Number of energy bins of the range tables
+
+  G4Navigator* navigator;               ///< Navigator for the boundaries (not the tracking one)
+  typedef std::pair<const G4ParticleDefinition*,const G4Material*> TableKey;
+  std::map<TableKey,ActarSimRangeTable*> rangeTables; ///< One per particle and material
+
+  ActarSimRangeTable* GetRangeTable(const G4ParticleDefinition* particle,
+				    const G4Material* material, G4double energy);
+  G4double DistanceToBoundary(const G4ThreeVector& position, const G4ThreeVector& direction,
+			      G4double maxLength);
+
+public:
+  ActarSimSilSciFastModel(G4String name, ActarSimSilSD* sil, ActarSimSciSD* sci);
+  ~ActarSimSilSciFastModel();
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle);
+  G4bool ModelTrigger(const G4FastTrack& fastTrack);
+  void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+  void ClearTables();
+
+  void SetActiveFlag(G4bool val){activeFlag = val;}
+  void SetStragglingFlag(G4bool val){stragglingFlag = val;}
+  void SetNumberOfBins(G4int val){nBins = val; ClearTables();}
+
+  G4bool GetActiveFlag() const {return activeFlag;}
+};
+#endif
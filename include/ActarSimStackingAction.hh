@@ -0,0 +1,67 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimStackingAction_h
+#define ActarSimStackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Track;
+class G4Step;
+class G4Region;
+class G4LogicalVolume;
+class ActarSimStackingActionMessenger;
+
+class ActarSimStackingAction : public G4UserStackingAction {
+private:
+  G4bool   stackingActive;                ///< Secondary classification on/off (default off)
+  G4double gasElectronCut;                ///< Electrons below this energy born in ActiveGas are killed
+  G4bool   killNeutrals;                  ///< Kill neutrals outside the chamber (default off)
+
+  std::vector<G4int>    killPDG;          ///< Secondaries of these types are killed...
+  std::vector<G4double> killMaxEnergy;    ///< ... if below this energy (0 means any energy)
+  std::vector<G4int>    deferPDG;         ///< Secondaries of these types go to the waiting stack
+
+  std::vector<G4String> killVolumeNames;  ///< Logical volumes where the tracks are killed
+  std::vector<G4LogicalVolume*> killVolumes; ///< Resolved pointers of the kill volumes
+
+  G4Region*        activeGasRegion;       ///< Pointer to the ActiveGas region (resolved every event)
+  G4LogicalVolume* worldLog;              ///< Pointer to the world logical volume (resolved every event)
+
+  G4int nKilled;                          ///< Number of secondaries killed in the event
+  G4int nDeferred;                        ///< Number of secondaries deferred in the event
+
+  ActarSimStackingActionMessenger* stackingMessenger; ///< Pointer to the messenger
+
+  G4bool IsKillVolume(const G4LogicalVolume*) const;
+
+public:
+  ActarSimStackingAction();
+  ~ActarSimStackingAction();
+
+  G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*);
+  void NewStage();
+  void PrepareNewEvent();
+
+  void KillTrackOutOfInterest(const G4Step*);
+  G4bool IsStepKillActive(){return stackingActive && (killNeutrals || !killVolumeNames.empty());}
+
+  void SetStackingActive(G4bool val){stackingActive = val;}
+  void SetGasElectronCut(G4double val){gasElectronCut = val;}
+  void SetKillNeutrals(G4bool val){killNeutrals = val;}
+  void AddKillParticle(G4String, G4double);
+  void AddDeferParticle(G4String);
+  void AddKillVolume(G4String val){killVolumeNames.push_back(val);}
+  void ClearLists();
+
+  void PrintStackingParameters();
+};
+#endif
@@ -0,0 +1,41 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimStackingActionMessenger_h
+#define ActarSimStackingActionMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class ActarSimStackingAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+class ActarSimStackingActionMessenger: public G4UImessenger {
+private:
+  ActarSimStackingAction*    stackingAction;     ///< Pointer to the stacking action class
+  G4UIdirectory*             stackDir;           ///< Directory in messenger structure
+  G4UIcmdWithAString*        activeCmd;          ///< Turns on/off the classification of secondaries
+  G4UIcmdWithADoubleAndUnit* gasElectronCutCmd;  ///< Energy cut for electrons born in the gas
+  G4UIcmdWithAString*        killNeutralsCmd;    ///< Kill neutrals outside the chamber
+  G4UIcommand*               killParticleCmd;    ///< Kill secondaries of a type below an energy
+  G4UIcmdWithAString*        deferParticleCmd;   ///< Defer secondaries of a type to the waiting stack
+  G4UIcmdWithAString*        killVolumeCmd;      ///< Adds a kill volume
+  G4UIcmdWithoutParameter*   clearCmd;           ///< Clears particle and volume lists
+  G4UIcmdWithoutParameter*   printCmd;           ///< Prints the stacking parameters
+
+public:
+  ActarSimStackingActionMessenger(ActarSimStackingAction*);
+  ~ActarSimStackingActionMessenger();
+
+  void SetNewValue(G4UIcommand*, G4String);
+};
+#endif
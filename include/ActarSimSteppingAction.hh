@@ -15,13 +15,19 @@
 
 class ActarSimDetectorConstruction;
 class ActarSimEventAction;
+class ActarSimStackingAction;
+class ActarSimRegionSettings;
 
 class ActarSimSteppingAction : public G4UserSteppingAction {
 private:
   ActarSimDetectorConstruction* detector;    ///< NOT USED
   ActarSimEventAction*          eventaction; ///< NOT USED
+  ActarSimStackingAction*       stacking;    ///< Kills the tracks out of interest
+  ActarSimRegionSettings*       regions;     ///< Counts the cost of the regions
 public:
-  ActarSimSteppingAction(ActarSimDetectorConstruction*, ActarSimEventAction*);
+  ActarSimSteppingAction(ActarSimDetectorConstruction*, ActarSimEventAction*,
+                         ActarSimStackingAction* stack=0,
+                         ActarSimRegionSettings* regionSettings=0);
   ~ActarSimSteppingAction();
 
   void UserSteppingAction(const G4Step*);
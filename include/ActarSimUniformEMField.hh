@@ -15,16 +15,31 @@
 
 class G4ChordFinder;
 class G4MagIntegratorStepper;
-class G4EqMagElectricField;
+class G4EquationOfMotion;
+class G4UniformMagField;
 class G4FieldManager;
 
 class ActarSimUniformEMField: public G4ElectroMagneticField {
 private:
+  /// Kind of field, selecting the propagation
+  enum FieldType {zeroField, magneticField, electricField, electroMagneticField};
+
   G4double fieldComponents[6];      ///< The EM field: follows the G4ElectroMagneticField convention
 
+  FieldType fieldType;              ///< Kind of the present field
+  G4String stepperType;             ///< Stepper selected (auto chooses it from the field)
+  G4String stepperName;             ///< Stepper in use
+  G4double deltaChord;              ///< Miss distance of the chords
+  G4double minEpsilonStep;          ///< Minimum relative accuracy of the steps
+  G4double maxEpsilonStep;          ///< Maximum relative accuracy of the steps
+
+  G4UniformMagField* magField;      ///< Field propagated for a pure magnetic field
   G4ChordFinder* theChordFinder;    ///< Chord parameter
   G4MagIntegratorStepper* stepper;  ///< Integrator stepper
-  G4EqMagElectricField* equation;   ///< Equation
+  G4EquationOfMotion* equation;     ///< Equation
+
+  void UpdateFieldManager(G4bool rebuild=false);
+  void DeletePropagation();
 
 public:
   ActarSimUniformEMField();
@@ -33,15 +48,20 @@ public:
   ActarSimUniformEMField(const  ActarSimUniformEMField &p);
   ~ActarSimUniformEMField();
 
-  ActarSimUniformEMField operator = (const ActarSimUniformEMField &p);
+  ActarSimUniformEMField& operator = (const ActarSimUniformEMField &p);
 
   void SetFieldValue(const G4ThreeVector magFieldVector,
 		     const G4ThreeVector elecFieldVector);
 
-  //Set the field as pure electric or magnetic    NOT YET USED...
+  //Set the field as pure electric or magnetic
   void SetPureElectricFieldValue(G4ThreeVector fieldVector);
   void SetPureMagneticFieldValue(G4ThreeVector fieldVector);
 
+  void SetStepperType(const G4String& type);
+  void SetDeltaChord(G4double val);
+  void SetMinEpsilonStep(G4double val);
+  void SetMaxEpsilonStep(G4double val);
+
   ///This is a virtual function in G4ElectroMagneticField to be instanciated here
   ///Return as Bfield[0], [1], [2] the magnetic field x, y & z components
   /// and   as Bfield[3], [4], [5] the electric field x, y & z components
@@ -50,6 +70,12 @@ public:
   G4ThreeVector GetMagneticFieldValue();
   G4ThreeVector GetElectricFieldValue();
 
+  G4String GetStepperType() const {return stepperType;}
+  G4String GetStepperName() const {return stepperName;}
+  G4double GetDeltaChord() const {return deltaChord;}
+  G4double GetMinEpsilonStep() const {return minEpsilonStep;}
+  G4double GetMaxEpsilonStep() const {return maxEpsilonStep;}
+
   G4bool DoesFieldChangeEnergy() const {return true;}
   //does not work in other way???
 
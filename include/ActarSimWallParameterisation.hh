@@ -0,0 +1,45 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+
+#ifndef ActarSimWallParameterisation_h
+#define ActarSimWallParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "G4ThreeVector.hh"
+#include "G4RotationMatrix.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+class G4LogicalVolume;
+class G4VTouchable;
+
+class ActarSimWallParameterisation : public G4VPVParameterisation {
+private:
+  std::vector<G4RotationMatrix*> rotations;  ///< Rotation of each element (as in G4PVPlacement), owned
+  std::vector<G4ThreeVector> translations;   ///< Position of each element in the mother
+  std::vector<G4int> copyNumbers;            ///< Copy number of each element (detID)
+
+public:
+  ActarSimWallParameterisation();
+  ~ActarSimWallParameterisation();
+
+  void AddElement(const G4RotationMatrix* rot, const G4ThreeVector& pos, G4int copyNo);
+
+  G4VPhysicalVolume* Place(const G4String& name, G4LogicalVolume* elementLog,
+			   const G4String& envelopeName, G4LogicalVolume* motherLog);
+
+  void ComputeTransformation(const G4int index, G4VPhysicalVolume* physVol) const;
+
+  G4int GetNumberOfElements() const {return copyNumbers.size();}
+  G4int GetCopyNumber(G4int index) const {return copyNumbers[index];}
+
+  static G4int GetCopyNumber(const G4VTouchable* touchable);
+};
+#endif
@@ -0,0 +1,171 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimAcceptanceFilter
+/// Fast test of the reaction products before the tracking. Each
+/// primary particle is followed in straight line from its vertex
+/// through the geometry (with a navigator independent of the tracking
+/// one). The product is in the acceptance if it enters a volume whose
+/// sensitive detector is in the list (silSD and sciSD by default) or,
+/// if minGasLength is set, if it travels at least this length in the
+/// gas (gasSD). If energyLossFlag is set, the charged products stop
+/// when their range (see ActarSimRangeTable) in the materials crossed
+/// is exhausted. The event is accepted if minProducts products are in
+/// the acceptance. Scattering and the electromagnetic field are not
+/// considered: the test is intended to remove the events that clearly
+/// cannot be detected, not to replace the tracking.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimAcceptanceFilter.hh"
+#include "ActarSimRangeTable.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSensitiveDetector.hh"
+#include "G4Material.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimAcceptanceFilter::ActarSimAcceptanceFilter()
+  :navigator(0), minProducts(1), minGasLength(0.), energyLossFlag(true),
+   numberOfTried(0), numberOfAccepted(0) {
+  SetDetectorNames("silSD sciSD");
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimAcceptanceFilter::~ActarSimAcceptanceFilter(){
+  Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Deletes the navigator and the range tables. They are created
+/// again at the next event, as the geometry may have changed
+void ActarSimAcceptanceFilter::Clear(){
+  delete navigator;
+  navigator = 0;
+  for(size_t i=0;i<rangeTables.size();i++) delete rangeTables[i];
+  rangeTables.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the list of sensitive detector names (separated by spaces)
+void ActarSimAcceptanceFilter::SetDetectorNames(G4String val){
+  detectorNames.clear();
+  std::istringstream names(val);
+  G4String name;
+  while(names >> name) detectorNames.push_back(name);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds an event to the counters of the run
+void ActarSimAcceptanceFilter::Count(G4bool accepted){
+  numberOfTried++;
+  if(accepted) numberOfAccepted++;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Returns true if enough primary particles of the event are in the
+/// acceptance (see the class description)
+G4bool ActarSimAcceptanceFilter::Accept(const G4Event* anEvent){
+  if(!navigator) {
+    navigator = new G4Navigator();
+    navigator->SetWorldVolume(G4TransportationManager::GetTransportationManager()->
+			      GetNavigatorForTracking()->GetWorldVolume());
+  }
+
+  G4int nInAcceptance = 0;
+  for(G4int i=0;i<anEvent->GetNumberOfPrimaryVertex();i++){
+    G4PrimaryVertex* vertex = anEvent->GetPrimaryVertex(i);
+    for(G4int j=0;j<vertex->GetNumberOfParticle();j++){
+      if(IsInAcceptance(vertex->GetPrimary(j),vertex->GetPosition()))
+	nInAcceptance++;
+      if(nInAcceptance>=minProducts) return true;
+    }
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Follows a primary particle in straight line from the vertex
+G4bool ActarSimAcceptanceFilter::IsInAcceptance(const G4PrimaryParticle* particle,
+						 const G4ThreeVector& position){
+  const G4ParticleDefinition* definition = particle->GetG4code();
+  G4ThreeVector direction = particle->GetMomentumDirection();
+  G4ThreeVector point = position;
+  G4double kineticEnergy = particle->GetKineticEnergy();
+  G4bool slowingDown = energyLossFlag && definition && definition->GetPDGCharge()!=0.;
+  G4double gasLength = 0.;
+
+  G4VPhysicalVolume* volume = navigator->LocateGlobalPointAndSetup(point,&direction,false,false);
+  for(G4int crossed=0;volume && crossed<1000;crossed++){
+    G4VSensitiveDetector* detector = volume->GetLogicalVolume()->GetSensitiveDetector();
+    G4bool inGas = false;
+    if(detector) {
+      for(size_t i=0;i<detectorNames.size();i++)
+	if(detector->GetName()==detectorNames[i]) return true;
+      inGas = (detector->GetName()=="gasSD");
+    }
+
+    G4double safety = 0.;
+    G4double step = navigator->ComputeStep(point,direction,kInfinity,safety);
+    if(step>=kInfinity) return false;
+
+    G4bool stopped = false;
+    if(slowingDown) {
+      const G4Material* material = volume->GetLogicalVolume()->GetMaterial();
+      ActarSimRangeTable* table = GetRangeTable(definition,material,kineticEnergy);
+      if(table) {
+	G4double range = table->GetRange(kineticEnergy);
+	if(range<=step) {
+	  step = range;
+	  stopped = true;
+	}
+	else kineticEnergy = table->GetEnergy(range-step);
+      }
+    }
+
+    if(inGas) {
+      gasLength += step;
+      if(minGasLength>0. && gasLength>=minGasLength) return true;
+    }
+    if(stopped) return false;
+
+    point += step*direction;
+    navigator->SetGeometricallyLimitedStep();
+    volume = navigator->LocateGlobalPointAndSetup(point,&direction,true);
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Range table for the particle in the material, valid up to the
+/// energy e. Returns 0 if the table cannot be built
+ActarSimRangeTable* ActarSimAcceptanceFilter::GetRangeTable(const G4ParticleDefinition* part,
+							    const G4Material* mat,
+							    G4double e){
+  for(size_t i=0;i<rangeTables.size();i++)
+    if(rangeTables[i]->IsBuilt(part,mat,e)) return rangeTables[i];
+
+  ActarSimRangeTable* table = new ActarSimRangeTable();
+  if(!table->Build(part,mat,1.*keV,(e>1.*MeV) ? 2.*e : 2.*MeV,200)) {
+    delete table;
+    return 0;
+  }
+  rangeTables.push_back(table);
+  return table;
+}
@@ -0,0 +1,97 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimAliasTable
+/// Sampling of a discrete distribution in constant time (Walker alias
+/// method, Vose construction). The table is built once from the
+/// (non-normalized) weights; each Sample() uses a single random number.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimAliasTable.hh"
+
+#include "Randomize.hh"
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimAliasTable::ActarSimAliasTable(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimAliasTable::~ActarSimAliasTable(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties the table
+void ActarSimAliasTable::Clear(){
+  probability.clear();
+  alias.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Builds the table from the weights. Negative weights count as zero.
+/// Returns false (and leaves the table empty) if no weight is positive
+G4bool ActarSimAliasTable::Build(const std::vector<G4double>& weights){
+  Clear();
+  G4int size = (G4int)weights.size();
+  G4double sum = 0.;
+  for(G4int i=0;i<size;i++)
+    if(weights[i]>0.) sum += weights[i];
+  if(size==0 || sum<=0.) return false;
+
+  probability.resize(size);
+  alias.resize(size);
+
+  std::vector<G4int> small, large;
+  for(G4int i=0;i<size;i++){
+    probability[i] = (weights[i]>0. ? weights[i] : 0.) * size / sum;
+    alias[i] = i;
+    if(probability[i]<1.) small.push_back(i);
+    else large.push_back(i);
+  }
+  while(!small.empty() && !large.empty()){
+    G4int s = small.back(); small.pop_back();
+    G4int l = large.back();
+    alias[s] = l;
+    probability[l] -= 1. - probability[s];
+    if(probability[l]<1.){
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  //remaining bins (rounding) are kept with probability one
+  for(size_t i=0;i<small.size();i++) probability[small[i]] = 1.;
+  for(size_t i=0;i<large.size();i++) probability[large[i]] = 1.;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Returns a bin index distributed according to the weights
+G4int ActarSimAliasTable::Sample() const {
+  G4double fraction;
+  return Sample(fraction);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Returns a bin index distributed according to the weights, and a
+/// uniform fraction in [0,1) for interpolation inside the bin, both
+/// from the same random number
+G4int ActarSimAliasTable::Sample(G4double& fraction) const {
+  G4int size = (G4int)probability.size();
+  if(size==0) {fraction = 0.; return -1;}
+  G4double u = G4UniformRand()*size;
+  G4int bin = (G4int)u;
+  if(bin>=size) bin = size-1;
+  G4double rest = u - bin;
+  if(rest<probability[bin]){
+    fraction = rest/probability[bin];
+    return bin;
+  }
+  fraction = (rest-probability[bin])/(1.-probability[bin]);
+  return alias[bin];
+}
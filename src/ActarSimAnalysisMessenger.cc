@@ -29,6 +29,8 @@
 /// - /ActarSim/analControl/storeSimpleTracks
 /// - /ActarSim/analControl/storeHistograms
 /// - /ActarSim/analControl/setMinStrideLength
+/// - /ActarSim/analControl/setTrackPositionResolution
+/// - /ActarSim/analControl/setTrackEnergyResolution
 ActarSimAnalysisMessenger::ActarSimAnalysisMessenger(ActarSimROOTAnalysis* analEx)
   :analExample(analEx) {
   analDir = new G4UIdirectory("/ActarSim/analControl/");
@@ -83,6 +85,24 @@ ActarSimAnalysisMessenger::ActarSimAnalysisMessenger(ActarSimROOTAnalysis* analE
   setMinStrideLengthCmd->SetUnitCategory("Length");
   setMinStrideLengthCmd->SetDefaultValue(1.);
   setMinStrideLengthCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  trackPosResolutionCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/analControl/setTrackPositionResolution",this);
+  trackPosResolutionCmd->SetGuidance("Sets the position resolution of the steps stored in the tracks tree.");
+  trackPosResolutionCmd->SetGuidance("Positions are rounded to multiples of this value (default 10 um).");
+  trackPosResolutionCmd->SetParameterName("length",false);
+  trackPosResolutionCmd->SetRange("length>0.");
+  trackPosResolutionCmd->SetUnitCategory("Length");
+  trackPosResolutionCmd->SetDefaultUnit("mm");
+  trackPosResolutionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  trackEneResolutionCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/analControl/setTrackEnergyResolution",this);
+  trackEneResolutionCmd->SetGuidance("Sets the energy resolution of the steps stored in the tracks tree.");
+  trackEneResolutionCmd->SetGuidance("Energies are rounded to multiples of this value (default 1 eV).");
+  trackEneResolutionCmd->SetParameterName("energy",false);
+  trackEneResolutionCmd->SetRange("energy>0.");
+  trackEneResolutionCmd->SetUnitCategory("Energy");
+  trackEneResolutionCmd->SetDefaultUnit("eV");
+  trackEneResolutionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -91,6 +111,8 @@ ActarSimAnalysisMessenger::~ActarSimAnalysisMessenger() {
   delete storeTracksCmd;
   delete storeTrackHistosCmd;
   delete setMinStrideLengthCmd;
+  delete trackPosResolutionCmd;
+  delete trackEneResolutionCmd;
   delete storeEventsCmd;
   delete storeSimpleTracksCmd;
   delete storeHistosCmd;
@@ -119,4 +141,10 @@ void ActarSimAnalysisMessenger::SetNewValue(G4UIcommand* command,
 
   if(command == setMinStrideLengthCmd)
     analExample->SetMinStrideLength(setMinStrideLengthCmd->GetNewDoubleValue(newValue));
+
+  if(command == trackPosResolutionCmd)
+    analExample->SetTrackPositionResolution(trackPosResolutionCmd->GetNewDoubleValue(newValue));
+
+  if(command == trackEneResolutionCmd)
+    analExample->SetTrackEnergyResolution(trackEneResolutionCmd->GetNewDoubleValue(newValue));
 }
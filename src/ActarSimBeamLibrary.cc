@@ -0,0 +1,343 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimBeamLibrary
+/// Library of beam trajectories in the gas, tracked once with the full
+/// simulation and reused in many events. When recording, the steps of
+/// the beam ion are merged into strides (up to strideLength), keeping
+/// the kinetic energy and time at the end of each stride. The library
+/// is stored in a ROOT file (tree beamLibrary, one entry per trajectory)
+/// together with a setting string (ion, energy, gas and density) which
+/// must match to use it. When replaying, a trajectory is sampled and
+/// cut at the vertex plane; the state at the vertex is interpolated
+/// inside the last stride and written in the ActarSimBeamInfo, and the
+/// strides up to the vertex are available for the gas analysis.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimBeamLibrary.hh"
+#include "ActarSimBeamInfo.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TNamed.h"
+#include "TDirectory.h"
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimBeamLibrary::ActarSimBeamLibrary()
+  :strideLength(1.*mm), recording(false), particleID(0) {
+  Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimBeamLibrary::~ActarSimBeamLibrary(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Removes all the trajectories
+void ActarSimBeamLibrary::Clear(){
+  setting = "";
+  loadedFile = "";
+  firstStride.clear();
+  xStart.clear();
+  yStart.clear();
+  zStart.clear();
+  energyStart.clear();
+  timeStart.clear();
+  xStride.clear();
+  yStride.clear();
+  zStride.clear();
+  energyStride.clear();
+  timeStride.clear();
+  edepStride.clear();
+  openTrajectory = false;
+  openStride = false;
+  ClearReplay();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Setting of the trajectories to be recorded. The trajectories
+/// of a different setting are removed
+void ActarSimBeamLibrary::SetSetting(G4String val){
+  if(val==setting) return;
+  if(!firstStride.empty())
+    G4cout << " ActarSimBeamLibrary::SetSetting(): new beam setting, removing "
+	   << firstStride.size() << " trajectories of " << setting << G4endl;
+  Clear();
+  setting = val;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds a step of the beam ion to the trajectory being recorded. As
+/// in ActarSimGasSD, the energy deposited is the kinetic energy lost
+void ActarSimBeamLibrary::AddStep(const G4ThreeVector& prePos, const G4ThreeVector& postPos,
+				  G4double preEnergy, G4double postEnergy,
+				  G4double preTime, G4double postTime){
+  if(!openTrajectory){
+    firstStride.push_back((G4int)xStride.size());
+    xStart.push_back(prePos.x()/mm);
+    yStart.push_back(prePos.y()/mm);
+    zStart.push_back(prePos.z()/mm);
+    energyStart.push_back(preEnergy/MeV);
+    timeStart.push_back(preTime/ns);
+    openTrajectory = true;
+  }
+  if(!openStride){
+    strideStart = prePos;
+    strideEdep = 0.;
+    openStride = true;
+  }
+  strideEnd = postPos;
+  strideEnergy = postEnergy;
+  strideTime = postTime;
+  strideEdep += preEnergy-postEnergy;
+  if((strideEnd-strideStart).mag()>=strideLength) CloseStride();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Stores the stride being recorded
+void ActarSimBeamLibrary::CloseStride(){
+  if(!openStride) return;
+  xStride.push_back(strideEnd.x()/mm);
+  yStride.push_back(strideEnd.y()/mm);
+  zStride.push_back(strideEnd.z()/mm);
+  energyStride.push_back(strideEnergy/MeV);
+  timeStride.push_back(strideTime/ns);
+  edepStride.push_back(strideEdep/MeV);
+  openStride = false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Closes the trajectory being recorded (end of the event). A
+/// trajectory without strides is removed
+void ActarSimBeamLibrary::EndTrajectory(){
+  if(!openTrajectory) return;
+  CloseStride();
+  openTrajectory = false;
+  if(firstStride.back()==(G4int)xStride.size()){
+    firstStride.pop_back();
+    xStart.pop_back();
+    yStart.pop_back();
+    zStart.pop_back();
+    energyStart.pop_back();
+    timeStart.pop_back();
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Writes the library in a ROOT file. Returns false if not possible
+G4bool ActarSimBeamLibrary::Write(G4String name){
+  EndTrajectory();
+  if(firstStride.empty()) return false;
+
+  TDirectory* previousDirectory = gDirectory;
+  TFile* file = new TFile(name.c_str(),"RECREATE");
+  if(!file || file->IsZombie()){
+    G4cout << " ActarSimBeamLibrary::Write(): ERROR, cannot create " << name << G4endl;
+    delete file;
+    if(previousDirectory) previousDirectory->cd();
+    return false;
+  }
+
+  TTree* tree = new TTree("beamLibrary","Beam trajectories");
+  Float_t start[5];
+  std::vector<Float_t> x, y, z, energy, time, edep;
+  tree->Branch("start",start,"x/F:y/F:z/F:energy/F:time/F");
+  tree->Branch("x",&x);
+  tree->Branch("y",&y);
+  tree->Branch("z",&z);
+  tree->Branch("energy",&energy);
+  tree->Branch("time",&time);
+  tree->Branch("edep",&edep);
+
+  for(size_t t=0;t<firstStride.size();t++){
+    G4int first = firstStride[t];
+    G4int last = (t+1<firstStride.size()) ? firstStride[t+1] : (G4int)xStride.size();
+    start[0] = xStart[t];
+    start[1] = yStart[t];
+    start[2] = zStart[t];
+    start[3] = energyStart[t];
+    start[4] = timeStart[t];
+    x.assign(xStride.begin()+first,xStride.begin()+last);
+    y.assign(yStride.begin()+first,yStride.begin()+last);
+    z.assign(zStride.begin()+first,zStride.begin()+last);
+    energy.assign(energyStride.begin()+first,energyStride.begin()+last);
+    time.assign(timeStride.begin()+first,timeStride.begin()+last);
+    edep.assign(edepStride.begin()+first,edepStride.begin()+last);
+    tree->Fill();
+  }
+  TNamed settingName("setting",setting.c_str());
+  settingName.Write();
+  tree->Write();
+  file->Close();
+  delete file;
+  if(previousDirectory) previousDirectory->cd();
+
+  loadedFile = name;
+  G4cout << " ActarSimBeamLibrary::Write(): " << firstStride.size()
+	 << " trajectories written in " << name << G4endl;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Reads a library file. Returns false if the file cannot be read or
+/// if it was made for a different setting
+G4bool ActarSimBeamLibrary::Load(G4String name, G4String requiredSetting){
+  if(IsLoaded(name,requiredSetting)) return true;
+  if(name==failedFile) return false;
+
+  Clear();
+  TDirectory* previousDirectory = gDirectory;
+  TFile* file = TFile::Open(name.c_str(),"READ");
+  TTree* tree = 0;
+  TNamed* settingName = 0;
+  if(file && !file->IsZombie()){
+    tree = (TTree*) file->Get("beamLibrary");
+    settingName = (TNamed*) file->Get("setting");
+  }
+  if(!tree || !settingName || requiredSetting!=settingName->GetTitle()){
+    G4cout << " ActarSimBeamLibrary::Load(): ERROR, " << name
+	   << " is not a beam library for " << requiredSetting << G4endl;
+    if(settingName)
+      G4cout << " ActarSimBeamLibrary::Load(): the library setting is "
+	     << settingName->GetTitle() << G4endl;
+    delete file;
+    if(previousDirectory) previousDirectory->cd();
+    failedFile = name;
+    return false;
+  }
+
+  Float_t start[5];
+  std::vector<Float_t> *x = 0, *y = 0, *z = 0, *energy = 0, *time = 0, *edep = 0;
+  tree->SetBranchAddress("start",start);
+  tree->SetBranchAddress("x",&x);
+  tree->SetBranchAddress("y",&y);
+  tree->SetBranchAddress("z",&z);
+  tree->SetBranchAddress("energy",&energy);
+  tree->SetBranchAddress("time",&time);
+  tree->SetBranchAddress("edep",&edep);
+
+  Long64_t nEntries = tree->GetEntries();
+  for(Long64_t i=0;i<nEntries;i++){
+    tree->GetEntry(i);
+    if(x->empty()) continue;
+    firstStride.push_back((G4int)xStride.size());
+    xStart.push_back(start[0]);
+    yStart.push_back(start[1]);
+    zStart.push_back(start[2]);
+    energyStart.push_back(start[3]);
+    timeStart.push_back(start[4]);
+    xStride.insert(xStride.end(),x->begin(),x->end());
+    yStride.insert(yStride.end(),y->begin(),y->end());
+    zStride.insert(zStride.end(),z->begin(),z->end());
+    energyStride.insert(energyStride.end(),energy->begin(),energy->end());
+    timeStride.insert(timeStride.end(),time->begin(),time->end());
+    edepStride.insert(edepStride.end(),edep->begin(),edep->end());
+  }
+  delete file;
+  if(previousDirectory) previousDirectory->cd();
+
+  setting = requiredSetting;
+  loadedFile = name;
+  failedFile = "";
+  G4cout << " ActarSimBeamLibrary::Load(): " << firstStride.size()
+	 << " trajectories (" << xStride.size() << " strides) read from " << name << G4endl;
+  return !firstStride.empty();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Position, kinetic energy and time at the start of a stride
+void ActarSimBeamLibrary::GetStart(G4int trajectory, G4int stride, G4ThreeVector& pos,
+				   G4double& energy, G4double& time) const {
+  if(stride==firstStride[trajectory]){
+    pos.set(xStart[trajectory]*mm,yStart[trajectory]*mm,zStart[trajectory]*mm);
+    energy = energyStart[trajectory]*MeV;
+    time = timeStart[trajectory]*ns;
+  }
+  else {
+    pos.set(xStride[stride-1]*mm,yStride[stride-1]*mm,zStride[stride-1]*mm);
+    energy = energyStride[stride-1]*MeV;
+    time = timeStride[stride-1]*ns;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Samples a trajectory and cuts it at the plane z=zVertex. The
+/// entrance and vertex information of the beamInfo are filled (in
+/// the same units used when the beam is tracked). Returns false if
+/// the library is empty or the sampled beam stops before the vertex
+G4bool ActarSimBeamLibrary::Sample(G4double zVertex, ActarSimBeamInfo* beamInfo){
+  ClearReplay();
+  G4int nTrajectories = (G4int)firstStride.size();
+  if(nTrajectories==0 || !beamInfo) return false;
+
+  G4int t = (G4int)(G4UniformRand()*nTrajectories);
+  if(t>=nTrajectories) t = nTrajectories-1;
+  G4int first = firstStride[t];
+  G4int last = (t+1<nTrajectories) ? firstStride[t+1] : (G4int)xStride.size();
+
+  G4ThreeVector pre, post;
+  G4double preEnergy, preTime;
+  for(G4int i=first;i<last;i++){
+    if(zStride[i]*mm<=zVertex) continue;
+
+    GetStart(t,i,pre,preEnergy,preTime);
+    post.set(xStride[i]*mm,yStride[i]*mm,zStride[i]*mm);
+    G4double fraction = (zVertex>pre.z()) ? (zVertex-pre.z())/(post.z()-pre.z()) : 0.;
+    G4ThreeVector vertex = pre + fraction*(post-pre);
+    G4ThreeVector direction = (post-pre).unit();
+
+    replayTrajectory = t;
+    replayStrides = (fraction>0.) ? i-first+1 : i-first;
+    replayFraction = (fraction>0.) ? fraction : 1.;
+
+    G4ThreeVector start, firstEnd(xStride[first]*mm,yStride[first]*mm,zStride[first]*mm);
+    G4double startEnergy, startTime;
+    GetStart(t,first,start,startEnergy,startTime);
+    beamInfo->SetPositionEntrance(start.x()/mm,start.y()/mm,start.z()/mm);
+    beamInfo->SetAnglesEntrance((firstEnd-start).theta(),(firstEnd-start).phi());
+    beamInfo->SetEnergyEntrance(startEnergy/MeV);
+
+    beamInfo->SetXVertex(vertex.x()/mm);
+    beamInfo->SetYVertex(vertex.y()/mm);
+    beamInfo->SetZVertex(vertex.z()/mm);
+    beamInfo->SetEnergyVertex((preEnergy+fraction*(energyStride[i]*MeV-preEnergy))/MeV);
+    beamInfo->SetTimeVertex((preTime+fraction*(timeStride[i]*ns-preTime))/ns);
+    beamInfo->SetThetaVertex(direction.theta());
+    beamInfo->SetPhiVertex(direction.phi());
+    return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Stride i (from 0 to GetReplayNumberOfStrides()-1) of the trajectory
+/// sampled for the event, cut at the vertex. The energy is the kinetic
+/// energy at the end of the stride
+void ActarSimBeamLibrary::GetReplayStride(G4int i, G4ThreeVector& prePos, G4ThreeVector& postPos,
+					  G4double& preTime, G4double& postTime,
+					  G4double& energy, G4double& edep) const {
+  if(replayTrajectory<0 || i<0 || i>=replayStrides) return;
+  G4int stride = firstStride[replayTrajectory]+i;
+  G4double preEnergy;
+  GetStart(replayTrajectory,stride,prePos,preEnergy,preTime);
+  postPos.set(xStride[stride]*mm,yStride[stride]*mm,zStride[stride]*mm);
+  postTime = timeStride[stride]*ns;
+  energy = energyStride[stride]*MeV;
+  edep = edepStride[stride]*MeV;
+  if(i==replayStrides-1){
+    postPos = prePos + replayFraction*(postPos-prePos);
+    postTime = preTime + replayFraction*(postTime-preTime);
+    energy = preEnergy + replayFraction*(energy-preEnergy);
+    edep *= replayFraction;
+  }
+}
@@ -0,0 +1,125 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimBeamPhaseSpace
+/// Beam phase space read from a file (measured or from a beam transport
+/// code), loaded once and kept in memory. Each line contains one beam
+/// particle: x [mm], x' [mrad], y [mm], y' [mrad] and kinetic energy
+/// [MeV] and, optionally, a sixth column with a weight. Lines starting
+/// with # are skipped. Rows are sampled uniformly or, if all of them
+/// have a weight, with the alias method; both in constant time. After
+/// Load() the table is not modified, so the sampling (const) can be
+/// shared by several threads.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimBeamPhaseSpace.hh"
+
+#include "G4ios.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimBeamPhaseSpace::ActarSimBeamPhaseSpace(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimBeamPhaseSpace::~ActarSimBeamPhaseSpace(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties the table
+void ActarSimBeamPhaseSpace::Clear(){
+  fileName = "";
+  x.clear();
+  xp.clear();
+  y.clear();
+  yp.clear();
+  energy.clear();
+  weight.clear();
+  weightTable.Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Reads the file. Returns false if the file cannot be opened or
+/// contains no valid row. Incomplete rows are skipped
+G4bool ActarSimBeamPhaseSpace::Load(G4String name){
+  Clear();
+
+  std::ifstream inputFile(name.c_str());
+  if(!inputFile) {
+    G4cout << "ActarSimBeamPhaseSpace::Load() - ERROR: file "
+	   << name << " not found." << G4endl;
+    return false;
+  }
+
+  G4bool allWeights = true;
+  std::string line;
+  while(std::getline(inputFile,line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if(first==std::string::npos || line[first]=='#') continue;
+    std::istringstream is(line);
+    G4double x0, xp0, y0, yp0, e0, w0;
+    if(!(is >> x0 >> xp0 >> y0 >> yp0 >> e0) || e0<=0.) continue;
+    x.push_back(x0);
+    xp.push_back(xp0);
+    y.push_back(y0);
+    yp.push_back(yp0);
+    energy.push_back(e0);
+    if(is >> w0) weight.push_back(w0);
+    else {
+      weight.push_back(0.);
+      allWeights = false;
+    }
+  }
+
+  if(x.empty()) {
+    G4cout << "ActarSimBeamPhaseSpace::Load() - ERROR: no rows in file "
+	   << name << G4endl;
+    return false;
+  }
+
+  if(allWeights && !weightTable.Build(weight))
+    G4cout << "ActarSimBeamPhaseSpace::Load() - WARNING: no positive weight"
+	   << " in " << name << ". Rows sampled uniformly." << G4endl;
+  weight.clear();
+
+  fileName = name;
+  G4cout << "ActarSimBeamPhaseSpace::Load() - " << x.size()
+	 << " beam particles loaded from " << name
+	 << (weightTable.IsEmpty() ? " (uniform sampling)" : " (weighted sampling)")
+	 << G4endl;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Returns a random row, uniformly or weighted
+G4int ActarSimBeamPhaseSpace::SampleRow() const {
+  if(!weightTable.IsEmpty()) return weightTable.Sample();
+  G4int nbRows = (G4int)x.size();
+  G4int row = (G4int)(G4UniformRand()*nbRows);
+  return (row<nbRows) ? row : nbRows-1;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Samples a beam particle: position in the transverse plane (z=0,
+/// relative to the nominal beam position), direction from the angles
+/// x' and y' (with respect to the Z axis) and kinetic energy
+void ActarSimBeamPhaseSpace::Sample(G4ThreeVector& position, G4ThreeVector& direction,
+				    G4double& kineticEnergy) const {
+  G4int row = SampleRow();
+  position.set(x[row]*mm, y[row]*mm, 0.);
+  direction.set(std::tan(xp[row]*mrad), std::tan(yp[row]*mrad), 1.);
+  direction = direction.unit();
+  kineticEnergy = energy[row]*MeV;
+}
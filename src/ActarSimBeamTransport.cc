@@ -0,0 +1,143 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimBeamTransport
+/// Analytic transport of the beam ion from the entrance point to the
+/// reaction vertex, replacing the tracking of the beam in a separate
+/// event. The beam is assumed to cross only the gas material along a
+/// straight line. The energy at the vertex is obtained from the range
+/// table (ActarSimRangeTable, shared through the range table service
+/// of the physics list), the time from the slowing down time,
+/// and, if required, the energy straggling (Bohr, thick absorber) and
+/// the multiple scattering (Highland, correlated angle and lateral
+/// displacement in two planes) are added. The ion is assumed fully
+/// stripped for the straggling.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimBeamTransport.hh"
+#include "ActarSimRangeTable.hh"
+#include "ActarSimRangeTableService.hh"
+#include "ActarSimPhysicsList.hh"
+#include "ActarSimBeamInfo.hh"
+
+#include "G4RunManager.hh"
+
+#include "G4ParticleDefinition.hh"
+#include "G4Material.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimBeamTransport::ActarSimBeamTransport()
+  :rangeTable(0), ownRangeTable(0), stragglingFlag(true), nBins(500) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimBeamTransport::~ActarSimBeamTransport(){
+  delete ownRangeTable;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Forces the range table to be built again (new run, new physics)
+void ActarSimBeamTransport::Clear(){
+  rangeTable = 0;
+  if(ownRangeTable) ownRangeTable->Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Range table of the ion in the gas covering the energy, from the
+/// range table service of the physics list; built here if the
+/// ActarSim physics list is not used. Returns 0 if not possible
+ActarSimRangeTable* ActarSimBeamTransport::FindRangeTable(const G4ParticleDefinition* ion,
+							  const G4Material* gas,
+							  G4double energy){
+  ActarSimPhysicsList* physicsList = dynamic_cast<ActarSimPhysicsList*>
+    (const_cast<G4VUserPhysicsList*>(G4RunManager::GetRunManager()->GetUserPhysicsList()));
+  if(physicsList)
+    return physicsList->GetRangeTableService()->GetTable(ion,gas,energy);
+
+  if(!ownRangeTable) ownRangeTable = new ActarSimRangeTable();
+  if(!ownRangeTable->IsBuilt(ion,gas,energy))
+    if(!ownRangeTable->Build(ion,gas,1.e-4*energy,energy,nBins)) return 0;
+  return ownRangeTable;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Moves the beam from the entrance to the plane z=zVertex and fills
+/// the vertex information (position, energy, angles and time) of the
+/// beamInfo, in the same units used when the beam is tracked. Returns
+/// false if the beam does not reach the vertex
+G4bool ActarSimBeamTransport::Transport(const G4ParticleDefinition* ion, const G4Material* gas,
+					const G4ThreeVector& entrancePosition,
+					const G4ThreeVector& entranceDirection,
+					G4double entranceEnergy, G4double zVertex,
+					ActarSimBeamInfo* beamInfo){
+  if(!ion || !gas || !beamInfo || entranceEnergy<=0.) return false;
+
+  G4ThreeVector direction = entranceDirection.unit();
+  if(direction.z()<=0.) return false;
+  G4double length = (zVertex-entrancePosition.z())/direction.z();
+  if(length<0.) return false;
+
+  rangeTable = FindRangeTable(ion,gas,entranceEnergy);
+  if(!rangeTable) return false;
+
+  G4double entranceRange = rangeTable->GetRange(entranceEnergy);
+  if(length>=entranceRange) return false;
+  G4double vertexEnergy = rangeTable->GetEnergy(entranceRange-length);
+  G4double vertexTime = rangeTable->GetTime(entranceEnergy)-rangeTable->GetTime(vertexEnergy);
+
+  G4ThreeVector position = entrancePosition + length*direction;
+
+  if(stragglingFlag && length>0.){
+    G4double charge = ion->GetPDGCharge()/eplus;
+    G4double mass = ion->GetPDGMass();
+
+    //Bohr energy straggling, propagated through the stopping power
+    G4double sigmaE2 = 2.*twopi_mc2_rcl2*electron_mass_c2*gas->GetElectronDensity()*charge*charge
+      *(rangeTable->GetStragglingIntegral(entranceEnergy)-rangeTable->GetStragglingIntegral(vertexEnergy));
+    G4double dedx = rangeTable->GetDEDX(vertexEnergy);
+    vertexEnergy += dedx*std::sqrt(sigmaE2)*G4RandGauss::shoot();
+    if(vertexEnergy<=0.) return false;
+
+    //Highland multiple scattering, with the geometric mean of p*beta
+    G4double pIn2 = entranceEnergy*(entranceEnergy+2.*mass);
+    G4double pOut2 = vertexEnergy*(vertexEnergy+2.*mass);
+    G4double pBeta = std::sqrt(pIn2/(entranceEnergy+mass)*pOut2/(vertexEnergy+mass));
+    G4double beta2 = pOut2/((vertexEnergy+mass)*(vertexEnergy+mass));
+    G4double thickness = length/gas->GetRadlen();
+    G4double theta0 = 13.6*MeV/pBeta*std::fabs(charge)*std::sqrt(thickness)*
+      (1.+0.038*std::log(thickness*charge*charge/beta2));
+    if(theta0>0.){
+      G4ThreeVector u = direction.orthogonal().unit();
+      G4ThreeVector v = direction.cross(u);
+      G4double z1 = G4RandGauss::shoot();
+      G4double z2 = G4RandGauss::shoot();
+      G4double z3 = G4RandGauss::shoot();
+      G4double z4 = G4RandGauss::shoot();
+      G4double lateralU = length*theta0*(z1/std::sqrt(12.)+z2/2.);
+      G4double lateralV = length*theta0*(z3/std::sqrt(12.)+z4/2.);
+      position += lateralU*u + lateralV*v;
+      direction = (direction + z2*theta0*u + z4*theta0*v).unit();
+    }
+  }
+
+  beamInfo->SetXVertex(position.x()/mm);
+  beamInfo->SetYVertex(position.y()/mm);
+  beamInfo->SetZVertex(position.z()/mm);
+  beamInfo->SetEnergyVertex(vertexEnergy/MeV);
+  beamInfo->SetTimeVertex(vertexTime/ns);
+  beamInfo->SetThetaVertex(direction.theta());
+  beamInfo->SetPhiVertex(direction.phi());
+  return true;
+}
@@ -54,6 +54,8 @@ ActarSimCinePrimGenerator::ActarSimCinePrimGenerator() {
   ANGAV = new G4double[8];
   ANGAR = new G4double[8];
 
+  verbose = 1;
+
   for(G4int i = 0;i<8;i++){
     ANGAV[i] = 0.;
     ANGAR[i] = 0.;
@@ -65,8 +67,8 @@ ActarSimCinePrimGenerator::ActarSimCinePrimGenerator() {
 //////////////////////////////////////////////////////////////////
 /// Destructor
 ActarSimCinePrimGenerator::~ActarSimCinePrimGenerator() {
-  delete ANGAV;
-  delete ANGAR;
+  delete [] ANGAV;
+  delete [] ANGAR;
 }
 
 
@@ -139,7 +141,7 @@ void ActarSimCinePrimGenerator::RelativisticKinematics() {
   //are the goto lines for negative, zero and positive results of the argument
 
   if(PS2 < 0.) {
-    G4cout << " !! ERROR. NO SOLUTION IN CINE::RelativisticKinematics()   PS2 < 0. Returning " << G4endl;
+    if(verbose>0) G4cout << " !! ERROR. NO SOLUTION IN CINE::RelativisticKinematics()   PS2 < 0. Returning " << G4endl;
     ANGAV[1] = -1.;
     return;
   }
@@ -163,7 +165,7 @@ void ActarSimCinePrimGenerator::RelativisticKinematics() {
   //translation note
   //IF(DELTA) 30,8,8
   if(DELTA < 0.) {
-    G4cout << " !! ERROR. NO SOLUTION IN CINE::RelativisticKinematics()  DELTA < 0. Returning " << G4endl;
+    if(verbose>0) G4cout << " !! ERROR. NO SOLUTION IN CINE::RelativisticKinematics()  DELTA < 0. Returning " << G4endl;
     return;
   }
 
@@ -184,7 +186,7 @@ void ActarSimCinePrimGenerator::RelativisticKinematics() {
     G4double CSTE = 1E-8;
 
     if(W3-CSTE < 0.) {
-      G4cout << " !! ERROR. NO SOLUTION IN CINE::RelativisticKinematics()  W3-CSTE < 0. Returning " << G4endl;
+      if(verbose>0) G4cout << " !! ERROR. NO SOLUTION IN CINE::RelativisticKinematics()  W3-CSTE < 0. Returning " << G4endl;
       ANGAR[1] = -1.;
       return;
     }
@@ -0,0 +1,140 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimCrossSectionTable
+/// Angular distribution of a binary reaction, read from a file with
+/// two columns: the CM angle of the scattered particle (deg, increasing)
+/// and the differential cross section dSigma/dOmega (any units). Lines
+/// starting with # are skipped. The probability of each interval between
+/// points is the integral of dSigma/dOmega*sin(thetaCM) (trapezoidal),
+/// sampled with an alias table; inside the interval the density is
+/// linear. SampleThetaCM() costs a constant time and a random number.
+/// The same table is used for the bias densities of the importance
+/// sampling of the reaction angle, given per unit angle (not per unit
+/// solid angle): they are loaded with perSolidAngle false.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimCrossSectionTable.hh"
+
+#include "G4ios.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimCrossSectionTable::ActarSimCrossSectionTable()
+  :integral(0.), totalCrossSection(0.) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimCrossSectionTable::~ActarSimCrossSectionTable(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties the table
+void ActarSimCrossSectionTable::Clear(){
+  fileName = "";
+  thetaCM.clear();
+  density.clear();
+  integral = 0.;
+  totalCrossSection = 0.;
+  binTable.Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Reads the file and builds the alias table. Returns false if the
+/// file cannot be opened or does not define a valid distribution.
+/// Points with negative cross section count as zero. If perSolidAngle
+/// is false the second column is a density per unit angle
+G4bool ActarSimCrossSectionTable::Load(G4String name, G4bool perSolidAngle){
+  Clear();
+
+  std::ifstream inputFile(name.c_str());
+  if(!inputFile) {
+    G4cout << "ActarSimCrossSectionTable::Load() - ERROR: file "
+	   << name << " not found." << G4endl;
+    return false;
+  }
+
+  std::string line;
+  while(std::getline(inputFile,line)) {
+    if(line.empty() || line[0]=='#') continue;
+    std::istringstream is(line);
+    G4double angle, xs;
+    if(!(is >> angle >> xs)) continue;
+    if(!thetaCM.empty() && angle*deg<=thetaCM.back()) {
+      G4cout << "ActarSimCrossSectionTable::Load() - ERROR: angles not increasing in file "
+	     << name << " (" << angle << " deg)" << G4endl;
+      Clear();
+      return false;
+    }
+    thetaCM.push_back(angle*deg);
+    density.push_back((xs>0. ? xs : 0.) * (perSolidAngle ? std::sin(angle*deg) : 1.));
+  }
+
+  std::vector<G4double> weights;
+  for(size_t i=0;i+1<thetaCM.size();i++)
+    weights.push_back(0.5*(density[i]+density[i+1])*(thetaCM[i+1]-thetaCM[i]));
+
+  if(!binTable.Build(weights)) {
+    G4cout << "ActarSimCrossSectionTable::Load() - ERROR: no valid distribution in file "
+	   << name << G4endl;
+    Clear();
+    return false;
+  }
+
+  for(size_t i=0;i<weights.size();i++) integral += weights[i];
+  totalCrossSection = twopi*integral;
+
+  fileName = name;
+  G4cout << "ActarSimCrossSectionTable::Load() - " << thetaCM.size()
+	 << " points loaded from " << name << ", from "
+	 << thetaCM.front()/deg << " to " << thetaCM.back()/deg << " deg";
+  if(perSolidAngle)
+    G4cout << "; integrated cross section: " << totalCrossSection
+	   << " (file units times sr)";
+  G4cout << G4endl;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Returns a CM angle distributed according to dSigma/dOmega. The
+/// interval is selected with the alias table and the position inside
+/// it inverting the (linear) cumulative density, using the same
+/// random number. Returns zero if the table is empty
+G4double ActarSimCrossSectionTable::SampleThetaCM() const {
+  G4double fraction;
+  G4int bin = binTable.Sample(fraction);
+  if(bin<0) return 0.;
+
+  G4double a = density[bin];
+  G4double b = density[bin+1];
+  G4double x = fraction;
+  if(std::fabs(b-a) > 1e-12*(a+b))
+    x = (std::sqrt(a*a + fraction*(b*b-a*a)) - a)/(b-a);
+  return thetaCM[bin] + x*(thetaCM[bin+1]-thetaCM[bin]);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Probability density (per unit angle, normalized to one) of the
+/// angles returned by SampleThetaCM(). Zero outside the table
+G4double ActarSimCrossSectionTable::GetProbabilityDensity(G4double angle) const {
+  if(integral<=0. || angle<thetaCM.front() || angle>thetaCM.back()) return 0.;
+
+  size_t bin = std::upper_bound(thetaCM.begin(),thetaCM.end(),angle) - thetaCM.begin();
+  if(bin>=thetaCM.size()) bin = thetaCM.size()-1;
+  bin--;
+  G4double x = (angle-thetaCM[bin])/(thetaCM[bin+1]-thetaCM[bin]);
+  return (density[bin] + x*(density[bin+1]-density[bin]))/integral;
+}
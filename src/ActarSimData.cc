@@ -30,6 +30,7 @@ ActarSimData::ActarSimData() {
   energyOnGasPrim2 = 0;
   stepSumLengthOnGasPrim1 = 0;
   stepSumLengthOnGasPrim2 = 0;
+  weight = 1;
   eventID = 0;
   runID = 0;
 }
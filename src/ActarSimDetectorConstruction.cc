@@ -27,11 +27,15 @@
 #include "ActarSimSciSD.hh"
 #include "ActarSimSciRingSD.hh"
 #include "ActarSimPlaSD.hh"
+#include "ActarSimSilSciFastModel.hh"
+#include "ActarSimGeometryCache.hh"
+#include "ActarSimMaterialRegistry.hh"
 
 #include "ActarSimROOTAnalysis.hh"
 
 #include "G4RotationMatrix.hh"
 #include "G4Material.hh"
+#include "G4Element.hh"
 #include "G4Box.hh"
 #include "G4Tubs.hh"
 #include "G4LogicalVolume.hh"
@@ -40,12 +44,38 @@
 #include "G4Colour.hh"
 #include "G4RunManager.hh"
 #include "G4SDManager.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4FastSimulationManager.hh"
 #include "globals.hh"
 #include "G4AssemblyVolume.hh"
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <sstream>
+#include <set>
+
+namespace {
+  /// Description of a material for the geometry cache key: name,
+  /// density, state, temperature, pressure and composition (element
+  /// Z, A and mass fraction), so that materials of the same name
+  /// (e.g. GasMix) and different composition give different keys
+  void DescribeMaterial(std::ostream& config, const G4Material* material){
+    if(!material) {
+      config << " none";
+      return;
+    }
+    config << " " << material->GetName() << " " << material->GetDensity()/(g/cm3)
+	   << " " << material->GetState() << " " << material->GetTemperature()/kelvin
+	   << " " << material->GetPressure()/bar;
+    for(size_t j=0;j<material->GetNumberOfElements();j++)
+      config << " " << material->GetElement(j)->GetZ()
+	     << " " << material->GetElement(j)->GetN()
+	     << " " << material->GetFractionVector()[j];
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 /// Constructor: initialize all variables, materials and pointers
 ActarSimDetectorConstruction::ActarSimDetectorConstruction()
@@ -95,6 +125,15 @@ ActarSimDetectorConstruction::ActarSimDetectorConstruction()
   plaSD = new ActarSimPlaSD( plaSDname );
   SDman->AddNewDetector( plaSD );
 
+  //parameterized response of the silicons and scintillators (inactive by default)
+  silSciFastModel = new ActarSimSilSciFastModel("silSciFastModel",silSD,sciSD);
+
+  //GDML cache of the geometry (inactive by default)
+  geometryCache = new ActarSimGeometryCache();
+
+  //elements and gas materials, created once
+  materialRegistry = new ActarSimMaterialRegistry();
+
   //define default materials and set medium, default, chamber, window default materials
   DefineMaterials();
   SetMediumMaterial("Air");
@@ -127,6 +166,9 @@ ActarSimDetectorConstruction::~ActarSimDetectorConstruction() {
   if (sciDet     != NULL) delete sciDet;
   if (sciRingDet != NULL) delete sciRingDet;
   if (plaDet     != NULL) delete plaDet;
+  delete silSciFastModel;
+  delete geometryCache;
+  delete materialRegistry;
   /*
     if (gasSD      != NULL) delete gasSD;
     if (silSD      != NULL) delete silSD;
@@ -153,6 +195,9 @@ ActarSimDetectorConstruction::~ActarSimDetectorConstruction() {
 ///
 ///  Only one geometry option can be specified.
 ///  In case of multiple geometry definiotn an error message is displayed and a NULL pointer returned.
+///
+///  If the geometry cache is active, the world is loaded from the GDML file
+///  of the current configuration, or constructed and saved in it.
 G4VPhysicalVolume* ActarSimDetectorConstruction::Construct() {
   G4int geo = 0;
   G4int i_geo = 1;
@@ -182,7 +227,53 @@ G4VPhysicalVolume* ActarSimDetectorConstruction::Construct() {
     exit (-1);
   }
 
-  //Build the DETECTOR according to the specified layout
+  //Load the DETECTOR from the geometry cache, or build and save it
+  G4String cacheKey;
+  G4VPhysicalVolume* world = 0;
+  if(geometryCache->GetActiveFlag()){
+    cacheKey = ActarSimGeometryCache::GetKey(GetGeometryConfiguration(geo));
+    world = LoadCachedGeometry(cacheKey,geo);
+  }
+
+  if(!world){
+    world = ConstructLayout(geo);
+    //the chamber (with the volumes in it not in other regions) is a region
+    if(world && chamberLog)
+      G4RegionStore::GetInstance()->FindOrCreateRegion("Chamber")->AddRootLogicalVolume(chamberLog);
+    if(world && geometryCache->GetActiveFlag())
+      geometryCache->Save(world,cacheKey);
+  }
+
+  FindGasFilledVolumes();
+  return world;
+}
+
+////////////////////////////////////////////////////////////////
+/// Records the logical volumes of the world built with the gas
+/// material (chamber, gas volume, envelopes of the walls, ...), whose
+/// material is replaced when the gas conditions change (see
+/// ActarSimGasDetectorConstruction::UpdateGasMaterial())
+void ActarSimDetectorConstruction::FindGasFilledVolumes() {
+  gasFilledVolumes.clear();
+  G4Material* gasMaterial = gasDet->GetGasMaterial();
+  if(!worldLog || !gasMaterial) return;
+
+  std::vector<G4LogicalVolume*> pending(1,worldLog);
+  std::set<G4LogicalVolume*> visited;
+  while(!pending.empty()){
+    G4LogicalVolume* volume = pending.back();
+    pending.pop_back();
+    if(!visited.insert(volume).second) continue;
+    if(volume->GetMaterial()==gasMaterial) gasFilledVolumes.push_back(volume);
+    for(G4int i=0;i<(G4int)volume->GetNoDaughters();i++)
+      pending.push_back(volume->GetDaughter(i)->GetLogicalVolume());
+  }
+}
+
+////////////////////////////////////////////////////////////////
+/// Builds the DETECTOR according to the specified layout (geo, see Construct())
+G4VPhysicalVolume* ActarSimDetectorConstruction::ConstructLayout(G4int geo) {
+  chamberLog = 0;
   switch (geo){
 
   case 0: G4cout << "Building empty geometry" <<G4endl;
@@ -928,6 +1019,10 @@ void ActarSimDetectorConstruction::PrintDetectorParameters() {
 	 << emField->GetElectricFieldValue().x() << " "
 	 << emField->GetElectricFieldValue().y() << " "
 	 << emField->GetElectricFieldValue().z() << G4endl
+	 << " Stepper: " << emField->GetStepperName()
+	 << ", delta chord: " << emField->GetDeltaChord()/mm << " mm"
+	 << ", epsilon step: " << emField->GetMinEpsilonStep()
+	 << " - " << emField->GetMaxEpsilonStep() << G4endl
 	 << "##################################################################" << G4endl;
   if (gasGeoIncludedFlag=="on") gasDet->PrintDetectorParameters();
   if (silGeoIncludedFlag=="on") silDet->PrintDetectorParameters();
@@ -984,6 +1079,145 @@ void ActarSimDetectorConstruction::UpdateGeometry() {
   G4RunManager::GetRunManager()->DefineWorldVolume(this->Construct());
 }
 
+////////////////////////////////////////////////////////////////
+/// Adds a silicon or scintillator logical volume to its region
+/// (SiliconWalls or ScintillatorWalls), where the parameterized
+/// response (ActarSimSilSciFastModel) can replace the tracking. The
+/// region and its fast simulation manager are kept when the geometry
+/// is rebuilt
+void ActarSimDetectorConstruction::AddToSilSciWalls(G4LogicalVolume* wallLog,
+						    const G4String& regionName) {
+  G4Region* walls = G4RegionStore::GetInstance()->FindOrCreateRegion(regionName);
+  walls->AddRootLogicalVolume(wallLog);
+  if(!walls->GetFastSimulationManager()) {
+    G4FastSimulationManager* fastSimManager = new G4FastSimulationManager(walls);
+    fastSimManager->AddFastSimulationModel(silSciFastModel);
+  }
+}
+
+////////////////////////////////////////////////////////////////
+/// Description of the parameters defining the geometry of the layout
+/// geo (see Construct()), used as key of the geometry cache. Only the
+/// ancillaries included in the layout are described. The version
+/// tag must be changed when the construction code changes the geometry
+G4String ActarSimDetectorConstruction::GetGeometryConfiguration(G4int geo) {
+  std::ostringstream config;
+  config.precision(12);
+  config << "ActarSimGeometry v5; layout " << geo
+	 << "; world " << worldSizeX/mm << " " << worldSizeY/mm << " " << worldSizeZ/mm
+	 << "; chamber " << chamberSizeX/mm << " " << chamberSizeY/mm << " " << chamberSizeZ/mm
+	 << "; medium";
+  DescribeMaterial(config,mediumMaterial);
+  config << "; chamberMat";
+  DescribeMaterial(config,chamberMaterial);
+  config << "; windowMat";
+  DescribeMaterial(config,windowMaterial);
+  config << "; gas " << gasGeoIncludedFlag << "; sil " << silGeoIncludedFlag
+	 << "; sci " << sciGeoIncludedFlag;
+
+  if(gasGeoIncludedFlag=="on"){
+    config << "; gasDet " << gasDet->GetDetectorGeometry() << " "
+	   << gasDet->GetGasBoxSizeX()/mm << " " << gasDet->GetGasBoxSizeY()/mm << " "
+	   << gasDet->GetGasBoxSizeZ()/mm << " " << gasDet->GetGasBoxCenterX()/mm << " "
+	   << gasDet->GetGasBoxCenterY()/mm << " " << gasDet->GetGasBoxCenterZ()/mm << " "
+	   << gasDet->GetRadiusGasTub()/mm << " " << gasDet->GetLengthGasTub()/mm;
+    DescribeMaterial(config,gasDet->GetGasMaterial());
+    config << "; beamShield " << gasDet->GetBeamShieldGeometry() << " "
+	   << gasDet->GetInnerRadiusBeamShieldTub()/mm << " "
+	   << gasDet->GetOuterRadiusBeamShieldTub()/mm << " "
+	   << gasDet->GetLengthBeamShieldTub()/mm;
+    DescribeMaterial(config,gasDet->GetBeamShieldMaterial());
+  }
+  if(silGeoIncludedFlag=="on"){
+    config << "; silDet " << silDet->GetSideCoverage() << " "
+	   << silDet->GetXBoxSilHalfLength()/mm << " " << silDet->GetYBoxSilHalfLength()/mm << " "
+	   << silDet->GetZBoxSilHalfLength()/mm;
+    DescribeMaterial(config,silDet->GetSilBulkMaterial());
+  }
+  if(sciGeoIncludedFlag=="on"){
+    config << "; sciDet " << sciDet->GetSideCoverage() << " "
+	   << sciDet->GetXBoxSciHalfLength()/mm << " " << sciDet->GetYBoxSciHalfLength()/mm << " "
+	   << sciDet->GetZBoxSciHalfLength()/mm;
+    DescribeMaterial(config,sciDet->GetSciBulkMaterial());
+  }
+  if(geo==4)
+    config << "; silRingDet " << silRingDet->GetSideCoverage() << " "
+	   << silRingDet->GetXBoxSilHalfLength()/mm << " " << silRingDet->GetYBoxSilHalfLength()/mm << " "
+	   << silRingDet->GetZBoxSilHalfLength()/mm
+	   << "; sciRingDet " << sciRingDet->GetSideCoverage() << " "
+	   << sciRingDet->GetXBoxSciHalfLength()/mm << " " << sciRingDet->GetYBoxSciHalfLength()/mm << " "
+	   << sciRingDet->GetZBoxSciHalfLength()/mm
+	   << "; plaDet " << plaDet->GetSideCoverage() << " "
+	   << plaDet->GetXBoxPlaHalfLength()/mm << " " << plaDet->GetYBoxPlaHalfLength()/mm << " "
+	   << plaDet->GetZBoxPlaHalfLength()/mm;
+
+  return config.str();
+}
+
+////////////////////////////////////////////////////////////////
+/// Loads the world of the key from the geometry cache (0 if it is not
+/// there) and sets what the construction of the layout geo would set:
+/// world and chamber pointers and sizes, regions (with their fast
+/// simulation models) and the connection to the analysis
+G4VPhysicalVolume* ActarSimDetectorConstruction::LoadCachedGeometry(const G4String& key,
+								    G4int geo) {
+  std::multimap<G4String,G4LogicalVolume*> regionRoots;
+  G4VPhysicalVolume* cachedWorld = geometryCache->Load(key,regionRoots);
+  if(!cachedWorld) return 0;
+
+  worldPhys = cachedWorld;
+  worldLog = worldPhys->GetLogicalVolume();
+  solidWorld = dynamic_cast<G4Box*>(worldLog->GetSolid());
+  if(solidWorld){
+    worldSizeX = solidWorld->GetXHalfLength();
+    worldSizeY = solidWorld->GetYHalfLength();
+    worldSizeZ = solidWorld->GetZHalfLength();
+  }
+
+  chamberPhys = 0;
+  chamberLog = 0;
+  for(G4int i=0;i<worldLog->GetNoDaughters();i++)
+    if(worldLog->GetDaughter(i)->GetName()=="Chamber") chamberPhys = worldLog->GetDaughter(i);
+  if(chamberPhys){
+    chamberLog = chamberPhys->GetLogicalVolume();
+    G4Box* solidChamber = dynamic_cast<G4Box*>(chamberLog->GetSolid());
+    if(solidChamber){
+      chamberSizeX = solidChamber->GetXHalfLength();
+      chamberSizeY = solidChamber->GetYHalfLength();
+      chamberSizeZ = solidChamber->GetZHalfLength();
+    }
+    chamberCenterX = chamberPhys->GetTranslation().x();
+    chamberCenterY = chamberPhys->GetTranslation().y();
+    chamberCenterZ = chamberPhys->GetTranslation().z();
+  }
+
+  std::multimap<G4String,G4LogicalVolume*>::iterator root;
+  for(root=regionRoots.begin();root!=regionRoots.end();++root){
+    if(root->first=="ActiveGas") gasDet->AddToActiveGas(root->second);
+    else if(root->first=="SiliconWalls" || root->first=="ScintillatorWalls")
+      AddToSilSciWalls(root->second,root->first);
+    else G4RegionStore::GetInstance()->FindOrCreateRegion(root->first)->AddRootLogicalVolume(root->second);
+  }
+
+  //the empty world and SpecMAT are not connected to the analysis
+  if(geo!=0 && geo!=3) ConnectAnalysis();
+
+  return worldPhys;
+}
+
+////////////////////////////////////////////////////////////////
+/// Histogramming and connection to the analysis only for those
+/// detectors included (as at the end of the layout constructions)
+void ActarSimDetectorConstruction::ConnectAnalysis() {
+  if (gActarSimROOTAnalysis) {
+    gActarSimROOTAnalysis->Construct(worldPhys);
+    if (gasGeoIncludedFlag=="on") gActarSimROOTAnalysis->SetGasAnalOn();
+    if (silGeoIncludedFlag=="on") gActarSimROOTAnalysis->SetSilAnalOn();
+    if (sciGeoIncludedFlag=="on") gActarSimROOTAnalysis->SetSciAnalOn();
+    gActarSimROOTAnalysis->InitAnalysisForExistingDetectors();
+  }
+}
+
 ////////////////////////////////////////////////////////////////
 /// Setting the uniform EM field
 void ActarSimDetectorConstruction::UpdateEMField() {
@@ -1002,30 +1236,30 @@ void ActarSimDetectorConstruction::DefineMaterials() {
   G4double a;  // atomic mass
   G4double z;  // atomic number
 
-  G4Element* H  = new G4Element("Hydrogen" ,"H" , z= 1., a=   1.00794*g/mole);
-  //G4Element* D  = new G4Element("Deuterium","D" , z= 1., a=    2.0140*g/mole);
-  G4Element* He = new G4Element("Helium"   ,"He", z= 2., a=    4.0026*g/mole);
-  G4Element* C  = new G4Element("Carbon"   ,"C",  z=6.,  a=   12.0107*g/mole);
-  G4Element* N  = new G4Element("Nitrogen" ,"N" , z= 7., a=  14.00674*g/mole);
-  G4Element* O  = new G4Element("Oxygen"   ,"O" , z= 8., a=   15.9994*g/mole);
-  G4Element* F  = new G4Element("Fluorine" ,"F",  z=9.,  a=18.9984032*g/mole);
-  G4Element* Na = new G4Element("Sodium"   ,"Na", z=11., a=  22.98977*g/mole);
-  G4Element* S  = new G4Element("Sulphur"  ,"S",  z=16., a=    32.066*g/mole);
-  G4Element* Ar = new G4Element("Argon"    ,"Ar", z=18., a=   39.9481*g/mole);
-  G4Element* Zn = new G4Element("Zinc",     "Zn", z=30., a=     65.39*g/mole);
-  G4Element* Ge = new G4Element("Germanium","Ge", z=32., a=     72.61*g/mole);
-  G4Element* Br = new G4Element("Bromine"  ,"Br", z=35., a=    79.904*g/mole);
-  G4Element* Cd = new G4Element("Cadmium"  ,"Cd", z=48., a=   112.411*g/mole);
-  G4Element* Te = new G4Element("Tellurium","Te", z=52., a=    127.60*g/mole);
-  G4Element* I  = new G4Element("Iodine"   ,"I",  z=53., a= 126.90447*g/mole);
-  G4Element* Cs = new G4Element("Cesium"   ,"Cs", z=55., a= 132.90545*g/mole);
-  G4Element* Ba = new G4Element("Barium"   ,"Ba", z=56., a=   137.327*g/mole);
-  G4Element* La = new G4Element("Lanthanum","La", z=57., a=  138.9055*g/mole);
-  G4Element* Ce = new G4Element("Cerium"   ,"Ce", z=58., a=   140.116*g/mole);
-  G4Element* Lu = new G4Element("Lutecium" ,"Lu", z=71., a=   174.967*g/mole);
-  G4Element* W  = new G4Element("Tungsten" ,"W" , z=74., a=    183.84*g/mole);
-  G4Element* Pb = new G4Element("Lead"     ,"Pb", z=82., a=    207.20*g/mole);
-  G4Element* Bi = new G4Element("Bismuth"  ,"Bi", z=83., a= 208.98038*g/mole);
+  //elements from the registry, shared with the gases
+  G4Element* H  = materialRegistry->GetElement("H");
+  G4Element* He = materialRegistry->GetElement("He");
+  G4Element* C  = materialRegistry->GetElement("C");
+  G4Element* N  = materialRegistry->GetElement("N");
+  G4Element* O  = materialRegistry->GetElement("O");
+  G4Element* F  = materialRegistry->GetElement("F");
+  G4Element* Na = materialRegistry->GetElement("Na");
+  G4Element* S  = materialRegistry->GetElement("S");
+  G4Element* Ar = materialRegistry->GetElement("Ar");
+  G4Element* Zn = materialRegistry->GetElement("Zn");
+  G4Element* Ge = materialRegistry->GetElement("Ge");
+  G4Element* Br = materialRegistry->GetElement("Br");
+  G4Element* Cd = materialRegistry->GetElement("Cd");
+  G4Element* Te = materialRegistry->GetElement("Te");
+  G4Element* I  = materialRegistry->GetElement("I");
+  G4Element* Cs = materialRegistry->GetElement("Cs");
+  G4Element* Ba = materialRegistry->GetElement("Ba");
+  G4Element* La = materialRegistry->GetElement("La");
+  G4Element* Ce = materialRegistry->GetElement("Ce");
+  G4Element* Lu = materialRegistry->GetElement("Lu");
+  G4Element* W  = materialRegistry->GetElement("W");
+  G4Element* Pb = materialRegistry->GetElement("Pb");
+  G4Element* Bi = materialRegistry->GetElement("Bi");
 
   //
   // define materials
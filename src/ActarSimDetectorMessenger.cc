@@ -13,6 +13,9 @@
 
 #include "ActarSimDetectorMessenger.hh"
 #include "ActarSimDetectorConstruction.hh"
+#include "ActarSimSilSciFastModel.hh"
+#include "ActarSimGeometryCache.hh"
+#include "ActarSimUniformEMField.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
@@ -46,8 +49,19 @@
 /// - /ActarSim/det/setChamberMat
 /// - /ActarSim/det/setEleField
 /// - /ActarSim/det/setMagField
+/// - /ActarSim/det/field/
+/// - /ActarSim/det/field/stepper
+/// - /ActarSim/det/field/deltaChord
+/// - /ActarSim/det/field/minEpsilonStep
+/// - /ActarSim/det/field/maxEpsilonStep
 /// - /ActarSim/det/update
 /// - /ActarSim/det/print
+/// - /ActarSim/det/silSciFastSim/
+/// - /ActarSim/det/silSciFastSim/active
+/// - /ActarSim/det/silSciFastSim/straggling
+/// - /ActarSim/det/geometryCache/
+/// - /ActarSim/det/geometryCache/active
+/// - /ActarSim/det/geometryCache/directory
 ActarSimDetectorMessenger::
 ActarSimDetectorMessenger(ActarSimDetectorConstruction* ActarSimDet)
   :ActarSimDetector(ActarSimDet) {
@@ -211,6 +225,38 @@ ActarSimDetectorMessenger(ActarSimDetectorConstruction* ActarSimDet)
   magFieldCmd->SetUnitCategory("Magnetic flux density");
   magFieldCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
+  fieldDir = new G4UIdirectory("/ActarSim/det/field/");
+  fieldDir->SetGuidance("propagation in the uniform EM field");
+
+  fieldStepperCmd = new G4UIcmdWithAString("/ActarSim/det/field/stepper",this);
+  fieldStepperCmd->SetGuidance("Select the stepper of the propagation in the field.");
+  fieldStepperCmd->SetGuidance("auto: ExactHelix for a pure magnetic field, ClassicalRK4 otherwise.");
+  fieldStepperCmd->SetGuidance("The helix steppers are only used for a pure magnetic field.");
+  fieldStepperCmd->SetGuidance("A zero field is never propagated.");
+  fieldStepperCmd->SetParameterName("stepper",true);
+  fieldStepperCmd->SetDefaultValue("auto");
+  fieldStepperCmd->SetCandidates("auto ClassicalRK4 SimpleRunge CashKarpRKF45 ExactHelix HelixExplicitEuler HelixSimpleRunge");
+  fieldStepperCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fieldDeltaChordCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/det/field/deltaChord",this);
+  fieldDeltaChordCmd->SetGuidance("Select the miss distance of the chords (default 0.01 mm).");
+  fieldDeltaChordCmd->SetParameterName("deltaChord",false);
+  fieldDeltaChordCmd->SetRange("deltaChord>0.");
+  fieldDeltaChordCmd->SetUnitCategory("Length");
+  fieldDeltaChordCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fieldMinEpsilonCmd = new G4UIcmdWithADouble("/ActarSim/det/field/minEpsilonStep",this);
+  fieldMinEpsilonCmd->SetGuidance("Select the minimum relative accuracy of the steps (default 5e-5).");
+  fieldMinEpsilonCmd->SetParameterName("epsilon",false);
+  fieldMinEpsilonCmd->SetRange("epsilon>0.");
+  fieldMinEpsilonCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fieldMaxEpsilonCmd = new G4UIcmdWithADouble("/ActarSim/det/field/maxEpsilonStep",this);
+  fieldMaxEpsilonCmd->SetGuidance("Select the maximum relative accuracy of the steps (default 1e-3).");
+  fieldMaxEpsilonCmd->SetParameterName("epsilon",false);
+  fieldMaxEpsilonCmd->SetRange("epsilon>0.");
+  fieldMaxEpsilonCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
   updateCmd = new G4UIcmdWithoutParameter("/ActarSim/det/update",this);
   updateCmd->SetGuidance("Update geometry.");
   updateCmd->SetGuidance("This command MUST be applied before \"beamOn\" ");
@@ -220,6 +266,45 @@ ActarSimDetectorMessenger(ActarSimDetectorConstruction* ActarSimDet)
   printCmd = new G4UIcmdWithoutParameter("/ActarSim/det/print",this);
   printCmd->SetGuidance("Prints geometry.");
   printCmd->AvailableForStates(G4State_Idle);
+
+  silSciFastSimDir = new G4UIdirectory("/ActarSim/det/silSciFastSim/");
+  silSciFastSimDir->SetGuidance("parameterized response of the silicons and scintillators");
+
+  silSciFastSimActiveCmd = new G4UIcmdWithAString("/ActarSim/det/silSciFastSim/active",this);
+  silSciFastSimActiveCmd->SetGuidance("Moves the charged hadrons and ions through each silicon or scintillator");
+  silSciFastSimActiveCmd->SetGuidance("in a single step from the tabulated range, instead of the full physics.");
+  silSciFastSimActiveCmd->SetGuidance("The process is registered with /ActarSim/phys/addPhysics fastSim");
+  silSciFastSimActiveCmd->SetGuidance("  Choice : on, off(default)");
+  silSciFastSimActiveCmd->SetParameterName("choice",true);
+  silSciFastSimActiveCmd->SetDefaultValue("off");
+  silSciFastSimActiveCmd->SetCandidates("on off");
+  silSciFastSimActiveCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  silSciFastSimStragglingCmd = new G4UIcmdWithAString("/ActarSim/det/silSciFastSim/straggling",this);
+  silSciFastSimStragglingCmd->SetGuidance("Energy and angular straggling in the parameterized response.");
+  silSciFastSimStragglingCmd->SetGuidance("  Choice : on(default), off");
+  silSciFastSimStragglingCmd->SetParameterName("choice",true);
+  silSciFastSimStragglingCmd->SetDefaultValue("on");
+  silSciFastSimStragglingCmd->SetCandidates("on off");
+  silSciFastSimStragglingCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  geometryCacheDir = new G4UIdirectory("/ActarSim/det/geometryCache/");
+  geometryCacheDir->SetGuidance("GDML cache of the constructed geometry");
+
+  geometryCacheActiveCmd = new G4UIcmdWithAString("/ActarSim/det/geometryCache/active",this);
+  geometryCacheActiveCmd->SetGuidance("Loads the geometry from the GDML file of the current configuration,");
+  geometryCacheActiveCmd->SetGuidance("or constructs it and saves it there (needs Geant4 with GDML).");
+  geometryCacheActiveCmd->SetGuidance("  Choice : on, off(default)");
+  geometryCacheActiveCmd->SetParameterName("choice",true);
+  geometryCacheActiveCmd->SetDefaultValue("off");
+  geometryCacheActiveCmd->SetCandidates("on off");
+  geometryCacheActiveCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  geometryCacheDirectoryCmd = new G4UIcmdWithAString("/ActarSim/det/geometryCache/directory",this);
+  geometryCacheDirectoryCmd->SetGuidance("Select the directory of the GDML cache (default geometryCache).");
+  geometryCacheDirectoryCmd->SetParameterName("directory",false);
+  geometryCacheDirectoryCmd->SetDefaultValue("geometryCache");
+  geometryCacheDirectoryCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -248,8 +333,19 @@ ActarSimDetectorMessenger::~ActarSimDetectorMessenger() {
   delete chamberMaterialCmd;
   delete eleFieldCmd;
   delete magFieldCmd;
+  delete fieldStepperCmd;
+  delete fieldDeltaChordCmd;
+  delete fieldMinEpsilonCmd;
+  delete fieldMaxEpsilonCmd;
+  delete fieldDir;
   delete updateCmd;
   delete printCmd;
+  delete silSciFastSimActiveCmd;
+  delete silSciFastSimStragglingCmd;
+  delete silSciFastSimDir;
+  delete geometryCacheActiveCmd;
+  delete geometryCacheDirectoryCmd;
+  delete geometryCacheDir;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -317,6 +413,18 @@ void ActarSimDetectorMessenger::SetNewValue(G4UIcommand* command,
   if( command == magFieldCmd )
     ActarSimDetector->SetMagField(magFieldCmd->GetNew3VectorValue(newValue));
 
+  if( command == fieldStepperCmd )
+    ActarSimDetector->GetEMField()->SetStepperType(newValue);
+
+  if( command == fieldDeltaChordCmd )
+    ActarSimDetector->GetEMField()->SetDeltaChord(fieldDeltaChordCmd->GetNewDoubleValue(newValue));
+
+  if( command == fieldMinEpsilonCmd )
+    ActarSimDetector->GetEMField()->SetMinEpsilonStep(fieldMinEpsilonCmd->GetNewDoubleValue(newValue));
+
+  if( command == fieldMaxEpsilonCmd )
+    ActarSimDetector->GetEMField()->SetMaxEpsilonStep(fieldMaxEpsilonCmd->GetNewDoubleValue(newValue));
+
   if( command == updateCmd ) {
     ActarSimDetector->UpdateGeometry();
     ActarSimDetector->UpdateEMField();
@@ -325,4 +433,16 @@ void ActarSimDetectorMessenger::SetNewValue(G4UIcommand* command,
 
   if( command == printCmd )
     ActarSimDetector->PrintDetectorParameters();
+
+  if( command == silSciFastSimActiveCmd )
+    ActarSimDetector->GetSilSciFastModel()->SetActiveFlag(newValue=="on");
+
+  if( command == silSciFastSimStragglingCmd )
+    ActarSimDetector->GetSilSciFastModel()->SetStragglingFlag(newValue=="on");
+
+  if( command == geometryCacheActiveCmd )
+    ActarSimDetector->GetGeometryCache()->SetActiveFlag(newValue=="on");
+
+  if( command == geometryCacheDirectoryCmd )
+    ActarSimDetector->GetGeometryCache()->SetDirectory(newValue);
 }
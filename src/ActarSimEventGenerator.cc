@@ -8,110 +8,314 @@
  ******************************************************************/
 //////////////////////////////////////////////////////////////////
 /// \class ActarSimEventGenerator
-/// Event generator kinematics reader
+/// Reader of the events of an external event generator. Each event is
+/// a list of particles (PDG code and momentum in the lab, MeV/c) and a
+/// weight; the vertex position and time are given by the caller. The
+/// events are streamed from the file, never loaded completely:
+/// - ASCII files: a background thread parses up to prefetchSize events
+///   ahead of the tracking. Format (lines starting with # are skipped):
+///     number_of_particles [weight]
+///     pdg px py pz         (one line per particle)
+/// - ROOT files (name ending in .root): tree "evgen" with branches n
+///   (Int_t), pdg[n] (Int_t), px[n], py[n], pz[n] (Double_t) and,
+///   optionally, weight (Double_t). The entries are read in blocks of
+///   prefetchSize events, with a TTreeCache.
+/// Ions use the PDG code 100ZZZAAAI (ground state, fully stripped).
 /////////////////////////////////////////////////////////////////
 
 #include "ActarSimEventGenerator.hh"
 
-using namespace std;
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleTable.hh"
+#include "G4IonTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TDirectory.h"
+
+#include <sstream>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimEventGenerator::ActarSimEventGenerator()
+  :rootFormat(false), prefetchSize(1000), numberOfEventsRead(0), endOfFile(false),
+   lineNumber(0), stopRequested(false), rootFile(0), rootTree(0), nextEntry(0),
+   treeN(0), treeWeight(1.) {
+}
 
 //////////////////////////////////////////////////////////////////
-/// Constructor, all job here
-ActarSimEventGenerator::ActarSimEventGenerator(){
-
-  // G4double a,b,c,d,e,f;
-  // G4double Integral = 0.;
-  int i;
-  // int nbins;
-  // const G4int MAX = 140;
-  // char buffer[MAX];
-
-  //Initial values
-  for(i=0;i<1000;i++) {
-    LabAngle_scatt[i]  = 0.;
-    LabEnergy_scatt[i] = 0.;
-    LabAngle_recoil[i]  = 0.;
-    LabEnergy_recoil[i] = 0.;
+/// Destructor. Stops the prefetch thread
+ActarSimEventGenerator::~ActarSimEventGenerator() {
+  Close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Opens a file (see the class description for the formats). Returns
+/// false if the file cannot be opened
+G4bool ActarSimEventGenerator::Open(G4String name){
+  Close();
+  fileName = name;
+  rootFormat = (name.size()>5 && name.substr(name.size()-5)==".root");
+
+  G4bool opened = rootFormat ? OpenTree() : OpenAscii();
+  if(!opened) {
+    G4cout << "ActarSimEventGenerator::Open() - ERROR: file " << name
+	   << " not found or not valid." << G4endl;
+    Close();
+    return false;
   }
+  G4cout << "ActarSimEventGenerator::Open() - reading events from " << name << G4endl;
+  return true;
+}
 
-  for(i=0;i<5000;i++) {
-    theta_xsec[i] = 0.;
-    CrossSection_t[i] = 0.;
-    Icross_section[i] = 0.;
+//////////////////////////////////////////////////////////////////
+/// Stops the prefetch thread and closes the file
+void ActarSimEventGenerator::Close(){
+  {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    stopRequested = true;
   }
+  bufferNotFull.notify_all();
+  if(prefetchThread.joinable()) prefetchThread.join();
 
-  //Read Kinematics File
-  /*
-    ifstream infile("data/kine/kinematics_77nidp.dat");
+  if(asciiFile.is_open()) asciiFile.close();
+  asciiFile.clear();
+  if(rootFile) {
+    rootFile->Close();
+    delete rootFile;
+  }
+  rootFile = 0;
+  rootTree = 0;
 
-    for(i=0;i<24;i++)
-      {
-	infile.getline(buffer, MAX);
-	//readout header
-	//	  G4cout << "i=" << i << G4endl;
-      }
+  buffer.clear();
+  fileName = "";
+  errorMessage = "";
+  endOfFile = false;
+  stopRequested = false;
+  numberOfEventsRead = 0;
+  lineNumber = 0;
+  nextEntry = 0;
+}
 
-    i = -1;
-    while( !infile.eof() )
-      {
-	i++;
-	infile >> LabAngle_scatt[i] >> a>> LabEnergy_scatt[i] >> b >> c >> d >>
-	  LabAngle_recoil[i] >> LabEnergy_recoil[i] >> e >> f ;
+//////////////////////////////////////////////////////////////////
+/// Opens the ASCII file and starts the prefetch thread
+G4bool ActarSimEventGenerator::OpenAscii(){
+  asciiFile.open(fileName.c_str());
+  if(!asciiFile) return false;
+  prefetchThread = std::thread(&ActarSimEventGenerator::PrefetchLoop,this);
+  return true;
+}
 
-	//	G4cout<<"Lab_Angle="<<LabAngle_scatt[i]<<"  Lab_Energy="<<LabEnergy_scatt[i]<<G4endl;
+//////////////////////////////////////////////////////////////////
+/// Opens the ROOT file and connects the branches of the tree. The
+/// current ROOT directory (the output file) is restored
+G4bool ActarSimEventGenerator::OpenTree(){
+  TDirectory* previous = gDirectory;
+  rootFile = TFile::Open(fileName.c_str());
+  if(previous) previous->cd();
+  if(!rootFile || rootFile->IsZombie()) return false;
 
+  rootTree = (TTree*) rootFile->Get("evgen");
+  if(!rootTree || !rootTree->GetBranch("n") || !rootTree->GetBranch("pdg") ||
+     !rootTree->GetBranch("px") || !rootTree->GetBranch("py") || !rootTree->GetBranch("pz"))
+    return false;
+  if(rootTree->GetMaximum("n") > maxParticles) {
+    G4cout << "ActarSimEventGenerator::OpenTree() - ERROR: more than " << maxParticles
+	   << " particles in an event." << G4endl;
+    return false;
+  }
 
-      }
+  rootTree->SetBranchAddress("n",&treeN);
+  rootTree->SetBranchAddress("pdg",treePdg);
+  rootTree->SetBranchAddress("px",treePx);
+  rootTree->SetBranchAddress("py",treePy);
+  rootTree->SetBranchAddress("pz",treePz);
+  treeWeight = 1.;
+  if(rootTree->GetBranch("weight")) rootTree->SetBranchAddress("weight",&treeWeight);
 
-  */
+  rootTree->SetCacheSize(32*1024*1024);
+  rootTree->AddBranchToCache("*",kTRUE);
+  return true;
+}
 
-  //Read cross section file
+//////////////////////////////////////////////////////////////////
+/// Body of the prefetch thread: parses events while the buffer is
+/// not full, until the end of the file or the stop request
+void ActarSimEventGenerator::PrefetchLoop(){
+  while(true) {
+    ActarSimEvGenEvent event;
+    G4bool parsed = ParseEvent(event);
 
-  /*
+    std::unique_lock<std::mutex> lock(bufferMutex);
+    if(!parsed) {
+      endOfFile = true;
+      bufferNotEmpty.notify_all();
+      return;
+    }
+    while(!stopRequested && buffer.size()>=prefetchSize) bufferNotFull.wait(lock);
+    if(stopRequested) return;
+    buffer.push_back(event);
+    bufferNotEmpty.notify_one();
+  }
+}
 
- ifstream infile_xsec("data/kine/xs_77ni_dp_0MeV_p.dat");
+//////////////////////////////////////////////////////////////////
+/// Next line of the ASCII file that is not empty or a comment
+G4bool ActarSimEventGenerator::ReadLine(std::string& line){
+  while(std::getline(asciiFile,line)) {
+    lineNumber++;
+    size_t first = line.find_first_not_of(" \t\r");
+    if(first==std::string::npos || line[first]=='#') continue;
+    return true;
+  }
+  return false;
+}
 
- i = -1;
- while( !infile_xsec.eof() )
-   {
-     i++;
-     infile_xsec >> theta_xsec[i] >> CrossSection_t[i];	//readout of data
-     //G4cout << "i="<<i << " " << T_xsec[i] << " " << CrossSection_t[i] <<  G4endl;
-     nbins = i;
-   }
+//////////////////////////////////////////////////////////////////
+/// Parses the next event of the ASCII file. Returns false at the end
+/// of the file or if the event is not valid (errorMessage is set)
+G4bool ActarSimEventGenerator::ParseEvent(ActarSimEvGenEvent& event){
+  std::string line;
+  if(!ReadLine(line)) return false;
 
+  std::ostringstream error;
+  std::istringstream header(line);
+  G4int nParticles = 0;
+  if(!(header >> nParticles) || nParticles<0) {
+    error << "invalid number of particles in line " << lineNumber;
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    errorMessage = error.str();
+    return false;
+  }
+  if(!(header >> event.weight)) event.weight = 1.;
 
- //Integral of cross section
+  for(G4int i=0;i<nParticles;i++) {
+    G4int pdg;
+    G4double px, py, pz;
+    if(!ReadLine(line)) {
+      error << "file ends in the middle of an event, line " << lineNumber;
+      std::lock_guard<std::mutex> lock(bufferMutex);
+      errorMessage = error.str();
+      return false;
+    }
+    std::istringstream is(line);
+    if(!(is >> pdg >> px >> py >> pz)) {
+      error << "invalid particle in line " << lineNumber;
+      std::lock_guard<std::mutex> lock(bufferMutex);
+      errorMessage = error.str();
+      return false;
+    }
+    event.pdg.push_back(pdg);
+    event.px.push_back(px);
+    event.py.push_back(py);
+    event.pz.push_back(pz);
+  }
+  return true;
+}
 
- for(i=0;i<nbins;i++)
-   {
-     Integral += CrossSection_t[i];
-     //G4cout << " Integral " << Integral << G4endl;
-   }
+//////////////////////////////////////////////////////////////////
+/// Reads the next block of prefetchSize entries of the ROOT tree
+void ActarSimEventGenerator::ReadTreeBlock(){
+  G4long entries = (G4long) rootTree->GetEntries();
+  for(size_t i=0;i<prefetchSize && nextEntry<entries;i++) {
+    rootTree->GetEntry(nextEntry++);
+    ActarSimEvGenEvent event;
+    event.weight = treeWeight;
+    for(G4int j=0;j<treeN && j<maxParticles;j++) {
+      event.pdg.push_back(treePdg[j]);
+      event.px.push_back(treePx[j]);
+      event.py.push_back(treePy[j]);
+      event.pz.push_back(treePz[j]);
+    }
+    buffer.push_back(event);
+  }
+  if(nextEntry>=entries) endOfFile = true;
+}
 
- //Building the probability distribution (Integral of the xs between 0 and a given theta)
+//////////////////////////////////////////////////////////////////
+/// Takes the next event from the buffer, waiting for the prefetch
+/// thread if needed. Returns false when there are no more events
+G4bool ActarSimEventGenerator::TakeEvent(ActarSimEvGenEvent& event){
+  if(rootFormat) {
+    if(buffer.empty() && !endOfFile) ReadTreeBlock();
+    if(buffer.empty()) return false;
+    event.weight = buffer.front().weight;
+    event.pdg.swap(buffer.front().pdg);
+    event.px.swap(buffer.front().px);
+    event.py.swap(buffer.front().py);
+    event.pz.swap(buffer.front().pz);
+    buffer.pop_front();
+    return true;
+  }
 
- for(i=0;i<nbins;i++)
-   {
-     if(i==0)
-       {
-	 Icross_section[0] = CrossSection_t[0]/Integral;
-	 // G4cout << "Cross_section[0] " << CrossSection_t[0]  << G4endl;
-	 //G4cout << "Icross_section[0] " <<  Icross_section[0] << G4endl;
-       }
-     if (i!=0)
-       {
-	 Icross_section[i] = Icross_section[i-1] + CrossSection_t[i]/Integral;
-	 //G4cout << "i" << i << "Icross_section[i]" <<  Icross_section[i]   << G4endl;
-       }
+  std::unique_lock<std::mutex> lock(bufferMutex);
+  while(buffer.empty() && !endOfFile) bufferNotEmpty.wait(lock);
+  if(buffer.empty()) {
+    if(!errorMessage.empty()) {
+      G4cout << "ActarSimEventGenerator::TakeEvent() - ERROR in file " << fileName
+	     << ": " << errorMessage << G4endl;
+      errorMessage = "";
+    }
+    return false;
+  }
+  event.weight = buffer.front().weight;
+  event.pdg.swap(buffer.front().pdg);
+  event.px.swap(buffer.front().px);
+  event.py.swap(buffer.front().py);
+  event.pz.swap(buffer.front().pz);
+  buffer.pop_front();
+  bufferNotFull.notify_one();
+  return true;
+}
 
-   }
+//////////////////////////////////////////////////////////////////
+/// Particle definition for a PDG code. The ions are created in the
+/// ion table (ground state) the first time they are used
+G4ParticleDefinition* ActarSimEventGenerator::FindDefinition(G4int pdg){
+  std::map<G4int,G4ParticleDefinition*>::const_iterator found = definitions.find(pdg);
+  if(found!=definitions.end()) return found->second;
 
-  */
+  G4ParticleDefinition* definition = 0;
+  if(pdg>1000000000) {
+    G4int Z = (pdg/10000)%1000;
+    G4int A = (pdg/10)%1000;
+    definition = G4IonTable::GetIonTable()->GetIon(Z,A,0.);
+  }
+  else
+    definition = G4ParticleTable::GetParticleTable()->FindParticle(pdg);
 
+  if(!definition)
+    G4cout << "ActarSimEventGenerator::FindDefinition() - ERROR: unknown PDG code "
+	   << pdg << "; these particles are not generated." << G4endl;
+  definitions[pdg] = definition;
+  return definition;
 }
 
 //////////////////////////////////////////////////////////////////
-/// Destructor
-ActarSimEventGenerator::~ActarSimEventGenerator() {
+/// Adds the particles of the next event to anEvent, one primary
+/// vertex per particle, all in the given position and time. Returns
+/// false if there are no more events in the file
+G4bool ActarSimEventGenerator::GenerateEvent(G4Event* anEvent, const G4ThreeVector& position,
+					     G4double time){
+  ActarSimEvGenEvent event;
+  if(!TakeEvent(event)) return false;
+  numberOfEventsRead++;
+
+  for(size_t i=0;i<event.pdg.size();i++) {
+    G4ParticleDefinition* definition = FindDefinition(event.pdg[i]);
+    if(!definition) continue;
+    G4PrimaryParticle* particle = new G4PrimaryParticle(definition,
+							event.px[i]*MeV,
+							event.py[i]*MeV,
+							event.pz[i]*MeV);
+    particle->SetWeight(event.weight);
+    G4PrimaryVertex* vertex = new G4PrimaryVertex(position,time);
+    vertex->SetPrimary(particle);
+    anEvent->AddPrimaryVertex(vertex);
+  }
+  return true;
 }
@@ -0,0 +1,157 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimEventTracks
+/// All the steps in the gas of one event, stored as a single entry
+/// of the tracks tree. Positions are quantized (positionResolution,
+/// 10 um by default) and stored as increments with respect to the
+/// previous point of the same track; the energy deposited in each step
+/// is rounded to energyResolution (1 eV by default). An index keeps,
+/// for each set of consecutive steps of a track, the track and parent
+/// IDs, the first step and the starting point. A new index entry is
+/// opened when the track changes or when the step does not start at
+/// the end of the previous one (steps without energy are not stored).
+/// GetStep() recovers the information in the ActarSimTrack format.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimEventTracks.hh"
+#include "ActarSimTrack.hh"
+
+#include "TMath.h"
+
+ClassImp(ActarSimEventTracks)
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimEventTracks::ActarSimEventTracks(){
+  eventID = 0;
+  runID = 0;
+  positionResolution = 0.01; // mm
+  energyResolution = 1.e-6;  // MeV
+  Reset();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimEventTracks::~ActarSimEventTracks(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties the buffer, keeping the allocated memory for the next event
+void ActarSimEventTracks::Reset(){
+  trackID.clear();
+  parentTrackID.clear();
+  firstStep.clear();
+  xStart.clear();
+  yStart.clear();
+  zStart.clear();
+  dx.clear();
+  dy.clear();
+  dz.clear();
+  energyStep.clear();
+  lastX = lastY = lastZ = 0;
+  ResetCursor();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Moves the GetStep() cursor to the beginning of the event. Needed
+/// only if an event with the same event and run IDs is read (from
+/// another file) into the same object
+void ActarSimEventTracks::ResetCursor(){
+  cursorStep = -1;
+  cursorEntry = -1;
+  cursorX = cursorY = cursorZ = 0;
+  cursorEventID = eventID;
+  cursorRunID = runID;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Position in units of positionResolution
+Int_t ActarSimEventTracks::Quantize(Double_t pos) const {
+  return (Int_t)TMath::Nint(pos/positionResolution);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds a step (positions in mm, energy in MeV)
+void ActarSimEventTracks::AddStep(Int_t track, Int_t parent,
+				  Double_t xPre, Double_t yPre, Double_t zPre,
+				  Double_t xPost, Double_t yPost, Double_t zPost,
+				  Double_t energy){
+  Int_t qxPre = Quantize(xPre);
+  Int_t qyPre = Quantize(yPre);
+  Int_t qzPre = Quantize(zPre);
+
+  if(trackID.empty() || trackID.back()!=track ||
+     qxPre!=lastX || qyPre!=lastY || qzPre!=lastZ){
+    trackID.push_back(track);
+    parentTrackID.push_back(parent);
+    firstStep.push_back((Int_t)dx.size());
+    xStart.push_back(qxPre);
+    yStart.push_back(qyPre);
+    zStart.push_back(qzPre);
+    lastX = qxPre;
+    lastY = qyPre;
+    lastZ = qzPre;
+  }
+
+  Int_t qxPost = Quantize(xPost);
+  Int_t qyPost = Quantize(yPost);
+  Int_t qzPost = Quantize(zPost);
+  dx.push_back(qxPost-lastX);
+  dy.push_back(qyPost-lastY);
+  dz.push_back(qzPost-lastZ);
+  energyStep.push_back((Float_t)(TMath::Nint(energy/energyResolution)*energyResolution));
+  lastX = qxPost;
+  lastY = qyPost;
+  lastZ = qzPost;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Number of steps in an index entry
+Int_t ActarSimEventTracks::GetEntryNumberOfSteps(Int_t i) const {
+  Int_t next = (i+1<(Int_t)firstStep.size()) ? firstStep[i+1] : (Int_t)dx.size();
+  return next - firstStep[i];
+}
+
+//////////////////////////////////////////////////////////////////
+/// Fills the ActarSimTrack with the information of a step. Reading
+/// the steps in order costs a constant time per step
+void ActarSimEventTracks::GetStep(Int_t step, ActarSimTrack* aTrack){
+  if(step<0 || step>=(Int_t)dx.size()) return;
+
+  //the cursor is not valid after reading a different event from the tree
+  if(cursorEventID!=eventID || cursorRunID!=runID || step<cursorStep) ResetCursor();
+
+  //the cursor is always at the start point of cursorStep
+  while(cursorStep<step){
+    if(cursorStep>=0){
+      cursorX += dx[cursorStep];
+      cursorY += dy[cursorStep];
+      cursorZ += dz[cursorStep];
+    }
+    cursorStep++;
+    if(cursorEntry+1<(Int_t)firstStep.size() && firstStep[cursorEntry+1]==cursorStep){
+      cursorEntry++;
+      cursorX = xStart[cursorEntry];
+      cursorY = yStart[cursorEntry];
+      cursorZ = zStart[cursorEntry];
+    }
+  }
+
+  aTrack->SetXPreCoord(cursorX*positionResolution);
+  aTrack->SetYPreCoord(cursorY*positionResolution);
+  aTrack->SetZPreCoord(cursorZ*positionResolution);
+  aTrack->SetXCoord((cursorX+dx[step])*positionResolution);
+  aTrack->SetYCoord((cursorY+dy[step])*positionResolution);
+  aTrack->SetZCoord((cursorZ+dz[step])*positionResolution);
+  aTrack->SetEnergyStep(energyStep[step]);
+  aTrack->SetTrackID(trackID[cursorEntry]);
+  aTrack->SetParentTrackID(parentTrackID[cursorEntry]);
+  aTrack->SetEventID(eventID);
+  aTrack->SetRunID(runID);
+}
@@ -17,6 +17,8 @@
 //#include "ActarSimDetectorMessenger.hh"
 #include "ActarSimROOTAnalysis.hh"
 #include "ActarSimGasSD.hh"
+#include "ActarSimGasFastModel.hh"
+#include "ActarSimMaterialRegistry.hh"
 
 #include "G4Material.hh"
 #include "G4Box.hh"
@@ -31,6 +33,8 @@
 #include "G4Transform3D.hh"
 
 #include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4FastSimulationManager.hh"
 
 #include "globals.hh"
 
@@ -72,6 +76,9 @@ ActarSimGasDetectorConstruction(ActarSimDetectorConstruction* det)
   outerRadiusBeamShieldTub = 0.1001*m;
   lengthBeamShieldTub = 0.5 * m;
 
+  //fast simulation of the ions in the gas (inactive by default)
+  gasFastModel = new ActarSimGasFastModel("gasFastModel");
+
   // create commands for interactive definition of the calorimeter
   gasMessenger = new ActarSimGasDetectorMessenger(det,this);
 }
@@ -80,6 +87,7 @@ ActarSimGasDetectorConstruction(ActarSimDetectorConstruction* det)
 /// Destructor
 ActarSimGasDetectorConstruction::~ActarSimGasDetectorConstruction(){
   delete gasMessenger;
+  delete gasFastModel;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -236,9 +244,8 @@ G4VPhysicalVolume* ActarSimGasDetectorConstruction::ConstructGas(G4LogicalVolume
   //------------------------------------------------
   gasLog->SetSensitiveDetector( detConstruction->GetGasSD() );
 
-  //Region (test for PAI)
-  G4Region* activeGas = new G4Region("ActiveGas");
-  activeGas->AddRootLogicalVolume(gasLog);
+  //Region (test for PAI and fast simulation)
+  AddToActiveGas(gasLog);
 
   //------------------------------------------------------------------
   // Visualization attributes
@@ -254,180 +261,63 @@ G4VPhysicalVolume* ActarSimGasDetectorConstruction::ConstructGas(G4LogicalVolume
 }
 
 //////////////////////////////////////////////////////////////////
-/// Sets the material the gas is made of
+/// Adds the gas logical volume to the ActiveGas region, with the fast
+/// simulation of the ions (ActarSimGasFastModel). The region and its
+/// fast simulation manager are kept when the geometry is rebuilt
+void ActarSimGasDetectorConstruction::AddToActiveGas(G4LogicalVolume* gasLog) {
+  G4Region* activeGas = G4RegionStore::GetInstance()->GetRegion("ActiveGas",false);
+  if(!activeGas) activeGas = new G4Region("ActiveGas");
+  activeGas->AddRootLogicalVolume(gasLog);
+  if(!activeGas->GetFastSimulationManager()) {
+    G4FastSimulationManager* fastSimManager = new G4FastSimulationManager(activeGas);
+    fastSimManager->AddFastSimulationModel(gasFastModel);
+  }
+  gasFastModel->SetGasSD(detConstruction->GetGasSD());
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the material the gas is made of, at the gas pressure and
+/// temperature. The material is taken from the registry of the
+/// detector construction (ActarSimMaterialRegistry), which builds
+/// each gas (or mixture) only once for each pressure and temperature
 ///
 /// STP used are P = 1atm and T = 20ºC
 void ActarSimGasDetectorConstruction::SetGasMaterial (G4String mat) {
-  //Gas Pressure & Temperature
-  G4double pressure=GetGasPressure();
-  G4double temperature=GetGasTemperature();
-
-  G4double density;
-  G4double a;  // atomic mass
-  G4double z;  // atomic number
-  G4double n;
-
-  //Gas Mix
-  //const G4int NGasMix=NumberOfGasMix;
-
-  //HAPOL NOTE: REMOVE REPETITIONS
-  G4Element* ele_H  = new G4Element("Hydrogen" ,"H" , z= 1., a=   1.00794*g/mole);
-  //G4Element* ele_D  = new G4Element("Deuterium","D" , z= 1., a=    2.0140*g/mole);
-  //G4Element* ele_He = new G4Element("Helium"   ,"He", z= 2., a=    4.0026*g/mole);
-  G4Element* ele_C  = new G4Element("Carbon"   ,"C",  z=6.,  a=   12.0107*g/mole);
-  //G4Element* ele_N  = new G4Element("Nitrogen" ,"N" , z= 7., a=  14.00674*g/mole);
-  //G4Element* ele_O  = new G4Element("Oxygen"   ,"O" , z= 8., a=   15.9994*g/mole);
-  G4Element* ele_F  = new G4Element("Fluorine" ,"F",  z=9.,  a=18.9984032*g/mole);
-  //G4Element* ele_Na = new G4Element("Sodium"   ,"Na", z=11., a=  22.98977*g/mole);
-  //G4Element* ele_S  = new G4Element("Sulphur"  ,"S",  z=16., a=    32.066*g/mole);
-  //G4Element* ele_Ar = new G4Element("Argon"    ,"Ar", z=18., a=   39.9481*g/mole);
-  /*
-  G4Element* ele_Zn = new G4Element("Zinc",     "Zn", z=30., a=     65.39*g/mole);
-  G4Element* ele_Ge = new G4Element("Germanium","Ge", z=32., a=     72.61*g/mole);
-  G4Element* ele_Br = new G4Element("Bromine"  ,"Br", z=35., a=    79.904*g/mole);
-  G4Element* ele_Cd = new G4Element("Cadmium"  ,"Cd", z=48., a=   112.411*g/mole);
-  G4Element* ele_Te = new G4Element("Tellurium","Te", z=52., a=    127.60*g/mole);
-  G4Element* ele_I  = new G4Element("Iodine"   ,"I",  z=53., a= 126.90447*g/mole);
-  G4Element* ele_Cs = new G4Element("Cesium"   ,"Cs", z=55., a= 132.90545*g/mole);
-  G4Element* ele_Ba = new G4Element("Barium"   ,"Ba", z=56., a=   137.327*g/mole);
-  G4Element* ele_La = new G4Element("Lanthanum","La", z=57., a=  138.9055*g/mole);
-  G4Element* ele_Ce = new G4Element("Cerium"   ,"Ce", z=58., a=   140.116*g/mole);
-  G4Element* ele_Lu = new G4Element("Lutecium" ,"Lu", z=71., a=   174.967*g/mole);
-  G4Element* ele_W  = new G4Element("Tungsten" ,"W" , z=74., a=    183.84*g/mole);
-  G4Element* ele_Pb = new G4Element("Lead"     ,"Pb", z=82., a=    207.20*g/mole);
-  G4Element* ele_Bi = new G4Element("Bismuth"  ,"Bi", z=83., a= 208.98038*g/mole);
-  */
-
-  G4int ncomponents, natoms;
-  G4double fractionmass, abundance;
-
-  G4double Vm=0.08206*temperature*atmosphere/(pressure*kelvin);
-
-  G4Isotope* iso_H2= new G4Isotope("iso_H2",z=1,n=2, a=2.0140*g/mole);
-  G4Element* ele_D= new G4Element("Deuterium","D" , ncomponents=1);
-  ele_D->AddIsotope(iso_H2, abundance = 100.*perCent);
-
-  //material definition by user's T and P
-
-  //H2 (default  0.083812*mg/cm3 STP)
-  //density	= (0.083812*293.15*kelvin*pressure)/(1.01325*bar*temperature)*mg/cm3;
-  density	= (2*1.00794/Vm)*mg/cm3;
-  G4Material* H2 =
-    new G4Material("H2", density, ncomponents=2, kStateGas, temperature, pressure);
-  H2->AddElement(ele_H, natoms=1);
-  H2->AddElement(ele_H, natoms=1);
-
-  //D2 (default  0.16746*mg/cm3 STP)
-  //density	=(0.16746*293.15*kelvin*pressure)/(1.01325*bar*temperature)*mg/cm3;
-  density	= (2*2.0140/Vm)*mg/cm3;
-  G4Material* D2 =
-    new G4Material("D2", density, ncomponents=2, kStateGas, temperature, pressure);
-  D2->AddElement(ele_D, natoms=1);
-  D2->AddElement(ele_D, natoms=1);
-
-  //He (default  0.16642*mg/cm3 STP)
-  //density	=(0.16642*293.15*kelvin*pressure)/(1.01325*bar*temperature)*mg/cm3;
-  density	= (4.0026/Vm)*mg/cm3;
-  G4Material* He =
-    new G4Material("He", z=2, a=4.0026*g/mole, density, kStateGas, temperature, pressure);
-
-  //Ar (default  0.16642*mg/cm3 STP)
-  //density	=(0.16642*293.15*kelvin*pressure)/(1.01325*bar*temperature)*mg/cm3;
-  density	= (39.9481/Vm)*mg/cm3;
-  G4Material* Ar =
-    new G4Material("Ar", z=18, a=39.9481*g/mole, density, kStateGas, temperature, pressure);
-
-  //CF4 (default  3.6586*mg/cm3 STP)
-  //density	=(3.6586*293.15*kelvin*pressure)/(1.01325*bar*temperature)*mg/cm3;
-  density	= ((12.0107+4*18.9984032)/Vm)*mg/cm3;
-  G4Material* CF4 =
-    new G4Material("CF4", density, ncomponents=2, kStateGas, temperature, pressure);
-  CF4->AddElement(ele_C, natoms=1);
-  CF4->AddElement(ele_F, natoms=4);
-
-  //Methane (default  0.66697*mg/cm3 STP)
-  //density = (0.6669*293.15*kelvin*pressure)/(1.01325*bar*temperature)*mg/cm3;
-  density	= ((12.0107+4*1.00794)/Vm)*mg/cm3;
-  G4Material* CH4 =
-    new G4Material("CH4", density, ncomponents=2, kStateGas, temperature, pressure) ;
-  CH4->AddElement(ele_C,1);
-  CH4->AddElement(ele_H,4);
-
-  //Isobutane (default  2.41464*mg/cm3 STP)
-  //density = (2.41464*293.15*kelvin*pressure)/(1.01325*bar*temperature)*mg/cm3;
-  density	= ((4*12.0107+10*1.00794)/Vm)*mg/cm3;
-  G4Material* iC4H10 =
-    new G4Material("iC4H10", density, ncomponents=2, kStateGas, temperature, pressure) ;
-  iC4H10->AddElement(ele_C,4);
-  iC4H10->AddElement(ele_H,10);
-
-  if(mat=="H2"){
-    gasMaterial = H2;
-    detConstruction->SetUpdateChamberMaterial(H2);
-  }
-  else if(mat=="D2"){
-    gasMaterial = D2;
-    detConstruction->SetUpdateChamberMaterial(D2);
-  }
-  else if(mat=="He"){
-    gasMaterial = He;
-    detConstruction->SetUpdateChamberMaterial(He);
-  }
-  else if(mat=="Ar"){
-    gasMaterial = Ar;
-    detConstruction->SetUpdateChamberMaterial(Ar);
-  }
-  else if(mat=="CF4"){
-    gasMaterial = CF4;
-    detConstruction->SetUpdateChamberMaterial(CF4);
-  }
-  else if(mat=="CH4"){
-    gasMaterial = CH4;
-    detConstruction->SetUpdateChamberMaterial(CH4);
+  ActarSimMaterialRegistry* registry = detConstruction->GetMaterialRegistry();
+  G4Material* pttoMaterial = 0;
+  if(mat=="GasMix")
+    pttoMaterial = registry->GetGasMixture(NumberOfGasMix,gasMixMaterial,gasMixRatio,
+					   GetGasPressure(),GetGasTemperature());
+  else
+    pttoMaterial = registry->GetGas(mat,GetGasPressure(),GetGasTemperature());
+
+  if(!pttoMaterial){
+    G4cout << "ActarSimGasDetectorConstruction::SetGasMaterial(): " << mat
+	   << " is not a known gas, the gas material is not changed" << G4endl;
+    return;
   }
-  else if(mat=="iC4H10"){
-    gasMaterial = iC4H10;
-    detConstruction->SetUpdateChamberMaterial(iC4H10);
-  }
-  else if(mat=="GasMix"){
-
-    density = 0*mg/cm3;
-    //G4double DensitySum=0;
-    //G4double FractionMass[NGasMix];
-    G4double FractionMass[10];
-    //G4Material pttoMaterial[NGasMix];
-    G4Material *pttoMaterial[10];
-
-    for(G4int i=0;i<NumberOfGasMix;i++) {
-      //pttoMaterial[i] = G4Material::GetMaterial(GasMat[i]);
-      if(gasMixMaterial[i]=="H2")pttoMaterial[i]=H2;
-      else if(gasMixMaterial[i]=="D2")pttoMaterial[i]=D2;
-      else if(gasMixMaterial[i]=="He")pttoMaterial[i]=He;
-      else if(gasMixMaterial[i]=="Ar")pttoMaterial[i]=Ar;
-      else if(gasMixMaterial[i]=="CF4")pttoMaterial[i]=CF4;
-      else if(gasMixMaterial[i]=="CH4")pttoMaterial[i]=CH4;
-      else if(gasMixMaterial[i]=="iC4H10")pttoMaterial[i]=iC4H10;
-
-      density+= ((gasMixRatio[i]*pttoMaterial[i]->GetDensity()));
-      //G4cout <<" Gas Mat "<<gasMixMaterial[i]<<" Gas Ratio "<<gasMixRatio[i]<<" Mat Density "<<gasMixRatio[i]*pttoMaterial[i]->GetDensity()*cm3/mg<< G4endl;
-      //DensitySum+=pttoMaterial[i]->GetDensity();
-
-    }
-
-    for(G4int i=0;i<NumberOfGasMix;i++) {
-      FractionMass[i]=((gasMixRatio[i]*pttoMaterial[i]->GetDensity()))/density;
-    }
-
-    G4Material* GasMix =
-      new G4Material("GasMix", density, ncomponents=NumberOfGasMix, kStateGas, temperature, pressure);
-
-    for(G4int i=0;i<NumberOfGasMix;i++) {
-      GasMix->AddMaterial( pttoMaterial[i], fractionmass = FractionMass[i] ) ;
-    }
+  gasMaterialName = mat;
+  gasMaterial = pttoMaterial;
+  detConstruction->SetUpdateChamberMaterial(pttoMaterial);
+}
 
-    gasMaterial = GasMix;
-    detConstruction->SetUpdateChamberMaterial(GasMix);
-  }
+//////////////////////////////////////////////////////////////////
+/// Updates the gas material after a change of the pressure or the
+/// temperature. The new material replaces the previous one in the
+/// volumes built with the gas (gas volume, chamber, envelopes of the
+/// walls; see ActarSimDetectorConstruction::GetGasFilledVolumes()),
+/// without rebuilding the geometry; only the physics tables of the
+/// new material are built at the next run (none if the conditions
+/// were already used)
+void ActarSimGasDetectorConstruction::UpdateGasMaterial() {
+  if(gasMaterialName=="") return;
+  G4Material* previousMaterial = gasMaterial;
+  SetGasMaterial(gasMaterialName);
+  if(gasMaterial==previousMaterial) return;
+
+  const std::vector<G4LogicalVolume*>& volumes = detConstruction->GetGasFilledVolumes();
+  for(size_t i=0;i<volumes.size();i++) volumes[i]->SetMaterial(gasMaterial);
+  if(!volumes.empty()) G4RunManager::GetRunManager()->PhysicsHasBeenModified();
 }
 
 //////////////////////////////////////////////////////////////////
@@ -17,6 +17,7 @@
 
 #include "ActarSimDetectorConstruction.hh"
 #include "ActarSimGasDetectorConstruction.hh"
+#include "ActarSimGasFastModel.hh"
 #include "ActarSimPrimaryGeneratorAction.hh"
 
 #include "G4UIcommand.hh"
@@ -53,6 +54,10 @@
 /// - /ActarSim/det/gas/mixture/
 /// - /ActarSim/det/gas/mixture/GasMixture
 /// - /ActarSim/det/gas/mixture/setGasMix
+/// - /ActarSim/det/gas/fastSim/
+/// - /ActarSim/det/gas/fastSim/active
+/// - /ActarSim/det/gas/fastSim/strideLength
+/// - /ActarSim/det/gas/fastSim/straggling
 ActarSimGasDetectorMessenger::
 ActarSimGasDetectorMessenger(ActarSimDetectorConstruction* ActarSimDet,ActarSimGasDetectorConstruction* ActarSimGasDet)
   :ActarSimDetector(ActarSimDet), ActarSimGasDetector(ActarSimGasDet){
@@ -71,6 +76,7 @@ ActarSimGasDetectorMessenger(ActarSimDetectorConstruction* ActarSimDet,ActarSimG
 
   gasPresCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/det/gas/setGasPressure",this);
   gasPresCmd->SetGuidance("Select the Gas Pressure (for the Gas box and the Chamber).");
+  gasPresCmd->SetGuidance("The gas material is replaced without rebuilding the geometry.");
   gasPresCmd->SetParameterName("gasPressure",false);
   gasPresCmd->SetRange("gasPressure>=0.");
   gasPresCmd->SetUnitCategory("Pressure");
@@ -80,6 +86,7 @@ ActarSimGasDetectorMessenger(ActarSimDetectorConstruction* ActarSimDet,ActarSimG
 
   gasTempCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/det/gas/setGasTemperature",this);
   gasTempCmd->SetGuidance("Select the Gas Temperature (for the Gas box and the Chamber).");
+  gasTempCmd->SetGuidance("The gas material is replaced without rebuilding the geometry.");
   gasTempCmd->SetParameterName("gasTemperature",false);
   gasTempCmd->SetRange("gasTemperature>=0.");
   gasTempCmd->SetUnitCategory("Temperature");
@@ -220,6 +227,35 @@ ActarSimGasDetectorMessenger(ActarSimDetectorConstruction* ActarSimDet,ActarSimG
   gasMixtureParam->SetParameterRange("GasRatio>=0.");
   gasMixtureParam->SetParameterRange("GasRatio<=1.");
   gasMixtureCmd->SetParameter(gasMixtureParam);
+
+  fastSimDir = new G4UIdirectory("/ActarSim/det/gas/fastSim/");
+  fastSimDir->SetGuidance("fast simulation of the ions in the gas");
+
+  fastSimActiveCmd = new G4UIcmdWithAString("/ActarSim/det/gas/fastSim/active",this);
+  fastSimActiveCmd->SetGuidance("Moves the ions (charge above 2) in the gas in strides");
+  fastSimActiveCmd->SetGuidance("from the tabulated range, instead of the full physics.");
+  fastSimActiveCmd->SetGuidance("The process is registered with /ActarSim/phys/addPhysics fastSim");
+  fastSimActiveCmd->SetGuidance("  Choice : on, off(default)");
+  fastSimActiveCmd->SetParameterName("choice",true);
+  fastSimActiveCmd->SetDefaultValue("off");
+  fastSimActiveCmd->SetCandidates("on off");
+  fastSimActiveCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fastSimStrideCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/det/gas/fastSim/strideLength",this);
+  fastSimStrideCmd->SetGuidance("Select the length of the strides of the fast simulation (default 1 mm).");
+  fastSimStrideCmd->SetParameterName("strideLength",false);
+  fastSimStrideCmd->SetRange("strideLength>0.");
+  fastSimStrideCmd->SetUnitCategory("Length");
+  fastSimStrideCmd->SetDefaultUnit("mm");
+  fastSimStrideCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fastSimStragglingCmd = new G4UIcmdWithAString("/ActarSim/det/gas/fastSim/straggling",this);
+  fastSimStragglingCmd->SetGuidance("Energy and angular straggling in the fast simulation strides.");
+  fastSimStragglingCmd->SetGuidance("  Choice : on(default), off");
+  fastSimStragglingCmd->SetParameterName("choice",true);
+  fastSimStragglingCmd->SetDefaultValue("on");
+  fastSimStragglingCmd->SetCandidates("on off");
+  fastSimStragglingCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -247,6 +283,10 @@ ActarSimGasDetectorMessenger::~ActarSimGasDetectorMessenger() {
   delete outerRadiusBeamShieldTubCmd;
   delete lengthBeamShieldTubCmd;
   delete printCmd;
+  delete fastSimActiveCmd;
+  delete fastSimStrideCmd;
+  delete fastSimStragglingCmd;
+  delete fastSimDir;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -268,11 +308,15 @@ void ActarSimGasDetectorMessenger::SetNewValue(G4UIcommand* command,
   if(command == gasMixtureCmd)
     GasMixtureCommand(newValue);
 
-  if(command == gasTempCmd)
+  if(command == gasTempCmd) {
     ActarSimGasDetector->SetGasTemperature(gasTempCmd->GetNewDoubleValue(newValue));
+    ActarSimGasDetector->UpdateGasMaterial();
+  }
 
-  if(command == gasPresCmd)
+  if(command == gasPresCmd) {
     ActarSimGasDetector->SetGasPressure(gasPresCmd->GetNewDoubleValue(newValue));
+    ActarSimGasDetector->UpdateGasMaterial();
+  }
 
   if(command == beamShieldMaterCmd)
     ActarSimGasDetector->SetBeamShieldMaterial(newValue);
@@ -318,6 +362,15 @@ void ActarSimGasDetectorMessenger::SetNewValue(G4UIcommand* command,
 
   if( command == printCmd )
     ActarSimGasDetector->PrintDetectorParameters();
+
+  if(command == fastSimActiveCmd)
+    ActarSimGasDetector->GetGasFastModel()->SetActiveFlag(newValue=="on");
+
+  if(command == fastSimStrideCmd)
+    ActarSimGasDetector->GetGasFastModel()->SetStrideLength(fastSimStrideCmd->GetNewDoubleValue(newValue));
+
+  if(command == fastSimStragglingCmd)
+    ActarSimGasDetector->GetGasFastModel()->SetStragglingFlag(newValue=="on");
 }
 
 //////////////////////////////////////////////////////////////////
@@ -0,0 +1,224 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimGasFastModel
+/// Fast simulation of the heavy ions (charge above 2) in the active
+/// gas. Attached to the ActiveGas region, it replaces the tracking of
+/// the ion in the gas volume by strides of strideLength, using the
+/// tabulated stopping power, range and time (ActarSimRangeTable) of
+/// the ion in the gas. In each stride the energy straggling (Bohr) and
+/// the angular straggling (Highland) are sampled, as in the beam
+/// transport, and the stride is given directly to the gas SD as a
+/// hit, so that it becomes one ActarSimSimpleTrack stride. The delta
+/// electrons are not produced and the lateral displacement inside a
+/// stride is neglected. The ion is moved until it stops or reaches the
+/// first boundary (gas limits or a daughter volume); paths shorter
+/// than minimumLength are left to the full physics. The beam ion
+/// tracked to the reaction vertex (beam status 1, see
+/// ActarSimBeamInfo) is also left to the full physics, since the
+/// vertex is found from its steps and its trajectory may be recorded
+/// (ActarSimBeamLibrary). Inactive by default: the full physics path
+/// remains for the validation.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimGasFastModel.hh"
+#include "ActarSimGasSD.hh"
+#include "ActarSimRangeTable.hh"
+#include "ActarSimROOTAnalysis.hh"
+#include "ActarSimBeamInfo.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Material.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "Randomize.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor. The model is created inactive
+ActarSimGasFastModel::ActarSimGasFastModel(G4String name)
+  :G4VFastSimulationModel(name), gasSD(0), activeFlag(false), stragglingFlag(true),
+   strideLength(1.*mm), minimumLength(0.1*mm), nBins(500), tableMaterial(0) {
+  navigator = new G4Navigator();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimGasFastModel::~ActarSimGasFastModel(){
+  ClearTables();
+  delete navigator;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Deletes the range tables (they are built again when needed)
+void ActarSimGasFastModel::ClearTables(){
+  std::map<const G4ParticleDefinition*,ActarSimRangeTable*>::iterator it;
+  for(it=rangeTables.begin();it!=rangeTables.end();++it) delete it->second;
+  rangeTables.clear();
+  tableMaterial = 0;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Only the ions with charge above 2 (the lighter particles keep
+/// the step by step description, also in the analysis)
+G4bool ActarSimGasFastModel::IsApplicable(const G4ParticleDefinition& particle){
+  return particle.GetParticleType()=="nucleus" && particle.GetPDGCharge()>2.*eplus;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Range table of the ion in the gas, built (up to twice the energy)
+/// the first time or when the energy is above the table. Returns 0 if
+/// the table cannot be built
+ActarSimRangeTable* ActarSimGasFastModel::GetRangeTable(const G4ParticleDefinition* ion,
+							const G4Material* gas,
+							G4double energy){
+  if(gas!=tableMaterial) {
+    ClearTables();
+    tableMaterial = gas;
+  }
+  ActarSimRangeTable*& table = rangeTables[ion];
+  if(!table) table = new ActarSimRangeTable();
+  if(!table->IsBuilt(ion,gas,energy))
+    if(!table->Build(ion,gas,2.e-4*energy,2.*energy,nBins)) return 0;
+  return table;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Distance along the direction to the next boundary of the mass
+/// geometry, up to maxLength
+G4double ActarSimGasFastModel::DistanceToBoundary(const G4ThreeVector& position,
+						  const G4ThreeVector& direction,
+						  G4double maxLength){
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()->
+    GetNavigatorForTracking()->GetWorldVolume();
+  if(navigator->GetWorldVolume()!=world) navigator->SetWorldVolume(world);
+
+  navigator->LocateGlobalPointAndSetup(position,&direction,false,false);
+  G4double safety = 0.;
+  G4double length = navigator->ComputeStep(position,direction,maxLength,safety);
+  return (length<maxLength) ? length : maxLength;
+}
+
+//////////////////////////////////////////////////////////////////
+/// The model is triggered for the ions in the gas volume (not in its
+/// daughters) with a residual range and a free path above minimumLength,
+/// except the beam ion on its way to the reaction vertex
+G4bool ActarSimGasFastModel::ModelTrigger(const G4FastTrack& fastTrack){
+  if(!activeFlag || !gasSD) return false;
+
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  if(track->GetVolume()->GetLogicalVolume()->GetSensitiveDetector()!=gasSD) return false;
+
+  //the vertex of the beam is found step by step in the analysis
+  if(track->GetParentID()==0 && gActarSimROOTAnalysis &&
+     gActarSimROOTAnalysis->GetBeamInfo() &&
+     gActarSimROOTAnalysis->GetBeamInfo()->GetStatus()==1) return false;
+
+  G4double energy = track->GetKineticEnergy();
+  if(energy<=0.) return false;
+  ActarSimRangeTable* table = GetRangeTable(track->GetDefinition(),track->GetMaterial(),energy);
+  if(!table || table->GetRange(energy)<=minimumLength) return false;
+
+  return DistanceToBoundary(track->GetPosition(),track->GetMomentumDirection(),
+			    minimumLength) >= minimumLength;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Moves the ion in strides until it stops (killed) or reaches a
+/// boundary (final state on the boundary, the tracking continues)
+void ActarSimGasFastModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep){
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  const G4ParticleDefinition* ion = track->GetDefinition();
+  const G4Material* gas = track->GetMaterial();
+  G4double charge = ion->GetPDGCharge()/eplus;
+  G4double mass = ion->GetPDGMass();
+
+  G4ThreeVector position = track->GetPosition();
+  G4ThreeVector direction = track->GetMomentumDirection();
+  G4double energy = track->GetKineticEnergy();
+  G4double time = track->GetGlobalTime();
+  G4double initialEnergy = energy;
+  G4double pathLength = 0.;
+
+  ActarSimRangeTable* table = GetRangeTable(ion,gas,energy);
+  G4double stragglingFactor = 2.*twopi_mc2_rcl2*electron_mass_c2*gas->GetElectronDensity()*charge*charge;
+
+  G4bool stopped = false;
+  G4bool boundary = false;
+  while(!stopped && !boundary) {
+    G4double length = DistanceToBoundary(position,direction,strideLength);
+    if(length<=0.) break;
+    boundary = (length<strideLength);
+
+    G4double range = table->GetRange(energy);
+    G4double newEnergy = 0.;
+    if(range<=length) {
+      length = range;
+      stopped = true;
+    }
+    else {
+      newEnergy = table->GetEnergy(range-length);
+      if(stragglingFlag) {
+	G4double sigmaE2 = stragglingFactor*
+	  (table->GetStragglingIntegral(energy)-table->GetStragglingIntegral(newEnergy));
+	newEnergy += table->GetDEDX(newEnergy)*std::sqrt(sigmaE2)*G4RandGauss::shoot();
+	if(newEnergy>energy) newEnergy = energy;
+	if(newEnergy<=0.) {
+	  newEnergy = 0.;
+	  stopped = true;
+	}
+      }
+    }
+
+    G4ThreeVector newPosition = position + length*direction;
+    G4double newTime = time + table->GetTime(energy) - table->GetTime(newEnergy);
+    gasSD->ProcessStride(track,position,newPosition,time,newTime,energy,newEnergy);
+
+    if(stragglingFlag && !stopped) {
+      //Highland multiple scattering, with the geometric mean of p*beta
+      G4double pIn2 = energy*(energy+2.*mass);
+      G4double pOut2 = newEnergy*(newEnergy+2.*mass);
+      G4double pBeta = std::sqrt(pIn2/(energy+mass)*pOut2/(newEnergy+mass));
+      G4double beta2 = pOut2/((newEnergy+mass)*(newEnergy+mass));
+      G4double thickness = length/gas->GetRadlen();
+      G4double theta0 = 13.6*MeV/pBeta*std::fabs(charge)*std::sqrt(thickness)*
+	(1.+0.038*std::log(thickness*charge*charge/beta2));
+      if(theta0>0.){
+	G4ThreeVector u = direction.orthogonal().unit();
+	G4ThreeVector v = direction.cross(u);
+	direction = (direction + G4RandGauss::shoot()*theta0*u +
+		     G4RandGauss::shoot()*theta0*v).unit();
+      }
+    }
+
+    position = newPosition;
+    time = newTime;
+    energy = newEnergy;
+    pathLength += length;
+  }
+
+  fastStep.ProposePrimaryTrackFinalPosition(position,false);
+  fastStep.ProposePrimaryTrackFinalTime(time);
+  fastStep.ProposePrimaryTrackPathLength(pathLength);
+  fastStep.ProposeTotalEnergyDeposited(initialEnergy-energy);
+  //the strides are already in the gas SD
+  fastStep.ProposeSteppingControl(AvoidHitInvocation);
+  if(stopped)
+    fastStep.KillPrimaryTrack();
+  else
+    fastStep.ProposePrimaryTrackFinalKineticEnergyAndDirection(energy,direction,false);
+}
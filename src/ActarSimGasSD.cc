@@ -12,9 +12,11 @@
 /////////////////////////////////////////////////////////////////
 
 #include "ActarSimGasSD.hh"
+#include "ActarSimSDFilter.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
+#include "G4Track.hh"
 #include "G4ThreeVector.hh"
 #include "G4SDManager.hh"
 #include "G4ios.hh"
@@ -32,11 +34,13 @@
 ActarSimGasSD::ActarSimGasSD(G4String name):G4VSensitiveDetector(name){
   G4String HCname;
   collectionName.insert(HCname="gasCollection");
+  stepFilter = new ActarSimSDFilter(name);
 }
 
 //////////////////////////////////////////////////////////////////
 /// Destructor
 ActarSimGasSD::~ActarSimGasSD(){
+  delete stepFilter;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -57,6 +61,8 @@ void ActarSimGasSD::Initialize(G4HCofThisEvent* HCE){
 /// Filling the ActarSimCalGeantHit information with the step info.
 /// Invoked by G4SteppingManager for each step
 G4bool ActarSimGasSD::ProcessHits(G4Step* aStep,G4TouchableHistory*){
+  //Optional rejection (parentID, particle, energy) before allocating the hit
+  if(!stepFilter->Accept(aStep)) return false;
 
   //G4double edep = aStep->GetTotalEnergyDeposit()/MeV;
   //G4double edep = -aStep->GetDeltaEnergy()/MeV;
@@ -96,6 +102,41 @@ G4bool ActarSimGasSD::ProcessHits(G4Step* aStep,G4TouchableHistory*){
   return true;
 }
 
+//////////////////////////////////////////////////////////////////
+/// Filling the ActarSimGasGeantHit information with a stride of the
+/// fast simulation in the gas (ActarSimGasFastModel), which does not
+/// produce G4Steps. Same units and conventions than ProcessHits()
+G4bool ActarSimGasSD::ProcessStride(const G4Track* track,
+				    const G4ThreeVector& prePos, const G4ThreeVector& postPos,
+				    G4double preTime, G4double postTime,
+				    G4double preEnergy, G4double postEnergy){
+  if(!stepFilter->Accept(track,preEnergy)) return false;
+
+  G4double edep = (preEnergy - postEnergy)/MeV;
+  if(edep==0.) return false;
+
+  ActarSimGasGeantHit* newHit = new ActarSimGasGeantHit();
+
+  newHit->SetTrackID(track->GetTrackID());
+  newHit->SetParentID(track->GetParentID());
+  newHit->SetEdep(edep);
+  newHit->SetParticleCharge(track->GetDefinition()->GetPDGCharge());
+  newHit->SetParticleMass(track->GetDefinition()->GetPDGMass());
+  newHit->SetParticleID(track->GetDefinition()->GetPDGEncoding());
+  newHit->SetPrePos(prePos/mm);
+  newHit->SetPostPos(postPos/mm);
+  newHit->SetPreToF(preTime/ns);
+  newHit->SetPostToF(postTime/ns);
+  newHit->SetStepLength((postPos-prePos).mag()/mm);
+  newHit->SetStepEnergy(postEnergy/MeV);
+
+  newHit->SetDetName(track->GetVolume()->GetName());
+  newHit->SetDetID(track->GetVolume()->GetCopyNo());
+
+  hitsCollection->insert(newHit);
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////
 /// Just prints and draws the event hits (class ActarSimGasGeantHit).
 /// The recollection of the hits energy deposition in a crystal
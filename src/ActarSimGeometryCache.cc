@@ -0,0 +1,305 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimGeometryCache
+/// Cache of the constructed geometry in GDML files. Each file is named
+/// after a hash of the geometry configuration (see
+/// ActarSimDetectorConstruction::GetGeometryConfiguration()), so the
+/// world built for a configuration is saved once and loaded on later
+/// runs (or by other batch jobs sharing the directory) instead of being
+/// constructed again. The sensitive detectors and the regions, which
+/// are not part of the GDML geometry, are stored as auxiliary
+/// information of the logical volumes (ActarSimSD and ActarSimRegion)
+/// and restored on loading: the SDs directly from the G4SDManager, the
+/// regions by the caller (they may carry fast simulation models).
+/// The copy numbers of the parameterised walls (see
+/// ActarSimWallParameterisation), lost in the GDML parameterisation,
+/// are kept as ActarSimWallCopyNumbers of the wall envelopes, and the
+/// colour and visibility of the volumes (not read from GDML) as
+/// ActarSimVis.
+/// The GDML reader creates its own copies of the materials; the loaded
+/// volumes are given back the ActarSim materials of the same name, so
+/// the material pointers (gas material swaps, material registry) are
+/// the same as in the constructed geometry.
+/// Requires Geant4 with GDML support (ACTARSIM_USE_GDML); otherwise
+/// the geometry is always constructed.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimGeometryCache.hh"
+#include "ActarSimWallParameterisation.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4PVParameterised.hh"
+#include "G4RotationMatrix.hh"
+#include "G4Region.hh"
+#include "G4Material.hh"
+#include "G4SDManager.hh"
+#include "G4VSensitiveDetector.hh"
+#include "G4VisAttributes.hh"
+#include "G4Colour.hh"
+#include "G4ios.hh"
+
+#ifdef ACTARSIM_USE_GDML
+#include "G4GDMLParser.hh"
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor. The cache is created inactive
+ActarSimGeometryCache::ActarSimGeometryCache()
+  :activeFlag(false), directory("geometryCache") {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimGeometryCache::~ActarSimGeometryCache(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Key of a geometry configuration: 64 bits FNV-1a hash, in
+/// hexadecimal. It does not depend on the platform or the run, so
+/// the cached files can be shared
+G4String ActarSimGeometryCache::GetKey(const G4String& configuration){
+  unsigned long long hash = 14695981039346656037ULL;
+  for(size_t i=0;i<configuration.size();i++){
+    hash ^= (unsigned char)configuration[i];
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return key.str();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Name of the GDML file of a key
+G4String ActarSimGeometryCache::GetFileName(const G4String& key) const {
+  return directory + "/ActarSimGeometry_" + key + ".gdml";
+}
+
+//////////////////////////////////////////////////////////////////
+/// Loads the world of the key from the cache. The SDs are attached
+/// to their logical volumes and the region roots are returned (region
+/// name, logical volume). Returns 0 if the key is not in the cache
+G4VPhysicalVolume* ActarSimGeometryCache::Load(const G4String& key,
+					       std::multimap<G4String,G4LogicalVolume*>& regionRoots){
+  regionRoots.clear();
+#ifdef ACTARSIM_USE_GDML
+  G4String fileName = GetFileName(key);
+  std::ifstream cachedFile(fileName.c_str());
+  if(!cachedFile.good()) return 0;
+  cachedFile.close();
+
+  G4cout << "ActarSimGeometryCache::Load(): geometry from " << fileName << G4endl;
+  size_t existingMaterials = G4Material::GetNumberOfMaterials();
+  G4GDMLParser parser;
+  parser.Read(fileName,false);
+  G4VPhysicalVolume* world = parser.GetWorldVolume();
+  if(!world) return 0;
+
+  std::set<G4LogicalVolume*> visited;
+  RestoreMaterials(world->GetLogicalVolume(),existingMaterials,visited);
+
+  G4SDManager* SDman = G4SDManager::GetSDMpointer();
+  const G4GDMLAuxMapType* auxMap = parser.GetAuxMap();
+  G4GDMLAuxMapType::const_iterator volume;
+  for(volume=auxMap->begin();volume!=auxMap->end();++volume){
+    for(size_t i=0;i<volume->second.size();i++){
+      const G4GDMLAuxStructType& aux = volume->second[i];
+      if(aux.type=="ActarSimSD"){
+	G4VSensitiveDetector* detector = SDman->FindSensitiveDetector(aux.value,false);
+	if(detector) volume->first->SetSensitiveDetector(detector);
+	else
+	  G4cout << "ActarSimGeometryCache::Load(): unknown SD " << aux.value
+		 << " in " << volume->first->GetName() << G4endl;
+      }
+      else if(aux.type=="ActarSimRegion")
+	regionRoots.insert(std::make_pair(G4String(aux.value),volume->first));
+      else if(aux.type=="ActarSimWallCopyNumbers")
+	RestoreWall(volume->first,aux.value);
+      else if(aux.type=="ActarSimVis")
+	RestoreVisAttributes(volume->first,aux.value);
+    }
+  }
+  return world;
+#else
+  G4cout << "ActarSimGeometryCache::Load(): no GDML support, the geometry "
+	 << key << " is constructed" << G4endl;
+  return 0;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+/// Saves the world under the key, with the SDs, region roots and vis
+/// attributes of its logical volumes. The file is written with a
+/// temporary name and renamed, so that jobs sharing the cache never
+/// read a partial file
+G4bool ActarSimGeometryCache::Save(G4VPhysicalVolume* world, const G4String& key){
+#ifdef ACTARSIM_USE_GDML
+  G4String fileName = GetFileName(key);
+  std::ifstream cachedFile(fileName.c_str());
+  if(cachedFile.good()) return true;
+
+  mkdir(directory.c_str(),0755);
+
+  G4GDMLParser parser;
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  for(size_t i=0;i<store->size();i++){
+    G4LogicalVolume* volume = (*store)[i];
+    if(volume->GetSensitiveDetector()){
+      G4GDMLAuxStructType aux;
+      aux.type = "ActarSimSD";
+      aux.value = volume->GetSensitiveDetector()->GetName();
+      aux.unit = "";
+      aux.auxList = 0;
+      parser.AddVolumeAuxiliary(aux,volume);
+    }
+    if(volume->GetNoDaughters()==1 && volume->GetDaughter(0)->IsParameterised()){
+      ActarSimWallParameterisation* wall =
+	dynamic_cast<ActarSimWallParameterisation*>(volume->GetDaughter(0)->GetParameterisation());
+      if(wall){
+	std::ostringstream copyNumbers;
+	for(G4int element=0;element<wall->GetNumberOfElements();element++)
+	  copyNumbers << (element ? " " : "") << wall->GetCopyNumber(element);
+	G4GDMLAuxStructType aux;
+	aux.type = "ActarSimWallCopyNumbers";
+	aux.value = copyNumbers.str();
+	aux.unit = "";
+	aux.auxList = 0;
+	parser.AddVolumeAuxiliary(aux,volume);
+      }
+    }
+    if(volume->GetVisAttributes()){
+      const G4VisAttributes* vis = volume->GetVisAttributes();
+      const G4Colour& colour = vis->GetColour();
+      std::ostringstream visValue;
+      visValue << vis->IsVisible() << " " << colour.GetRed() << " " << colour.GetGreen()
+	       << " " << colour.GetBlue() << " " << colour.GetAlpha();
+      G4GDMLAuxStructType aux;
+      aux.type = "ActarSimVis";
+      aux.value = visValue.str();
+      aux.unit = "";
+      aux.auxList = 0;
+      parser.AddVolumeAuxiliary(aux,volume);
+    }
+    if(volume->IsRootRegion() && volume->GetRegion() &&
+       volume->GetRegion()->GetName()!="DefaultRegionForTheWorld"){
+      G4GDMLAuxStructType aux;
+      aux.type = "ActarSimRegion";
+      aux.value = volume->GetRegion()->GetName();
+      aux.unit = "";
+      aux.auxList = 0;
+      parser.AddVolumeAuxiliary(aux,volume);
+    }
+  }
+
+  std::ostringstream tempName;
+  tempName << fileName << "." << getpid() << ".tmp";
+  parser.Write(tempName.str(),world);
+  if(std::rename(tempName.str().c_str(),fileName.c_str())!=0){
+    G4cout << "ActarSimGeometryCache::Save(): cannot write " << fileName << G4endl;
+    std::remove(tempName.str().c_str());
+    return false;
+  }
+  G4cout << "ActarSimGeometryCache::Save(): geometry saved in " << fileName << G4endl;
+  return true;
+#else
+  if(world){;}
+  G4cout << "ActarSimGeometryCache::Save(): no GDML support, the geometry "
+	 << key << " is not saved" << G4endl;
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+/// Gives the volume and its daughters the materials existing before the
+/// GDML file was read (the first existingMaterials of the table) with
+/// the names of the materials created by the reader. If a name is
+/// repeated, the latest material is used, as G4Material::GetMaterial()
+/// is not used to find them
+void ActarSimGeometryCache::RestoreMaterials(G4LogicalVolume* volume, size_t existingMaterials,
+					     std::set<G4LogicalVolume*>& visited){
+  if(!visited.insert(volume).second) return;
+
+  G4Material* loaded = volume->GetMaterial();
+  if(loaded && loaded->GetIndex()>=existingMaterials){
+    const G4MaterialTable* table = G4Material::GetMaterialTable();
+    G4Material* existing = 0;
+    for(size_t i=0;i<existingMaterials;i++)
+      if((*table)[i]->GetName()==loaded->GetName()) existing = (*table)[i];
+    if(existing) volume->SetMaterial(existing);
+    else
+      G4cout << "ActarSimGeometryCache::Load(): material " << loaded->GetName()
+	     << " of " << volume->GetName() << " only defined in the cache file" << G4endl;
+  }
+
+  for(G4int i=0;i<(G4int)volume->GetNoDaughters();i++)
+    RestoreMaterials(volume->GetDaughter(i)->GetLogicalVolume(),existingMaterials,visited);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Gives the volume the visibility and colour saved in the cache
+/// ("visible red green blue alpha"). The invisible volumes share
+/// G4VisAttributes::Invisible, as in the construction
+void ActarSimGeometryCache::RestoreVisAttributes(G4LogicalVolume* volume,
+						 const G4String& attributes){
+  std::istringstream values(attributes);
+  G4int visible;
+  G4double red, green, blue, alpha;
+  if(!(values >> visible >> red >> green >> blue >> alpha)){
+    G4cout << "ActarSimGeometryCache::Load(): wrong vis attributes in "
+	   << volume->GetName() << G4endl;
+    return;
+  }
+  if(!visible){
+    volume->SetVisAttributes(G4VisAttributes::Invisible);
+    return;
+  }
+  G4VisAttributes* vis = new G4VisAttributes(G4Colour(red,green,blue,alpha));
+  vis->SetVisibility(true);
+  volume->SetVisAttributes(vis);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Replaces the GDML parameterised volume of a wall envelope by an
+/// ActarSimWallParameterisation with the same elements and the saved
+/// copy numbers, so the SDs keep the detector IDs of the constructed
+/// geometry
+void ActarSimGeometryCache::RestoreWall(G4LogicalVolume* envelope, const G4String& copyNumbers){
+  if(envelope->GetNoDaughters()!=1 || !envelope->GetDaughter(0)->IsParameterised()) return;
+  G4VPhysicalVolume* loaded = envelope->GetDaughter(0);
+  G4VPVParameterisation* parameterisation = loaded->GetParameterisation();
+
+  ActarSimWallParameterisation* wall = new ActarSimWallParameterisation();
+  std::istringstream list(copyNumbers);
+  G4int copyNo = 0;
+  for(G4int element=0;element<loaded->GetMultiplicity() && list >> copyNo;element++){
+    parameterisation->ComputeTransformation(element,loaded);
+    wall->AddElement(loaded->GetRotation(),loaded->GetTranslation(),copyNo);
+  }
+  if(wall->GetNumberOfElements()!=loaded->GetMultiplicity()){
+    G4cout << "ActarSimGeometryCache::Load(): wrong copy numbers in "
+	   << envelope->GetName() << ", elements numbered from 0" << G4endl;
+    delete wall;
+    return;
+  }
+
+  envelope->RemoveDaughter(loaded);
+  new G4PVParameterised(loaded->GetName(),loaded->GetLogicalVolume(),envelope,
+			kUndefined,wall->GetNumberOfElements(),wall);
+  //the GDML parameterisation is owned by neither the reader nor the volume
+  delete loaded;
+  delete parameterisation;
+}
@@ -60,13 +60,14 @@ ActarSimKinePrimGenerator::ActarSimKinePrimGenerator() {
   }
 
   NoSolution=FALSE;
+  verbose=1;
 }
 
 //////////////////////////////////////////////////////////////////
 /// Destructor
 ActarSimKinePrimGenerator::~ActarSimKinePrimGenerator() {
-  delete ANGAs;
-  delete ANGAr;
+  delete [] ANGAs;
+  delete [] ANGAr;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -101,6 +102,8 @@ void ActarSimKinePrimGenerator::KineKinematics() {
   G4double beta=pb/(eb+wm2);
   G4double gamma=1.0/sqrt(1.0-beta*beta);
 
+  NoSolution=FALSE;
+
   G4double thetacms=thetacmsInput*rad2deg;  // degree to radian
 
   G4double thetacmr=PI-thetacms;
@@ -110,7 +113,7 @@ void ActarSimKinePrimGenerator::KineKinematics() {
   G4double t_cm  = e_cm-wm3-wm4;
 
   if(t_cm<0.0){
-    G4cout << "Kine No solution!";
+    if(verbose>0) G4cout << "Kine No solution!";
     NoSolution=TRUE;
     return;
   }
@@ -0,0 +1,276 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimKinematicsTable
+/// Binary reaction kinematics tabulated on a grid of beam energies
+/// and angles (from 0 to pi). The angle is the lab angle of the
+/// scattered particle for CINE (up to two solutions) and the CM angle
+/// for KINE (one solution). The table is filled once using the CINE
+/// or KINE calculations and the values for each event are obtained
+/// by bilinear interpolation. GetSolution() returns false if any of
+/// the surrounding nodes has no solution or if the point is outside
+/// the grid; the caller should then make the exact calculation.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimKinematicsTable.hh"
+#include "ActarSimCinePrimGenerator.hh"
+#include "ActarSimKinePrimGenerator.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimKinematicsTable::ActarSimKinematicsTable()
+  :nEnergies(0), energyMin(0.), energyStep(0.), nAngles(0) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimKinematicsTable::~ActarSimKinematicsTable(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties the table. It is built again before the next use
+void ActarSimKinematicsTable::Clear(){
+  nEnergies = 0;
+  nAngles = 0;
+  theta3.clear();
+  energy3.clear();
+  theta4.clear();
+  energy4.clear();
+  valid.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the grid. With a single energy node only eMin is used
+void ActarSimKinematicsTable::Allocate(G4double eMin, G4double eMax, G4int nE, G4int nA){
+  nEnergies = (nE>1) ? nE : 1;
+  nAngles = (nA>2) ? nA : 2;
+  energyMin = eMin;
+  energyStep = (nEnergies>1) ? (eMax-eMin)/(nEnergies-1) : 0.;
+
+  size_t size = (size_t)nEnergies*nAngles*2;
+  theta3.assign(size,0.);
+  energy3.assign(size,0.);
+  theta4.assign(size,0.);
+  energy4.assign(size,0.);
+  valid.assign(size,0);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Fills the table using CINE. The angle is the lab angle of the
+/// scattered particle; the two solutions are stored
+void ActarSimKinematicsTable::BuildFromCine(ActarSimCinePrimGenerator* cine,
+					    G4double eMin, G4double eMax, G4int nE, G4int nA){
+  Allocate(eMin,eMax,nE,nA);
+
+  for(G4int iE=0;iE<nEnergies;iE++){
+    cine->SetLabEnergy((energyMin+iE*energyStep)/MeV);
+    for(G4int iA=0;iA<nAngles;iA++){
+      G4double angle = iA*pi/(nAngles-1);
+      cine->SetThetaLabAngle(angle/deg);
+      cine->RelativisticKinematics();
+      if(cine->GetANGAV(1)<0) continue;
+
+      size_t node = ((size_t)iE*nAngles+iA)*2;
+      theta3[node] = angle;
+      energy3[node] = cine->GetANGAV(1)*MeV;
+      theta4[node] = cine->GetANGAV(4)*deg;
+      energy4[node] = cine->GetANGAV(5)*MeV;
+      valid[node] = 1;
+      if(cine->GetANGAR(1)<0) continue;
+
+      theta3[node+1] = angle;
+      energy3[node+1] = cine->GetANGAR(1)*MeV;
+      theta4[node+1] = cine->GetANGAR(4)*deg;
+      energy4[node+1] = cine->GetANGAR(5)*MeV;
+      valid[node+1] = 1;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Fills the table using KINE. The angle is the CM angle of the
+/// scattered particle; there is a single solution
+void ActarSimKinematicsTable::BuildFromKine(ActarSimKinePrimGenerator* kine,
+					    G4double eMin, G4double eMax, G4int nE, G4int nA){
+  Allocate(eMin,eMax,nE,nA);
+
+  for(G4int iE=0;iE<nEnergies;iE++){
+    kine->SetLabEnergy((energyMin+iE*energyStep)/MeV);
+    for(G4int iA=0;iA<nAngles;iA++){
+      G4double angle = iA*pi/(nAngles-1);
+      kine->SetThetaCMAngle(angle/deg);
+      kine->KineKinematics();
+      if(kine->GetNoSolution()) continue;
+
+      size_t node = ((size_t)iE*nAngles+iA)*2;
+      theta3[node] = kine->GetANGAs(0);
+      energy3[node] = kine->GetANGAs(1)*MeV;
+      theta4[node] = kine->GetANGAr(0);
+      energy4[node] = kine->GetANGAr(1)*MeV;
+      valid[node] = 1;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Lower node and fraction to the next node, for energy and angle
+G4bool ActarSimKinematicsTable::Locate(G4double energy, G4double angle,
+				       G4int& iE, G4double& fE, G4int& iA, G4double& fA) const {
+  if(nEnergies==0) return false;
+
+  if(nEnergies==1){
+    if(std::fabs(energy-energyMin) > 1e-9*std::fabs(energyMin)) return false;
+    iE = 0;
+    fE = 0.;
+  }
+  else {
+    G4double pos = (energy-energyMin)/energyStep;
+    if(pos<0. || pos>nEnergies-1) return false;
+    iE = (G4int)pos;
+    if(iE>nEnergies-2) iE = nEnergies-2;
+    fE = pos-iE;
+  }
+
+  G4double pos = angle*(nAngles-1)/pi;
+  if(pos<0. || pos>nAngles-1) return false;
+  iA = (G4int)pos;
+  if(iA>nAngles-2) iA = nAngles-2;
+  fA = pos-iA;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Interpolated solution (0 or 1) for a beam energy and an angle
+/// (see the class description). Returns false if not available
+G4bool ActarSimKinematicsTable::GetSolution(G4double energy, G4double angle, G4int solution,
+					    G4double& th3, G4double& e3,
+					    G4double& th4, G4double& e4) const {
+  G4int iE, iA;
+  G4double fE, fA;
+  if(solution<0 || solution>1 || !Locate(energy,angle,iE,fE,iA,fA)) return false;
+
+  th3 = e3 = th4 = e4 = 0.;
+  for(G4int dE=0;dE<2;dE++){
+    G4double wE = dE ? fE : 1.-fE;
+    if(wE==0.) continue;
+    for(G4int dA=0;dA<2;dA++){
+      G4double w = wE*(dA ? fA : 1.-fA);
+      if(w==0.) continue;
+      size_t node = ((size_t)(iE+dE)*nAngles+iA+dA)*2+solution;
+      if(!valid[node]) return false;
+      th3 += w*theta3[node];
+      e3 += w*energy3[node];
+      th4 += w*theta4[node];
+      e4 += w*energy4[node];
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Number of solutions (0, 1 or 2) if all the surrounding nodes
+/// agree, or -1 if they do not or the point is outside the grid
+G4int ActarSimKinematicsTable::GetNumberOfSolutions(G4double energy, G4double angle) const {
+  G4int iE, iA;
+  G4double fE, fA;
+  if(!Locate(energy,angle,iE,fE,iA,fA)) return -1;
+
+  G4int nSolutions = -1;
+  for(G4int dE=0;dE<2;dE++){
+    if((dE ? fE : 1.-fE)==0.) continue;
+    for(G4int dA=0;dA<2;dA++){
+      if((dA ? fA : 1.-fA)==0.) continue;
+      size_t node = ((size_t)(iE+dE)*nAngles+iA+dA)*2;
+      G4int n = valid[node] + valid[node+1];
+      if(nSolutions<0) nSolutions = n;
+      else if(n!=nSolutions) return -1;
+    }
+  }
+  return nSolutions;
+}
+
+//////////////////////////////////////////////////////////////////
+/// True if the angular bin iA has solution in both ends, for the two
+/// energy nodes around the energy located in (iE,fE)
+G4bool ActarSimKinematicsTable::IsValidBin(G4int iE, G4double fE, G4int iA) const {
+  for(G4int dE=0;dE<2;dE++){
+    if(dE && fE==0.) continue;
+    size_t node = ((size_t)(iE+dE)*nAngles+iA)*2;
+    if(!valid[node] || !valid[node+2]) return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Length of the region between aMin and aMax where the table has (at
+/// least one) solution for this energy, the region sampled by
+/// SampleAngle(). Zero if there is no solution in the range
+G4double ActarSimKinematicsTable::GetValidLength(G4double energy, G4double aMin,
+						 G4double aMax) const {
+  G4double angle;
+  return ScanValidRegion(energy,aMin,aMax,-1.,angle);
+}
+
+//////////////////////////////////////////////////////////////////
+/// True if the angle is in the region with solution for this energy
+/// (see GetValidLength())
+G4bool ActarSimKinematicsTable::IsValidAngle(G4double energy, G4double angle) const {
+  G4int iE, iA;
+  G4double fE, fA;
+  if(!Locate(energy,angle,iE,fE,iA,fA)) return false;
+  return IsValidBin(iE,fE,iA);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Samples an angle between aMin and aMax with flat probability in
+/// the region where the table has (at least one) solution for this
+/// energy. Returns false if there is no solution in the range
+G4bool ActarSimKinematicsTable::SampleAngle(G4double energy, G4double aMin, G4double aMax,
+					    G4double& angle) const {
+  G4double total = GetValidLength(energy,aMin,aMax);
+  if(total<=0.) return false;
+  return ScanValidRegion(energy,aMin,aMax,total*G4UniformRand(),angle) < 0.;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Walks the angular bins between aMin and aMax with solution for this
+/// energy, adding their lengths. If target is not negative, stops at
+/// the angle where the length reaches target, returning -1 and the
+/// angle. Otherwise (or if target is not reached) returns the length
+G4double ActarSimKinematicsTable::ScanValidRegion(G4double energy, G4double aMin, G4double aMax,
+						  G4double target, G4double& angle) const {
+  G4int iE, iA;
+  G4double fE, fA;
+  if(!Locate(energy,0.,iE,fE,iA,fA)) return 0.;
+
+  const G4double angleStep = pi/(nAngles-1);
+  G4int iMin = (G4int)(aMin/angleStep);
+  G4int iMax = (G4int)(aMax/angleStep);
+  if(iMin<0) iMin = 0;
+  if(iMax>nAngles-2) iMax = nAngles-2;
+
+  //length of each angular bin with solution in both ends (and energies)
+  G4double sum = 0.;
+  for(G4int i=iMin;i<=iMax;i++){
+    if(!IsValidBin(iE,fE,i)) continue;
+    G4double low = (i*angleStep>aMin) ? i*angleStep : aMin;
+    G4double high = ((i+1)*angleStep<aMax) ? (i+1)*angleStep : aMax;
+    if(high<=low) continue;
+    if(target>=0. && sum+(high-low)>=target){
+      angle = low + (target-sum);
+      return -1.;
+    }
+    sum += high-low;
+  }
+  return sum;
+}
@@ -6,6 +6,7 @@
 
 #pragma link C++ class ActarSimData;
 #pragma link C++ class ActarSimTrack;
+#pragma link C++ class ActarSimEventTracks;
 #pragma link C++ class ActarSimSimpleTrack;
 #pragma link C++ class ActarSimSilHit;
 #pragma link C++ class ActarSimSilRingHit;
@@ -0,0 +1,251 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimMaterialRegistry
+/// Registry of the elements and of the gas materials. Each element is
+/// created once, on its first request, and shared by all the materials
+/// (ActarSimDetectorConstruction::DefineMaterials() and the gases).
+/// The gases (H2, D2, He, Ar, CF4, CH4, iC4H10 and their mixtures) are
+/// built when first requested for a pressure and temperature and kept,
+/// so the same conditions always give the same G4Material: a pressure
+/// or temperature scan creates one material per point and coming back
+/// to a previous point does not create a new one (nor new physics
+/// tables). The first material of a gas keeps the gas name (as found by
+/// G4Material::GetMaterial()); the following ones are named after
+/// their conditions.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimMaterialRegistry.hh"
+
+#include "G4Element.hh"
+#include "G4Isotope.hh"
+#include "G4Material.hh"
+#include "G4ios.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+#include <vector>
+
+namespace {
+  /// Elements of the registry (name, symbol, Z, A in g/mole)
+  struct ElementData {
+    const char* name;
+    const char* symbol;
+    G4double z;
+    G4double a;
+  };
+
+  const ElementData elementData[] = {
+    {"Hydrogen" ,"H" , 1.,    1.00794},
+    {"Helium"   ,"He", 2.,     4.0026},
+    {"Carbon"   ,"C" , 6.,    12.0107},
+    {"Nitrogen" ,"N" , 7.,   14.00674},
+    {"Oxygen"   ,"O" , 8.,    15.9994},
+    {"Fluorine" ,"F" , 9., 18.9984032},
+    {"Sodium"   ,"Na",11.,   22.98977},
+    {"Sulphur"  ,"S" ,16.,     32.066},
+    {"Argon"    ,"Ar",18.,    39.9481},
+    {"Zinc"     ,"Zn",30.,      65.39},
+    {"Germanium","Ge",32.,      72.61},
+    {"Bromine"  ,"Br",35.,     79.904},
+    {"Cadmium"  ,"Cd",48.,    112.411},
+    {"Tellurium","Te",52.,     127.60},
+    {"Iodine"   ,"I" ,53.,  126.90447},
+    {"Cesium"   ,"Cs",55.,  132.90545},
+    {"Barium"   ,"Ba",56.,    137.327},
+    {"Lanthanum","La",57.,   138.9055},
+    {"Cerium"   ,"Ce",58.,    140.116},
+    {"Lutecium" ,"Lu",71.,    174.967},
+    {"Tungsten" ,"W" ,74.,     183.84},
+    {"Lead"     ,"Pb",82.,     207.20},
+    {"Bismuth"  ,"Bi",83.,  208.98038}
+  };
+  const G4int numberOfElements = sizeof(elementData)/sizeof(ElementData);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimMaterialRegistry::ActarSimMaterialRegistry(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor. Elements and materials belong to the Geant4 tables
+ActarSimMaterialRegistry::~ActarSimMaterialRegistry(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Element of the symbol, created on the first request. Deuterium
+/// (D) is made of the 2H isotope. Returns 0 for an unknown symbol
+G4Element* ActarSimMaterialRegistry::GetElement(const G4String& symbol){
+  std::map<G4String,G4Element*>::iterator found = elements.find(symbol);
+  if(found!=elements.end()) return found->second;
+
+  G4Element* element = 0;
+  if(symbol=="D"){
+    G4double z, a, abundance;
+    G4int n, ncomponents;
+    G4Isotope* iso_H2 = new G4Isotope("iso_H2",z=1,n=2, a=2.0140*g/mole);
+    element = new G4Element("Deuterium","D" , ncomponents=1);
+    element->AddIsotope(iso_H2, abundance = 100.*perCent);
+  }
+  else {
+    for(G4int i=0;i<numberOfElements;i++)
+      if(symbol==elementData[i].symbol)
+	element = new G4Element(elementData[i].name,elementData[i].symbol,
+				elementData[i].z,elementData[i].a*g/mole);
+  }
+  if(!element){
+    G4cout << "ActarSimMaterialRegistry::GetElement(): unknown element "
+	   << symbol << G4endl;
+    return 0;
+  }
+  elements[symbol] = element;
+  return element;
+}
+
+//////////////////////////////////////////////////////////////////
+/// True if the gas is one of the gases of the registry
+G4bool ActarSimMaterialRegistry::IsGas(const G4String& gas) const {
+  return gas=="H2" || gas=="D2" || gas=="He" || gas=="Ar" ||
+    gas=="CF4" || gas=="CH4" || gas=="iC4H10";
+}
+
+//////////////////////////////////////////////////////////////////
+/// Key of a gas at a pressure and temperature
+G4String ActarSimMaterialRegistry::GetGasKey(const G4String& gas, G4double pressure,
+					     G4double temperature) const {
+  std::ostringstream key;
+  key.precision(10);
+  key << gas << "_" << pressure/bar << "bar_" << temperature/kelvin << "K";
+  return key.str();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Name of a new material: the base name if it is not used, else
+/// the key
+G4String ActarSimMaterialRegistry::GetNewMaterialName(const G4String& base,
+						      const G4String& key) const {
+  if(!G4Material::GetMaterial(base,false)) return base;
+  return key;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Gas material at the pressure and temperature, built on the first
+/// request. Returns 0 if the gas is not in the registry
+G4Material* ActarSimMaterialRegistry::GetGas(const G4String& gas, G4double pressure,
+					     G4double temperature){
+  if(!IsGas(gas)) return 0;
+  G4String key = GetGasKey(gas,pressure,temperature);
+  std::map<G4String,G4Material*>::iterator found = gases.find(key);
+  if(found!=gases.end()) return found->second;
+
+  G4Material* material = BuildGas(gas,key,pressure,temperature);
+  gases[key] = material;
+  return material;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Builds a gas as an ideal gas at the pressure and temperature
+G4Material* ActarSimMaterialRegistry::BuildGas(const G4String& gas, const G4String& key,
+					       G4double pressure, G4double temperature){
+  G4String name = GetNewMaterialName(gas,key);
+  G4double density, z, a;
+  G4int ncomponents, natoms;
+
+  //molar volume (l/mol)
+  G4double Vm=0.08206*temperature*atmosphere/(pressure*kelvin);
+
+  G4Material* material = 0;
+  if(gas=="H2"){
+    //H2 (default  0.083812*mg/cm3 STP)
+    density = (2*1.00794/Vm)*mg/cm3;
+    material = new G4Material(name, density, ncomponents=2, kStateGas, temperature, pressure);
+    material->AddElement(GetElement("H"), natoms=1);
+    material->AddElement(GetElement("H"), natoms=1);
+  }
+  else if(gas=="D2"){
+    //D2 (default  0.16746*mg/cm3 STP)
+    density = (2*2.0140/Vm)*mg/cm3;
+    material = new G4Material(name, density, ncomponents=2, kStateGas, temperature, pressure);
+    material->AddElement(GetElement("D"), natoms=1);
+    material->AddElement(GetElement("D"), natoms=1);
+  }
+  else if(gas=="He"){
+    //He (default  0.16642*mg/cm3 STP)
+    density = (4.0026/Vm)*mg/cm3;
+    material = new G4Material(name, z=2, a=4.0026*g/mole, density, kStateGas, temperature, pressure);
+  }
+  else if(gas=="Ar"){
+    density = (39.9481/Vm)*mg/cm3;
+    material = new G4Material(name, z=18, a=39.9481*g/mole, density, kStateGas, temperature, pressure);
+  }
+  else if(gas=="CF4"){
+    //CF4 (default  3.6586*mg/cm3 STP)
+    density = ((12.0107+4*18.9984032)/Vm)*mg/cm3;
+    material = new G4Material(name, density, ncomponents=2, kStateGas, temperature, pressure);
+    material->AddElement(GetElement("C"), natoms=1);
+    material->AddElement(GetElement("F"), natoms=4);
+  }
+  else if(gas=="CH4"){
+    //Methane (default  0.66697*mg/cm3 STP)
+    density = ((12.0107+4*1.00794)/Vm)*mg/cm3;
+    material = new G4Material(name, density, ncomponents=2, kStateGas, temperature, pressure);
+    material->AddElement(GetElement("C"),1);
+    material->AddElement(GetElement("H"),4);
+  }
+  else if(gas=="iC4H10"){
+    //Isobutane (default  2.41464*mg/cm3 STP)
+    density = ((4*12.0107+10*1.00794)/Vm)*mg/cm3;
+    material = new G4Material(name, density, ncomponents=2, kStateGas, temperature, pressure);
+    material->AddElement(GetElement("C"),4);
+    material->AddElement(GetElement("H"),10);
+  }
+  return material;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Mixture of numberOfGases gases of the registry with the ratios
+/// (fractions in volume), at the pressure and temperature. Built on
+/// the first request; returns 0 if a gas is not in the registry
+G4Material* ActarSimMaterialRegistry::GetGasMixture(G4int numberOfGases, const G4String* gas,
+						    const G4double* ratio, G4double pressure,
+						    G4double temperature){
+  std::ostringstream mixture;
+  mixture.precision(10);
+  mixture << "GasMix";
+  for(G4int i=0;i<numberOfGases;i++){
+    if(!IsGas(gas[i])){
+      G4cout << "ActarSimMaterialRegistry::GetGasMixture(): unknown gas "
+	     << gas[i] << G4endl;
+      return 0;
+    }
+    mixture << "_" << gas[i] << "_" << ratio[i];
+  }
+  G4String key = GetGasKey(mixture.str(),pressure,temperature);
+  std::map<G4String,G4Material*>::iterator found = gases.find(key);
+  if(found!=gases.end()) return found->second;
+
+  //the components are the gases at the same conditions
+  std::vector<G4Material*> component(numberOfGases);
+  G4double density = 0.;
+  for(G4int i=0;i<numberOfGases;i++){
+    component[i] = GetGas(gas[i],pressure,temperature);
+    density += ratio[i]*component[i]->GetDensity();
+  }
+
+  G4Material* material =
+    new G4Material(GetNewMaterialName("GasMix",key), density, numberOfGases,
+		   kStateGas, temperature, pressure);
+  for(G4int i=0;i<numberOfGases;i++)
+    material->AddMaterial(component[i], ratio[i]*component[i]->GetDensity()/density);
+
+  gases[key] = material;
+  return material;
+}
@@ -0,0 +1,315 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimPhaseSpaceGenerator
+/// N-body phase space generator for breakup channels (Raubold-Lynch
+/// algorithm, as GENBOD or ROOT TGenPhaseSpace). The initial system is
+/// the beam, moving along Z, on the target at rest. When the beam
+/// energy is fixed the events are generated in batches of batchSize,
+/// stored by body and event in contiguous arrays, so the successive
+/// two-body decays and the Lorentz boosts are done in loops over the
+/// events of the batch that the compiler can vectorize. A batch is
+/// valid only for one CM energy, so when the beam energy changes from
+/// event to event (beamInteraction on) the events are generated one by
+/// one; in the unweighted mode each trial of the hit or miss selection
+/// is then a new event.
+/// The phase space weight can be multiplied by a matrix element (see
+/// ActarSimPhaseSpaceWeight). In the weighted mode all the events are
+/// used and the primaries carry the weight, normalized to the maximum;
+/// in the unweighted mode the events are selected with probability
+/// equal to this normalized weight and the primaries have weight one.
+/// Each product is placed in its own primary vertex, as the analysis
+/// takes the first two vertexes as Prim1 and Prim2.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimPhaseSpaceGenerator.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleTable.hh"
+#include "G4IonTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <sstream>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimPhaseSpaceGenerator::ActarSimPhaseSpaceGenerator()
+  :matrixElement(0), weightedFlag(false), batchSize(1000),
+   batchMass(0.), batchBeta(0.), maximumWeight(0.), eventsInBatch(0), nextEvent(0),
+   numberOfBatches(0) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimPhaseSpaceGenerator::~ActarSimPhaseSpaceGenerator(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Discards the events of the present batch
+void ActarSimPhaseSpaceGenerator::Clear(){
+  batchMass = 0.;
+  batchBeta = 0.;
+  maximumWeight = 0.;
+  eventsInBatch = 0;
+  nextEvent = 0;
+  weight.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the products from a list of names separated by spaces: names
+/// of the particle table (proton, neutron, alpha, ...) or ions as Z:A
+/// (ground state). Returns false (and keeps the previous list) if any
+/// name is not valid or there are less than two products
+G4bool ActarSimPhaseSpaceGenerator::SetProducts(G4String names){
+  std::vector<G4ParticleDefinition*> newProducts;
+  std::istringstream list(names);
+  std::string name;
+  while(list >> name) {
+    G4ParticleDefinition* definition = 0;
+    size_t colon = name.find(':');
+    if(colon!=std::string::npos) {
+      G4int Z = atoi(name.substr(0,colon).c_str());
+      G4int A = atoi(name.substr(colon+1).c_str());
+      if(Z>0 && A>=Z) definition = G4IonTable::GetIonTable()->GetIon(Z,A,0.);
+    }
+    else
+      definition = G4ParticleTable::GetParticleTable()->FindParticle(name);
+    if(!definition) {
+      G4cout << "ActarSimPhaseSpaceGenerator::SetProducts() - ERROR: unknown particle "
+	     << name << ". Products not changed." << G4endl;
+      return false;
+    }
+    newProducts.push_back(definition);
+  }
+  if(newProducts.size()<2) {
+    G4cout << "ActarSimPhaseSpaceGenerator::SetProducts() - ERROR: at least two"
+	   << " products are needed. Products not changed." << G4endl;
+    return false;
+  }
+
+  products = newProducts;
+  masses.clear();
+  for(size_t i=0;i<products.size();i++) masses.push_back(products[i]->GetPDGMass());
+  Clear();
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Momentum of the products in the two-body decay of a mass a into
+/// masses b and c
+G4double ActarSimPhaseSpaceGenerator::Pdk(G4double a, G4double b, G4double c){
+  G4double x = (a-b-c)*(a+b+c)*(a-b+c)*(a+b-c);
+  return (x>0.) ? std::sqrt(x)/(2.*a) : 0.;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Generates eventsInBatch events for the CM energy batchMass, moving
+/// with velocity batchBeta along Z
+void ActarSimPhaseSpaceGenerator::GenerateBatch(){
+  const G4int nBodies = (G4int)masses.size();
+  const G4int nEvents = eventsInBatch;
+  const G4int nRandom = 3*nBodies-4;
+  numberOfBatches++;
+
+  px.assign(nBodies*nEvents,0.);
+  py.assign(nBodies*nEvents,0.);
+  pz.assign(nBodies*nEvents,0.);
+  e.assign(nBodies*nEvents,0.);
+  weight.assign(nEvents,1.);
+  random.resize(nRandom*nEvents);
+  G4RandFlat::shootArray(nRandom*nEvents,&random[0]);
+
+  G4double sumMass = 0.;
+  for(G4int k=0;k<nBodies;k++) sumMass += masses[k];
+  const G4double kineticCM = batchMass - sumMass;
+
+  // invariant masses of the subsystems of the k+1 first products: the
+  // n-2 random numbers of each event are sorted (few, insertion sort)
+  std::vector<G4double> invMass(nBodies*nEvents);
+  std::vector<G4double> sorted(nBodies);
+  for(G4int i=0;i<nEvents;i++) {
+    const G4double* r = &random[i*nRandom];
+    G4int nSorted = 0;
+    for(G4int k=0;k<nBodies-2;k++) {
+      G4int j = nSorted++;
+      while(j>0 && sorted[j-1]>r[k]) {sorted[j] = sorted[j-1]; j--;}
+      sorted[j] = r[k];
+    }
+    G4double partialMass = masses[0];
+    invMass[i] = masses[0];
+    for(G4int k=1;k<nBodies-1;k++) {
+      partialMass += masses[k];
+      invMass[k*nEvents+i] = partialMass + sorted[k-1]*kineticCM;
+    }
+    invMass[(nBodies-1)*nEvents+i] = batchMass;
+  }
+
+  // momenta in the two-body decays and phase space weight
+  std::vector<G4double> pd((nBodies-1)*nEvents);
+  for(G4int k=0;k<nBodies-1;k++) {
+    G4double* p = &pd[k*nEvents];
+    const G4double* upper = &invMass[(k+1)*nEvents];
+    const G4double* lower = &invMass[k*nEvents];
+    const G4double m = masses[k+1];
+    for(G4int i=0;i<nEvents;i++) {
+      p[i] = Pdk(upper[i],lower[i],m);
+      weight[i] *= p[i];
+    }
+  }
+
+  // first two products back to back along Y in the frame of the first subsystem
+  for(G4int i=0;i<nEvents;i++) {
+    py[i] = pd[i];
+    e[i] = std::sqrt(pd[i]*pd[i]+masses[0]*masses[0]);
+  }
+  std::vector<G4double> cosZ(nEvents), sinZ(nEvents), cosY(nEvents), sinY(nEvents), beta(nEvents);
+  for(G4int k=1;k<nBodies;k++) {
+    const G4double* p = &pd[(k-1)*nEvents];
+    for(G4int i=0;i<nEvents;i++) {
+      py[k*nEvents+i] = -p[i];
+      e[k*nEvents+i] = std::sqrt(p[i]*p[i]+masses[k]*masses[k]);
+    }
+    // random rotation of the subsystem (around Z, then around Y)
+    for(G4int i=0;i<nEvents;i++) {
+      const G4double* r = &random[i*nRandom+nBodies-2+2*(k-1)];
+      cosZ[i] = 2.*r[0]-1.;
+      sinZ[i] = std::sqrt(1.-cosZ[i]*cosZ[i]);
+      cosY[i] = std::cos(twopi*r[1]);
+      sinY[i] = std::sin(twopi*r[1]);
+    }
+    for(G4int j=0;j<=k;j++) {
+      G4double* x = &px[j*nEvents];
+      G4double* y = &py[j*nEvents];
+      G4double* z = &pz[j*nEvents];
+      for(G4int i=0;i<nEvents;i++) {
+	G4double xr = cosZ[i]*x[i] - sinZ[i]*y[i];
+	y[i] = sinZ[i]*x[i] + cosZ[i]*y[i];
+	x[i] = cosY[i]*xr - sinY[i]*z[i];
+	z[i] = sinY[i]*xr + cosY[i]*z[i];
+      }
+    }
+    if(k==nBodies-1) break;
+    // boost along Y to the frame of the next subsystem
+    const G4double* pNext = &pd[k*nEvents];
+    const G4double* mass = &invMass[k*nEvents];
+    for(G4int i=0;i<nEvents;i++)
+      beta[i] = pNext[i]/std::sqrt(pNext[i]*pNext[i]+mass[i]*mass[i]);
+    for(G4int j=0;j<=k;j++) {
+      G4double* y = &py[j*nEvents];
+      G4double* en = &e[j*nEvents];
+      for(G4int i=0;i<nEvents;i++) {
+	G4double gamma = 1./std::sqrt(1.-beta[i]*beta[i]);
+	G4double yb = gamma*(y[i]+beta[i]*en[i]);
+	en[i] = gamma*(en[i]+beta[i]*y[i]);
+	y[i] = yb;
+      }
+    }
+  }
+
+  // weights normalized to the maximum, including the matrix element
+  for(G4int i=0;i<nEvents;i++) weight[i] /= maximumWeight;
+  if(matrixElement) {
+    std::vector<G4LorentzVector> cm(nBodies);
+    G4double maximumME = matrixElement->GetMaximumWeight();
+    for(G4int i=0;i<nEvents;i++) {
+      for(G4int k=0;k<nBodies;k++)
+	cm[k].set(px[k*nEvents+i],py[k*nEvents+i],pz[k*nEvents+i],e[k*nEvents+i]);
+      weight[i] *= matrixElement->GetWeight(cm)/maximumME;
+    }
+  }
+
+  // boost from the CM to the laboratory, along Z
+  const G4double gammaLab = 1./std::sqrt(1.-batchBeta*batchBeta);
+  for(G4int j=0;j<nBodies;j++) {
+    G4double* z = &pz[j*nEvents];
+    G4double* en = &e[j*nEvents];
+    for(G4int i=0;i<nEvents;i++) {
+      G4double zb = gammaLab*(z[i]+batchBeta*en[i]);
+      en[i] = gammaLab*(en[i]+batchBeta*z[i]);
+      z[i] = zb;
+    }
+  }
+  nextEvent = 0;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds the products of the next event to anEvent, one vertex per
+/// product at the given position and time. The initial system is the
+/// beam with kinetic energy beamEnergy along Z on the target at rest.
+/// With fixedEnergy the events come from batches of batchSize; if not,
+/// each event is generated alone. Returns false if the reaction is
+/// closed or no event is selected
+G4bool ActarSimPhaseSpaceGenerator::GenerateEvent(G4Event* anEvent, const G4ThreeVector& position,
+						  G4double time,
+						  const G4ParticleDefinition* beam, G4double beamEnergy,
+						  const G4ParticleDefinition* target,
+						  G4bool fixedEnergy){
+  const G4int nBodies = (G4int)masses.size();
+  if(nBodies<2 || !beam || !target) return false;
+
+  G4double beamMass = beam->GetPDGMass();
+  G4double totalEnergy = beamEnergy + beamMass + target->GetPDGMass();
+  G4double beamMomentum = std::sqrt(beamEnergy*(beamEnergy+2.*beamMass));
+  G4double mass = std::sqrt(totalEnergy*totalEnergy-beamMomentum*beamMomentum);
+  G4double betaCM = beamMomentum/totalEnergy;
+
+  G4double sumMass = 0.;
+  for(G4int k=0;k<nBodies;k++) sumMass += masses[k];
+  if(mass<=sumMass) {
+    G4cout << "ActarSimPhaseSpaceGenerator::GenerateEvent() - ERROR: CM energy "
+	   << mass/MeV << " MeV below the threshold " << sumMass/MeV << " MeV." << G4endl;
+    return false;
+  }
+
+  // a new batch is needed if the CM energy or the batch mode changed
+  const G4int size = fixedEnergy ? batchSize : 1;
+  if(weight.empty() || mass!=batchMass || betaCM!=batchBeta || size!=eventsInBatch) {
+    eventsInBatch = size;
+    batchMass = mass;
+    batchBeta = betaCM;
+    maximumWeight = 1.;
+    G4double emmax = mass - sumMass + masses[0];
+    G4double emmin = 0.;
+    for(G4int k=1;k<nBodies;k++) {
+      emmin += masses[k-1];
+      emmax += masses[k];
+      maximumWeight *= Pdk(emmax,emmin,masses[k]);
+    }
+    GenerateBatch();
+  }
+
+  // next event of the batch (hit or miss in the unweighted mode)
+  G4int event = -1;
+  for(G4int tries=0;tries<100*batchSize && event<0;tries++) {
+    if(nextEvent>=eventsInBatch) GenerateBatch();
+    G4int i = nextEvent++;
+    if(weightedFlag || G4UniformRand()<weight[i]) event = i;
+  }
+  if(event<0) {
+    G4cout << "ActarSimPhaseSpaceGenerator::GenerateEvent() - ERROR: no event selected"
+	   << " in " << 100*batchSize << " tries. Check the matrix element weight." << G4endl;
+    return false;
+  }
+
+  for(G4int k=0;k<nBodies;k++) {
+    G4PrimaryParticle* particle = new G4PrimaryParticle(products[k],
+							px[k*eventsInBatch+event],
+							py[k*eventsInBatch+event],
+							pz[k*eventsInBatch+event]);
+    if(weightedFlag) particle->SetWeight(weight[event]);
+    G4PrimaryVertex* vertex = new G4PrimaryVertex(position,time);
+    vertex->SetPrimary(particle);
+    anEvent->AddPrimaryVertex(vertex);
+  }
+  return true;
+}
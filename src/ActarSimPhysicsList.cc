@@ -13,6 +13,9 @@
 
 #include "ActarSimPhysicsList.hh"
 #include "ActarSimPhysicsListMessenger.hh"
+#include "ActarSimPhysicsTableCache.hh"
+#include "ActarSimRegionSettings.hh"
+#include "ActarSimRangeTableService.hh"
 
 #include "G4EmStandardPhysics.hh"
 #include "G4EmStandardPhysics_option1.hh"
@@ -61,6 +64,8 @@
 #include "G4ParticleTable.hh"
 
 #include "G4IonPhysics.hh"
+#include "G4ProcessManager.hh"
+#include "G4FastSimulationManagerProcess.hh"
 
 //////////////////////////////////////////////////////////////////
 /// Constructor. Initializing values
@@ -74,6 +79,7 @@ ActarSimPhysicsList::ActarSimPhysicsList():  G4VModularPhysicsList(){
   gnucIsRegisted = false;
   gasIsRegisted = false;
   stopIsRegisted = false;
+  fastSimIsRegisted = false;
   verbose = 0;
   G4LossTableManager::Instance()->SetVerbose(verbose);
   //G4LossTableManager::Instance();
@@ -94,6 +100,10 @@ ActarSimPhysicsList::ActarSimPhysicsList():  G4VModularPhysicsList(){
   steplimiter = new ActarSimStepLimiterBuilder();
   //Trying to add PAI
   fConfig = G4LossTableManager::Instance()->EmConfigurator();
+
+  physicsTableCache = new ActarSimPhysicsTableCache();
+  regionSettings = new ActarSimRegionSettings();
+  rangeTableService = new ActarSimRangeTableService();
 }
 
 //////////////////////////////////////////////////////////////////
@@ -101,6 +111,9 @@ ActarSimPhysicsList::ActarSimPhysicsList():  G4VModularPhysicsList(){
 ActarSimPhysicsList::~ActarSimPhysicsList() {
   delete emPhysicsList;
   delete pMessenger;
+  delete physicsTableCache;
+  delete regionSettings;
+  delete rangeTableService;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -114,46 +127,57 @@ void ActarSimPhysicsList::AddPhysicsList(const G4String& name){
   if ((name == "emstandard") && !emBuilderIsRegisted) {
     RegisterPhysics(new G4EmStandardPhysics(1));
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "local" && !emBuilderIsRegisted) {
     emPhysicsList = new PhysListEmStandard(name);
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "emstandard_opt1" && !emBuilderIsRegisted) {
     RegisterPhysics(new G4EmStandardPhysics_option1());
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "emstandard_opt2" && !emBuilderIsRegisted) {
     RegisterPhysics(new G4EmStandardPhysics_option2());
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "emstandard_opt3" && !emBuilderIsRegisted) {
     RegisterPhysics(new G4EmStandardPhysics_option3());
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "emstandard_opt4" && !emBuilderIsRegisted) {
     RegisterPhysics(new G4EmStandardPhysics_option4());
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "emlivermore" && !emBuilderIsRegisted) {
     RegisterPhysics(new G4EmLivermorePhysics());
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "empenelope" && !emBuilderIsRegisted) {
     RegisterPhysics(new G4EmPenelopePhysics());
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "standardSS" && !emBuilderIsRegisted) {
     emPhysicsList = new PhysListEmStandardSS(name);
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "standardWVI" && !emBuilderIsRegisted) {
     emPhysicsList = new PhysListEmStandardWVI(name);
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "standardGS" && !emBuilderIsRegisted) {
     emPhysicsList = new PhysListEmStandardGS(name);
     emBuilderIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   }
 
@@ -169,41 +193,54 @@ void ActarSimPhysicsList::AddPhysicsList(const G4String& name){
     else {
       RegisterPhysics( new HadrontherapyIonStandard(name) );
       ionIsRegisted = true;
+      physicsNames += " " + name;
       G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
     }
   } else if (name == "ionGasModels" && !gasIsRegisted && emBuilderIsRegisted) {
     //AddPhysicsList("emstandard");
     AddIonGasModels();
     gasIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "elastic" && !helIsRegisted && emBuilderIsRegisted) {
     RegisterPhysics(new G4HadronElasticPhysics());
     helIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "binary" && !bicIsRegisted && emBuilderIsRegisted) {
     RegisterPhysics(new G4HadronInelasticQBBC());
     bicIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "binary_ion" && !ionIsRegisted && emBuilderIsRegisted) {
     RegisterPhysics(new G4IonBinaryCascadePhysics());
     ionIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "gamma_nuc" && !gnucIsRegisted && emBuilderIsRegisted) {
     RegisterPhysics(new G4EmExtraPhysics());
     gnucIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "stopping" && !stopIsRegisted && emBuilderIsRegisted) {
     RegisterPhysics(new G4StoppingPhysics());
     stopIsRegisted = true;
+    physicsNames += " " + name;
+    G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
+  } else if (name == "fastSim" && !fastSimIsRegisted) {
+    fastSimIsRegisted = true;
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if(!emBuilderIsRegisted) {
     G4cout << "PhysicsList::AddPhysicsList <" << name << ">"
            << " fail - EM physics should be registered first " << G4endl;
   } else if (name == "pai") {
     AddPAIModel(name);
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else if (name == "pai_photon") {
     AddPAIModel(name);
+    physicsNames += " " + name;
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">" << G4endl;
   } else {
     G4cout << "ActarSimPhysicsList::AddPhysicsList <" << name << ">"
@@ -288,6 +325,10 @@ void ActarSimPhysicsList::ConstructProcess() {
     AddTransportation();
     emPhysicsList->ConstructProcess();
   }
+  if(fastSimIsRegisted) AddFastSimulation();
+  // step limits (/ActarSim/phys/stepMax and the limits of the regions)
+  steplimiter->ConstructProcess();
+  stepLimiterIsRegisted = true;
   // Define energy interval for loss processes
   G4EmProcessOptions emOptions;
   emOptions.SetMinEnergy(0.1*keV);
@@ -311,6 +352,14 @@ void ActarSimPhysicsList::SetCuts() {
   if (verbose>0) DumpCutValuesTable();
 }
 
+//////////////////////////////////////////////////////////////////
+/// Description of the physics modules, for the physics table cache
+/// (see ActarSimPhysicsTableCache). The tag changes when the physics
+/// built for the modules changes
+G4String ActarSimPhysicsList::GetPhysicsConfiguration() const {
+  return "ActarSimPhysicsTables v1:" + physicsNames;
+}
+
 //////////////////////////////////////////////////////////////////
 /// Selecting verbosity
 void ActarSimPhysicsList::SetVerbose(G4int val){
@@ -360,6 +409,28 @@ void ActarSimPhysicsList::AddIonGasModels() {
   }
 }
 
+//////////////////////////////////////////////////////////////////
+/// Adds the fast simulation process (mass geometry) to the charged
+/// hadrons and ions (GenericIon, proton, deuteron, triton, He3, alpha...),
+/// needed by the fast simulation of the ions in the gas
+/// (ActarSimGasFastModel, activated with /ActarSim/det/gas/fastSim/active)
+/// and by the response of the silicon and scintillator walls
+/// (ActarSimSilSciFastModel, /ActarSim/det/silSciFastSim/active)
+void ActarSimPhysicsList::AddFastSimulation() {
+  G4FastSimulationManagerProcess* fastSimProcess =
+    new G4FastSimulationManagerProcess("fastSimProcess_massGeom");
+  G4ParticleTable::G4PTblDicIterator* aaaParticleIterator = G4ParticleTable::GetParticleTable()->GetIterator();
+  aaaParticleIterator->reset();
+  while( (*aaaParticleIterator)() ){
+    G4ParticleDefinition* particle = aaaParticleIterator->value();
+    G4String particleType = particle->GetParticleType();
+    G4ProcessManager* pmanager = particle->GetProcessManager();
+    if(pmanager && particle->GetPDGCharge()!=0. &&
+       (particleType=="nucleus" || particleType=="baryon"))
+      pmanager->AddDiscreteProcess(fastSimProcess);
+  }
+}
+
 void ActarSimPhysicsList::AddPAIModel(const G4String& modname){
   G4ParticleTable::G4PTblDicIterator* aaaParticleIterator = G4ParticleTable::GetParticleTable()->GetIterator();
   aaaParticleIterator->reset();
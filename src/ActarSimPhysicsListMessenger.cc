@@ -13,10 +13,17 @@
 
 #include "ActarSimPhysicsListMessenger.hh"
 #include "ActarSimPhysicsList.hh"
+#include "ActarSimPhysicsTableCache.hh"
+#include "ActarSimRegionSettings.hh"
+#include "ActarSimRangeTableService.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4Tokenizer.hh"
 #include "G4LossTableManager.hh"
 
 //////////////////////////////////////////////////////////////////
@@ -29,6 +36,21 @@
 /// - /ActarSim/phys/addPhysics
 /// - /ActarSim/phys/RemovePhysics
 /// - /ActarSim/phys/verbose
+/// - /ActarSim/phys/tableCache/active
+/// - /ActarSim/phys/tableCache/directory
+/// - /ActarSim/phys/region/setCuts
+/// - /ActarSim/phys/region/setStepMax
+/// - /ActarSim/phys/region/report
+/// - /ActarSim/phys/rangeTables/addParticle
+/// - /ActarSim/phys/rangeTables/addIon
+/// - /ActarSim/phys/rangeTables/clearParticles
+/// - /ActarSim/phys/rangeTables/cache
+/// - /ActarSim/phys/rangeTables/directory
+/// - /ActarSim/phys/rangeTables/export
+/// - /ActarSim/phys/rangeTables/exportDirectory
+/// - /ActarSim/phys/rangeTables/minEnergy
+/// - /ActarSim/phys/rangeTables/maxEnergy
+/// - /ActarSim/phys/rangeTables/binsPerDecade
 ActarSimPhysicsListMessenger::ActarSimPhysicsListMessenger(ActarSimPhysicsList* pPhys)
   :pPhysicsList(pPhys){
 
@@ -76,6 +98,145 @@ ActarSimPhysicsListMessenger::ActarSimPhysicsListMessenger(ActarSimPhysicsList*
   verbCmd->SetGuidance("Set verbose level for processes");
   verbCmd->SetParameterName("pVerb",false);
   verbCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  tableCacheDir = new G4UIdirectory("/ActarSim/phys/tableCache/");
+  tableCacheDir->SetGuidance("physics table cache commands");
+
+  tableCacheActiveCmd = new G4UIcmdWithAString("/ActarSim/phys/tableCache/active",this);
+  tableCacheActiveCmd->SetGuidance("Retrieves the physics tables from the cache when they are there");
+  tableCacheActiveCmd->SetGuidance("and stores them after they are built otherwise (default off).");
+  tableCacheActiveCmd->SetGuidance("The tables are keyed by physics modules, cuts and materials.");
+  tableCacheActiveCmd->SetParameterName("choice",false);
+  tableCacheActiveCmd->SetCandidates("on off");
+  tableCacheActiveCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  tableCacheDirCmd = new G4UIcmdWithAString("/ActarSim/phys/tableCache/directory",this);
+  tableCacheDirCmd->SetGuidance("Selects the directory of the physics table cache.");
+  tableCacheDirCmd->SetGuidance("Default value: physicsTableCache");
+  tableCacheDirCmd->SetParameterName("directory",false);
+  tableCacheDirCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  regionDir = new G4UIdirectory("/ActarSim/phys/region/");
+  regionDir->SetGuidance("cuts and step limits of the regions");
+
+  regionCutCmd = new G4UIcommand("/ActarSim/phys/region/setCuts",this);
+  regionCutCmd->SetGuidance("Set the cut of gammas, electrons and positrons in a region.");
+  regionCutCmd->SetGuidance("[usage] /ActarSim/phys/region/setCuts region cut unit");
+  regionCutCmd->SetGuidance("        region: gas, silicon, scintillator, chamber or world");
+  regionCutCmd->SetGuidance("        (the world cut is used by the regions without cuts)");
+
+  G4UIparameter* regionParam;
+  regionParam = new G4UIparameter("region",'s',false);
+  regionParam->SetParameterCandidates("gas silicon scintillator chamber world");
+  regionCutCmd->SetParameter(regionParam);
+  regionParam = new G4UIparameter("cut",'d',false);
+  regionParam->SetParameterRange("cut>0.");
+  regionCutCmd->SetParameter(regionParam);
+  regionParam = new G4UIparameter("unit",'s',true);
+  regionParam->SetDefaultValue("mm");
+  regionCutCmd->SetParameter(regionParam);
+  regionCutCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  regionStepMaxCmd = new G4UIcommand("/ActarSim/phys/region/setStepMax",this);
+  regionStepMaxCmd->SetGuidance("Set the maximum step length of the charged particles in a region.");
+  regionStepMaxCmd->SetGuidance("[usage] /ActarSim/phys/region/setStepMax region step unit");
+  regionStepMaxCmd->SetGuidance("        region: gas, silicon, scintillator, chamber or world");
+
+  regionParam = new G4UIparameter("region",'s',false);
+  regionParam->SetParameterCandidates("gas silicon scintillator chamber world");
+  regionStepMaxCmd->SetParameter(regionParam);
+  regionParam = new G4UIparameter("step",'d',false);
+  regionParam->SetParameterRange("step>0.");
+  regionStepMaxCmd->SetParameter(regionParam);
+  regionParam = new G4UIparameter("unit",'s',true);
+  regionParam->SetDefaultValue("mm");
+  regionStepMaxCmd->SetParameter(regionParam);
+  regionStepMaxCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  regionReportCmd = new G4UIcmdWithAString("/ActarSim/phys/region/report",this);
+  regionReportCmd->SetGuidance("Reports the steps, tracks and CPU time of each region at the end of the run.");
+  regionReportCmd->SetGuidance("  Choice : on, off(default)");
+  regionReportCmd->SetParameterName("choice",true);
+  regionReportCmd->SetDefaultValue("off");
+  regionReportCmd->SetCandidates("on off");
+  regionReportCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeDir = new G4UIdirectory("/ActarSim/phys/rangeTables/");
+  rangeDir->SetGuidance("range-energy and stopping power tables (G4EmCalculator)");
+
+  rangeParticleCmd = new G4UIcmdWithAString("/ActarSim/phys/rangeTables/addParticle",this);
+  rangeParticleCmd->SetGuidance("Adds a particle (proton, deuteron, alpha...) whose range table");
+  rangeParticleCmd->SetGuidance("in the gas is prepared at the start of each run.");
+  rangeParticleCmd->SetParameterName("particle",false);
+  rangeParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeIonCmd = new G4UIcommand("/ActarSim/phys/rangeTables/addIon",this);
+  rangeIonCmd->SetGuidance("Adds an ion whose range table in the gas is prepared");
+  rangeIonCmd->SetGuidance("at the start of each run.");
+  rangeIonCmd->SetGuidance("[usage] /ActarSim/phys/rangeTables/addIon Z A");
+  G4UIparameter* rangeParam;
+  rangeParam = new G4UIparameter("Z",'i',false);
+  rangeParam->SetParameterRange("Z>0");
+  rangeIonCmd->SetParameter(rangeParam);
+  rangeParam = new G4UIparameter("A",'i',false);
+  rangeParam->SetParameterRange("A>0");
+  rangeIonCmd->SetParameter(rangeParam);
+  rangeIonCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeClearCmd = new G4UIcmdWithoutParameter("/ActarSim/phys/rangeTables/clearParticles",this);
+  rangeClearCmd->SetGuidance("Removes the particles and ions added to the range tables.");
+  rangeClearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeCacheCmd = new G4UIcmdWithAString("/ActarSim/phys/rangeTables/cache",this);
+  rangeCacheCmd->SetGuidance("Reads the range tables from the disk cache when they are there");
+  rangeCacheCmd->SetGuidance("and stores them after they are built otherwise (default off).");
+  rangeCacheCmd->SetParameterName("choice",false);
+  rangeCacheCmd->SetCandidates("on off");
+  rangeCacheCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeDirCmd = new G4UIcmdWithAString("/ActarSim/phys/rangeTables/directory",this);
+  rangeDirCmd->SetGuidance("Selects the directory of the range table cache.");
+  rangeDirCmd->SetGuidance("Default value: rangeTables");
+  rangeDirCmd->SetParameterName("directory",false);
+  rangeDirCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeExportCmd = new G4UIcmdWithAString("/ActarSim/phys/rangeTables/export",this);
+  rangeExportCmd->SetGuidance("Writes the range tables of the added particles in the gas as");
+  rangeExportCmd->SetGuidance("ROOT files <particle>_on_<material>.root at the start of each run,");
+  rangeExportCmd->SetGuidance("with the graphs range, energy and dedx and the spline of the");
+  rangeExportCmd->SetGuidance("energy (keV) vs. range (mm) (default off). See ranges/README.");
+  rangeExportCmd->SetParameterName("choice",false);
+  rangeExportCmd->SetCandidates("on off");
+  rangeExportCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeExportDirCmd = new G4UIcmdWithAString("/ActarSim/phys/rangeTables/exportDirectory",this);
+  rangeExportDirCmd->SetGuidance("Selects the directory of the exported ROOT files.");
+  rangeExportDirCmd->SetGuidance("Default value: ranges");
+  rangeExportDirCmd->SetParameterName("directory",false);
+  rangeExportDirCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeMinEnergyCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/phys/rangeTables/minEnergy",this);
+  rangeMinEnergyCmd->SetGuidance("Sets the lower kinetic energy per nucleon of the range tables.");
+  rangeMinEnergyCmd->SetGuidance("Default value: 1 keV");
+  rangeMinEnergyCmd->SetParameterName("minEnergy",false);
+  rangeMinEnergyCmd->SetUnitCategory("Energy");
+  rangeMinEnergyCmd->SetRange("minEnergy>0.0");
+  rangeMinEnergyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeMaxEnergyCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/phys/rangeTables/maxEnergy",this);
+  rangeMaxEnergyCmd->SetGuidance("Sets the upper kinetic energy per nucleon of the range tables");
+  rangeMaxEnergyCmd->SetGuidance("(doubled if a higher energy is needed). Default value: 100 MeV");
+  rangeMaxEnergyCmd->SetParameterName("maxEnergy",false);
+  rangeMaxEnergyCmd->SetUnitCategory("Energy");
+  rangeMaxEnergyCmd->SetRange("maxEnergy>0.0");
+  rangeMaxEnergyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rangeBinsCmd = new G4UIcmdWithAnInteger("/ActarSim/phys/rangeTables/binsPerDecade",this);
+  rangeBinsCmd->SetGuidance("Sets the number of log spaced nodes per decade of energy.");
+  rangeBinsCmd->SetGuidance("Default value: 100");
+  rangeBinsCmd->SetParameterName("bins",false);
+  rangeBinsCmd->SetRange("bins>0");
+  rangeBinsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -88,6 +249,24 @@ ActarSimPhysicsListMessenger::~ActarSimPhysicsListMessenger(){
   delete pListCmd;
   delete RmPListCmd;
   delete verbCmd;
+  delete tableCacheActiveCmd;
+  delete tableCacheDirCmd;
+  delete tableCacheDir;
+  delete regionCutCmd;
+  delete regionStepMaxCmd;
+  delete regionReportCmd;
+  delete regionDir;
+  delete rangeParticleCmd;
+  delete rangeIonCmd;
+  delete rangeClearCmd;
+  delete rangeCacheCmd;
+  delete rangeDirCmd;
+  delete rangeExportCmd;
+  delete rangeExportDirCmd;
+  delete rangeMinEnergyCmd;
+  delete rangeMaxEnergyCmd;
+  delete rangeBinsCmd;
+  delete rangeDir;
   delete physDir;
 }
 
@@ -121,4 +300,67 @@ void ActarSimPhysicsListMessenger::SetNewValue(G4UIcommand* command,
 
   if( command == RmPListCmd )
     pPhysicsList->~ActarSimPhysicsList();
+
+  if( command == tableCacheActiveCmd )
+    pPhysicsList->GetPhysicsTableCache()->SetActiveFlag(newValue=="on");
+
+  if( command == tableCacheDirCmd )
+    pPhysicsList->GetPhysicsTableCache()->SetDirectory(newValue);
+
+  if( command == regionCutCmd || command == regionStepMaxCmd )
+    RegionCommand(command,newValue);
+
+  if( command == regionReportCmd )
+    pPhysicsList->GetRegionSettings()->SetReportFlag(newValue=="on");
+
+  if( command == rangeParticleCmd )
+    pPhysicsList->GetRangeTableService()->AddParticle(newValue);
+
+  if( command == rangeIonCmd ) {
+    G4Tokenizer next(newValue);
+    G4int Z = StoI(next());
+    G4int A = StoI(next());
+    pPhysicsList->GetRangeTableService()->AddIon(Z,A);
+  }
+
+  if( command == rangeClearCmd )
+    pPhysicsList->GetRangeTableService()->ClearParticles();
+
+  if( command == rangeCacheCmd )
+    pPhysicsList->GetRangeTableService()->SetCacheFlag(newValue=="on");
+
+  if( command == rangeDirCmd )
+    pPhysicsList->GetRangeTableService()->SetDirectory(newValue);
+
+  if( command == rangeExportCmd )
+    pPhysicsList->GetRangeTableService()->SetExportFlag(newValue=="on");
+
+  if( command == rangeExportDirCmd )
+    pPhysicsList->GetRangeTableService()->SetExportDirectory(newValue);
+
+  if( command == rangeMinEnergyCmd )
+    pPhysicsList->GetRangeTableService()->
+      SetMinEnergyPerNucleon(rangeMinEnergyCmd->GetNewDoubleValue(newValue));
+
+  if( command == rangeMaxEnergyCmd )
+    pPhysicsList->GetRangeTableService()->
+      SetMaxEnergyPerNucleon(rangeMaxEnergyCmd->GetNewDoubleValue(newValue));
+
+  if( command == rangeBinsCmd )
+    pPhysicsList->GetRangeTableService()->SetBinsPerDecade(rangeBinsCmd->GetNewIntValue(newValue));
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the cut or the maximum step length of a region
+void ActarSimPhysicsListMessenger::RegionCommand(G4UIcommand* command, G4String newValues){
+  G4Tokenizer next(newValues);
+  G4String region = next();
+  G4double value = StoD(next());
+  G4String unit = next();
+  value *= G4UIcommand::ValueOf(unit);
+
+  if(command == regionCutCmd)
+    pPhysicsList->GetRegionSettings()->SetCut(region,value);
+  else
+    pPhysicsList->GetRegionSettings()->SetMaxStep(region,value);
 }
@@ -0,0 +1,186 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimPhysicsTableCache
+/// Cache of the physics tables, using the store and retrieve facility
+/// of the Geant4 physics lists. The tables of each configuration are
+/// stored in a subdirectory named after a hash (see
+/// ActarSimGeometryCache::GetKey()) of the physics modules, the
+/// Geant4 version, the materials of the geometry and the production
+/// cuts of the regions. Before the physics tables of a run are built
+/// (ActarSimRunManager::RunInitialization()) the tables are retrieved
+/// if the configuration is in the cache; otherwise they are built as
+/// usual and stored after the run initialization. The tables are
+/// written in a temporary directory and renamed, so that jobs sharing
+/// the cache never read partial tables.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimPhysicsTableCache.hh"
+#include "ActarSimGeometryCache.hh"
+
+#include "G4VUserPhysicsList.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Version.hh"
+#include "G4ios.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dirent.h>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor. The cache is created inactive
+ActarSimPhysicsTableCache::ActarSimPhysicsTableCache()
+  :activeFlag(false), directory("physicsTableCache"),
+   retrieveFlag(false), storePending(false) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimPhysicsTableCache::~ActarSimPhysicsTableCache(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Description of the configuration of the physics tables: physics
+/// modules (given by the physics list), Geant4 version, materials in
+/// the geometry (with their composition) and production cuts
+G4String ActarSimPhysicsTableCache::GetConfiguration(const G4String& physicsConfiguration) const {
+  std::ostringstream config;
+  config.precision(12);
+  config << physicsConfiguration << "; Geant4 " << G4VERSION_NUMBER;
+
+  G4ProductionCutsTable* cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  config << "; energy range " << cutsTable->GetLowEdgeEnergy()/keV
+	 << " " << cutsTable->GetHighEdgeEnergy()/keV;
+
+  //materials of the geometry, in the order they are placed
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()->
+    GetNavigatorForTracking()->GetWorldVolume();
+  std::set<const G4LogicalVolume*> visited;
+  std::vector<const G4Material*> materials;
+  if(world) AddMaterials(world->GetLogicalVolume(),visited,materials);
+  for(size_t i=0;i<materials.size();i++){
+    const G4Material* material = materials[i];
+    config << "; material " << material->GetName()
+	   << " " << material->GetDensity()/(g/cm3) << " " << material->GetState()
+	   << " " << material->GetTemperature()/kelvin << " " << material->GetPressure()/bar
+	   << " " << material->GetIonisation()->GetMeanExcitationEnergy()/eV;
+    for(size_t j=0;j<material->GetNumberOfElements();j++)
+      config << " " << material->GetElement(j)->GetZ()
+	     << " " << material->GetElement(j)->GetN()
+	     << " " << material->GetFractionVector()[j];
+  }
+
+  //production cuts (gamma, e-, e+, proton) of the regions
+  G4RegionStore* regions = G4RegionStore::GetInstance();
+  for(size_t i=0;i<regions->size();i++){
+    G4ProductionCuts* cuts = (*regions)[i]->GetProductionCuts();
+    if(!cuts) continue;
+    config << "; region " << (*regions)[i]->GetName();
+    for(G4int index=0;index<4;index++)
+      config << " " << cuts->GetProductionCut(index)/mm;
+  }
+  return config.str();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds the materials of the volume and its daughters not yet in
+/// the list
+void ActarSimPhysicsTableCache::AddMaterials(const G4LogicalVolume* volume,
+					     std::set<const G4LogicalVolume*>& visited,
+					     std::vector<const G4Material*>& materials) const {
+  if(!visited.insert(volume).second) return;
+  const G4Material* material = volume->GetMaterial();
+  G4bool found = false;
+  for(size_t i=0;i<materials.size() && !found;i++) found = (materials[i]==material);
+  if(!found && material) materials.push_back(material);
+  for(G4int i=0;i<(G4int)volume->GetNoDaughters();i++)
+    AddMaterials(volume->GetDaughter(i)->GetLogicalVolume(),visited,materials);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the physics list to retrieve the tables of the current
+/// configuration if they are in the cache. To be called before the
+/// physics tables are built
+void ActarSimPhysicsTableCache::Prepare(G4VUserPhysicsList* physicsList,
+					const G4String& physicsConfiguration){
+  storePending = false;
+  if(!activeFlag){
+    if(retrieveFlag) physicsList->ResetPhysicsTableRetrieved();
+    retrieveFlag = false;
+    return;
+  }
+
+  tableDirectory = directory + "/" +
+    ActarSimGeometryCache::GetKey(GetConfiguration(physicsConfiguration));
+  struct stat info;
+  if(stat(tableDirectory.c_str(),&info)==0 && S_ISDIR(info.st_mode)){
+    physicsList->SetPhysicsTableRetrieved(tableDirectory);
+    retrieveFlag = true;
+    G4cout << "ActarSimPhysicsTableCache::Prepare(): physics tables from "
+	   << tableDirectory << G4endl;
+  }
+  else {
+    if(retrieveFlag) physicsList->ResetPhysicsTableRetrieved();
+    retrieveFlag = false;
+    storePending = true;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Stores the physics tables of the current configuration if they
+/// are not in the cache. To be called after the tables are built
+void ActarSimPhysicsTableCache::Store(G4VUserPhysicsList* physicsList){
+  if(!activeFlag || !storePending) return;
+  storePending = false;
+
+  mkdir(directory.c_str(),0755);
+  std::ostringstream tempName;
+  tempName << tableDirectory << "." << getpid() << ".tmp";
+  mkdir(tempName.str().c_str(),0755);
+  if(!physicsList->StorePhysicsTable(tempName.str())){
+    G4cout << "ActarSimPhysicsTableCache::Store(): cannot store the physics tables in "
+	   << tempName.str() << G4endl;
+    RemoveDirectory(tempName.str());
+    return;
+  }
+  if(std::rename(tempName.str().c_str(),tableDirectory.c_str())!=0){
+    //stored meanwhile by another job
+    RemoveDirectory(tempName.str());
+    return;
+  }
+  G4cout << "ActarSimPhysicsTableCache::Store(): physics tables stored in "
+	 << tableDirectory << G4endl;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Removes a directory of tables (files only)
+void ActarSimPhysicsTableCache::RemoveDirectory(const G4String& path) const {
+  DIR* tables = opendir(path.c_str());
+  if(tables){
+    struct dirent* entry;
+    while((entry = readdir(tables))){
+      G4String name = entry->d_name;
+      if(name!="." && name!="..") std::remove((path + "/" + name).c_str());
+    }
+    closedir(tables);
+  }
+  rmdir(path.c_str());
+}
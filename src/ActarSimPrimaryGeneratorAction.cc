@@ -21,11 +21,22 @@
 #include "ActarSimCinePrimGenerator.hh"
 #include "ActarSimKinePrimGenerator.hh"
 #include "ActarSimEulerTransformation.hh"
+#include "ActarSimKinematicsTable.hh"
+#include "ActarSimCrossSectionTable.hh"
+#include "ActarSimReactionTable.hh"
+#include "ActarSimBeamTransport.hh"
+#include "ActarSimBeamLibrary.hh"
+#include "ActarSimAcceptanceFilter.hh"
+#include "ActarSimEventGenerator.hh"
+#include "ActarSimBeamPhaseSpace.hh"
+#include "ActarSimPhaseSpaceGenerator.hh"
 
 #include "ActarSimBeamInfo.hh"
 
 #include "G4RunManager.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4ParticleGun.hh"
 #include "G4ThreeVector.hh"
 #include "G4Gamma.hh"
@@ -34,22 +45,29 @@
 #include "Randomize.hh"
 
 #include "G4ParticleDefinition.hh"
+#include "G4Material.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 
 # include <cstdlib>
 # include <iostream>
 # include <fstream>
+# include <sstream>
 using namespace std;
 
 //////////////////////////////////////////////////////////////////
 /// Constructor: init values are filled
 ActarSimPrimaryGeneratorAction::ActarSimPrimaryGeneratorAction()
   :gasDetector(0), incidentIon(0),targetIon(0),scatteredIon(0),recoilIon(0),
-   beamInteractionFlag("off"),
+   beamInteractionFlag("off"), fastBeamFlag("off"), fastBeamStragglingFlag("on"),
+   beamLibraryMode("off"), beamLibraryFile("beamLibrary.root"),
+   beamPhaseSpaceFlag("off"), beamPhaseSpaceFile("beamPhaseSpace.dat"), beamPhaseSpaceFailed(false),
+   acceptanceFilterMode("off"), acceptanceMaxTries(100),
    realisticBeamFlag("off"), reactionFromEvGenFlag("off"), reactionFromCrossSectionFlag("off"),
+   angularBiasFlag("off"), angularBiasFile("angularBias.dat"), reactionWeight(1.),
    reactionFromFileFlag("off"),reactionFromCineFlag("off"),
-   randomThetaFlag("off"),reactionFile("He8onC12_100MeV_Elastic.dat"),reactionFromKineFlag("off"),
+   randomThetaFlag("off"),reactionFile("He8onC12_100MeV_Elastic.dat"),
+   reactionFileWeightedFlag("off"),reactionFileFailed(false),reactionFromKineFlag("off"),reactionFromPhaseSpaceFlag("off"),
    vertexPosition(0) {
 
   G4ThreeVector zero;
@@ -62,6 +80,34 @@ ActarSimPrimaryGeneratorAction::ActarSimPrimaryGeneratorAction()
   //create a messenger for this class
   gunMessenger = new ActarSimPrimaryGeneratorMessenger(this);
 
+  //the reaction file is read at the first event using it
+  reactionTable = new ActarSimReactionTable();
+  crossSectionTable = new ActarSimCrossSectionTable();
+  angularBiasTable = new ActarSimCrossSectionTable();
+
+  //the CINE and KINE kinematics are tabulated at the first event of each run
+  cineGenerator = new ActarSimCinePrimGenerator();
+  kineGenerator = new ActarSimKinePrimGenerator();
+  eulerTransformer = new ActarSimEulerTransformation();
+  cineTable = new ActarSimKinematicsTable();
+  kineTable = new ActarSimKinematicsTable();
+
+  //the range table of the beam in the gas is built at the first event using it
+  beamTransport = new ActarSimBeamTransport();
+
+  //the beam trajectories are recorded during the tracking (in the analysis)
+  beamLibrary = new ActarSimBeamLibrary();
+  if(gActarSimROOTAnalysis) gActarSimROOTAnalysis->SetBeamLibrary(beamLibrary);
+
+  //the beam phase space file is read at the first event using it
+  beamPhaseSpace = new ActarSimBeamPhaseSpace();
+
+  //the N-body phase space events are generated in batches (fixed beam energy)
+  phaseSpaceGenerator = new ActarSimPhaseSpaceGenerator();
+
+  //the reaction products can be tested before the tracking
+  acceptanceFilter = new ActarSimAcceptanceFilter();
+
   G4ParticleDefinition* pd = particleTable->FindParticle("proton");
   if(pd != 0)
     particleGun->SetParticleDefinition(pd);
@@ -73,9 +119,8 @@ ActarSimPrimaryGeneratorAction::ActarSimPrimaryGeneratorAction()
   particleGun->SetParticleMomentumDirection(G4ThreeVector(0.0,0.0,1.0));
   particleGun->SetParticleEnergy(1*MeV);
 
-  //NOTE: FOR THE MOMENT THIS IS NOT ACCESIBLE. REVIEW IN THE FUTURE
-  //create a pointer that gives access to the tabulated xs
-  //pReadEvGen = new ActarSimEventGenerator();
+  //the external generator file is opened at the first event using it
+  eventGenerator = new ActarSimEventGenerator();
 
   reactionQ = 0.0001;   //does 0 work? (QM)
   labEnergy = 100 *MeV;      // 15MeV*numero de nucleones (EI)
@@ -97,6 +142,350 @@ ActarSimPrimaryGeneratorAction::ActarSimPrimaryGeneratorAction()
 ActarSimPrimaryGeneratorAction::~ActarSimPrimaryGeneratorAction() {
   delete particleGun;
   delete gunMessenger;
+  delete reactionTable;
+  delete crossSectionTable;
+  delete angularBiasTable;
+  delete cineGenerator;
+  delete kineGenerator;
+  delete eulerTransformer;
+  delete cineTable;
+  delete kineTable;
+  delete beamTransport;
+  delete beamLibrary;
+  delete acceptanceFilter;
+  delete eventGenerator;
+  delete beamPhaseSpace;
+  delete phaseSpaceGenerator;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Called at the beginning of each run. The kinematics and range
+/// tables are emptied, as the reaction parameters may have changed,
+/// and filled again at the first event using them. The files that
+/// could not be loaded in the previous run are tried again
+void ActarSimPrimaryGeneratorAction::BeginOfRunAction() {
+  beamPhaseSpaceFailed = false;
+  reactionFileFailed = false;
+  cineTable->Clear();
+  kineTable->Clear();
+  beamTransport->Clear();
+  acceptanceFilter->Clear();
+  acceptanceFilter->ResetCounters();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Called at the end of each run. The recorded beam trajectories
+/// are written in the library file
+void ActarSimPrimaryGeneratorAction::EndOfRunAction() {
+  if(beamLibraryMode == "record")
+    beamLibrary->Write(beamLibraryFile);
+
+  if(acceptanceFilterMode != "off") {
+    std::ostringstream summary;
+    summary << acceptanceFilterMode << ": " << acceptanceFilter->GetNumberOfAccepted()
+	    << " accepted of " << acceptanceFilter->GetNumberOfTried()
+	    << " reactions generated, efficiency " << acceptanceFilter->GetEfficiency();
+    G4cout << "##################################################################" << G4endl
+	   << "#### ActarSimPrimaryGeneratorAction::EndOfRunAction()" << G4endl
+	   << "#### Acceptance filter " << summary.str() << G4endl;
+    G4cout << "##################################################################" << G4endl;
+    if(gActarSimROOTAnalysis)
+      gActarSimROOTAnalysis->StoreRunInfo("acceptanceFilter",summary.str());
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects the use of the beam trajectory library (off, record or
+/// replay). See ActarSimBeamLibrary
+void ActarSimPrimaryGeneratorAction::SetBeamLibraryMode(G4String val) {
+  beamLibraryMode = val;
+  beamLibrary->SetRecording(val == "record");
+}
+
+//////////////////////////////////////////////////////////////////
+/// Maximum length of the strides of the recorded trajectories
+void ActarSimPrimaryGeneratorAction::SetBeamLibraryStrideLength(G4double val) {
+  beamLibrary->SetStrideLength(val);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sensitive detectors (names separated by spaces) giving the acceptance
+/// of a reaction product. See ActarSimAcceptanceFilter
+void ActarSimPrimaryGeneratorAction::SetAcceptanceDetectors(G4String val) {
+  acceptanceFilter->SetDetectorNames(val);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Number of reaction products in the acceptance needed to accept the event
+void ActarSimPrimaryGeneratorAction::SetAcceptanceMinProducts(G4int val) {
+  acceptanceFilter->SetMinProducts(val);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Length in the gas giving the acceptance of a product (0: not used)
+void ActarSimPrimaryGeneratorAction::SetAcceptanceMinGasLength(G4double val) {
+  acceptanceFilter->SetMinGasLength(val);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects if the charged products stop according to their range
+void ActarSimPrimaryGeneratorAction::SetAcceptanceEnergyLossFlag(G4String val) {
+  acceptanceFilter->SetEnergyLossFlag(val == "on");
+}
+
+//////////////////////////////////////////////////////////////////
+/// Beam and gas setting identifying a beam trajectory library: ion,
+/// incident energy, gas material and density
+G4String ActarSimPrimaryGeneratorAction::GetBeamLibrarySetting() {
+  std::ostringstream setting;
+  setting << (incidentIon ? incidentIon->GetParticleName() : G4String("none"))
+	  << " " << GetIncidentEnergy()/MeV << " MeV in "
+	  << gasDetector->GetGasMaterial()->GetName() << " "
+	  << gasDetector->GetGasMaterial()->GetDensity()/(mg/cm3) << " mg/cm3";
+  return setting.str();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects the beam phase space file. The file is (re)loaded at the
+/// next event using it, even if the name did not change
+void ActarSimPrimaryGeneratorAction::SetBeamPhaseSpaceFile(G4String val) {
+  beamPhaseSpaceFile = val;
+  beamPhaseSpaceFailed = false;
+  beamPhaseSpace->Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Loads the beam phase space file if it is not loaded. If the file
+/// cannot be loaded the run is aborted, and the file is not read
+/// again (nor the error repeated) until the next run
+G4bool ActarSimPrimaryGeneratorAction::LoadBeamPhaseSpace() {
+  if(beamPhaseSpace->IsLoaded(beamPhaseSpaceFile)) return true;
+  if(beamPhaseSpaceFailed) return false;
+  if(beamPhaseSpace->Load(beamPhaseSpaceFile)) return true;
+
+  beamPhaseSpaceFailed = true;
+  G4cout << "ActarSimPrimaryGeneratorAction::LoadBeamPhaseSpace() - no beam phase space in "
+	 << beamPhaseSpaceFile << "; the run is aborted." << G4endl;
+  G4RunManager::GetRunManager()->AbortRun(true);
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects the products of the N-body phase space, as a list of names
+/// of the particle table or ions as Z:A (e.g. "alpha alpha neutron" or
+/// "2:4 2:4 neutron")
+void ActarSimPrimaryGeneratorAction::SetPhaseSpaceProducts(G4String val) {
+  phaseSpaceGenerator->SetProducts(val);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects weighted (on) or unweighted (off) N-body phase space events
+void ActarSimPrimaryGeneratorAction::SetPhaseSpaceWeightedFlag(G4String val) {
+  phaseSpaceGenerator->SetWeightedFlag(val == "on");
+}
+
+//////////////////////////////////////////////////////////////////
+/// Number of N-body phase space events generated together
+void ActarSimPrimaryGeneratorAction::SetPhaseSpaceBatchSize(G4int val) {
+  phaseSpaceGenerator->SetBatchSize(val);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects the reaction file. The file is (re)loaded at the next
+/// event using it, even if the name did not change
+void ActarSimPrimaryGeneratorAction::SetReactionFile(G4String val) {
+  reactionFile = val;
+  reactionFileFailed = false;
+  reactionTable->Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Loads the reaction file if it is not loaded (or the weighting
+/// changed). If the file cannot be loaded the run is aborted, and the
+/// file is not read again (nor the error repeated) until the next run
+G4bool ActarSimPrimaryGeneratorAction::LoadReactionFile() {
+  G4bool weighted = (reactionFileWeightedFlag == "on");
+  if(reactionTable->IsLoaded(reactionFile,weighted)) return true;
+  if(reactionFileFailed) return false;
+  if(reactionTable->Load(reactionFile,weighted)) return true;
+
+  reactionFileFailed = true;
+  G4cout << " *************************************************** " << G4endl
+	 << "File " << reactionFile << " not found or not valid. The run is aborted." << G4endl;
+  G4cout << " *************************************************** "<< G4endl;
+  G4RunManager::GetRunManager()->AbortRun(true);
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects the angular distribution file. The file is (re)loaded at
+/// the next event using it, even if the name did not change
+void ActarSimPrimaryGeneratorAction::SetCrossSectionFile(G4String val) {
+  crossSectionFile = val;
+  crossSectionTable->Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects the external event generator file. The file is (re)opened
+/// at the next event using it, starting from its first event
+void ActarSimPrimaryGeneratorAction::SetEvGenFile(G4String val) {
+  evGenFile = val;
+  eventGenerator->Close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Maximum number of events of the external generator read ahead
+/// of the tracking
+void ActarSimPrimaryGeneratorAction::SetEvGenPrefetchSize(G4int val) {
+  eventGenerator->SetPrefetchSize(val);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects the bias density file. The file is (re)loaded at the
+/// next event using it, even if the name did not change
+void ActarSimPrimaryGeneratorAction::SetAngularBiasFile(G4String val) {
+  angularBiasFile = val;
+  angularBiasTable->Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Importance sampling of the reaction angle. The angle is sampled
+/// from the bias density in angularBiasFile (the lab angle for CINE,
+/// the CM angle for KINE) and reactionWeight is the ratio between the
+/// nominal density and the bias density for this angle. The nominal
+/// density is the angular distribution in crossSectionFile if
+/// fromCrossSection, or flat between randomThetaMin and randomThetaMax
+/// if randomThetaFlag is on (for CINE, flat over the angles in this
+/// range with solution at the lab energy, and zero elsewhere). Returns
+/// false (and the angle should be sampled as usual) if there is no
+/// nominal or bias density
+G4bool ActarSimPrimaryGeneratorAction::SampleBiasedAngle(G4bool fromCrossSection, G4double& angle) {
+  if(!angularBiasTable->IsLoaded(angularBiasFile) &&
+     !angularBiasTable->Load(angularBiasFile,false)) return false;
+
+  if(fromCrossSection) {
+    if(!crossSectionTable->IsLoaded(crossSectionFile) &&
+       !crossSectionTable->Load(crossSectionFile)) return false;
+  }
+  else if(randomThetaFlag != "on" || randomThetaMax<=randomThetaMin) return false;
+
+  angle = angularBiasTable->SampleThetaCM();
+
+  G4double nominal = 0.;
+  if(fromCrossSection)
+    nominal = crossSectionTable->GetProbabilityDensity(angle);
+  else if(angle>=randomThetaMin && angle<=randomThetaMax) {
+    if(reactionFromCineFlag == "on") {
+      //flat only over the angles with a CINE solution at this energy,
+      //as sampled by cineTable->SampleAngle() without bias
+      G4double validLength = cineTable->GetValidLength(GetLabEnergy(),randomThetaMin,randomThetaMax);
+      if(validLength>0. && cineTable->IsValidAngle(GetLabEnergy(),angle))
+        nominal = 1./validLength;
+    }
+    else
+      nominal = 1./(randomThetaMax-randomThetaMin);
+  }
+  reactionWeight = nominal/angularBiasTable->GetProbabilityDensity(angle);
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Tabulates the CINE kinematics for the present reaction parameters.
+/// With beamInteractionFlag on, the energy at the vertex changes from
+/// event to event and the table covers from zero to the incident energy.
+/// Otherwise only the lab energy is tabulated. Grid of 0.25 deg in angle
+void ActarSimPrimaryGeneratorAction::BuildCineTable() {
+  cineGenerator->SetIncidentMass(GetIncidentIon()->GetAtomicMass());
+  cineGenerator->SetTargetMass(GetTargetIon()->GetAtomicMass());
+  cineGenerator->SetScatteredMass(GetScatteredIon()->GetAtomicMass());
+  cineGenerator->SetRecoilMass(GetRecoilIon()->GetAtomicMass());
+  cineGenerator->SetReactionQ(GetReactionQ());
+  cineGenerator->SetTargetExcitationEnergy(GetTargetIon()->GetExcitationEnergy()/MeV);
+  cineGenerator->SetProjectileExcitationEnergy(GetIncidentIon()->GetExcitationEnergy()/MeV);
+
+  cineGenerator->SetVerbose(0);
+  if(beamInteractionFlag == "on")
+    cineTable->BuildFromCine(cineGenerator,0.,GetIncidentEnergy(),101,721);
+  else
+    cineTable->BuildFromCine(cineGenerator,GetLabEnergy(),GetLabEnergy(),1,721);
+  cineGenerator->SetVerbose(1);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Tabulates the KINE kinematics for the present reaction parameters.
+/// Same energy and angular grids as in BuildCineTable()
+void ActarSimPrimaryGeneratorAction::BuildKineTable() {
+  kineGenerator->SetMassOfProjectile(GetMassOfProjectile());
+  kineGenerator->SetMassOfTarget(GetMassOfTarget());
+  kineGenerator->SetMassOfScattered(GetMassOfScattered());
+  kineGenerator->SetMassOfRecoiled(GetMassOfRecoiled());
+
+  kineGenerator->SetExEnergyOfProjectile(GetExEnergyOfProjectile());
+  kineGenerator->SetExEnergyOfTarget(GetExEnergyOfTarget());
+  kineGenerator->SetExEnergyOfScattered(GetExEnergyOfScattered());
+  kineGenerator->SetExEnergyOfRecoiled(GetExEnergyOfRecoiled());
+
+  kineGenerator->SetVerbose(0);
+  if(beamInteractionFlag == "on")
+    kineTable->BuildFromKine(kineGenerator,0.,GetIncidentEnergy(),101,721);
+  else
+    kineTable->BuildFromKine(kineGenerator,GetLabEnergy(),GetLabEnergy(),1,721);
+  kineGenerator->SetVerbose(1);
+}
+
+//////////////////////////////////////////////////////////////////
+/// CINE solutions for the present lab energy and a lab angle of the
+/// scattered particle. Returns the number of solutions (0, 1 or 2).
+/// The values are interpolated in the table; if not possible (close to
+/// the limits of the solutions or outside the table), CINE is called
+G4int ActarSimPrimaryGeneratorAction::CineKinematics(G4double thetaLab, G4double* energyScattered,
+						     G4double* thetaRecoil, G4double* energyRecoil) {
+  G4double energy = GetLabEnergy();
+  G4double thetaScattered;
+  G4int nSolutions = cineTable->GetNumberOfSolutions(energy,thetaLab);
+  if(nSolutions>0) {
+    for(G4int i=0;i<nSolutions;i++)
+      cineTable->GetSolution(energy,thetaLab,i,thetaScattered,energyScattered[i],
+			     thetaRecoil[i],energyRecoil[i]);
+    return nSolutions;
+  }
+
+  cineGenerator->SetLabEnergy(energy/MeV);
+  cineGenerator->SetThetaLabAngle(thetaLab/deg);
+  cineGenerator->RelativisticKinematics();
+  if(cineGenerator->GetANGAV(1)<0) return 0;
+
+  energyScattered[0] = cineGenerator->GetANGAV(1)*MeV;
+  thetaRecoil[0] = cineGenerator->GetANGAV(4)*deg;
+  energyRecoil[0] = cineGenerator->GetANGAV(5)*MeV;
+  if(cineGenerator->GetANGAR(1)<0) return 1;
+
+  energyScattered[1] = cineGenerator->GetANGAR(1)*MeV;
+  thetaRecoil[1] = cineGenerator->GetANGAR(4)*deg;
+  energyRecoil[1] = cineGenerator->GetANGAR(5)*MeV;
+  return 2;
+}
+
+//////////////////////////////////////////////////////////////////
+/// KINE solution for the present lab energy and a CM angle of the
+/// scattered particle. Interpolated in the table if possible, or
+/// calculated by KINE. Returns false if there is no solution
+G4bool ActarSimPrimaryGeneratorAction::KineKinematics(G4double thetaCM,
+						      G4double& thetaScattered, G4double& energyScattered,
+						      G4double& thetaRecoil, G4double& energyRecoil) {
+  G4double energy = GetLabEnergy();
+  if(kineTable->GetSolution(energy,thetaCM,0,thetaScattered,energyScattered,
+			    thetaRecoil,energyRecoil))
+    return true;
+
+  kineGenerator->SetLabEnergy(energy/MeV);
+  kineGenerator->SetThetaCMAngle(thetaCM/deg);
+  kineGenerator->KineKinematics();
+  thetaScattered = kineGenerator->GetANGAs(0);
+  energyScattered = kineGenerator->GetANGAs(1)*MeV;
+  thetaRecoil = kineGenerator->GetANGAr(0);
+  energyRecoil = kineGenerator->GetANGAr(1)*MeV;
+  return !kineGenerator->GetNoSolution();
 }
 
 //////////////////////////////////////////////////////////////////
@@ -112,16 +501,25 @@ ActarSimPrimaryGeneratorAction::~ActarSimPrimaryGeneratorAction() {
 ///   while in the odd events (1,3,5, ...) the reaction products are tracked,
 ///   (CINE, KINE, from file, one output particle, ...) using some parameters
 ///   (vertex position, remaining beam ion energy, ...) obtained in the beam tracking.
+///   With beamPhaseSpaceFlag on, the position, angles and energy of the beam at
+///   the entrance are sampled from the file beamPhaseSpaceFile (see
+///   ActarSimBeamPhaseSpace) instead of the emittance and beamRadiusAtEntrance.
 ///
 /// - CASE A2:  now the beam is not included and the fragments produced.
-///   [ corresponds to line   else if(realisticBeamFlag == "on") { ].
+///   [ corresponds to line   else if(realisticBeamFlag == "on" || beamPhaseSpaceFlag == "on") { ].
 ///   Despite the name of the flag, there is no beam interacting in the gas.
 ///   RealisticBeamFlag means a reaction products being generated according to a
 ///   realistic vertex posisioning as if a beam were interacting.
 ///   Not anymore a gaussian, but a flat distribution in a given radius around Z axis.
+///   With beamPhaseSpaceFlag on, the transverse vertex position is the one of a
+///   particle of the beam phase space, drifted in straight line to the vertex Z.
 ///
 /// - CASE B: Reaction from Event-Generator
-///   WARNING: THIS IS NOT IMPLEMENTED
+///   [ corresponds to line   if(reactionFromEvGenFlag == "on") { ].
+///   The reaction products (any number of particles) are read from the
+///   file evGenFile, in ASCII or ROOT format (see ActarSimEventGenerator),
+///   and placed at the vertex position. The run is aborted at the end of
+///   the file.
 ///
 /// - CASE C Reaction products taken from a file (format given by CINE output).
 ///   [ corresponds to line   if(reactionFromFileFlag == "on"){ ].
@@ -130,8 +528,9 @@ ActarSimPrimaryGeneratorAction::~ActarSimPrimaryGeneratorAction() {
 ///      recoiled ion Z;  recoil ion A;  recoil ion charge state].
 ///   The folowing lines contains:
 ///   scattered ion angle; scattered ion energy; recoil ion angle; recoil ion energy
-///   (typical output from CINE, for example)
-///   A random line (that is, a random angle) is taken from the event list
+///   (typical output from CINE, for example) and, optionally, a cross section.
+///   A random line (that is, a random angle) is taken from the event list,
+///   uniformly or weighted by the cross section (see ActarSimReactionTable)
 ///
 /// - CASE D  Reaction products kinematics calculated using Cine
 ///   [ corresponds to line   else if(reactionFromCineFlag == "on"){  ].
@@ -139,6 +538,21 @@ ActarSimPrimaryGeneratorAction::~ActarSimPrimaryGeneratorAction() {
 ///
 /// - CASE E Reaction products kinematics calculated using Kine
 ///   [ corresponds to line else if(reactionFromKineFlag == "on"){  ].
+///   With reactionFromCrossSectionFlag on, the CM angle is sampled from the
+///   angular distribution in crossSectionFile (see ActarSimCrossSectionTable).
+///   With angularBiasFlag on, the CINE lab angle or the KINE CM angle is
+///   sampled from the bias density in angularBiasFile and the reaction
+///   products carry the importance sampling weight (see SampleBiasedAngle()).
+///   For CINE and KINE the kinematics are tabulated at the first event of
+///   each run (see ActarSimKinematicsTable) and interpolated in each event.
+///
+/// - CASE G  N-body phase space for breakup channels
+///   [ corresponds to line else if(reactionFromPhaseSpaceFlag == "on"){  ].
+///   The products (two or more, see SetPhaseSpaceProducts()) are generated
+///   with the N-body phase space of the incident ion on the target ion,
+///   optionally weighted with a matrix element (see ActarSimPhaseSpaceGenerator).
+///   Each of them is placed in its own primary vertex. The events are generated
+///   in batches only with beamInteractionFlag off (fixed beam energy).
 ///
 /// - CASE F  Particle selected manually (using the messenger commands)
 void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
@@ -147,10 +561,6 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
     G4cout << G4endl << " _____ G4RunManager VerboseLevel = " <<verboseLevel<< G4endl;
 
   G4ThreeVector zero;
-  G4double theta1=0.;
-  G4double theta2=0.;
-  G4double energy1=0.;
-  G4double energy2=0.;
 
   ActarSimDetectorConstruction* detector = (ActarSimDetectorConstruction*)
     (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
@@ -175,6 +585,7 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
   // While the beam is only emitted if beamInteractionFlag == "on"
   // the reaction products are always produced later in the code.
   //
+  beamLibrary->ClearReplay();
   if(beamInteractionFlag == "on"){
     // The beam is described by the (G4Ions*) incidentIon (or incident particles)
     // and it is tracked in the gas in the even events (begining at zero, 0,2,4, ...)
@@ -205,7 +616,7 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
       SetLabEnergy(pBeamInfo->GetEnergyVertex());
       pBeamInfo->SetStatus(0);
     } //end of if(pBeamInfo->GetStatus() > 1)
-    else if(pBeamInfo->GetStatus() == 1){
+    else if(pBeamInfo->GetStatus() == 1 && beamLibraryMode != "record"){
       // the beam finished the tracking in the previous event without reaching
       // the requested vertex position! This is a faulty case! Aborting present event and continue.
       G4cout << G4endl
@@ -256,15 +667,53 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
       else if(randomVertexZPositionFlag=="on"){
         vertex_z0 = randomVertexZPositionMin + G4UniformRand()*(randomVertexZPositionMax-randomVertexZPositionMin);
       }
+      // When recording the beam library the vertex is never reached: the beam
+      // is tracked through all the gas (the next event starts with status 1)
+      if(beamLibraryMode == "record") {
+        vertex_z0 = DBL_MAX;
+        beamLibrary->SetSetting(GetBeamLibrarySetting());
+      }
       // TODO: The probability of interaction is simply constant over the path on the gas.
       // This is the right place for introducing some dependence with the ion energy using
       // the reaction cross section, or even a simple exponential if a constant cross sections
       // approximation is suitable (non-resonant beam)
 
       pBeamInfo->SetNextZVertex(vertex_z0);
-      pBeamInfo->SetEnergyEntrance(GetIncidentEnergy()); //no need of nextEnergyEntrance, as all entry energies are the same. If this is not true in future, an additional datamember for beamInfo will be needed
 
-      if(realisticBeamFlag == "on") {
+      // all entry energies are the same, except if taken from the beam phase space
+      G4double beamEnergy = GetIncidentEnergy();
+
+      if(beamPhaseSpaceFlag == "on") {
+        // Position, angles and energy at entrance sampled from the measured
+        // (or transported) beam phase space, relative to the beam position
+        if(!LoadBeamPhaseSpace()) {
+          pBeamInfo->SetStatus(0);
+          anEvent->SetEventAborted();
+          return;
+        }
+        G4ThreeVector positionAtEntrance;
+        G4ThreeVector directionAtEntrance;
+        beamPhaseSpace->Sample(positionAtEntrance,directionAtEntrance,beamEnergy);
+        positionAtEntrance += beamPosition;
+
+        if(verboseLevel>0){
+          G4cout << G4endl
+                 << " *************************************************** " << G4endl
+                 << " * ActarSimPrimaryGeneratorAction::GeneratePrimaries() " << G4endl
+                 << " * beamInteractionFlag=on, beam.Status=0, beamPhaseSpaceFlag=on " << G4endl
+                 << " * Beam from phase space file " << beamPhaseSpaceFile << G4endl
+                 << " * PositionAtEntrance: " << positionAtEntrance/mm << " mm" << G4endl
+                 << " * ThetaAtEntrance: " << directionAtEntrance.theta()/mrad << " mrad" << G4endl
+                 << " * EnergyAtEntrance: " << beamEnergy/MeV << " MeV" << G4endl;
+          G4cout << " *************************************************** "<< G4endl;
+        }
+        particleGun->SetParticlePosition(positionAtEntrance);
+        particleGun->SetParticleMomentumDirection(directionAtEntrance);
+        pBeamInfo->SetPositionEntrance(positionAtEntrance.x(),positionAtEntrance.y(),
+                                       positionAtEntrance.z());
+        pBeamInfo->SetAnglesEntrance(directionAtEntrance.theta(),directionAtEntrance.phi());
+      } //end of if(beamPhaseSpaceFlag == "on")
+      else if(realisticBeamFlag == "on") {
         // Emittance is defined in mm mrad
         // The polar angle at Entrance is defined by the relation between emitance and radiusAtEntrance.
         // this relation is roughtly emittance =  widthPos * widthAng ~ 2 * radiusMax * 2 * thetaMax
@@ -305,22 +754,65 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
 	pBeamInfo->SetPositionEntrance(beamPosition.x(),beamPosition.y(),beamPosition.z());
 	pBeamInfo->SetAnglesEntrance(0.,0.);
       }
-      particleGun->SetParticleTime(0.0);
-      particleGun->SetParticlePolarization(zero);
-      particleGun->SetParticleEnergy(GetIncidentEnergy());
-      particleGun->GeneratePrimaryVertex(anEvent);
+      pBeamInfo->SetEnergyEntrance(beamEnergy);
+
+      if(beamLibraryMode == "replay" || fastBeamFlag == "on") {
+        // The beam is not tracked: the vertex information is taken from a
+        // trajectory of the library or calculated from the range tables, and
+        // the reaction products are produced in this event
+        G4bool reached = false;
+        if(beamLibraryMode == "replay") {
+          beamLibrary->SetParticleID(incidentIon->GetPDGEncoding());
+          if(beamLibrary->Load(beamLibraryFile,GetBeamLibrarySetting()))
+            reached = beamLibrary->Sample(vertex_z0,pBeamInfo);
+        }
+        else {
+          beamTransport->SetStragglingFlag(fastBeamStragglingFlag == "on");
+          reached = beamTransport->Transport(incidentIon,gasDetector->GetGasMaterial(),
+                                             particleGun->GetParticlePosition(),
+                                             particleGun->GetParticleMomentumDirection(),
+                                             beamEnergy,vertex_z0,pBeamInfo);
+        }
+        if(!reached){
+          G4cout << G4endl
+                 << " *************************************************** " << G4endl
+                 << " * ActarSimPrimaryGeneratorAction::GeneratePrimaries() " << G4endl
+                 << " * ERROR! beamInteractionFlag=on, beamLibraryMode=" << beamLibraryMode
+                 << ", fastBeamFlag=" << fastBeamFlag << G4endl
+                 << " * The beam does not reach the vertex. ABORTING! " << G4endl;
+          G4cout << " *************************************************** "<< G4endl;
+          pBeamInfo->SetStatus(0);
+          anEvent->SetEventAborted();
+          return;
+        }
+        vertexPosition.setX(pBeamInfo->GetXVertex());
+        vertexPosition.setY(pBeamInfo->GetYVertex());
+        vertexPosition.setZ(pBeamInfo->GetZVertex());
+        SetLabEnergy(pBeamInfo->GetEnergyVertex());
+        pBeamInfo->SetStatus(0);
+
+        //Histogramming
+        if(gActarSimROOTAnalysis)
+          gActarSimROOTAnalysis->GenerateBeam(anEvent);
+      }
+      else {
+        particleGun->SetParticleTime(0.0);
+        particleGun->SetParticlePolarization(zero);
+        particleGun->SetParticleEnergy(beamEnergy);
+        particleGun->GeneratePrimaryVertex(anEvent);
 
-      //Histogramming
-      if(gActarSimROOTAnalysis)
-        gActarSimROOTAnalysis->GenerateBeam(anEvent);
+        //Histogramming
+        if(gActarSimROOTAnalysis)
+          gActarSimROOTAnalysis->GenerateBeam(anEvent);
 
-      return;  //end of the function after generating the beam...
-               //waiting for next event for the reaction products.
+        return;  //end of the function after generating the beam...
+                 //waiting for next event for the reaction products.
+      }
     }
   }//end of  if(beamInteractionFlag == "on")
 
   // CASE A2:  now the beam is not included...
-  else if(realisticBeamFlag == "on") {
+  else if(realisticBeamFlag == "on" || beamPhaseSpaceFlag == "on") {
     // Despite the name of the flag, there is no beam interacting in the gas.
     // RealisticBeamFlag means a reaction products being generated according to a
     // realistic vertex posisioning as if a beam were interacting.
@@ -341,6 +833,24 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
       vertex_z0 = -lengthParameter + G4UniformRand()*lengthParameter;//If Z origin is at the center of GasBox
     }
 
+    if(beamPhaseSpaceFlag == "on") {
+      // Transverse position of a beam particle from the phase space,
+      // drifted in straight line from the entrance to the vertex Z
+      if(!LoadBeamPhaseSpace()) {
+        anEvent->SetEventAborted();
+        return;
+      }
+      G4ThreeVector positionAtEntrance;
+      G4ThreeVector directionAtEntrance;
+      G4double beamEnergy;
+      beamPhaseSpace->Sample(positionAtEntrance,directionAtEntrance,beamEnergy);
+      G4double drift = (vertex_z0-beamPosition.z())/directionAtEntrance.z();
+      vertex_x0 = beamPosition.x() + positionAtEntrance.x() + drift*directionAtEntrance.x();
+      vertex_y0 = beamPosition.y() + positionAtEntrance.y() + drift*directionAtEntrance.y();
+      radiusAtEntrance = std::sqrt(positionAtEntrance.x()*positionAtEntrance.x() +
+                                   positionAtEntrance.y()*positionAtEntrance.y());
+    }
+
     if(verboseLevel>0){
       G4cout << G4endl
 	     << " *************************************************** " << G4endl
@@ -357,108 +867,117 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
     vertexPosition.setZ(vertex_z0);
   }
 
-  // After the beam, now different options for the reaction products!
-  //
-  // CASE B Reaction from Event-Generator
-  //
-  if(reactionFromEvGenFlag == "on") {
-    if(verboseLevel>0){
-      G4cout << G4endl
-	     << " *************************************************** " << G4endl
-	     << " * WARNING: THIS IS NOT IMPLEMENTED!!!"  << G4endl
-	     << " * ActarSimPrimaryGeneratorAction::GeneratePrimaries() " << G4endl
-	     << " * reactionFromEvGenFlag=on                            " << G4endl
-	     << " * An external event generator is used..."  << G4endl
-	     << " * WARNING: THIS IS NOT IMPLEMENTED!!!"  << G4endl;
-      G4cout << " *************************************************** "<< G4endl;
-    }
-    /* REMOVING THE COMPLETE CASE B CODE
-    //Initial values
-
-    G4double particle_energy = 50*MeV;
-    G4double particle_energy_rec = 50*MeV;
-    G4double momentum_x = 1.;
-    G4double momentum_y = 0.;
-    G4double momentum_z = 1.5;
-    G4double momentum_x_rec = 1.;
-    G4double momentum_y_rec = 0.;
-    G4double momentum_z_rec = 1.5;
-    G4double phi= 0. ;
-    if( particle_energy &&  particle_energy_rec ){;}
-    if( momentum_x && momentum_x_rec){;}
-    if( momentum_y && momentum_y_rec){;}
-    if( momentum_z && momentum_z_rec){;}
-    //TRANSFER
-    // Polar angle:
-    G4double theta=0;
-    // Random number between 0 and 1
-    G4double randnum = G4UniformRand();
-    G4double energy_scatt=0;
-    G4double slop1=0.,slop2=0.,offset1=0.,offset2=0.;
-    G4double theta_recoil=0;
-    G4double energy_recoil=0;
-    G4double slop_rec=0.,offset_rec=0.;
-
-    //The last angle could be different from 181,
-    //extract the nbins from ActarSimEventGenerator (todo)
-    for(G4int i=0;i<181;i++) {
-      if(randnum>=pReadEvGen->Icross_section[i] &&
-	       randnum<pReadEvGen->Icross_section[i+1]) {
-        slop1=(pReadEvGen->LabAngle_scatt[i+1]-
-	             pReadEvGen->LabAngle_scatt[i])/(pReadEvGen->Icross_section[i+1]-
-					     pReadEvGen->Icross_section[i]);
-        offset1= pReadEvGen->LabAngle_scatt[i]-slop1*pReadEvGen->Icross_section[i];
-        theta=randnum*slop1+offset1;
-
-        for(G4int j=0; j<181; j++) {
-          if(theta>=pReadEvGen->LabAngle_scatt[j] &&
-	           theta<pReadEvGen->LabAngle_scatt[j+1]) {
-            slop2=(pReadEvGen->LabEnergy_scatt[int(pReadEvGen->LabAngle_scatt[j+1])]-
-		              pReadEvGen->LabEnergy_scatt[int(pReadEvGen->LabAngle_scatt[j])])/
-	                (pReadEvGen->LabAngle_scatt[j+1]-pReadEvGen->LabAngle_scatt[j]);
-
-            offset2= pReadEvGen->LabEnergy_scatt[int(pReadEvGen->LabAngle_scatt[j])]-
-	                   slop2*pReadEvGen->LabAngle_scatt[j];
-            energy_scatt=theta*slop2+offset2;
-            //Angle of the Recoil
-            theta_recoil=pReadEvGen->LabAngle_recoil[j];
-            //The same for the recoil
-            slop_rec=(pReadEvGen->LabEnergy_recoil[int(pReadEvGen->LabAngle_recoil[j+1])]-
-		                 pReadEvGen->LabEnergy_recoil[int(pReadEvGen->LabAngle_recoil[j])])/
-	                   (pReadEvGen->LabAngle_recoil[j+1]-pReadEvGen->LabAngle_recoil[j]);
-            offset_rec=pReadEvGen->LabEnergy_recoil[int(pReadEvGen->LabAngle_scatt[j])]-
-	                     slop_rec*pReadEvGen->LabAngle_recoil[j];
-      	    energy_recoil=theta_recoil*slop_rec+offset_rec;
-          }
-        }
-        theta=theta*deg;   // Polar angle in radian
-        theta_recoil=theta_recoil*deg;   // Polar angle in radian
+  // After the beam, the reaction products (see GenerateReaction()).
+  // With the acceptance filter they are tested before the tracking
+  if(acceptanceFilterMode == "off")
+    GenerateReaction(anEvent);
+  else
+    GenerateAcceptedReaction(anEvent);
+
+  ActarSimBeamInfo *pBeamInfo = (ActarSimBeamInfo*) 0;
+  if(gActarSimROOTAnalysis){
+    pBeamInfo = gActarSimROOTAnalysis->GetBeamInfo();
+    //Histogramming
+    gActarSimROOTAnalysis->GeneratePrimaries(anEvent,pBeamInfo);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Generates the reaction products and tests them with the acceptance
+/// filter before the tracking. The products are generated in a scratch
+/// event and copied to anEvent if accepted. If not, the event is aborted
+/// (acceptanceFilterMode reject) or the reaction is generated again, at
+/// the same vertex and with the same beam, up to acceptanceMaxTries times
+/// (resample). Note that resampling changes the vertex distribution of
+/// the accepted events, as vertices with low acceptance are kept anyway
+void ActarSimPrimaryGeneratorAction::GenerateAcceptedReaction(G4Event* anEvent) {
+  //an event already aborted (beam error) is not tested
+  if(anEvent->IsAborted()) {
+    GenerateReaction(anEvent);
+    return;
+  }
+
+  G4int maxTries = (acceptanceFilterMode == "resample") ? acceptanceMaxTries : 1;
+  for(G4int i=0;i<maxTries;i++){
+    G4Event trial(anEvent->GetEventID());
+    GenerateReaction(&trial);
+    G4bool accepted = !trial.IsAborted() && acceptanceFilter->Accept(&trial);
+    acceptanceFilter->Count(accepted);
+    if(!accepted) continue;
+
+    //the vertices are owned by the scratch event; the particles are copied
+    for(G4int iv=0;iv<trial.GetNumberOfPrimaryVertex();iv++){
+      G4PrimaryVertex* source = trial.GetPrimaryVertex(iv);
+      G4PrimaryVertex* vertex = new G4PrimaryVertex(source->GetPosition(),source->GetT0());
+      for(G4int ip=0;ip<source->GetNumberOfParticle();ip++){
+	G4PrimaryParticle* original = source->GetPrimary(ip);
+	G4PrimaryParticle* particle = new G4PrimaryParticle(original->GetG4code(),
+							    original->GetPx(),
+							    original->GetPy(),
+							    original->GetPz());
+	particle->SetCharge(original->GetCharge());
+	particle->SetPolarization(original->GetPolarization());
+	particle->SetWeight(original->GetWeight());
+	vertex->SetPrimary(particle);
       }
+      anEvent->AddPrimaryVertex(vertex);
     }
-    // Azimuthal angle:
-    phi = G4UniformRand()*twopi;
+    return;
+  }
 
-    momentum_x = sin(theta)*cos(phi);
-    momentum_y = sin(theta)*sin(phi);
-    momentum_z = cos(theta);
+  if(G4RunManager::GetRunManager()->GetVerboseLevel()>0)
+    G4cout << " ActarSimPrimaryGeneratorAction::GenerateAcceptedReaction(): no reaction"
+	   << " in the acceptance after " << maxTries << " tries. The event is aborted." << G4endl;
+  anEvent->SetEventAborted();
+}
 
-    momentum_x_rec = sin(theta_recoil)*cos(phi+pi);
-    momentum_y_rec = sin(theta_recoil)*sin(phi+pi);
-    momentum_z_rec = cos(theta_recoil);
+//////////////////////////////////////////////////////////////////
+/// Generates the reaction products (CASES B to F in GeneratePrimaries())
+/// at the present vertex position and with the present beam energy
+void ActarSimPrimaryGeneratorAction::GenerateReaction(G4Event* anEvent) {
+  const G4int verboseLevel = G4RunManager::GetRunManager()->GetVerboseLevel();
+  reactionWeight = 1.;
 
-    particle_energy = energy_scatt;
-    LabParticleAngle = theta;
+  G4ThreeVector zero;
+  G4double theta1=0.;
+  G4double theta2=0.;
+  G4double energy1=0.;
+  G4double energy2=0.;
 
-    particle_energy_rec = energy_recoil;
-    LabParticleAngle_rec = theta_recoil;
+  // After the beam, now different options for the reaction products!
+  //
+  // CASE B Reaction from Event-Generator
+  //
+  if(reactionFromEvGenFlag == "on") {
+    // The events (particles and momenta) are read from evGenFile (see
+    // ActarSimEventGenerator); the vertex is the present vertex position
+    if(!eventGenerator->IsOpen(evGenFile) && !eventGenerator->Open(evGenFile)) {
+      anEvent->SetEventAborted();
+      G4RunManager::GetRunManager()->AbortRun(true);
+      return;
+    }
 
-    */
-    //Send 2 vertex
-    //Define ions from the macro (talk to Hector->use the ones from CINE)
+    //time, including the beam tracking before the vertex formation
+    G4double time = 0.;
+    if(beamInteractionFlag == "on" && gActarSimROOTAnalysis)
+      time = gActarSimROOTAnalysis->GetBeamInfo()->GetTimeVertex();
+
+    if(!eventGenerator->GenerateEvent(anEvent,vertexPosition,time)) {
+      G4cout << "ActarSimPrimaryGeneratorAction::GeneratePrimaries() - no more events in "
+	     << evGenFile << " after " << eventGenerator->GetNumberOfEventsRead()
+	     << " events; the run is aborted." << G4endl;
+      anEvent->SetEventAborted();
+      G4RunManager::GetRunManager()->AbortRun(true);
+      return;
+    }
+    if(verboseLevel>0)
+      G4cout << "ActarSimPrimaryGeneratorAction::GeneratePrimaries() - event "
+	     << eventGenerator->GetNumberOfEventsRead() << " of " << evGenFile
+	     << " generated at " << vertexPosition/mm << " mm" << G4endl;
   }
 
   // CASE C Reaction products taken from a file (format given by CINE output)
-  if(reactionFromFileFlag == "on"){
+  else if(reactionFromFileFlag == "on"){
     // FILE format: first row should contain 6 integers with the info:
     //    scattered ion Z;  scattered ion A;  scattered ion charge state;
     //    recoiled ion Z;  recoil ion A;  recoil ion charge state;
@@ -474,15 +993,14 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
 	     << " * An external file with products information is used."  << G4endl;
       G4cout << " *************************************************** "<< G4endl;
     }
-    ifstream inputFile(reactionFile);
-    if(reactionFile) {
-      //TODO Modify completely this funtion!!! Dynamic objetc to avoid hardcoded size in arrays and limits
-      G4double cine[91*4+1];
-      G4int  ion1Z, ion1A, ion1Charge;
-      G4int  ion2Z, ion2A, ion2Charge;
-
-      inputFile >> ion1Z;    inputFile >> ion1A;    inputFile >> ion1Charge;
-      inputFile >> ion2Z;    inputFile >> ion2A;    inputFile >> ion2Charge;
+    //The file is parsed only once (or when the file or the weighting changes)
+    if(LoadReactionFile()) {
+      G4int  ion1Z = reactionTable->GetIon1Z();
+      G4int  ion1A = reactionTable->GetIon1A();
+      G4int  ion1Charge = reactionTable->GetIon1Charge();
+      G4int  ion2Z = reactionTable->GetIon2Z();
+      G4int  ion2A = reactionTable->GetIon2A();
+      G4int  ion2Charge = reactionTable->GetIon2Charge();
 
       if(verboseLevel>1){
         G4cout << G4endl
@@ -491,19 +1009,13 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
 	       << " Second ion Z, A and Charge: "
 	       << ion2Z << " " << ion2A << " " << ion2Charge << G4endl;
       }
-      G4int i=0;
-      do{
-        inputFile >>  cine[i];
-        i++;
-      }while(!inputFile.eof());
-
-      G4int rowsInputFile = (G4int) i/4;
-      //Taken a random cinematic from the previous table
-      G4int randomRow = (G4int)(G4UniformRand()*rowsInputFile);
-      theta1 = pi*cine[randomRow*4]/180;
-      theta2 = pi*cine[randomRow*4+2]/180;
-      energy1 = cine[randomRow*4+1];
-      energy2 = cine[randomRow*4+3];
+
+      //Taken a random cinematic from the table
+      G4int randomRow = reactionTable->SampleRow();
+      theta1 = pi*reactionTable->GetTheta1(randomRow)/180;
+      theta2 = pi*reactionTable->GetTheta2(randomRow)/180;
+      energy1 = reactionTable->GetEnergy1(randomRow);
+      energy2 = reactionTable->GetEnergy2(randomRow);
       G4double phi = twopi *G4UniformRand();   //flat in phi
       G4ThreeVector direction1 = G4ThreeVector(sin(theta1)*cos(phi),
 					       sin(theta1)*sin(phi),
@@ -546,7 +1058,7 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
       }
       else{
         G4Ions* ion2;
-        ion2 = (G4Ions*) ionTable->GetIon(ion2Z, ion2Z, 0.0);
+        ion2 = (G4Ions*) ionTable->GetIon(ion2Z, ion2A, 0.0);
         particleGun->SetParticleDefinition(ion2);
         particleGun->SetParticleCharge(ion2Charge);
       }
@@ -569,11 +1081,8 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
 
       particleGun->GeneratePrimaryVertex(anEvent);
     }
-    else { //no file found
-      G4cout << " *************************************************** " << G4endl
-             << "File " << reactionFile << " not found." << G4endl;
-      G4cout << " *************************************************** "<< G4endl;
-    }
+    else //no file found, or no valid rows in the file
+      anEvent->SetEventAborted();
   } //end of if(reactionFromFileFlag == "on")
 
   //CASE D  Reaction products kinematics calculated using Cine
@@ -605,17 +1114,9 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
       recoilIonCharge = 6;
     }
 
-    //CINE object...
-    ActarSimCinePrimGenerator* CINE = new ActarSimCinePrimGenerator();
-
-    CINE->SetIncidentMass(GetIncidentIon()->GetAtomicMass());
-    CINE->SetTargetMass(GetTargetIon()->GetAtomicMass());
-    CINE->SetScatteredMass(GetScatteredIon()->GetAtomicMass());
-    CINE->SetRecoilMass(GetRecoilIon()->GetAtomicMass());
-    CINE->SetReactionQ(GetReactionQ());
-    CINE->SetLabEnergy(GetLabEnergy());
-    CINE->SetTargetExcitationEnergy(GetTargetIon()->GetExcitationEnergy()/MeV);
-    CINE->SetProjectileExcitationEnergy(GetIncidentIon()->GetExcitationEnergy()/MeV);
+    //The kinematics are tabulated at the first event of the run
+    if(!cineTable->IsBuilt()) BuildCineTable();
+
     // Random generator for scattered angle triggered by a messenger Cmd
     if(randomThetaFlag == "on") {
       if(verboseLevel>0){
@@ -629,10 +1130,15 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
 	       << randomThetaMin/deg << "," << randomThetaMax/deg << "] degrees)" << G4endl;
       }
 
-      //flat prob in theta from randomThetaMin to randomThetaMin
-      SetThetaLabAngle((randomThetaMin +
-			((randomThetaMax-randomThetaMin) * G4UniformRand())) * rad);
-      CINE->SetThetaLabAngle(GetThetaLabAngle()/deg);
+      //flat prob in theta from randomThetaMin to randomThetaMax, restricted
+      //to the angles with a CINE solution for the present energy
+      //(or from the bias density, with a weight, zero for the angles
+      //without CINE solution; these events are aborted)
+      G4double theta;
+      if(angularBiasFlag == "on" && SampleBiasedAngle(false,theta)) {;}
+      else if(!cineTable->SampleAngle(GetLabEnergy(),randomThetaMin,randomThetaMax,theta))
+	theta = randomThetaMin + ((randomThetaMax-randomThetaMin) * G4UniformRand());
+      SetThetaLabAngle(theta * rad);
 
       if(verboseLevel>0) {
         G4cout << G4endl
@@ -657,163 +1163,110 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
 	     << GetTargetIon()->GetExcitationEnergy() << G4endl;
       G4cout << " * Setting projectileExcitationEnergy to:"
 	     << GetIncidentIon()->GetExcitationEnergy() << G4endl;
-      G4cout << " * Setting labAngle to:" << GetThetaLabAngle() << " deg" << G4endl;
+      G4cout << " * Setting labAngle to:" << GetThetaLabAngle()/deg << " deg" << G4endl;
       G4cout << " *************************************************** "<< G4endl;
     }
 
-    if(verboseLevel>2){
-      //Parameters are introduced in CINE... Just a checker
-      G4cout << " CINE: Checking parameters..." << CINE->GetS1()
-	     << " " << CINE->GetS2() << " " << CINE->GetS3()
-	     << " " << CINE->GetS4() << " " << CINE->GetQM()
-	     << " " << CINE->GetEI() << " " << CINE->GetEN()
-	     << " " << CINE->GetENI() << " " << CINE->GetThetaLabAngle() << endl;
-    }
     if(verboseLevel>2){
       //Parameters are introduced in CINE... Just a checker
       G4cout << " " << G4endl;
       G4cout << " CINE: Checking... parameters are introduced in CINE..." << G4endl;
-      //G4cout << " verboseLevel>0..." << G4endl;
-      G4cout << " mass of the incident particle = " << CINE->GetS1()<< G4endl;
-      G4cout << " mass of the target = " << CINE->GetS2() << G4endl;
-      G4cout << " mass of the scattered particle = " << CINE->GetS3()<< G4endl;
-      G4cout << " mass of the recoil = " << CINE->GetS4() << G4endl;
-      G4cout << " Reaction Q = " << CINE->GetQM()<< G4endl;
-      G4cout << " LAB energy (total Lab energy in MeV) = " << CINE->GetEI() << G4endl;
-      G4cout << " Target excitation energy (positive) = " << CINE->GetEN()<< G4endl;
-      G4cout << " Projectile excitation energy (positive) = " << CINE->GetENI() << G4endl;
-      G4cout << " CINE->GetThetaLabAngle = " << CINE->GetThetaLabAngle() << G4endl;
+      G4cout << " mass of the incident particle = " << cineGenerator->GetS1()<< G4endl;
+      G4cout << " mass of the target = " << cineGenerator->GetS2() << G4endl;
+      G4cout << " mass of the scattered particle = " << cineGenerator->GetS3()<< G4endl;
+      G4cout << " mass of the recoil = " << cineGenerator->GetS4() << G4endl;
+      G4cout << " Reaction Q = " << cineGenerator->GetQM()<< G4endl;
+      G4cout << " Target excitation energy (positive) = " << cineGenerator->GetEN()<< G4endl;
+      G4cout << " Projectile excitation energy (positive) = " << cineGenerator->GetENI() << G4endl;
       G4cout << " " << G4endl;
     }
 
-    //Calling the relativistic kinematic calculation
-    CINE->RelativisticKinematics();
-
-    if(verboseLevel>1){
-      G4cout << " *************************************************** "<< G4endl;
-      G4cout << " ***** CINE: Relativistic calculation invoked ****** "<< G4endl;
-      G4cout << " *************************************************** "<< G4endl;
-    }
+    //Interpolated (or calculated) relativistic kinematics
+    G4double cineEnergy1[2], cineTheta2[2], cineEnergy2[2];
+    G4int nSolutions = CineKinematics(GetThetaLabAngle(),cineEnergy1,cineTheta2,cineEnergy2);
 
-    G4int stillNoSol=0;
-    if(CINE->GetANGAV(1)<0 && randomThetaFlag == "on") {
-      while( CINE->GetANGAV(1)<0 && stillNoSol<50) { //50 tries to get a result!
-        G4cout << " *************************************************** "<< G4endl;
-        G4cout << " * There is no CINE solution" << G4endl;
-        G4cout << " * Trying again with CINE and other scattered angle..." << G4endl;
-        stillNoSol++;
-        SetThetaLabAngle(pi * G4UniformRand() * rad);
-        CINE->SetThetaLabAngle(GetThetaLabAngle()/deg);
-        if(verboseLevel>1) G4cout << " *** random Theta = "
-				  << GetThetaLabAngle()/rad << " rad = "
-				  << GetThetaLabAngle()/deg  << " deg "<< G4endl;
-	//Calling again the relativistic kinematic calculation
-	CINE->RelativisticKinematics();
-      }
-      if(stillNoSol>49)
-        G4cout << G4endl
-               << " ####################################################### "<< G4endl
-	       << " ERROR in ActarSimPrimaryGeneratorAction::GeneratePrimaries()" << G4endl
-	       << " There is no CINE solution for any angle" << G4endl
-	       << " A dummy solution is used: DO NOT RELY ON THE RESULTS!" << G4endl
-	       << " ####################################################### "<< G4endl;
-    }
-    if(CINE->GetANGAV(1)<0 && randomThetaFlag == "off") {
+    G4int selected = 0;
+    if(nSolutions == 0) {
       G4cout << G4endl
              <<" ####################################################### "<< G4endl
 	     << " ERROR in ActarSimPrimaryGeneratorAction::GeneratePrimaries()" << G4endl
 	     << " There is no CINE solution for this angle" << G4endl
-	     << " A dummy solution is used: DO NOT RELY ON THE RESULTS!" << G4endl
+	     << " The event is aborted." << G4endl
 	     <<" ####################################################### "<< G4endl;
-      theta2 = (CINE->GetANGAV(4))*deg;
-      energy1 = CINE->GetANGAV(1);
-      energy2 = CINE->GetANGAV(5);
+      anEvent->SetEventAborted();
     }
-    else if( CINE->GetANGAR(1)<0 && stillNoSol<50) {
-      if(verboseLevel>0){
-        G4cout << " One solution:" << G4endl;
-	CINE->printResults(0);
-      }
-      theta2 = (CINE->GetANGAV(4))*deg;
-      energy1 = CINE->GetANGAV(1);
-      energy2 = CINE->GetANGAV(5);
+    else if(nSolutions == 1) {
+      if(verboseLevel>0) G4cout << " One solution" << G4endl;
     }
     else {
       //In this case one should select only one of the two possible cases!
+      if(verboseLevel>0) G4cout << " Two solutions" << G4endl;
+      selected = (G4int)(2*G4UniformRand());
+    }
+
+    if(nSolutions > 0) {
+      theta2 = cineTheta2[selected];
+      energy1 = cineEnergy1[selected];
+      energy2 = cineEnergy2[selected];
       if(verboseLevel>0){
-        G4cout << " Two solutions" << G4endl;
-        G4cout << " First solution:" << G4endl;
-        CINE->printResults(0);
-        G4cout << " Second solution:" << G4endl;
-        CINE->printResults(1);
-      }
-      if((G4int)(2*G4UniformRand()) == 0){
-        //theta2 = pi*CINE->GetANGAV(4)/180;
-        theta2 = (CINE->GetANGAV(4))*deg;
-        energy1 = CINE->GetANGAV(1);
-        energy2 = CINE->GetANGAV(5);
-      }
-      else{
-        //theta2 = pi*CINE->GetANGAV(4)/180;
-        theta2 = (CINE->GetANGAV(4))*deg;
-        energy1 = CINE->GetANGAR(1);
-        energy2 = CINE->GetANGAR(5);
+        G4cout << " CINE result:    Scattered Particle Angle: " << GetThetaLabAngle()/deg
+	       << " deg,    Scattered Particle Energy: " << energy1/MeV  << " MeV" << G4endl;
+        G4cout << " CINE result:    Recoil Particle Angle: " << theta2/deg
+	       << " deg,    Recoil Particle Energy: " << energy2/MeV  << " MeV" << G4endl;
+        G4cout << " *************************************************** "<< G4endl;
+        G4cout << " At least one solution found... generating primaries." << G4endl;
+        G4cout << " " << G4endl;
       }
-    }
-    if(verboseLevel>0){
-      G4cout << " *************************************************** "<< G4endl;
-      G4cout << " At least one solution found... generating primaries." << G4endl;
-      G4cout << " " << G4endl;
-    }
-    theta1 = CINE->GetThetaLabAngle()*deg;      //Note the units coming from CINE !
-    G4double phi = twopi * G4UniformRand();         //flat probability in phi
-    G4ThreeVector direction1 = G4ThreeVector(sin(theta1)*cos(phi),
-					     sin(theta1)*sin(phi),
-					     cos(theta1));
-    G4ThreeVector direction2 = G4ThreeVector(sin(theta2)*cos(phi+pi),
-					     sin(theta2)*sin(phi+pi),
-					     cos(theta2));
+      theta1 = GetThetaLabAngle();
+      G4double phi = twopi * G4UniformRand();         //flat probability in phi
+      G4ThreeVector direction1 = G4ThreeVector(sin(theta1)*cos(phi),
+					       sin(theta1)*sin(phi),
+					       cos(theta1));
+      G4ThreeVector direction2 = G4ThreeVector(sin(theta2)*cos(phi+pi),
+					       sin(theta2)*sin(phi+pi),
+					       cos(theta2));
 
-    particleGun->SetParticleDefinition(scatteredIon);
-    particleGun->SetParticleCharge(scatteredIonCharge);
-    particleGun->SetParticlePosition(vertexPosition);
-    //time, including the beam tracking before the vertex formation
-    if(beamInteractionFlag == "on") {
-      ActarSimBeamInfo *pBeamInfo = (ActarSimBeamInfo*) 0;
-      if(gActarSimROOTAnalysis) {
-        pBeamInfo = gActarSimROOTAnalysis->GetBeamInfo();
-        particleGun->SetParticleTime(pBeamInfo->GetTimeVertex());
+      particleGun->SetParticleDefinition(scatteredIon);
+      particleGun->SetParticleCharge(scatteredIonCharge);
+      particleGun->SetParticlePosition(vertexPosition);
+      //time, including the beam tracking before the vertex formation
+      if(beamInteractionFlag == "on") {
+        ActarSimBeamInfo *pBeamInfo = (ActarSimBeamInfo*) 0;
+        if(gActarSimROOTAnalysis) {
+          pBeamInfo = gActarSimROOTAnalysis->GetBeamInfo();
+          particleGun->SetParticleTime(pBeamInfo->GetTimeVertex());
+        }
       }
-    }
-    else
-      particleGun->SetParticleTime(0.0);
+      else
+        particleGun->SetParticleTime(0.0);
 
-    particleGun->SetParticlePolarization(zero);
-    particleGun->SetParticleMomentumDirection(direction1);
-    particleGun->SetParticleEnergy(energy1);
+      particleGun->SetParticlePolarization(zero);
+      particleGun->SetParticleMomentumDirection(direction1);
+      particleGun->SetParticleEnergy(energy1);
 
-    particleGun->GeneratePrimaryVertex(anEvent);
+      particleGun->GeneratePrimaryVertex(anEvent);
 
-    particleGun->SetParticleDefinition(recoilIon);
-    particleGun->SetParticleCharge(recoilIonCharge);
-    particleGun->SetParticlePosition(vertexPosition);
+      particleGun->SetParticleDefinition(recoilIon);
+      particleGun->SetParticleCharge(recoilIonCharge);
+      particleGun->SetParticlePosition(vertexPosition);
 
-    //time, including the beam tracking before the vertex formation
-    if(beamInteractionFlag == "on") {
-      ActarSimBeamInfo *pBeamInfo = (ActarSimBeamInfo*) 0;
-      if(gActarSimROOTAnalysis) {
-        pBeamInfo = gActarSimROOTAnalysis->GetBeamInfo();
-        particleGun->SetParticleTime(pBeamInfo->GetTimeVertex());
+      //time, including the beam tracking before the vertex formation
+      if(beamInteractionFlag == "on") {
+        ActarSimBeamInfo *pBeamInfo = (ActarSimBeamInfo*) 0;
+        if(gActarSimROOTAnalysis) {
+          pBeamInfo = gActarSimROOTAnalysis->GetBeamInfo();
+          particleGun->SetParticleTime(pBeamInfo->GetTimeVertex());
+        }
       }
-    }
-    else
-      particleGun->SetParticleTime(0.0);
+      else
+        particleGun->SetParticleTime(0.0);
 
-    particleGun->SetParticlePolarization(zero);
-    particleGun->SetParticleMomentumDirection(direction2);
-    particleGun->SetParticleEnergy(energy2);
+      particleGun->SetParticlePolarization(zero);
+      particleGun->SetParticleMomentumDirection(direction2);
+      particleGun->SetParticleEnergy(energy2);
 
-    particleGun->GeneratePrimaryVertex(anEvent);
+      particleGun->GeneratePrimaryVertex(anEvent);
+    }
   }
 
   //CASE E Reaction products kinematics calculated using Kine
@@ -845,76 +1298,65 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
       recoilIonCharge = 6;
     }
 
-    //KINE object...
-    ActarSimKinePrimGenerator* KINE = new ActarSimKinePrimGenerator();
-
-    KINE->SetMassOfProjectile(GetMassOfProjectile());
-    KINE->SetMassOfTarget(GetMassOfTarget());
-    KINE->SetMassOfScattered(GetMassOfScattered());
-    KINE->SetMassOfRecoiled(GetMassOfRecoiled());
-
-    KINE->SetExEnergyOfProjectile(GetExEnergyOfProjectile());
-    KINE->SetExEnergyOfTarget(GetExEnergyOfTarget());
-    KINE->SetExEnergyOfScattered(GetExEnergyOfScattered());
-    KINE->SetExEnergyOfRecoiled(GetExEnergyOfRecoiled());
+    //The kinematics are tabulated at the first event of the run
+    if(!kineTable->IsBuilt()) BuildKineTable();
 
-    KINE->SetLabEnergy(GetLabEnergy());
-
-    // Random generator for scattered angle triggered by a messenger Cmd
-    if(randomThetaFlag == "on") {
+    // CM angle distributed according to the bias density, with a weight ...
+    G4double biasedAngle;
+    if(angularBiasFlag == "on" &&
+       SampleBiasedAngle(reactionFromCrossSectionFlag == "on",biasedAngle)) {
+      SetThetaCMAngle(biasedAngle);
+      if(verboseLevel>1)
+        G4cout << " *** biased CM Theta = " << GetThetaCMAngle()/deg << " deg, weight "
+               << reactionWeight << G4endl;
+    }
+    // ... or according to the cross section ...
+    else if(reactionFromCrossSectionFlag == "on") {
+      if(!crossSectionTable->IsLoaded(crossSectionFile))
+        crossSectionTable->Load(crossSectionFile);
+      if(crossSectionTable->GetNumberOfPoints()>0)
+        SetThetaCMAngle(crossSectionTable->SampleThetaCM());
+      else
+        G4cout << " *************************************************** " << G4endl
+               << "Cross section file " << crossSectionFile << " not found or not valid." << G4endl
+               << "Using the CM angle " << GetThetaCMAngle()/deg << " deg" << G4endl;
+      if(verboseLevel>1)
+        G4cout << " *** CM Theta from cross section = " << GetThetaCMAngle()/deg << " deg "<< G4endl;
+    }
+    // ... or random generator for scattered angle triggered by a messenger Cmd
+    else if(randomThetaFlag == "on") {
       SetThetaCMAngle((randomThetaMin +              // randomThetaMin, randomThetaMax, use exist ones
 		       ((randomThetaMax-randomThetaMin) * G4UniformRand())) * rad);
-      KINE->SetThetaCMAngle(GetThetaCMAngle()/deg);  // units: degree, deg=pi/180.
       if(verboseLevel>1)
         G4cout << " *** random CM Theta = " << GetThetaCMAngle() << ", it is "
                << GetThetaCMAngle()/rad << " rad = "
                << GetThetaCMAngle()/deg << " deg "<< G4endl;
     }
-    else {
-      KINE->SetThetaCMAngle(GetThetaCMAngle()/deg);  // units: degree
-    }
     if(verboseLevel>1){
       G4cout << " KINE: Setting (atomic) masses to :" << GetIncidentIon()->GetAtomicMass()
 	     << " " << GetTargetIon()->GetAtomicMass()
 	     << " " << GetScatteredIon()->GetAtomicMass()
 	     << " " << GetRecoilIon()->GetAtomicMass()<< " "<< endl;
-      G4cout << " KINE: Setting labEnergy to:" << KINE->GetLabEnergy() << G4endl;
+      G4cout << " KINE: Setting labEnergy to:" << GetLabEnergy() << G4endl;
       G4cout << " KINE: Setting targetExcitationEnergy to:"
 	     << GetTargetIon()->GetExcitationEnergy() << G4endl;
       G4cout << " KINE: Setting projectileExcitationEnergy to:"
 	     << GetIncidentIon()->GetExcitationEnergy() << G4endl;
       G4cout << " Kine: Setting excitation energy of Scattered particle to:"
 	     << GetScatteredIon()->GetExcitationEnergy() << G4endl;
-      G4cout << " KINE: Setting CM Angle to:" << KINE->GetThetaCMAngle() << " deg" << G4endl;
-    }
-    //Calling the relativistic kinematic calculation
-    KINE->KineKinematics();
-
-    if(KINE->GetNoSolution()) G4cout << "Kine NO solution, check your input!" << G4endl;
-
-    if(verboseLevel>1){
-      G4cout << " *************************************************** "<< G4endl;
-      G4cout << " ***** KINE: Relativistic calculation invoked ****** "<< G4endl;
-      G4cout << " *************************************************** "<< G4endl;
+      G4cout << " KINE: Setting CM Angle to:" << GetThetaCMAngle()/deg << " deg" << G4endl;
     }
 
+    //Interpolated (or calculated) relativistic kinematics
     G4double thetaBeam1, thetaBeam2;
-
-    thetaBeam1 = KINE->GetANGAs(0);    // unit: rad
-    thetaBeam2 = KINE->GetANGAr(0);    // unit: rad
-    energy1    = KINE->GetANGAs(1);    // unit: MeV
-    energy2    = KINE->GetANGAr(1);    // unit: MeV
+    if(!KineKinematics(GetThetaCMAngle(),thetaBeam1,energy1,thetaBeam2,energy2))
+      G4cout << "Kine NO solution, check your input!" << G4endl;
 
     if(verboseLevel>1){
-      G4cout << "Kine: Scattered energy:" << KINE->GetANGAs(1) << " MeV" << G4endl;
-      G4cout << "Kine: Recoiled energy:" << KINE->GetANGAr(1) << " MeV" << G4endl;
-      G4cout << "Kine: Scattered angle:"  << KINE->GetANGAs(0)/deg << " deg" << G4endl;
-      G4cout << "Kine: recoiled  angle:"  << KINE->GetANGAr(0)/deg << " deg" << G4endl;
-      G4cout << "Kine: passed Scattered energy:" << energy1 << " MeV" << G4endl;
-      G4cout << "Kine: passed Recoil energy:"    << energy2 << " MeV" << G4endl;
-      G4cout << "Kine: passed Scattered angle:"  << theta1/deg  << " deg" << G4endl;
-      G4cout << "Kine: passed Recoil angle:"     << theta2/deg  << " deg" << G4endl;
-      G4cout << "deg=" << deg << ", MeV=" << MeV << G4endl;
+      G4cout << "Kine: Scattered energy:" << energy1/MeV << " MeV" << G4endl;
+      G4cout << "Kine: Recoiled energy:" << energy2/MeV << " MeV" << G4endl;
+      G4cout << "Kine: Scattered angle:"  << thetaBeam1/deg << " deg" << G4endl;
+      G4cout << "Kine: recoiled  angle:"  << thetaBeam2/deg << " deg" << G4endl;
     }
     G4double phiBeam1=0., phiBeam2=0.;
     phiBeam1 = twopi * G4UniformRand();         //flat probability in phi
@@ -926,34 +1368,31 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
     ActarSimBeamInfo *pBeamInfo = (ActarSimBeamInfo*) 0;
     if(gActarSimROOTAnalysis) pBeamInfo=gActarSimROOTAnalysis->GetBeamInfo();
 
-    ActarSimEulerTransformation* EulerTransformer = new ActarSimEulerTransformation();
-
-    EulerTransformer->SetThetaInBeamSystem(thetaBeam1);
-    EulerTransformer->SetPhiInBeamSystem(phiBeam1);
-    EulerTransformer->SetBeamDirectionAtVertexTheta(pBeamInfo->GetThetaVertex());
-    EulerTransformer->SetBeamDirectionAtVertexPhi(pBeamInfo->GetPhiVertex());
-    EulerTransformer->DoTheEulerTransformationBeam2Lab();   // Euler transformation for particle 1
+    eulerTransformer->SetThetaInBeamSystem(thetaBeam1);
+    eulerTransformer->SetPhiInBeamSystem(phiBeam1);
+    eulerTransformer->SetBeamDirectionAtVertexTheta(pBeamInfo->GetThetaVertex());
+    eulerTransformer->SetBeamDirectionAtVertexPhi(pBeamInfo->GetPhiVertex());
+    eulerTransformer->DoTheEulerTransformationBeam2Lab();   // Euler transformation for particle 1
 
-    thetaLab1 = EulerTransformer->GetThetaInLabSystem();
-    phiLab1   = EulerTransformer->GetPhiInLabSystem();
+    thetaLab1 = eulerTransformer->GetThetaInLabSystem();
+    phiLab1   = eulerTransformer->GetPhiInLabSystem();
     if(randomPhiAngleFlag=="off") phiLab1 = GetUserPhiAngle()+pi;
 
     G4ThreeVector direction1 = G4ThreeVector(sin(thetaLab1)*cos(phiLab1),
                                              sin(thetaLab1)*sin(phiLab1),
                                              cos(thetaLab1));
 
-    EulerTransformer->SetThetaInBeamSystem(thetaBeam2);
-    EulerTransformer->SetPhiInBeamSystem(phiBeam2);
-    EulerTransformer->DoTheEulerTransformationBeam2Lab();   // Euler transformation for particle 2
+    eulerTransformer->SetThetaInBeamSystem(thetaBeam2);
+    eulerTransformer->SetPhiInBeamSystem(phiBeam2);
+    eulerTransformer->DoTheEulerTransformationBeam2Lab();   // Euler transformation for particle 2
 
-    thetaLab2 = EulerTransformer->GetThetaInLabSystem();
-    phiLab2   = EulerTransformer->GetPhiInLabSystem();
+    thetaLab2 = eulerTransformer->GetThetaInLabSystem();
+    phiLab2   = eulerTransformer->GetPhiInLabSystem();
     if(randomPhiAngleFlag=="off") phiLab2 = GetUserPhiAngle();
 
     G4ThreeVector direction2 = G4ThreeVector(sin(thetaLab2)*cos(phiLab2),
 					     sin(thetaLab2)*sin(phiLab2),
 					     cos(thetaLab2));
-    delete EulerTransformer;
 
     particleGun->SetParticleDefinition(scatteredIon);
     particleGun->SetParticleCharge(scatteredIonCharge);
@@ -1033,6 +1472,41 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
     }//end if(ExEnergyScattered>0)
   }
 
+  // CASE G  N-body phase space for breakup channels
+  else if(reactionFromPhaseSpaceFlag == "on"){
+    if(verboseLevel>0){
+      G4cout << G4endl
+             << " *************************************************** " << G4endl
+             << " * ActarSimPrimaryGeneratorAction::GeneratePrimaries() " << G4endl
+             << " * reactionFromPhaseSpaceFlag = on                     " << G4endl
+             << " * N-body phase space with " << phaseSpaceGenerator->GetNumberOfProducts()
+             << " products." << G4endl;
+      G4cout << " *************************************************** "<< G4endl;
+    }
+    if(!incidentIon) {
+      incidentIon =  (G4Ions*) ionTable->GetIon(2, 8, 0.);  // 8He (S1)
+      incidentIonCharge =  2;
+    }
+    if(!targetIon) {
+      targetIon = (G4Ions*) ionTable->GetIon(6, 12, 0.);     // C12 (S2)
+      targetIonCharge = 6;
+    }
+
+    //time, including the beam tracking before the vertex formation
+    G4double time = 0.;
+    if(beamInteractionFlag == "on" && gActarSimROOTAnalysis)
+      time = gActarSimROOTAnalysis->GetBeamInfo()->GetTimeVertex();
+
+    if(!phaseSpaceGenerator->GenerateEvent(anEvent,vertexPosition,time,
+                                           incidentIon,GetLabEnergy(),targetIon,
+                                           beamInteractionFlag != "on")) {
+      G4cout << " ActarSimPrimaryGeneratorAction::GeneratePrimaries(): no phase space"
+             << " event generated (check the products). The event is aborted." << G4endl;
+      anEvent->SetEventAborted();
+      return;
+    }
+  }
+
   // CASE F  Particle selected manually (using the messenger commands)
   else{
     if(verboseLevel>0){
@@ -1115,10 +1589,12 @@ void ActarSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent) {
     particleGun->GeneratePrimaryVertex(anEvent);
   }
 
-  ActarSimBeamInfo *pBeamInfo = (ActarSimBeamInfo*) 0;
-  if(gActarSimROOTAnalysis){
-    pBeamInfo = gActarSimROOTAnalysis->GetBeamInfo();
-    //Histogramming
-    gActarSimROOTAnalysis->GeneratePrimaries(anEvent,pBeamInfo);
+  //importance sampling weight of the reaction angle (angularBiasFlag)
+  if(angularBiasFlag == "on") {
+    for(G4int i=0;i<anEvent->GetNumberOfPrimaryVertex();i++){
+      G4PrimaryVertex* vertex = anEvent->GetPrimaryVertex(i);
+      for(G4int j=0;j<vertex->GetNumberOfParticle();j++)
+	vertex->GetPrimary(j)->SetWeight(vertex->GetPrimary(j)->GetWeight()*reactionWeight);
+    }
   }
 }
@@ -43,10 +43,18 @@
 /// - /ActarSim/gun/beamPhi
 /// - /ActarSim/gun/beamPosition
 /// - /ActarSim/gun/beamRadiusAtEntrance
+/// - /ActarSim/gun/beamPhaseSpace
+/// - /ActarSim/gun/beamPhaseSpaceFile
 /// - /ActarSim/gun/reactionFromEvGen
+/// - /ActarSim/gun/evGenFile
+/// - /ActarSim/gun/evGenPrefetchSize
 /// - /ActarSim/gun/reactionFromFile
 /// - /ActarSim/gun/reactionFromCrossSection
 /// - /ActarSim/gun/reactionFile
+/// - /ActarSim/gun/reactionFileWeighted
+/// - /ActarSim/gun/crossSectionFile
+/// - /ActarSim/gun/angularBias
+/// - /ActarSim/gun/angularBiasFile
 /// - /ActarSim/gun/reactionFromCine
 /// - /ActarSim/gun/Cine/randomTheta
 /// - /ActarSim/gun/randomTheta
@@ -62,6 +70,10 @@
 /// - /ActarSim/gun/Cine/reactionQ
 /// - /ActarSim/gun/Cine/labEnergy
 /// - /ActarSim/gun/Cine/thetaLabAngle
+/// - /ActarSim/gun/reactionFromPhaseSpace
+/// - /ActarSim/gun/PhaseSpace/products
+/// - /ActarSim/gun/PhaseSpace/weighted
+/// - /ActarSim/gun/PhaseSpace/batchSize
 /// - /ActarSim/gun/reactionFromKine
 /// - /ActarSim/gun/Kine/randomThetaCM
 /// - /ActarSim/gun/Kine/randomPhiAngle
@@ -133,6 +145,120 @@ ActarSimPrimaryGeneratorMessenger::ActarSimPrimaryGeneratorMessenger(ActarSimPri
   beamInteractionCmd->SetCandidates("on off");
   beamInteractionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
+  fastBeamCmd = new G4UIcmdWithAString("/ActarSim/gun/fastBeam",this);
+  fastBeamCmd->SetGuidance("With beamInteraction on, the beam is not tracked in the gas: the energy,");
+  fastBeamCmd->SetGuidance("direction and time at the vertex are calculated from the range tables");
+  fastBeamCmd->SetGuidance("and the reaction products are generated in the same event.");
+  fastBeamCmd->SetGuidance("  Choice : on, off(default)");
+  fastBeamCmd->SetParameterName("choice",true);
+  fastBeamCmd->SetDefaultValue("off");
+  fastBeamCmd->SetCandidates("on off");
+  fastBeamCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fastBeamStragglingCmd = new G4UIcmdWithAString("/ActarSim/gun/fastBeamStraggling",this);
+  fastBeamStragglingCmd->SetGuidance("Energy straggling and multiple scattering in the fastBeam transport.");
+  fastBeamStragglingCmd->SetGuidance("  Choice : on(default), off");
+  fastBeamStragglingCmd->SetParameterName("choice",true);
+  fastBeamStragglingCmd->SetDefaultValue("on");
+  fastBeamStragglingCmd->SetCandidates("on off");
+  fastBeamStragglingCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  beamLibraryModeCmd = new G4UIcmdWithAString("/ActarSim/gun/beamLibraryMode",this);
+  beamLibraryModeCmd->SetGuidance("Beam trajectory library, with beamInteraction on.");
+  beamLibraryModeCmd->SetGuidance(" record: the beam is tracked through all the gas in each event and the");
+  beamLibraryModeCmd->SetGuidance("   trajectories are written in the beamLibraryFile at the end of the run.");
+  beamLibraryModeCmd->SetGuidance(" replay: the beam is not tracked; a trajectory of the beamLibraryFile is cut");
+  beamLibraryModeCmd->SetGuidance("   at the vertex and the reaction products are generated in the same event.");
+  beamLibraryModeCmd->SetGuidance("  Choice : off(default), record, replay");
+  beamLibraryModeCmd->SetParameterName("choice",true);
+  beamLibraryModeCmd->SetDefaultValue("off");
+  beamLibraryModeCmd->SetCandidates("off record replay");
+  beamLibraryModeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  beamLibraryFileCmd = new G4UIcmdWithAString("/ActarSim/gun/beamLibraryFile",this);
+  beamLibraryFileCmd->SetGuidance("Selects the ROOT file of the beam trajectory library.");
+  beamLibraryFileCmd->SetGuidance("It is valid only for the same beam ion, energy and gas.");
+  beamLibraryFileCmd->SetParameterName("beamLibraryFile",false);
+  beamLibraryFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  beamLibraryStrideLengthCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/gun/beamLibraryStrideLength",this);
+  beamLibraryStrideLengthCmd->SetGuidance("Maximum length of the strides of the recorded beam trajectories.");
+  beamLibraryStrideLengthCmd->SetGuidance(" Default value is 1 mm.");
+  beamLibraryStrideLengthCmd->SetParameterName("strideLength",false);
+  beamLibraryStrideLengthCmd->SetRange("strideLength>0.");
+  beamLibraryStrideLengthCmd->SetUnitCategory("Length");
+  beamLibraryStrideLengthCmd->SetDefaultUnit("mm");
+  beamLibraryStrideLengthCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  beamPhaseSpaceCmd = new G4UIcmdWithAString("/ActarSim/gun/beamPhaseSpace",this);
+  beamPhaseSpaceCmd->SetGuidance("Beam position, angles and energy at entrance sampled from the");
+  beamPhaseSpaceCmd->SetGuidance("beamPhaseSpaceFile, instead of the emittance and beamRadiusAtEntrance.");
+  beamPhaseSpaceCmd->SetGuidance("Without beamInteraction, only the vertex position is taken from it.");
+  beamPhaseSpaceCmd->SetGuidance("  Choice : on, off(default)");
+  beamPhaseSpaceCmd->SetParameterName("choice",true);
+  beamPhaseSpaceCmd->SetDefaultValue("off");
+  beamPhaseSpaceCmd->SetCandidates("on off");
+  beamPhaseSpaceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  beamPhaseSpaceFileCmd = new G4UIcmdWithAString("/ActarSim/gun/beamPhaseSpaceFile",this);
+  beamPhaseSpaceFileCmd->SetGuidance("Selects the beam phase space file. Each line contains a beam");
+  beamPhaseSpaceFileCmd->SetGuidance("particle: x [mm], x' [mrad], y [mm], y' [mrad], energy [MeV] and,");
+  beamPhaseSpaceFileCmd->SetGuidance("optionally, a weight. Positions relative to the beamPosition.");
+  beamPhaseSpaceFileCmd->SetParameterName("beamPhaseSpaceFile",false);
+  beamPhaseSpaceFileCmd->SetDefaultValue("beamPhaseSpace.dat");
+  beamPhaseSpaceFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  acceptanceFilterCmd = new G4UIcmdWithAString("/ActarSim/gun/acceptanceFilter",this);
+  acceptanceFilterCmd->SetGuidance("Tests the reaction products before the tracking, following them in");
+  acceptanceFilterCmd->SetGuidance("straight line through the geometry (see acceptanceDetectors).");
+  acceptanceFilterCmd->SetGuidance(" reject: the events out of the acceptance are aborted.");
+  acceptanceFilterCmd->SetGuidance(" resample: the reaction is generated again at the same vertex.");
+  acceptanceFilterCmd->SetGuidance("The efficiency is stored in the run directory of the output file.");
+  acceptanceFilterCmd->SetGuidance("  Choice : off(default), reject, resample");
+  acceptanceFilterCmd->SetParameterName("choice",true);
+  acceptanceFilterCmd->SetDefaultValue("off");
+  acceptanceFilterCmd->SetCandidates("off reject resample");
+  acceptanceFilterCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  acceptanceDetectorsCmd = new G4UIcmdWithAString("/ActarSim/gun/acceptanceDetectors",this);
+  acceptanceDetectorsCmd->SetGuidance("Sensitive detectors (names separated by spaces, in quotes) giving");
+  acceptanceDetectorsCmd->SetGuidance("the acceptance of a reaction product in the acceptanceFilter.");
+  acceptanceDetectorsCmd->SetGuidance(" Default value is \"silSD sciSD\".");
+  acceptanceDetectorsCmd->SetParameterName("detectors",false);
+  acceptanceDetectorsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  acceptanceMinProductsCmd = new G4UIcmdWithAnInteger("/ActarSim/gun/acceptanceMinProducts",this);
+  acceptanceMinProductsCmd->SetGuidance("Reaction products in the acceptance needed to accept the event.");
+  acceptanceMinProductsCmd->SetGuidance(" Default value is 1.");
+  acceptanceMinProductsCmd->SetParameterName("minProducts",false);
+  acceptanceMinProductsCmd->SetRange("minProducts>0");
+  acceptanceMinProductsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  acceptanceMinGasLengthCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/gun/acceptanceMinGasLength",this);
+  acceptanceMinGasLengthCmd->SetGuidance("A reaction product travelling at least this length in the gas is also");
+  acceptanceMinGasLengthCmd->SetGuidance("in the acceptance (pad plane tracks). Default value is 0 (not used).");
+  acceptanceMinGasLengthCmd->SetParameterName("minGasLength",false);
+  acceptanceMinGasLengthCmd->SetRange("minGasLength>=0.");
+  acceptanceMinGasLengthCmd->SetUnitCategory("Length");
+  acceptanceMinGasLengthCmd->SetDefaultUnit("mm");
+  acceptanceMinGasLengthCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  acceptanceEnergyLossCmd = new G4UIcmdWithAString("/ActarSim/gun/acceptanceEnergyLoss",this);
+  acceptanceEnergyLossCmd->SetGuidance("The charged reaction products stop in the acceptanceFilter according");
+  acceptanceEnergyLossCmd->SetGuidance("to their range in the materials crossed.");
+  acceptanceEnergyLossCmd->SetGuidance("  Choice : on(default), off");
+  acceptanceEnergyLossCmd->SetParameterName("choice",true);
+  acceptanceEnergyLossCmd->SetDefaultValue("on");
+  acceptanceEnergyLossCmd->SetCandidates("on off");
+  acceptanceEnergyLossCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  acceptanceMaxTriesCmd = new G4UIcmdWithAnInteger("/ActarSim/gun/acceptanceMaxTries",this);
+  acceptanceMaxTriesCmd->SetGuidance("Maximum number of reactions generated in an event with the");
+  acceptanceMaxTriesCmd->SetGuidance("acceptanceFilter resample. Default value is 100.");
+  acceptanceMaxTriesCmd->SetParameterName("maxTries",false);
+  acceptanceMaxTriesCmd->SetRange("maxTries>0");
+  acceptanceMaxTriesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
   emittanceCmd = new G4UIcmdWithADouble("/ActarSim/gun/emittance",this);
   emittanceCmd->SetGuidance("Selects the value of the emittance [in mm mrad].");
   emittanceCmd->SetGuidance(" Default value is 1 mm mrad. ");
@@ -179,15 +305,31 @@ ActarSimPrimaryGeneratorMessenger::ActarSimPrimaryGeneratorMessenger(ActarSimPri
   beamRadiusAtEntranceCmd->SetDefaultValue(1.);
   beamRadiusAtEntranceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
-  //HAPOL NOTE: REMOVE OR REBUILT COMPLETELY
   reactionFromEvGenCmd = new G4UIcmdWithAString("/ActarSim/gun/reactionFromEvGen",this);
-  reactionFromEvGenCmd->SetGuidance("DO NOT USE. Simulates beam/target from event generator. DO NOT USE.");
+  reactionFromEvGenCmd->SetGuidance("Reaction products read from an external event generator file");
+  reactionFromEvGenCmd->SetGuidance("(see /ActarSim/gun/evGenFile)");
   reactionFromEvGenCmd->SetGuidance("  Choice : on, off(default)");
   reactionFromEvGenCmd->SetParameterName("choice",true);
   reactionFromEvGenCmd->SetDefaultValue("off");
   reactionFromEvGenCmd->SetCandidates("on off");
   reactionFromEvGenCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
+  evGenFileCmd = new G4UIcmdWithAString("/ActarSim/gun/evGenFile",this);
+  evGenFileCmd->SetGuidance("Select the external event generator file. ASCII format: lines");
+  evGenFileCmd->SetGuidance("'number_of_particles [weight]' followed by one line 'pdg px py pz'");
+  evGenFileCmd->SetGuidance("(MeV/c) per particle. ROOT format (name ending in .root): tree");
+  evGenFileCmd->SetGuidance("evgen with branches n, pdg[n], px[n], py[n], pz[n] and weight.");
+  evGenFileCmd->SetParameterName("evGenFile",false);
+  evGenFileCmd->SetDefaultValue("evgen.dat");
+  evGenFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  evGenPrefetchSizeCmd = new G4UIcmdWithAnInteger("/ActarSim/gun/evGenPrefetchSize",this);
+  evGenPrefetchSizeCmd->SetGuidance("Maximum number of events of the external generator read");
+  evGenPrefetchSizeCmd->SetGuidance("ahead of the tracking. Default value is 1000.");
+  evGenPrefetchSizeCmd->SetParameterName("prefetchSize",false);
+  evGenPrefetchSizeCmd->SetRange("prefetchSize>0");
+  evGenPrefetchSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
   //commands affecting the input file selection for the reaction
   reactionFromFileCmd = new G4UIcmdWithAString("/ActarSim/gun/reactionFromFile",this);
   reactionFromFileCmd->SetGuidance("Select a reaction from an input file");
@@ -197,9 +339,9 @@ ActarSimPrimaryGeneratorMessenger::ActarSimPrimaryGeneratorMessenger(ActarSimPri
   reactionFromFileCmd->SetCandidates("on off");
   reactionFromFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
-  //HAPOL NOTE: REMOVE OR REBUILT COMPLETELY
   reactionFromCrossSectionCmd = new G4UIcmdWithAString("/ActarSim/gun/reactionFromCrossSection",this);
-  reactionFromCrossSectionCmd->SetGuidance("DO NOT USE. Simulates beam/target from the cross-sections. DO NOT USE.");
+  reactionFromCrossSectionCmd->SetGuidance("Samples the KINE CM angle from the angular distribution given");
+  reactionFromCrossSectionCmd->SetGuidance("in the crossSectionFile (requires reactionFromKine on).");
   reactionFromCrossSectionCmd->SetGuidance("  Choice : on, off(default)");
   reactionFromCrossSectionCmd->SetParameterName("choice",true);
   reactionFromCrossSectionCmd->SetDefaultValue("off");
@@ -211,6 +353,39 @@ ActarSimPrimaryGeneratorMessenger::ActarSimPrimaryGeneratorMessenger(ActarSimPri
   reactionFileCmd->SetParameterName("reactionFile",false);
   reactionFileCmd->SetDefaultValue("He8onC12Elastic.dat");
 
+  crossSectionFileCmd = new G4UIcmdWithAString("/ActarSim/gun/crossSectionFile",this);
+  crossSectionFileCmd->SetGuidance("Select the angular distribution file: CM angle (deg) and dSigma/dOmega");
+  crossSectionFileCmd->SetGuidance("in two columns. Lines starting with # are skipped.");
+  crossSectionFileCmd->SetParameterName("crossSectionFile",false);
+  crossSectionFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  angularBiasCmd = new G4UIcmdWithAString("/ActarSim/gun/angularBias",this);
+  angularBiasCmd->SetGuidance("Importance sampling of the reaction angle (CINE lab angle or KINE CM");
+  angularBiasCmd->SetGuidance("angle) from the bias density in the angularBiasFile. The reaction products");
+  angularBiasCmd->SetGuidance("get the weight (nominal/bias density), stored in the primary info and");
+  angularBiasCmd->SetGuidance("in the event data. The nominal density is the cross section (with");
+  angularBiasCmd->SetGuidance("reactionFromCrossSection on) or flat in the randomTheta range.");
+  angularBiasCmd->SetGuidance("  Choice : on, off(default)");
+  angularBiasCmd->SetParameterName("choice",true);
+  angularBiasCmd->SetDefaultValue("off");
+  angularBiasCmd->SetCandidates("on off");
+  angularBiasCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  angularBiasFileCmd = new G4UIcmdWithAString("/ActarSim/gun/angularBiasFile",this);
+  angularBiasFileCmd->SetGuidance("Select the bias density file: angle (deg) and relative density per unit");
+  angularBiasFileCmd->SetGuidance("angle (not per solid angle) in two columns. Lines starting with # are skipped.");
+  angularBiasFileCmd->SetParameterName("angularBiasFile",false);
+  angularBiasFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  reactionFileWeightedCmd = new G4UIcmdWithAString("/ActarSim/gun/reactionFileWeighted",this);
+  reactionFileWeightedCmd->SetGuidance("Sample the rows of the reaction file using the cross section");
+  reactionFileWeightedCmd->SetGuidance("given in an optional fifth column as weight (uniform otherwise)");
+  reactionFileWeightedCmd->SetGuidance("  Choice : on, off(default)");
+  reactionFileWeightedCmd->SetParameterName("choice",true);
+  reactionFileWeightedCmd->SetDefaultValue("off");
+  reactionFileWeightedCmd->SetCandidates("on off");
+  reactionFileWeightedCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
   //commands affecting the Cine kinematic reaction generator
   reactionFromCineCmd = new G4UIcmdWithAString("/ActarSim/gun/reactionFromCine",this);
   reactionFromCineCmd->SetGuidance("Select a reaction using Cine");
@@ -406,6 +581,43 @@ ActarSimPrimaryGeneratorMessenger::ActarSimPrimaryGeneratorMessenger(ActarSimPri
   thetaLabAngleCmd->SetDefaultValue(0.5);
   thetaLabAngleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
+  //commands affecting the N-body phase space generator
+  reactionFromPhaseSpaceCmd = new G4UIcmdWithAString("/ActarSim/gun/reactionFromPhaseSpace",this);
+  reactionFromPhaseSpaceCmd->SetGuidance("Select a breakup reaction using the N-body phase space");
+  reactionFromPhaseSpaceCmd->SetGuidance("of the incident ion on the target ion (see /ActarSim/gun/PhaseSpace/)");
+  reactionFromPhaseSpaceCmd->SetGuidance("  Choice : on, off(default)");
+  reactionFromPhaseSpaceCmd->SetParameterName("choice",true);
+  reactionFromPhaseSpaceCmd->SetDefaultValue("off");
+  reactionFromPhaseSpaceCmd->SetCandidates("on off");
+  reactionFromPhaseSpaceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  PhaseSpaceDir = new G4UIdirectory("/ActarSim/gun/PhaseSpace/");
+  PhaseSpaceDir->SetGuidance("N-body phase space generator control");
+
+  PhaseSpaceProductsCmd = new G4UIcmdWithAString("/ActarSim/gun/PhaseSpace/products",this);
+  PhaseSpaceProductsCmd->SetGuidance("Products of the breakup: names of particles (proton, neutron,");
+  PhaseSpaceProductsCmd->SetGuidance("alpha, ...) or ions as Z:A, separated by spaces. At least two.");
+  PhaseSpaceProductsCmd->SetGuidance("  Example: /ActarSim/gun/PhaseSpace/products alpha alpha neutron");
+  PhaseSpaceProductsCmd->SetParameterName("products",false);
+  PhaseSpaceProductsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  PhaseSpaceWeightedCmd = new G4UIcmdWithAString("/ActarSim/gun/PhaseSpace/weighted",this);
+  PhaseSpaceWeightedCmd->SetGuidance("Weighted events (on: the primaries carry the phase space weight)");
+  PhaseSpaceWeightedCmd->SetGuidance("or unweighted events (off: hit or miss selection).");
+  PhaseSpaceWeightedCmd->SetGuidance("  Choice : on, off(default)");
+  PhaseSpaceWeightedCmd->SetParameterName("choice",true);
+  PhaseSpaceWeightedCmd->SetDefaultValue("off");
+  PhaseSpaceWeightedCmd->SetCandidates("on off");
+  PhaseSpaceWeightedCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  PhaseSpaceBatchSizeCmd = new G4UIcmdWithAnInteger("/ActarSim/gun/PhaseSpace/batchSize",this);
+  PhaseSpaceBatchSizeCmd->SetGuidance("Number of phase space events generated together.");
+  PhaseSpaceBatchSizeCmd->SetGuidance(" Used only with a fixed beam energy (beamInteraction off).");
+  PhaseSpaceBatchSizeCmd->SetGuidance(" Default value is 1000.");
+  PhaseSpaceBatchSizeCmd->SetParameterName("batchSize",false);
+  PhaseSpaceBatchSizeCmd->SetRange("batchSize>0");
+  PhaseSpaceBatchSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
   //commands affecting the Cine kinematic reaction generator
   reactionFromKineCmd = new G4UIcmdWithAString("/ActarSim/gun/reactionFromKine",this);
   reactionFromKineCmd->SetGuidance("Select a reaction using Kine");
@@ -692,14 +904,33 @@ ActarSimPrimaryGeneratorMessenger::~ActarSimPrimaryGeneratorMessenger() {
   delete ionCmd;
   delete realisticBeamCmd;
   delete beamInteractionCmd;
+  delete fastBeamCmd;
+  delete fastBeamStragglingCmd;
+  delete beamLibraryModeCmd;
+  delete beamLibraryFileCmd;
+  delete beamLibraryStrideLengthCmd;
+  delete beamPhaseSpaceCmd;
+  delete beamPhaseSpaceFileCmd;
+  delete acceptanceFilterCmd;
+  delete acceptanceDetectorsCmd;
+  delete acceptanceMinProductsCmd;
+  delete acceptanceMinGasLengthCmd;
+  delete acceptanceEnergyLossCmd;
+  delete acceptanceMaxTriesCmd;
   delete emittanceCmd;
   delete beamDirectionCmd;
   delete beamPositionCmd;
   delete beamRadiusAtEntranceCmd;
   delete reactionFromEvGenCmd;
+  delete evGenFileCmd;
+  delete evGenPrefetchSizeCmd;
   delete reactionFromCrossSectionCmd;
   delete reactionFromFileCmd;
   delete reactionFileCmd;
+  delete reactionFileWeightedCmd;
+  delete crossSectionFileCmd;
+  delete angularBiasCmd;
+  delete angularBiasFileCmd;
   delete randomThetaCmd;
   delete randomPhiCmd;
   delete alphaSourceCmd;
@@ -717,6 +948,11 @@ ActarSimPrimaryGeneratorMessenger::~ActarSimPrimaryGeneratorMessenger() {
   delete labEnergyCmd;
   delete thetaLabAngleCmd;
   delete reactionFromKineCmd;
+  delete reactionFromPhaseSpaceCmd;
+  delete PhaseSpaceProductsCmd;
+  delete PhaseSpaceWeightedCmd;
+  delete PhaseSpaceBatchSizeCmd;
+  delete PhaseSpaceDir;
   delete KineDir;
   delete KineRandomThetaCmd;
   delete KineRandomThetaRangeCmd;
@@ -755,6 +991,45 @@ void ActarSimPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,
   if( command == beamInteractionCmd )
     actarSimActionGun->SetBeamInteractionFlag(newValues);
 
+  if( command == fastBeamCmd )
+    actarSimActionGun->SetFastBeamFlag(newValues);
+
+  if( command == fastBeamStragglingCmd )
+    actarSimActionGun->SetFastBeamStragglingFlag(newValues);
+
+  if( command == beamLibraryModeCmd )
+    actarSimActionGun->SetBeamLibraryMode(newValues);
+
+  if( command == beamLibraryFileCmd )
+    actarSimActionGun->SetBeamLibraryFile(newValues);
+
+  if( command == beamLibraryStrideLengthCmd )
+    actarSimActionGun->SetBeamLibraryStrideLength(beamLibraryStrideLengthCmd->GetNewDoubleValue(newValues));
+
+  if( command == beamPhaseSpaceCmd )
+    actarSimActionGun->SetBeamPhaseSpaceFlag(newValues);
+
+  if( command == beamPhaseSpaceFileCmd )
+    actarSimActionGun->SetBeamPhaseSpaceFile(newValues);
+
+  if( command == acceptanceFilterCmd )
+    actarSimActionGun->SetAcceptanceFilterMode(newValues);
+
+  if( command == acceptanceDetectorsCmd )
+    actarSimActionGun->SetAcceptanceDetectors(newValues);
+
+  if( command == acceptanceMinProductsCmd )
+    actarSimActionGun->SetAcceptanceMinProducts(acceptanceMinProductsCmd->GetNewIntValue(newValues));
+
+  if( command == acceptanceMinGasLengthCmd )
+    actarSimActionGun->SetAcceptanceMinGasLength(acceptanceMinGasLengthCmd->GetNewDoubleValue(newValues));
+
+  if( command == acceptanceEnergyLossCmd )
+    actarSimActionGun->SetAcceptanceEnergyLossFlag(newValues);
+
+  if( command == acceptanceMaxTriesCmd )
+    actarSimActionGun->SetAcceptanceMaxTries(acceptanceMaxTriesCmd->GetNewIntValue(newValues));
+
   if( command == emittanceCmd)
     actarSimActionGun->SetEmittance(emittanceCmd->GetNewDoubleValue(newValues));
 
@@ -778,6 +1053,12 @@ void ActarSimPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,
   if( command == reactionFromEvGenCmd )
     actarSimActionGun->SetReactionFromEvGenFlag(newValues);
 
+  if( command == evGenFileCmd )
+    actarSimActionGun->SetEvGenFile(newValues);
+
+  if( command == evGenPrefetchSizeCmd )
+    actarSimActionGun->SetEvGenPrefetchSize(evGenPrefetchSizeCmd->GetNewIntValue(newValues));
+
   if( command == reactionFromCrossSectionCmd )
     actarSimActionGun->SetReactionFromCrossSectionFlag(newValues);
 
@@ -790,6 +1071,18 @@ void ActarSimPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,
   if( command == reactionFileCmd )
     actarSimActionGun->SetReactionFile(newValues);
 
+  if( command == reactionFileWeightedCmd )
+    actarSimActionGun->SetReactionFileWeightedFlag(newValues);
+
+  if( command == crossSectionFileCmd )
+    actarSimActionGun->SetCrossSectionFile(newValues);
+
+  if( command == angularBiasCmd )
+    actarSimActionGun->SetAngularBiasFlag(newValues);
+
+  if( command == angularBiasFileCmd )
+    actarSimActionGun->SetAngularBiasFile(newValues);
+
   if( command == randomThetaCmd )
     actarSimActionGun->SetRandomThetaFlag(newValues);
 
@@ -865,6 +1158,18 @@ void ActarSimPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,
   if( command == reactionFromKineCmd )
     actarSimActionGun->SetReactionFromKineFlag(newValues);
 
+  if( command == reactionFromPhaseSpaceCmd )
+    actarSimActionGun->SetReactionFromPhaseSpaceFlag(newValues);
+
+  if( command == PhaseSpaceProductsCmd )
+    actarSimActionGun->SetPhaseSpaceProducts(newValues);
+
+  if( command == PhaseSpaceWeightedCmd )
+    actarSimActionGun->SetPhaseSpaceWeightedFlag(newValues);
+
+  if( command == PhaseSpaceBatchSizeCmd )
+    actarSimActionGun->SetPhaseSpaceBatchSize(PhaseSpaceBatchSizeCmd->GetNewIntValue(newValues));
+
   if( command == KineRandomThetaCmd )
     actarSimActionGun->SetRandomThetaFlag(newValues);
 
@@ -27,9 +27,11 @@
 //#include "G4PhysicalConstants.hh"
 //#include "G4SystemOfUnits.hh"
 
-#include "ActarSimTrack.hh"
+#include "ActarSimEventTracks.hh"
 #include "ActarSimSimpleTrack.hh"
 #include "ActarSimData.hh"
+#include "ActarSimBeamLibrary.hh"
+#include "ActarSimBeamInfo.hh"
 
 //ROOT INCLUDES
 #include "TROOT.h"
@@ -45,7 +47,7 @@
 #include "TClonesArray.h"
 #include "TProfile.h"
 
-#include "Randomize.hh"
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////
 /// Default constructor... Simply inits
@@ -71,7 +73,8 @@ void ActarSimROOTAnalGas::init(){
   htrack1InPads = (TH2D *)0;
   htrack2InPads = (TH2D *)0;
   htrackFromBeam = (TH2D *)0;
-  htrack = (TH3D *)0;
+  htrack = (TH3F *)0;
+  storeTrackHistos = false;
 
   hEdepInGas = (TH1D *)0;
 
@@ -96,7 +99,8 @@ void ActarSimROOTAnalGas::init(){
   theData =
     ((ActarSimROOTAnalysis*)gActarSimROOTAnalysis)->GetTheData();
 
-  theTracks = new ActarSimTrack();
+  eventTracks = new ActarSimEventTracks();
+  storeTracks = false;
 
   //Let us create 2 simpleTrack's for the primaries...
   simpleTrack = new ActarSimSimpleTrack*[2];
@@ -104,7 +108,8 @@ void ActarSimROOTAnalGas::init(){
     simpleTrack[i] = new ActarSimSimpleTrack();
 
   //eventTree->Branch("theData","ActarSimData",&theData,128000,99);
-  tracksTree->Branch("trackData","ActarSimTrack",&theTracks,128000,99);
+  //All the steps of the event in a single entry (see ActarSimEventTracks)
+  tracksTree->Branch("eventTracks","ActarSimEventTracks",&eventTracks,128000,99);
   //Now, simple track as a TClonesArray
   eventTree->Branch("simpleTrackData",&simpleTrackCA);
 
@@ -123,6 +128,8 @@ void ActarSimROOTAnalGas::GeneratePrimaries(const G4Event *anEvent){
   /// NOT VALID !!! ONLY GAMMAS ALLOWED, MODIFY FOR OTHER PARTICLES!!!
   //Filling the primary accessing on other functions
   //(in particular during UserSteppingAction()
+  //events aborted at the generation have no primaries
+  if(anEvent->IsAborted() || anEvent->GetNumberOfPrimaryVertex()==0) return;
   G4PrimaryVertex* myPVertex = anEvent->GetPrimaryVertex();
   //Modify this code in future for allowing several primary
   //particles and select on the gammas
@@ -229,10 +236,10 @@ void ActarSimROOTAnalGas::BeginOfRunAction(const G4Run *aRun) {
 
     //
     htrack =
-      (TH3D *)gROOT->FindObject("htrack");
+      (TH3F *)gROOT->FindObject("htrack");
     if(htrack) htrack->Reset();
     else {
-      htrack = new TH3D("htrack",
+      htrack = new TH3F("htrack",
 			"All tracks from a beam view ",
 			100, -500, 500, 100, -500, 500, 100, -500, 500);
       htrack->SetZTitle("Z [mm]");
@@ -292,11 +299,50 @@ void ActarSimROOTAnalGas::EndOfRunAction(const G4Run *aRun) {
 /// Actions to perform in the analysis at the begining of the event
 void ActarSimROOTAnalGas::BeginOfEventAction(const G4Event *anEvent) {
   SetTheEventID(anEvent->GetEventID());
+
+  storeTracks =
+    (((ActarSimROOTAnalysis*) gActarSimROOTAnalysis)->GetStoreTracksFlag() == "on");
+  if(storeTracks) {
+    eventTracks->Reset();
+    eventTracks->SetEventID(GetTheEventID());
+    eventTracks->SetRunID(GetTheRunID());
+  }
+
+  storeTrackHistos =
+    (((ActarSimROOTAnalysis*) gActarSimROOTAnalysis)->GetStoreTrackHistosFlag() == "on");
+
+  //the beam trajectory taken from the library (not tracked) is stored as track 0
+  ActarSimBeamLibrary* beamLibrary =
+    ((ActarSimROOTAnalysis*) gActarSimROOTAnalysis)->GetBeamLibrary();
+  if(beamLibrary && (storeTracks || storeTrackHistos)) {
+    G4ThreeVector prePoint, postPoint;
+    G4double preTime, postTime, energy, edep;
+    for(G4int i=0;i<beamLibrary->GetReplayNumberOfStrides();i++) {
+      beamLibrary->GetReplayStride(i,prePoint,postPoint,preTime,postTime,energy,edep);
+      if(edep <= 0.) continue;
+      if(storeTrackHistos) {
+        histoXPost.push_back(postPoint.x());
+        histoYPost.push_back(postPoint.y());
+        histoZPost.push_back(postPoint.z());
+        histoZPre.push_back(prePoint.z());
+        histoEdep.push_back(edep);
+        histoPrimary.push_back(0);
+      }
+      if(storeTracks)
+        eventTracks->AddStep(0,0,
+                             prePoint.x()/CLHEP::mm,prePoint.y()/CLHEP::mm,prePoint.z()/CLHEP::mm,
+                             postPoint.x()/CLHEP::mm,postPoint.y()/CLHEP::mm,postPoint.z()/CLHEP::mm,
+                             edep/CLHEP::MeV);
+    }
+  }
 }
 
 //////////////////////////////////////////////////////////////////
 /// Actions to perform in the analysis at the end of the event
 void ActarSimROOTAnalGas::EndOfEventAction(const G4Event *anEvent) {
+  //events aborted at the generation have no primaries
+  if(anEvent->IsAborted() || anEvent->GetNumberOfPrimaryVertex()==0) return;
+
   Double_t aEnergyInGas1 =0;// (EnerGas1 / MeV); // in [MeV]
   Double_t aEnergyInGas2 =0;// (EnerGas2 / MeV); // in [MeV]
   Double_t aTLInGas1 =0;// (TLGas1 / mm); // in [mm]
@@ -435,7 +481,58 @@ void ActarSimROOTAnalGas::EndOfEventAction(const G4Event *anEvent) {
         simpleTrack[j]->Reset();
       }
     }
+
+    //strides of the beam trajectory taken from the library, as track 0
+    ActarSimBeamLibrary* beamLibrary =
+      ((ActarSimROOTAnalysis*) gActarSimROOTAnalysis)->GetBeamLibrary();
+    G4int nbBeamStrides = beamLibrary ? beamLibrary->GetReplayNumberOfStrides() : 0;
+    if(nbBeamStrides>0) {
+      ActarSimBeamInfo* pBeamInfo = ((ActarSimROOTAnalysis*) gActarSimROOTAnalysis)->GetBeamInfo();
+      ActarSimSimpleTrack beamTrack;
+      G4int beamOrdinal = 0;
+      G4ThreeVector prePoint, postPoint;
+      G4double preTime, postTime, energy, edep;
+      for(G4int i=0;i<nbBeamStrides;i++) {
+        beamLibrary->GetReplayStride(i,prePoint,postPoint,preTime,postTime,energy,edep);
+        if(beamTrack.GetNumberSteps() == 0) {
+          beamTrack.SetXPre(prePoint.x()/CLHEP::mm);
+          beamTrack.SetYPre(prePoint.y()/CLHEP::mm);
+          beamTrack.SetZPre(prePoint.z()/CLHEP::mm);
+          beamTrack.SetTimePre(preTime/CLHEP::ns);
+          beamTrack.SetEnergyStride(0.);
+          beamTrack.SetStrideLength(0.);
+          beamTrack.SetParticleCharge(pBeamInfo->GetCharge());
+          beamTrack.SetParticleMass(pBeamInfo->GetMass());
+          beamTrack.SetParticleID(beamLibrary->GetParticleID());
+          beamTrack.SetTrackID(0);
+          beamTrack.SetParentTrackID(0);
+          beamTrack.SetEventID(GetTheEventID());
+          beamTrack.SetRunID(GetTheRunID());
+          beamTrack.SetStrideOrdinal(beamOrdinal);
+        }
+        beamTrack.SetXPost(postPoint.x()/CLHEP::mm);
+        beamTrack.SetYPost(postPoint.y()/CLHEP::mm);
+        beamTrack.SetZPost(postPoint.z()/CLHEP::mm);
+        beamTrack.SetTimePost(postTime/CLHEP::ns);
+        beamTrack.SetParticleEnergy(energy/CLHEP::MeV);
+        beamTrack.SetEnergyStride(beamTrack.GetEnergyStride() + edep/CLHEP::MeV);
+        beamTrack.SetStrideLength(beamTrack.GetStrideLength() + (postPoint-prePoint).mag()/CLHEP::mm);
+        beamTrack.SetNumberSteps(beamTrack.GetNumberSteps()+1);
+        if(beamTrack.GetStrideLength() > minStrideLength || i == nbBeamStrides-1) {
+          new((*simpleTrackCA)[NbStrides])ActarSimSimpleTrack(beamTrack);
+          NbStrides++;
+          beamOrdinal++;
+          beamTrack.Reset();
+        }
+      }
+    }
   }
+  //one entry per event in the tracks tree
+  if(storeTracks) tracksTree->Fill();
+
+  //the steps of the event go now to the track histograms
+  if(storeTrackHistos) FlushTrackHistos();
+
   if(((ActarSimROOTAnalysis*) gActarSimROOTAnalysis)->GetStoreEventsFlag()=="on"){
     theData->SetEnergyOnGasPrim1(aEnergyInGas1);
     theData->SetEnergyOnGasPrim2(aEnergyInGas2);
@@ -478,50 +575,89 @@ void ActarSimROOTAnalGas::EndOfEventAction(const G4Event *anEvent) {
 //////////////////////////////////////////////////////////////////
 /// Actions to perform in the ACTAR gas detector analysis after each step
 void ActarSimROOTAnalGas::UserSteppingAction(const G4Step *aStep){
-  G4Track* myTrack = aStep->GetTrack();
-  G4ThreeVector prePoint = aStep->GetPreStepPoint()->GetPosition();
-  G4ThreeVector postPoint = aStep->GetPostStepPoint()->GetPosition();
-
-  G4double z1 = prePoint.z();
-  G4double z2 = postPoint.z();
-  G4double z  = z1 + G4UniformRand()*(z2-z1);// + 0.5*(fDetector->GetAbsorSizeX());
-
   G4double edep = aStep->GetTotalEnergyDeposit();
   if (edep <= 0.) return;
 
-  if(((ActarSimROOTAnalysis*) gActarSimROOTAnalysis)->GetStoreTrackHistosFlag() == "on") {
-    if(hEdepInGas && z2<300) hEdepInGas->Fill(z,edep);
-    if(htrack) htrack->Fill(postPoint.x(),
-			    postPoint.y(),
-			    postPoint.z());
-    if(htrackFromBeam) htrackFromBeam->Fill(postPoint.x(),
-					    postPoint.y(),
-					    aStep->GetTotalEnergyDeposit());
-    if(htrackInPads) htrackInPads->Fill(postPoint.x(),
-					postPoint.z(),
-					aStep->GetTotalEnergyDeposit());
-    if(myTrack->GetTrackID()==1 && myTrack->GetParentID()==0)
-      if(htrack1InPads) htrack1InPads->Fill(postPoint.x(),
-					    postPoint.z(),
-					    aStep->GetTotalEnergyDeposit());
-    if(myTrack->GetTrackID()==2 && myTrack->GetParentID()==0)
-      if(htrack2InPads) htrack2InPads->Fill(postPoint.x(),
-					    postPoint.z(),
-					    aStep->GetTotalEnergyDeposit());
+  G4Track* myTrack = aStep->GetTrack();
+  const G4ThreeVector& prePoint = aStep->GetPreStepPoint()->GetPosition();
+  const G4ThreeVector& postPoint = aStep->GetPostStepPoint()->GetPosition();
+
+  //the step is buffered; the histograms are filled at the end of the event
+  if(storeTrackHistos) {
+    histoXPost.push_back(postPoint.x());
+    histoYPost.push_back(postPoint.y());
+    histoZPost.push_back(postPoint.z());
+    histoZPre.push_back(prePoint.z());
+    histoEdep.push_back(edep);
+    if(myTrack->GetParentID()==0 && (myTrack->GetTrackID()==1 || myTrack->GetTrackID()==2))
+      histoPrimary.push_back(myTrack->GetTrackID());
+    else
+      histoPrimary.push_back(0);
+    //limiting the buffer size in very large events
+    if(histoEdep.size()>=100000) FlushTrackHistos();
   }
 
-  if(((ActarSimROOTAnalysis*) gActarSimROOTAnalysis)->GetStoreTracksFlag() == "on") {
-    theTracks->SetXCoord(postPoint.x());
-    theTracks->SetYCoord(postPoint.y());
-    theTracks->SetZCoord(postPoint.z());
-    theTracks->SetXPreCoord(prePoint.x());
-    theTracks->SetYPreCoord(prePoint.y());
-    theTracks->SetZPreCoord(prePoint.z());
-    theTracks->SetEnergyStep(aStep->GetTotalEnergyDeposit());
-    theTracks->SetTrackID(myTrack->GetTrackID());
-    theTracks->SetParentTrackID(myTrack->GetParentID());
-    theTracks->SetEventID(GetTheEventID());
-    theTracks->SetRunID(GetTheRunID());
-    tracksTree->Fill();
+  //the step is buffered; the tracks tree is filled at the end of the event
+  if(storeTracks)
+    eventTracks->AddStep(myTrack->GetTrackID(),myTrack->GetParentID(),
+			 prePoint.x()/CLHEP::mm,prePoint.y()/CLHEP::mm,prePoint.z()/CLHEP::mm,
+			 postPoint.x()/CLHEP::mm,postPoint.y()/CLHEP::mm,postPoint.z()/CLHEP::mm,
+			 edep/CLHEP::MeV);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the position quantum of the steps in the tracks tree.
+/// Applied from the next event
+void ActarSimROOTAnalGas::SetTrackPositionResolution(G4double val){
+  eventTracks->SetPositionResolution(val/CLHEP::mm);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the energy quantum of the steps in the tracks tree
+void ActarSimROOTAnalGas::SetTrackEnergyResolution(G4double val){
+  eventTracks->SetEnergyResolution(val/CLHEP::MeV);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Fills the track histograms with the steps buffered during the event
+/// and empties the buffer. The energy deposit in hEdepInGas is shared
+/// among the bins crossed by the step, proportionally to the length in
+/// each bin (the mean of filling at a random point of the step)
+void ActarSimROOTAnalGas::FlushTrackHistos() {
+  size_t nbSteps = histoEdep.size();
+  for(size_t i=0;i<nbSteps;i++) {
+    G4double x = histoXPost[i];
+    G4double y = histoYPost[i];
+    G4double z = histoZPost[i];
+    G4double edep = histoEdep[i];
+
+    if(htrack) htrack->Fill(x,y,z);
+    if(htrackFromBeam) htrackFromBeam->Fill(x,y,edep);
+    if(htrackInPads) htrackInPads->Fill(x,z,edep);
+    if(histoPrimary[i]==1 && htrack1InPads) htrack1InPads->Fill(x,z,edep);
+    if(histoPrimary[i]==2 && htrack2InPads) htrack2InPads->Fill(x,z,edep);
+
+    if(hEdepInGas && z<300) {
+      G4double zLow = std::min(histoZPre[i],z);
+      G4double zUp = std::max(histoZPre[i],z);
+      if(zUp-zLow<=0.) {
+	hEdepInGas->Fill(z,edep);
+	continue;
+      }
+      TAxis* axis = hEdepInGas->GetXaxis();
+      G4int lastBin = axis->FindFixBin(zUp);
+      for(G4int bin=axis->FindFixBin(zLow);bin<=lastBin;bin++) {
+	G4double binLow = (bin==0) ? zLow : std::max(zLow,axis->GetBinLowEdge(bin));
+	G4double binUp = (bin>axis->GetNbins()) ? zUp : std::min(zUp,axis->GetBinUpEdge(bin));
+	if(binUp>binLow)
+	  hEdepInGas->Fill(axis->GetBinCenter(bin),edep*(binUp-binLow)/(zUp-zLow));
+      }
+    }
   }
+  histoXPost.clear();
+  histoYPost.clear();
+  histoZPost.clear();
+  histoZPre.clear();
+  histoEdep.clear();
+  histoPrimary.clear();
 }
@@ -100,6 +100,8 @@ void ActarSimROOTAnalPla::BeginOfEventAction(const G4Event *anEvent) {
 //////////////////////////////////////////////////////////////////
 /// Actions to perform in the scintillator anal at the beginning of the run
 void ActarSimROOTAnalPla::EndOfEventAction(const G4Event *anEvent) {
+  //events aborted at the generation have no primaries
+  if(anEvent->IsAborted() || anEvent->GetNumberOfPrimaryVertex()==0) return;
   FillingHits(anEvent);
 }
 
@@ -126,269 +128,25 @@ void ActarSimROOTAnalPla::FillingHits(const G4Event *anEvent) {
   //G4int NbHitsWithSomeEnergy = NbHits;
   //G4cout << " NbHits: " << NbHits << G4endl;
 
-  G4int indepHits = 0; //number of Hits
-  G4int* trackIDtable; //stores the trackID of primary particles for each (valid) GeantHit
-  trackIDtable = new G4int[NbHits];
-  G4int* detIDtable;   //stores the detIDs for each (valid) GeantHit
-  detIDtable = new G4int[NbHits];
-  G4int* IDtable;         //stores the order in previous array for each (valid) GeantHit
-  IDtable = new G4int[NbHits];
-
-
-  for (G4int i=0;i<NbHits;i++) {
-    if((*hitsCollection)[i]->GetParentID()==0) { //step from primary
-      if(indepHits==0) { //only for the first Hit
-	trackIDtable[indepHits] = (*hitsCollection)[i]->GetTrackID();
-	detIDtable[indepHits] = (*hitsCollection)[i]->GetDetID();
-	IDtable[i] = indepHits;
-	indepHits++;
-      }
-      else { // this part is never reached. Maybe because there is always only one indepHits that has parentID equals to 0.
-	for(G4int j=0; j<indepHits;j++) {
-	  if( (*hitsCollection)[i]->GetTrackID() == trackIDtable[j] &&
-	      (*hitsCollection)[i]->GetDetID() == detIDtable[j]) { //checking trackID and detID
-	    IDtable[i] = j;
-	    break; //not a new Hit
-	  }
-	  if(j==indepHits-1){ //we got the last hit and there was no match!
-	    trackIDtable[indepHits] = (*hitsCollection)[i]->GetTrackID();
-	    detIDtable[indepHits] = (*hitsCollection)[i]->GetDetID();
-	    IDtable[i] = indepHits;
-	    indepHits++;
-	  }
-	}
-      }
-    }
-  }
-
-  //Let us create as many ActarSimSilHit as independent primary particles
-  thePlaHit = new ActarSimPlaHit*[indepHits];
-  for (G4int i=0;i<indepHits;i++)
-    thePlaHit[i] = new ActarSimPlaHit();
-
   //Clear the ClonesArray before filling it
   plaHitCA->Clear();
 
-  //a variable to check if the Hit was already created
-  G4int* existing;
-  existing = new G4int[indepHits];
-  for(G4int i=0;i<indepHits;i++) existing[i] = 0;
-
+  //One ActarSimPlaHit per independent primary particle (trackID) and
+  //detector (detID), constructed directly in the ClonesArray
+  hitMerger.Reset(NbHits);
+  G4bool isNew;
   for(G4int i=0;i<NbHits;i++) {
     if( (*hitsCollection)[i]->GetParentID()==0 ) { //step from primary
-      //the IDtable[i] contains the order in the indepHits list
-      if( existing[IDtable[i]]==0) { //if the indepHits does not exist
-	AddCalPlaHit(thePlaHit[IDtable[i]],(*hitsCollection)[i],0);
-	existing[IDtable[i]] = 1;
-      }
+      G4int index = hitMerger.FindOrInsert((*hitsCollection)[i]->GetTrackID(),
+					   (*hitsCollection)[i]->GetDetID(),isNew);
+      if(isNew)
+	AddCalPlaHit(new((*plaHitCA)[index])ActarSimPlaHit(),(*hitsCollection)[i],0);
       else
-	AddCalPlaHit(thePlaHit[IDtable[i]],(*hitsCollection)[i],1);
+	AddCalPlaHit((ActarSimPlaHit*)plaHitCA->UncheckedAt(index),(*hitsCollection)[i],1);
     }
   }
-
-  //at the end, fill the ClonesArray
-  for (G4int i=0;i<indepHits;i++)
-    new((*plaHitCA)[i])ActarSimPlaHit(*thePlaHit[i]);
-
-  delete [] trackIDtable;
-  delete [] IDtable;
-  delete [] existing;
-  delete [] detIDtable;
-  for (G4int i=0;i<indepHits;i++) delete thePlaHit[i];
-  delete [] thePlaHit;
 }
 
-//CsI-like hit pattern
-/*
-  //We accept edep=0 GeantHits, we have to remove them
-  //from the total number of GeantHits accepted for creating a real CrystalHit
-  for (G4int i=0;i<NbHits;i++)
-    if((*hitsCollection)[i]->GetEdep()==0.)
-      NbHitsWithSomeEnergy--;
-  //G4cout << " NbHitsWithSomeEnergy: " << NbHitsWithSomeEnergy << G4endl;
-
-  G4int NbCrystalsWithHit=NbHitsWithSomeEnergy;
-  G4String* nameWithSomeEnergy;
-  G4int* detIDWithSomeEnergy;
-  detIDWithSomeEnergy = new G4int[NbHitsWithSomeEnergy];
-  nameWithSomeEnergy = new G4String[NbHitsWithSomeEnergy];
-
-  //keep the crystal identifiers of the GeantHits with some energy
-  G4int hitsWithEnergyCounter=0;
-  for (G4int i=0;i<NbHits;i++) {
-    if((*hitsCollection)[i]->GetEdep()>0.){
-      nameWithSomeEnergy[hitsWithEnergyCounter] = (*hitsCollection)[i]->GetDetName();
-      detIDWithSomeEnergy[hitsWithEnergyCounter] = (*hitsCollection)[i]->GetDetID();
-      //G4cout << "with some energy:   name:" << nameWithSomeEnergy[hitsWithEnergyCounter]
-      //     << " detID:"<<detIDWithSomeEnergy[hitsWithEnergyCounter] << G4endl;
-      hitsWithEnergyCounter++;
-    }
-  }
-
-  //if(hitsWithEnergyCounter != NbHitsWithSomeEnergy) {
-  //  G4cout << "ERROR in ActarSimROOTAnalSci::FillingHits(): hitsWithEnergyCounter!=NbHitsWithSomeEnergy" << G4endl;
-  //  G4cout << " hitsWithEnergyCounter = " << hitsWithEnergyCounter << " while NbHitsWithSomeEnergy = " << NbHitsWithSomeEnergy << G4endl;
-  //}
-
-  //We ask for the number of crystals with signal and
-  //this loop calculates them from the number of ActarSimSciGeantHits with energy
-  for (G4int i=0;i<NbHitsWithSomeEnergy;i++) {
-    for(G4int j=0;j<i;j++){
-      if(nameWithSomeEnergy[i] == nameWithSomeEnergy[j] && detIDWithSomeEnergy[i] == detIDWithSomeEnergy[j]){
-	NbCrystalsWithHit--;
-	break;  //break stops the second for() sentence as soon as one repetition is found
-      }
-    }
-  }
-  //G4cout << " NbCrystalsWithHit: " << NbCrystalsWithHit << G4endl;
-
-  G4String* nameWithHit;
-  G4int* detIDWithHit;
-  detIDWithHit = new G4int[NbCrystalsWithHit];
-  nameWithHit = new G4String[NbCrystalsWithHit];
-  hitsWithEnergyCounter=0;
-
-  //keep the crystal identifiers of the final crystalHits
-  G4int hitsCounter=0;
-  for (G4int i=0;i<NbHits;i++) {
-    if ((*hitsCollection)[i]->GetEdep()>0.) {
-      if(hitsCounter==0) { //the first geantHit with energy always creates a newHit
-	nameWithHit[hitsCounter] = (*hitsCollection)[i]->GetDetName();
-	detIDWithHit[hitsCounter] = (*hitsCollection)[i]->GetDetID();
-	//G4cout << "with hit:   name:" << nameWithHit[hitsCounter]
-	//       << " detID:"<<detIDWithHit[hitsCounter] << G4endl;
-	hitsCounter++;
-      }
-      else {
-	for (G4int j=0;j<hitsCounter;j++) {
-	  if ( (*hitsCollection)[i]->GetDetName() == nameWithHit[j] &&
-	       (*hitsCollection)[i]->GetDetID() == detIDWithHit[j] ) {
-	    break;  //break stops the second for() sentence as soon as one repetition is found
-	  }
-	  if(j==hitsCounter-1){ //when the previous if was never true, there is no repetition
-	    nameWithHit[hitsCounter] = (*hitsCollection)[i]->GetDetName();
-	    detIDWithHit[hitsCounter] = (*hitsCollection)[i]->GetDetID();
-	    //G4cout << "with hit:   name:" << nameWithHit[hitsCounter]
-	    //   << " detID:"<<detIDWithHit[hitsCounter] << G4endl;
-	    hitsCounter++;
-	  }
-	}
-      }
-    }
-  }
-  //DELETE ME AFTER THE PRELIMINARY TESTS!
-  //if(hitsCounter != NbCrystalsWithHit) {
-  //  G4cout << "ERROR in R3BROOTAnalCal::FillingHits(): hitsCounter!=NbCrystalsWithHit" << G4endl;
-  //  G4cout << " hitsCounter = " << hitsCounter << " while NbCrystalsWithHit = " << NbCrystalsWithHit << G4endl;
-  //}
-
-  //Let us create as many R3BCalCrystalHit as NbCrystalsWithHit
-  //TODO->Recover here the simhit/hit duality if needed!!
-  //if(((ActarSimROOTAnalysis*)gActarSimROOTAnalysis)->GetUseCrystalHitSim()==0){
-    thePlaHit = new ActarSimPlaHit*[NbCrystalsWithHit];
-    for (G4int i=0;i<NbCrystalsWithHit;i++)
-      thePlaHit[i] = new ActarSimPlaHit();
-  //}
-  //else{  //In case that the simulated hits were used!
-  //  theSciHit = new ActarSimSciHit*[NbCrystalsWithHit];
-  //  for (G4int i=0;i<NbCrystalsWithHit;i++)
-  //    theSciHit[i] = new ActarSimSciHitSim();
-  //}
-
-  //Clear the ClonesArray before filling it
-  plaHitCA->Clear();
-
-  G4bool counted = 0;
-  hitsCounter = 0; //now this variable is going to count the added GeantHits
-  G4String* name;
-  G4int* detID;
-  detID = new G4int[NbCrystalsWithHit];
-  name = new G4String[NbCrystalsWithHit];
-
-  G4bool shouldThisBeStored = 0;
-  //Filling the ActarSimSciHit from the R3BCalGeantHit (or step)
-  for (G4int i=0;i<NbHits;i++) {
-    //do not accept GeantHits with edep=0
-    //if there is no other GeantHit with edep>0 in the same crystal!
-    shouldThisBeStored=0;
-    counted =0;
-    //G4cout << "ADDING THE HITS. GeantHit with name:" << (*hitsCollection)[i]->GetDetName()
-    //   << " detID:"<< (*hitsCollection)[i]->GetDetID() << " edep:"<< (*hitsCollection)[i]->GetEdep() <<" under consideration"<< G4endl;
-    for (G4int j=0;j<NbCrystalsWithHit;j++) {
-      if( (*hitsCollection)[i]->GetDetName() == nameWithHit[j] &&
-	  (*hitsCollection)[i]->GetDetID() == detIDWithHit[j] ) {
-	shouldThisBeStored=1;
-	break;  //break stops the for() sentence as soon as one "energetic" partner is found
-      }
-    }
-    if(!shouldThisBeStored) continue; //so, continue with next, if there is no "energetic partner"
-    if(hitsCounter==0){ //only for the first geantHit accepted for storage
-      name[hitsCounter] = (*hitsCollection)[i]->GetDetName();
-      detID[hitsCounter] = (*hitsCollection)[i]->GetDetID();
-      AddCalPlaHit(thePlaHit[hitsCounter],(*hitsCollection)[i],0);
-      //G4cout << "ADD hit:   name:" << name[hitsCounter]
-      //     << " detID:"<<detID[hitsCounter]  << " with code 0 (initial)" << G4endl;
-      hitsCounter++;
-    }
-    else {   // from the second in advance, compare if a R3BCalCrystalHit
-             // in the same volume already exists
-      for (G4int j=0;j<hitsCounter;j++) {
-	if( (*hitsCollection)[i]->GetDetName() == name[j] &&
-	    (*hitsCollection)[i]->GetDetID() == detID[j]     ){ //identical Hit already present
-	  AddCalPlaHit(thePlaHit[j],(*hitsCollection)[i],1);
-	  //G4cout << "ADD hit:   name:" << name[j]
-	  // << " detID:"<< detID[j]  << " with code 1" << G4endl;
-	  counted = 1;
-	  break;   // stops the for() loop; the info is written in the first identical Hit
-	}
-      }
-      if(counted==0) {	//No identical Hit present.
-	name[hitsCounter] = (*hitsCollection)[i]->GetDetName();
-	detID[hitsCounter] = (*hitsCollection)[i]->GetDetID();
-	AddCalPlaHit(thePlaHit[hitsCounter],(*hitsCollection)[i],0);
-	//G4cout << "ADD hit:   name:" << name[hitsCounter]
-	//     << " detID:"<<detID[hitsCounter]  << " with code 0" << G4endl;
-	hitsCounter++;
-      }
-    }
-  }
-
-  //BORRAME
-  //G4cout << G4endl <<"************************  END OF DEBUGGING *****************************************" << G4endl;
-  //G4cout <<"************************************************************************************" << G4endl;
-
-  //at the end, fill the ClonesArray
-  //TODO-> Recover here the simhit/hit duality if needed!!
-  //if(((ActarSimROOTAnalysis*)gActarSimROOTAnalysis)->GetUseCrystalHitSim()==0){
-    for (G4int i=0;i<NbCrystalsWithHit;i++)
-      new((*plaHitCA)[i])ActarSimPlaHit(*thePlaHit[i]);
-  //}
-  //else{  //In case that the simulated hits were used!
-  //  ActarSimSciHitSim* testSim;
-  //  for (G4int i=0;i<NbCrystalsWithHit;i++) {
-  //    testSim =  (ActarSimSciHitSim*) (theSciHit[i]);
-  //    new((*sciHitCA)[i])ActarSimSciHitSim(*testSim);
-  //  }
-  //}
-
-  // all branches at the same time!
-  //G4cout << " #@BITCOUNT "<< crystalHitsBranch->Fill() << G4endl;
-  //G4cout << " #@BITCOUNT "<< theR3BTree->Fill() << G4endl;
-
-  delete [] detIDWithSomeEnergy;
-  delete [] nameWithSomeEnergy;
-  delete [] detIDWithHit;
-  delete [] nameWithHit;
-  delete [] detID;
-  delete [] name;
-  for (G4int i=0;i<NbCrystalsWithHit;i++) delete thePlaHit[i];
-  delete [] thePlaHit;
-
- }
-
- */
-//End of CsI Like hit
-
 //////////////////////////////////////////////////////////////////
 ///  Function to move the information from the ActarSimSciGeantHit (a step hit)
 /// to ActarSimSciHit (an event hit) for the Darmstadt-Heidelberg Crystall Ball.
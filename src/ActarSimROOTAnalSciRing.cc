@@ -98,6 +98,8 @@ void ActarSimROOTAnalSciRing::BeginOfEventAction(const G4Event *anEvent) {
 //////////////////////////////////////////////////////////////////
 /// Actions to perform in the scintillator anal at the beginning of the run
 void ActarSimROOTAnalSciRing::EndOfEventAction(const G4Event *anEvent) {
+  //events aborted at the generation have no primaries
+  if(anEvent->IsAborted() || anEvent->GetNumberOfPrimaryVertex()==0) return;
   FillingHits(anEvent);
 }
 
@@ -121,192 +123,32 @@ void ActarSimROOTAnalSciRing::FillingHits(const G4Event *anEvent) {
 
   //Number of R3BCalGeantHit (or steps) in the hitsCollection
   G4int NbHits = hitsCollection->entries();
-  G4int NbHitsWithSomeEnergy = NbHits;
-  //G4cout << " NbHits: " << NbHits << G4endl;
 
-  //We accept edep=0 GeantHits, we have to remove them
-  //from the total number of GeantHits accepted for creating a real CrystalHit
+  //Only the crystals with some energy deposited produce a Hit;
+  //the GeantHits with edep=0 are added to those crystals if present
+  energeticCrystals.Reset(NbHits);
+  G4bool isNew;
   for (G4int i=0;i<NbHits;i++)
-    if((*hitsCollection)[i]->GetEdep()==0.)
-      NbHitsWithSomeEnergy--;
-  //G4cout << " NbHitsWithSomeEnergy: " << NbHitsWithSomeEnergy << G4endl;
-
-  G4int NbCrystalsWithHit=NbHitsWithSomeEnergy;
-  G4String* nameWithSomeEnergy;
-  G4int* detIDWithSomeEnergy;
-  detIDWithSomeEnergy = new G4int[NbHitsWithSomeEnergy];
-  nameWithSomeEnergy = new G4String[NbHitsWithSomeEnergy];
-
-  //keep the crystal identifiers of the GeantHits with some energy
-  G4int hitsWithEnergyCounter=0;
-  for (G4int i=0;i<NbHits;i++) {
-    if((*hitsCollection)[i]->GetEdep()>0.){
-      nameWithSomeEnergy[hitsWithEnergyCounter] = (*hitsCollection)[i]->GetDetName();
-      detIDWithSomeEnergy[hitsWithEnergyCounter] = (*hitsCollection)[i]->GetDetID();
-      //G4cout << "with some energy:   name:" << nameWithSomeEnergy[hitsWithEnergyCounter]
-      //     << " detID:"<<detIDWithSomeEnergy[hitsWithEnergyCounter] << G4endl;
-      hitsWithEnergyCounter++;
-    }
-  }
-
-  //if(hitsWithEnergyCounter != NbHitsWithSomeEnergy) {
-  //  G4cout << "ERROR in ActarSimROOTAnalSci::FillingHits(): hitsWithEnergyCounter!=NbHitsWithSomeEnergy" << G4endl;
-  //  G4cout << " hitsWithEnergyCounter = " << hitsWithEnergyCounter << " while NbHitsWithSomeEnergy = " << NbHitsWithSomeEnergy << G4endl;
-  //}
-
-  //We ask for the number of crystals with signal and
-  //this loop calculates them from the number of ActarSimSciGeantHits with energy
-  for (G4int i=0;i<NbHitsWithSomeEnergy;i++) {
-    for(G4int j=0;j<i;j++){
-      if(nameWithSomeEnergy[i] == nameWithSomeEnergy[j] && detIDWithSomeEnergy[i] == detIDWithSomeEnergy[j]){
-	NbCrystalsWithHit--;
-	break;  //break stops the second for() sentence as soon as one repetition is found
-      }
-    }
-  }
-  //G4cout << " NbCrystalsWithHit: " << NbCrystalsWithHit << G4endl;
-
-  G4String* nameWithHit;
-  G4int* detIDWithHit;
-  detIDWithHit = new G4int[NbCrystalsWithHit];
-  nameWithHit = new G4String[NbCrystalsWithHit];
-  hitsWithEnergyCounter=0;
-
-  //keep the crystal identifiers of the final crystalHits
-  G4int hitsCounter=0;
-  for (G4int i=0;i<NbHits;i++) {
-    if ((*hitsCollection)[i]->GetEdep()>0.) {
-      if(hitsCounter==0) { //the first geantHit with energy always creates a newHit
-	nameWithHit[hitsCounter] = (*hitsCollection)[i]->GetDetName();
-	detIDWithHit[hitsCounter] = (*hitsCollection)[i]->GetDetID();
-	//G4cout << "with hit:   name:" << nameWithHit[hitsCounter]
-	//       << " detID:"<<detIDWithHit[hitsCounter] << G4endl;
-	hitsCounter++;
-      }
-      else {
-	for (G4int j=0;j<hitsCounter;j++) {
-	  if ( (*hitsCollection)[i]->GetDetName() == nameWithHit[j] &&
-	       (*hitsCollection)[i]->GetDetID() == detIDWithHit[j] ) {
-	    break;  //break stops the second for() sentence as soon as one repetition is found
-	  }
-	  if(j==hitsCounter-1){ //when the previous if was never true, there is no repetition
-	    nameWithHit[hitsCounter] = (*hitsCollection)[i]->GetDetName();
-	    detIDWithHit[hitsCounter] = (*hitsCollection)[i]->GetDetID();
-	    //G4cout << "with hit:   name:" << nameWithHit[hitsCounter]
-	    //   << " detID:"<<detIDWithHit[hitsCounter] << G4endl;
-	    hitsCounter++;
-	  }
-	}
-      }
-    }
-  }
-  //DELETE ME AFTER THE PRELIMINARY TESTS!
-  //if(hitsCounter != NbCrystalsWithHit) {
-  //  G4cout << "ERROR in R3BROOTAnalCal::FillingHits(): hitsCounter!=NbCrystalsWithHit" << G4endl;
-  //  G4cout << " hitsCounter = " << hitsCounter << " while NbCrystalsWithHit = " << NbCrystalsWithHit << G4endl;
-  //}
-
-  //Let us create as many R3BCalCrystalHit as NbCrystalsWithHit
-  //TODO->Recover here the simhit/hit duality if needed!!
-  //if(((ActarSimROOTAnalysis*)gActarSimROOTAnalysis)->GetUseCrystalHitSim()==0){
-  theSciRingHit = new ActarSimSciRingHit*[NbCrystalsWithHit];
-  for (G4int i=0;i<NbCrystalsWithHit;i++)
-    theSciRingHit[i] = new ActarSimSciRingHit();
-  //}
-  //else{  //In case that the simulated hits were used!
-  //  theSciHit = new ActarSimSciHit*[NbCrystalsWithHit];
-  //  for (G4int i=0;i<NbCrystalsWithHit;i++)
-  //    theSciHit[i] = new ActarSimSciHitSim();
-  //}
+    if((*hitsCollection)[i]->GetEdep()>0.)
+      energeticCrystals.FindOrInsert(hitMerger.GetNameIndex((*hitsCollection)[i]->GetDetName()),
+				     (*hitsCollection)[i]->GetDetID(),isNew);
 
   //Clear the ClonesArray before filling it
   sciRingHitCA->Clear();
 
-  G4bool counted = 0;
-  hitsCounter = 0; //now this variable is going to count the added GeantHits
-  G4String* name;
-  G4int* detID;
-  detID = new G4int[NbCrystalsWithHit];
-  name = new G4String[NbCrystalsWithHit];
-
-  G4bool shouldThisBeStored = 0;
-  //Filling the ActarSimSciHit from the R3BCalGeantHit (or step)
+  //Filling the ActarSimSciRingHit (one per crystal, directly in the ClonesArray)
+  //from the ActarSimSciRingGeantHit (or step)
+  hitMerger.Reset(energeticCrystals.GetEntries());
   for (G4int i=0;i<NbHits;i++) {
-    //do not accept GeantHits with edep=0
-    //if there is no other GeantHit with edep>0 in the same crystal!
-    shouldThisBeStored=0;
-    counted =0;
-    //G4cout << "ADDING THE HITS. GeantHit with name:" << (*hitsCollection)[i]->GetDetName()
-    //   << " detID:"<< (*hitsCollection)[i]->GetDetID() << " edep:"<< (*hitsCollection)[i]->GetEdep() <<" under consideration"<< G4endl;
-    for (G4int j=0;j<NbCrystalsWithHit;j++) {
-      if( (*hitsCollection)[i]->GetDetName() == nameWithHit[j] &&
-	  (*hitsCollection)[i]->GetDetID() == detIDWithHit[j] ) {
-	shouldThisBeStored=1;
-	break;  //break stops the for() sentence as soon as one "energetic" partner is found
-      }
-    }
-    if(!shouldThisBeStored) continue; //so, continue with next, if there is no "energetic partner"
-    if(hitsCounter==0){ //only for the first geantHit accepted for storage
-      name[hitsCounter] = (*hitsCollection)[i]->GetDetName();
-      detID[hitsCounter] = (*hitsCollection)[i]->GetDetID();
-      AddCalCrystalHit(theSciRingHit[hitsCounter],(*hitsCollection)[i],0);
-      //G4cout << "ADD hit:   name:" << name[hitsCounter]
-      //     << " detID:"<<detID[hitsCounter]  << " with code 0 (initial)" << G4endl;
-      hitsCounter++;
-    }
-    else {   // from the second in advance, compare if a R3BCalCrystalHit
-             // in the same volume already exists
-      for (G4int j=0;j<hitsCounter;j++) {
-	if( (*hitsCollection)[i]->GetDetName() == name[j] &&
-	    (*hitsCollection)[i]->GetDetID() == detID[j]     ){ //identical Hit already present
-	  AddCalCrystalHit(theSciRingHit[j],(*hitsCollection)[i],1);
-	  //G4cout << "ADD hit:   name:" << name[j]
-	  // << " detID:"<< detID[j]  << " with code 1" << G4endl;
-	  counted = 1;
-	  break;   // stops the for() loop; the info is written in the first identical Hit
-	}
-      }
-      if(counted==0) {	//No identical Hit present.
-	name[hitsCounter] = (*hitsCollection)[i]->GetDetName();
-	detID[hitsCounter] = (*hitsCollection)[i]->GetDetID();
-	AddCalCrystalHit(theSciRingHit[hitsCounter],(*hitsCollection)[i],0);
-	//G4cout << "ADD hit:   name:" << name[hitsCounter]
-	//     << " detID:"<<detID[hitsCounter]  << " with code 0" << G4endl;
-	hitsCounter++;
-      }
-    }
+    G4int nameIndex = hitMerger.GetNameIndex((*hitsCollection)[i]->GetDetName());
+    G4int detID = (*hitsCollection)[i]->GetDetID();
+    if(energeticCrystals.Find(nameIndex,detID)<0) continue; //no "energetic partner"
+    G4int index = hitMerger.FindOrInsert(nameIndex,detID,isNew);
+    if(isNew)
+      AddCalCrystalHit(new((*sciRingHitCA)[index])ActarSimSciRingHit(),(*hitsCollection)[i],0);
+    else
+      AddCalCrystalHit((ActarSimSciRingHit*)sciRingHitCA->UncheckedAt(index),(*hitsCollection)[i],1);
   }
-
-  //BORRAME
-  //G4cout << G4endl <<"************************  END OF DEBUGGING *****************************************" << G4endl;
-  //G4cout <<"************************************************************************************" << G4endl;
-
-  //at the end, fill the ClonesArray
-  //TODO-> Recover here the simhit/hit duality if needed!!
-  //if(((ActarSimROOTAnalysis*)gActarSimROOTAnalysis)->GetUseCrystalHitSim()==0){
-  for (G4int i=0;i<NbCrystalsWithHit;i++)
-    new((*sciRingHitCA)[i])ActarSimSciRingHit(*theSciRingHit[i]);
-  //}
-  //else{  //In case that the simulated hits were used!
-  //  ActarSimSciHitSim* testSim;
-  //  for (G4int i=0;i<NbCrystalsWithHit;i++) {
-  //    testSim =  (ActarSimSciHitSim*) (theSciHit[i]);
-  //    new((*sciHitCA)[i])ActarSimSciHitSim(*testSim);
-  //  }
-  //}
-
-  // all branches at the same time!
-  //G4cout << " #@BITCOUNT "<< crystalHitsBranch->Fill() << G4endl;
-  //G4cout << " #@BITCOUNT "<< theR3BTree->Fill() << G4endl;
-
-  delete [] detIDWithSomeEnergy;
-  delete [] nameWithSomeEnergy;
-  delete [] detIDWithHit;
-  delete [] nameWithHit;
-  delete [] detID;
-  delete [] name;
-  for (G4int i=0;i<NbCrystalsWithHit;i++) delete theSciRingHit[i];
-  delete [] theSciRingHit;
 }
 
 //////////////////////////////////////////////////////////////////
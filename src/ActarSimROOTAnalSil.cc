@@ -122,77 +122,23 @@ void ActarSimROOTAnalSil::FillingHits(const G4Event *anEvent) {
   //Number of ActarSimSilGeantHit (or steps) in the hitsCollection
   G4int NbHits = hitsCollection->entries();
 
-  G4int indepHits = 0; //number of Hits
-  G4int* trackIDtable; //stores the trackID of primary particles for each (valid) GeantHit
-  trackIDtable = new G4int[NbHits];
-  G4int* detIDtable;   //stores the detIDs for each (valid) GeantHit
-  detIDtable = new G4int[NbHits];
-  G4int* IDtable;         //stores the order in previous array for each (valid) GeantHit
-  IDtable = new G4int[NbHits];
-
-  for (G4int i=0;i<NbHits;i++) {
-    if((*hitsCollection)[i]->GetParentID()==0) { //step from primary
-      if(indepHits==0) { //only for the first Hit
-	trackIDtable[indepHits] = (*hitsCollection)[i]->GetTrackID();
-	detIDtable[indepHits] = (*hitsCollection)[i]->GetDetID();
-	IDtable[i] = indepHits;
-	indepHits++;
-      }
-      else { // this part is never reached. Maybe because there is always only one indepHits that has parentID equals to 0.
-	for(G4int j=0; j<indepHits;j++) {
-	  if( (*hitsCollection)[i]->GetTrackID() == trackIDtable[j] &&
-	      (*hitsCollection)[i]->GetDetID() == detIDtable[j]) { //checking trackID and detID
-	    IDtable[i] = j;
-	    break; //not a new Hit
-	  }
-	  if(j==indepHits-1){ //we got the last hit and there was no match!
-	    trackIDtable[indepHits] = (*hitsCollection)[i]->GetTrackID();
-	    detIDtable[indepHits] = (*hitsCollection)[i]->GetDetID();
-	    IDtable[i] = indepHits;
-	    indepHits++;
-	  }
-	}
-      }
-    }
-  }
-
-  //Let us create as many ActarSimSilHit as independent primary particles
-  theSilHit = new ActarSimSilHit*[indepHits];
-  for (G4int i=0;i<indepHits;i++)
-    theSilHit[i] = new ActarSimSilHit();
-
   //Clear the ClonesArray before filling it
   silHitCA->Clear();
 
-  //a variable to check if the Hit was already created
-  G4int* existing;
-  existing = new G4int[indepHits];
-  for(G4int i=0;i<indepHits;i++) existing[i] = 0;
-
+  //One ActarSimSilHit per independent primary particle (trackID) and
+  //detector (detID), constructed directly in the ClonesArray
+  hitMerger.Reset(NbHits);
+  G4bool isNew;
   for(G4int i=0;i<NbHits;i++) {
     if( (*hitsCollection)[i]->GetParentID()==0 ) { //step from primary
-      //the IDtable[i] contains the order in the indepHits list
-      if( existing[IDtable[i]]==0) { //if the indepHits does not exist
-	AddSilHit(theSilHit[IDtable[i]],(*hitsCollection)[i],0);
-	existing[IDtable[i]] = 1;
-      }
+      G4int index = hitMerger.FindOrInsert((*hitsCollection)[i]->GetTrackID(),
+					   (*hitsCollection)[i]->GetDetID(),isNew);
+      if(isNew)
+	AddSilHit(new((*silHitCA)[index])ActarSimSilHit(),(*hitsCollection)[i],0);
       else
-	AddSilHit(theSilHit[IDtable[i]],(*hitsCollection)[i],1);
+	AddSilHit((ActarSimSilHit*)silHitCA->UncheckedAt(index),(*hitsCollection)[i],1);
     }
   }
-
-  //at the end, fill the ClonesArray
-  for (G4int i=0;i<indepHits;i++){
-    //G4cout<<"ActarSimROOTAnalSil----------->FillingHits() "<<silHitCA<<G4endl;
-    new((*silHitCA)[i])ActarSimSilHit(*theSilHit[i]);
-    //G4cout<<"ActarSimROOTAnalSil----------->FillingHits() "<<silHitCA<<G4endl;
-  }
-  delete [] trackIDtable;
-  delete [] IDtable;
-  delete [] existing;
-  delete [] detIDtable;
-  for (G4int i=0;i<indepHits;i++) delete theSilHit[i];
-  delete [] theSilHit;
 }
 
 //////////////////////////////////////////////////////////////////
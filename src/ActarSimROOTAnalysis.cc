@@ -31,12 +31,14 @@
 #include "ActarSimSimpleTrack.hh"
 
 #include "ActarSimBeamInfo.hh"
+#include "ActarSimBeamLibrary.hh"
 
 #include "G4ios.hh"
 
 #include "G4RunManager.hh"
 #include "G4SDManager.hh"
 #include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
 #include "G4Event.hh"
 #include "G4Run.hh"
 #include "G4Track.hh"
@@ -63,6 +65,7 @@
 //#include "TPad.h"
 //#include "TCanvas.h"
 #include "TFile.h"
+#include "TNamed.h"
 #include "TClonesArray.h"
 
 //global pointer to the ROOT analysis manager
@@ -93,6 +96,7 @@ ActarSimROOTAnalysis::ActarSimROOTAnalysis():
   primaryInfoCA = 0;
   beamInfoCA = 0;
   theDataCA = 0;
+  beamLibrary = 0;
 
   //null initialization to check that is null before their instantiation
   gasAnal = 0;
@@ -502,6 +506,18 @@ void ActarSimROOTAnalysis::EndOfRunAction(const G4Run *aRun) {
   OnceAWhileDoIt(true); // do it now
 }
 
+//////////////////////////////////////////////////////////////////
+/// Stores a summary of the run (a TNamed with the given name and
+/// value) in the directory of the present run
+void ActarSimROOTAnalysis::StoreRunInfo(const G4String& name, const G4String& value) {
+  if(!simFile) return;
+  TDirectory* previous = gDirectory;
+  simFile->cd(newDirName);
+  TNamed info(name.c_str(),value.c_str());
+  info.Write(name.c_str(),TObject::kOverwrite);
+  if(previous) previous->cd();
+}
+
 //////////////////////////////////////////////////////////////////
 /// Actions to perform in the analysis at the beginning of the event
 void ActarSimROOTAnalysis::BeginOfEventAction(const G4Event *anEvent){
@@ -525,6 +541,17 @@ void ActarSimROOTAnalysis::BeginOfEventAction(const G4Event *anEvent){
 void ActarSimROOTAnalysis::EndOfEventAction(const G4Event *anEvent) {
   if (gSystem) gSystem->ProcessEvents();
 
+  //events aborted at the generation (no reaction solution, rejected by
+  //the acceptance filter, beam not reaching the vertex...) have no
+  //primaries and are not stored
+  if(anEvent->IsAborted() || anEvent->GetNumberOfPrimaryVertex()==0){
+    primaryInfoCA->Clear();
+    beamInfoCA->Clear();
+    theDataCA->Clear();
+    OnceAWhileDoIt();
+    return;
+  }
+
   G4PrimaryVertex* myPVertex1 = anEvent->GetPrimaryVertex(0);
   G4PrimaryVertex* myPVertex2 = 0;
   if(anEvent->GetNumberOfPrimaryVertex()>1)
@@ -550,14 +577,15 @@ void ActarSimROOTAnalysis::EndOfEventAction(const G4Event *anEvent) {
 
   if(storeHistogramsFlag=="on"){ // added flag dypang 080301
     //Primary histograms
+    //weighted with the importance sampling weight of the primaries
     if (hPrimTheta)
-      hPrimTheta->Fill(momentumPrim1.theta());
+      hPrimTheta->Fill(momentumPrim1.theta(),myPrim1->GetWeight());
     if (hPrimPhi)
-      hPrimPhi->Fill(momentumPrim1.phi());
+      hPrimPhi->Fill(momentumPrim1.phi(),myPrim1->GetWeight());
     if (hPrimEnergy)
-      hPrimEnergy->Fill(energyPrim1);
+      hPrimEnergy->Fill(energyPrim1,myPrim1->GetWeight());
     if (hPrimEnergyVsTheta)
-      hPrimEnergyVsTheta->Fill(momentumPrim1.theta(),energyPrim1);
+      hPrimEnergyVsTheta->Fill(momentumPrim1.theta(),energyPrim1,myPrim1->GetWeight());
   }
 
   if(storeEventsFlag=="on"){
@@ -567,6 +595,7 @@ void ActarSimROOTAnalysis::EndOfEventAction(const G4Event *anEvent) {
     theData->SetPhiPrim2(momentumPrim2.phi());
     theData->SetEnergyPrim1(energyPrim1);
     theData->SetEnergyPrim2(energyPrim2);
+    theData->SetWeight(myPrim1->GetWeight());
   }
 
   //calling the actions defined for each detector
@@ -593,6 +622,9 @@ void ActarSimROOTAnalysis::EndOfEventAction(const G4Event *anEvent) {
     //do not delete theData, as the same pointer is used for all events
   }
 
+  //the beam trajectory recorded in this event is complete
+  if(beamLibrary && beamLibrary->IsRecording()) beamLibrary->EndTrajectory();
+
   eventTree->Fill();
   primaryInfoCA->Clear(); //needed to avoid duplication of the CA contents in even/odd events
   beamInfoCA->Clear(); //needed to avoid duplication of the CA contents in even/odd events
@@ -603,15 +635,16 @@ void ActarSimROOTAnalysis::EndOfEventAction(const G4Event *anEvent) {
 }
 
 //////////////////////////////////////////////////////////////////
-/// Actions to perform in the analysis when classifying new tracks
+/// Actions to perform in the analysis when classifying new tracks.
+/// The classification can be modified through the pointer
 void ActarSimROOTAnalysis::ClassifyNewTrack(const G4Track *aTrack,
 					    G4ClassificationOfNewTrack *classification_ptr) {
   if (aTrack){;} /* keep the compiler "quiet" */
   if (classification_ptr){;} /* keep the compiler "quiet" */
   // G4ClassificationOfNewTrack &classification = (*classification_ptr);
 
-  if (gSystem) gSystem->ProcessEvents();
-
+  //Called for every new track from ActarSimStackingAction: no ProcessEvents()
+  //here, OnceAWhileDoIt() takes care of it
   OnceAWhileDoIt();
 }
 
@@ -658,6 +691,15 @@ void ActarSimROOTAnalysis::UserSteppingAction(const G4Step *aStep){
   if(beamInteractionFlag=="on" && pBeamInfo->GetStatus() == 1){
     G4double zVertex = pBeamInfo->GetNextZVertex();
     if(aStep->GetTrack()->GetParentID()==0){
+      //the steps of the beam in the gas go to the beam trajectory library
+      if(beamLibrary && beamLibrary->IsRecording() &&
+	 aStep->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetName()=="gasLog")
+	beamLibrary->AddStep(aStep->GetPreStepPoint()->GetPosition(),
+			     aStep->GetPostStepPoint()->GetPosition(),
+			     aStep->GetPreStepPoint()->GetKineticEnergy(),
+			     aStep->GetPostStepPoint()->GetKineticEnergy(),
+			     aStep->GetPreStepPoint()->GetGlobalTime(),
+			     aStep->GetPostStepPoint()->GetGlobalTime());
       if(aStep->GetPreStepPoint()->GetPosition().z() < zVertex &&
 	 aStep->GetPostStepPoint()->GetPosition().z() > zVertex){
         const G4int verboseLevel = G4RunManager::GetRunManager()->GetVerboseLevel();
@@ -708,3 +750,17 @@ void ActarSimROOTAnalysis::SetMinStrideLength(Double_t value){
   if(gasAnal)
     gasAnal->SetMinStrideLength(value);
 }
+
+//////////////////////////////////////////////////////////////////
+/// Setter of the position resolution of the steps in the tracks tree
+void ActarSimROOTAnalysis::SetTrackPositionResolution(Double_t value){
+  if(gasAnal)
+    gasAnal->SetTrackPositionResolution(value);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Setter of the energy resolution of the steps in the tracks tree
+void ActarSimROOTAnalysis::SetTrackEnergyResolution(Double_t value){
+  if(gasAnal)
+    gasAnal->SetTrackEnergyResolution(value);
+}
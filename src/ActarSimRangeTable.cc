@@ -0,0 +1,217 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimRangeTable
+/// Stopping power, CSDA range and slowing down time of a particle in
+/// a material, tabulated in log spaced kinetic energies using the
+/// G4EmCalculator (the physics list must be initialized). Also keeps
+/// the integral of dE/dedx^3, used for the energy straggling of thick
+/// absorbers. Below the first node the range and the time are taken
+/// proportional to the energy. The interpolations are linear between
+/// the nodes, so the range and its inverse are monotone. The nodes
+/// (energy, stopping power) can be written to and read from a text
+/// file (see ActarSimRangeTableService); the integrals are computed
+/// again when read.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimRangeTable.hh"
+
+#include "G4EmCalculator.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Material.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimRangeTable::ActarSimRangeTable()
+  :particle(0), material(0) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimRangeTable::~ActarSimRangeTable(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties the table
+void ActarSimRangeTable::Clear(){
+  particle = 0;
+  material = 0;
+  energy.clear();
+  dedx.clear();
+  range.clear();
+  time.clear();
+  straggling.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Fills the table between eMin and eMax (kinetic energies) with
+/// nBins log spaced intervals. Returns false if the stopping power
+/// is not positive in all the nodes
+G4bool ActarSimRangeTable::Build(const G4ParticleDefinition* part, const G4Material* mat,
+				 G4double eMin, G4double eMax, G4int nBins){
+  Clear();
+  if(!part || !mat || eMin<=0. || eMax<=eMin || nBins<1) return false;
+
+  G4EmCalculator calculator;
+  G4double ratio = std::pow(eMax/eMin,1./nBins);
+
+  std::vector<G4double> energyNodes, dedxNodes;
+  for(G4int i=0;i<=nBins;i++){
+    G4double e = eMin*std::pow(ratio,i);
+    G4double s = calculator.ComputeTotalDEDX(e,part,mat);
+    if(s<=0.) return false;
+    energyNodes.push_back(e);
+    dedxNodes.push_back(s);
+  }
+  return Fill(part,mat,energyNodes,dedxNodes);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Fills the table from the nodes (increasing kinetic energies and
+/// positive stopping powers), integrating the range, time and
+/// straggling. Returns false if the nodes are not valid
+G4bool ActarSimRangeTable::Fill(const G4ParticleDefinition* part, const G4Material* mat,
+				const std::vector<G4double>& energyNodes,
+				const std::vector<G4double>& dedxNodes){
+  Clear();
+  if(!part || !mat || energyNodes.size()<2 || energyNodes.size()!=dedxNodes.size()) return false;
+  for(size_t i=0;i<energyNodes.size();i++)
+    if(dedxNodes[i]<=0. || energyNodes[i]<=0. || (i>0 && energyNodes[i]<=energyNodes[i-1]))
+      return false;
+  energy = energyNodes;
+  dedx = dedxNodes;
+  G4double mass = part->GetPDGMass();
+
+  //trapezoidal integration of dE/S, dE/(S*v) and dE/S^3
+  range.push_back(energy[0]/dedx[0]);
+  G4double beta0 = std::sqrt(1.-mass*mass/((energy[0]+mass)*(energy[0]+mass)));
+  time.push_back(range[0]/(beta0*c_light));
+  straggling.push_back(energy[0]/(dedx[0]*dedx[0]*dedx[0]));
+  G4double previousInvV = 1./(beta0*c_light);
+  for(size_t i=1;i<energy.size();i++){
+    G4double de = energy[i]-energy[i-1];
+    G4double beta = std::sqrt(1.-mass*mass/((energy[i]+mass)*(energy[i]+mass)));
+    G4double invV = 1./(beta*c_light);
+    range.push_back(range[i-1] + 0.5*de*(1./dedx[i]+1./dedx[i-1]));
+    time.push_back(time[i-1] + 0.5*de*(invV/dedx[i]+previousInvV/dedx[i-1]));
+    straggling.push_back(straggling[i-1] +
+			 0.5*de*(1./(dedx[i]*dedx[i]*dedx[i])+1./(dedx[i-1]*dedx[i-1]*dedx[i-1])));
+    previousInvV = invV;
+  }
+
+  particle = part;
+  material = mat;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Reads the nodes of the table from a file written by Write(). The
+/// first line of the file must be the header. Returns false if the
+/// file cannot be read, is for another header or has invalid nodes
+G4bool ActarSimRangeTable::Read(const G4ParticleDefinition* part, const G4Material* mat,
+				const G4String& fileName, const G4String& header){
+  std::ifstream file(fileName.c_str());
+  if(!file) return false;
+  std::string line;
+  if(!std::getline(file,line) || line!="# "+header) return false;
+
+  std::vector<G4double> energyNodes, dedxNodes;
+  while(std::getline(file,line)){
+    if(line.empty() || line[0]=='#') continue;
+    std::istringstream values(line);
+    G4double e, s;
+    if(!(values >> e >> s)) return false;
+    energyNodes.push_back(e*MeV);
+    dedxNodes.push_back(s*MeV/mm);
+  }
+  return Fill(part,mat,energyNodes,dedxNodes);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Writes the nodes of the table (kinetic energy in MeV, stopping
+/// power in MeV/mm) after a header line. Returns false if not possible
+G4bool ActarSimRangeTable::Write(const G4String& fileName, const G4String& header) const {
+  if(energy.empty()) return false;
+  std::ofstream file(fileName.c_str());
+  if(!file) return false;
+  file.precision(12);
+  file << "# " << header << std::endl
+       << "# energy(MeV) dedx(MeV/mm)" << std::endl;
+  for(size_t i=0;i<energy.size();i++)
+    file << energy[i]/MeV << " " << dedx[i]/(MeV/mm) << std::endl;
+  return file.good();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Lower node of the interval containing value (values increasing)
+G4int ActarSimRangeTable::FindBin(const std::vector<G4double>& values, G4double value) const {
+  G4int low = 0;
+  G4int high = (G4int)values.size()-1;
+  while(high-low>1){
+    G4int middle = (low+high)/2;
+    if(values[middle]>value) high = middle;
+    else low = middle;
+  }
+  return low;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Linear interpolation in energy of a tabulated quantity. Below the
+/// first node, proportional to the energy
+G4double ActarSimRangeTable::Interpolate(const std::vector<G4double>& values, G4double e) const {
+  if(energy.empty()) return 0.;
+  if(e<=energy[0]) return values[0]*e/energy[0];
+  if(e>=energy.back()) return values.back();
+  G4int i = FindBin(energy,e);
+  return values[i] + (values[i+1]-values[i])*(e-energy[i])/(energy[i+1]-energy[i]);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Stopping power for a kinetic energy
+G4double ActarSimRangeTable::GetDEDX(G4double e) const {
+  if(energy.empty()) return 0.;
+  if(e<=energy[0]) return dedx[0];
+  if(e>=energy.back()) return dedx.back();
+  G4int i = FindBin(energy,e);
+  return dedx[i] + (dedx[i+1]-dedx[i])*(e-energy[i])/(energy[i+1]-energy[i]);
+}
+
+//////////////////////////////////////////////////////////////////
+/// CSDA range for a kinetic energy
+G4double ActarSimRangeTable::GetRange(G4double e) const {
+  return Interpolate(range,e);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Kinetic energy with a given CSDA range (inverse of GetRange())
+G4double ActarSimRangeTable::GetEnergy(G4double r) const {
+  if(range.empty() || r<=0.) return 0.;
+  if(r<=range[0]) return energy[0]*r/range[0];
+  if(r>=range.back()) return energy.back();
+  G4int i = FindBin(range,r);
+  return energy[i] + (energy[i+1]-energy[i])*(r-range[i])/(range[i+1]-range[i]);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Time to slow down from a kinetic energy to the first node. The
+/// time between two energies is the difference of the values
+G4double ActarSimRangeTable::GetTime(G4double e) const {
+  return Interpolate(time,e);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Integral of dE/dedx^3 from the first node to a kinetic energy
+G4double ActarSimRangeTable::GetStragglingIntegral(G4double e) const {
+  return Interpolate(straggling,e);
+}
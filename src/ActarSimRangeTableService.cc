@@ -0,0 +1,252 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimRangeTableService
+/// Range-energy and stopping power tables (ActarSimRangeTable) of any
+/// particle or ion in any material, computed with the G4EmCalculator
+/// of the physics list in use. The tables are kept by particle and
+/// material for the whole job (the analytic beam transport asks for
+/// them here) and are built again only when the physics changes.
+/// The tables span from minEnergyPerNucleon to maxEnergyPerNucleon
+/// (doubled until the requested energy is included) with a fixed
+/// number of log spaced nodes per decade.
+///
+/// Optionally the nodes of each table are stored in a disk cache,
+/// named after a hash (see ActarSimGeometryCache::GetKey()) of the
+/// particle, the material, the energy nodes, the physics modules and
+/// the Geant4 version, and read from there by the following jobs.
+///
+/// At the start of each run the tables of the selected particles and
+/// ions in the gas are prepared and, if selected, exported as ROOT
+/// files (exportDirectory/<particle>_on_<material>.root) for the
+/// analysis macros, with the graphs "range" (range in mm vs. energy
+/// in MeV), "energy" (its inverse) and "dedx" (MeV/mm vs. energy in
+/// MeV). The graphs are monotone and TGraph::Eval() interpolates them
+/// linearly, as the simulation does. The file also holds the TSpline3
+/// "spline" of the energy (keV) vs. the range (mm), the object (and
+/// units) of the older ranges/p_on_D2_*.root files (see ranges/README).
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimRangeTableService.hh"
+#include "ActarSimRangeTable.hh"
+#include "ActarSimGeometryCache.hh"
+
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4IonTable.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4Version.hh"
+#include "G4ios.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include "TFile.h"
+#include "TGraph.h"
+#include "TSpline.h"
+#include "TNamed.h"
+#include "TDirectory.h"
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor. Tables between 1 keV and 100 MeV per nucleon, with
+/// 100 nodes per decade; disk cache and export inactive
+ActarSimRangeTableService::ActarSimRangeTableService()
+  :cacheFlag(false), directory("rangeTables"),
+   exportFlag(false), exportDirectory("ranges"),
+   minEnergyPerNucleon(1.*keV), maxEnergyPerNucleon(100.*MeV),
+   binsPerDecade(100) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimRangeTableService::~ActarSimRangeTableService(){
+  Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Deletes the tables (they are built again when needed)
+void ActarSimRangeTableService::Clear(){
+  std::map<TableKey,ActarSimRangeTable*>::iterator it;
+  for(it=tables.begin();it!=tables.end();++it) delete it->second;
+  tables.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Description of a table: physics modules, Geant4 version, particle,
+/// material (with its composition) and energy nodes
+G4String ActarSimRangeTableService::GetConfiguration(const G4ParticleDefinition* part,
+						     const G4Material* mat,
+						     G4double eMin, G4double eMax,
+						     G4int nBins) const {
+  std::ostringstream config;
+  config.precision(12);
+  config << "ActarSimRangeTable v1; " << physicsConfiguration
+	 << "; Geant4 " << G4VERSION_NUMBER
+	 << "; particle " << part->GetParticleName()
+	 << " " << part->GetPDGMass()/MeV << " " << part->GetPDGCharge()/eplus
+	 << "; material " << mat->GetName()
+	 << " " << mat->GetDensity()/(g/cm3)
+	 << " " << mat->GetIonisation()->GetMeanExcitationEnergy()/eV;
+  for(size_t j=0;j<mat->GetNumberOfElements();j++)
+    config << " " << mat->GetElement(j)->GetZ()
+	   << " " << mat->GetElement(j)->GetN()
+	   << " " << mat->GetFractionVector()[j];
+  config << "; energy " << eMin/MeV << " " << eMax/MeV << " " << nBins;
+  return config.str();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Fills the table of the particle in the material up to (at least)
+/// the energy, reading it from the disk cache if it is there.
+/// Returns false if the table cannot be built
+G4bool ActarSimRangeTableService::BuildTable(ActarSimRangeTable* table,
+					     const G4ParticleDefinition* part,
+					     const G4Material* mat, G4double energy){
+  G4int nucleons = part->GetBaryonNumber();
+  if(nucleons<1) nucleons = 1;
+  G4double eMin = minEnergyPerNucleon*nucleons;
+  G4double eMax = maxEnergyPerNucleon*nucleons;
+  if(eMin<=0. || eMax<=eMin || binsPerDecade<1) return false;
+  while(eMax<energy) eMax *= 2.;
+  G4int nBins = (G4int)std::ceil(binsPerDecade*std::log10(eMax/eMin));
+
+  G4String header = GetConfiguration(part,mat,eMin,eMax,nBins);
+  G4String fileName = directory + "/ActarSimRange_" + ActarSimGeometryCache::GetKey(header) + ".dat";
+  if(cacheFlag && table->Read(part,mat,fileName,header)) return true;
+
+  if(!table->Build(part,mat,eMin,eMax,nBins)){
+    G4cout << "ActarSimRangeTableService::BuildTable(): cannot build the table of "
+	   << part->GetParticleName() << " in " << mat->GetName() << G4endl;
+    return false;
+  }
+
+  if(cacheFlag){
+    //written in a temporary file and renamed, so that jobs sharing
+    //the cache never read partial tables
+    mkdir(directory.c_str(),0755);
+    std::ostringstream tempName;
+    tempName << fileName << "." << getpid() << ".tmp";
+    if(!table->Write(tempName.str(),header) ||
+       std::rename(tempName.str().c_str(),fileName.c_str())!=0){
+      G4cout << "ActarSimRangeTableService::BuildTable(): cannot store the table in "
+	     << fileName << G4endl;
+      std::remove(tempName.str().c_str());
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Table of the particle in the material, covering the energy. Built
+/// the first time or when the energy is above the table. Returns 0
+/// if the table cannot be built
+ActarSimRangeTable* ActarSimRangeTableService::GetTable(const G4ParticleDefinition* part,
+							const G4Material* mat,
+							G4double energy){
+  if(!part || !mat) return 0;
+  ActarSimRangeTable*& table = tables[TableKey(part,mat)];
+  if(!table) table = new ActarSimRangeTable();
+  if(!table->IsBuilt(part,mat,energy))
+    if(!BuildTable(table,part,mat,energy)) return 0;
+  return table;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Prepares the tables of the selected particles and ions in the gas
+/// and exports them (if selected). To be called after the physics
+/// tables are built. The tables are deleted if the physics changed
+void ActarSimRangeTableService::BeginOfRun(const G4String& physicsConfig, const G4Material* gas){
+  if(physicsConfig!=physicsConfiguration){
+    Clear();
+    physicsConfiguration = physicsConfig;
+  }
+  if(!gas) return;
+
+  std::vector<const G4ParticleDefinition*> particles;
+  for(size_t i=0;i<particleNames.size();i++){
+    G4ParticleDefinition* part = G4ParticleTable::GetParticleTable()->FindParticle(particleNames[i]);
+    if(part) particles.push_back(part);
+    else G4cout << "ActarSimRangeTableService::BeginOfRun(): unknown particle "
+		<< particleNames[i] << G4endl;
+  }
+  for(size_t i=0;i<ionZA.size();i++){
+    G4ParticleDefinition* ion = G4IonTable::GetIonTable()->GetIon(ionZA[i].first,ionZA[i].second,0.);
+    if(ion) particles.push_back(ion);
+    else G4cout << "ActarSimRangeTableService::BeginOfRun(): unknown ion Z="
+		<< ionZA[i].first << " A=" << ionZA[i].second << G4endl;
+  }
+
+  for(size_t i=0;i<particles.size();i++){
+    ActarSimRangeTable* table = GetTable(particles[i],gas,0.);
+    if(table && exportFlag) Export(table);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Writes the range, inverse range and stopping power of the table as
+/// graphs in a ROOT file (exportDirectory/<particle>_on_<material>.root),
+/// together with the spline of the energy vs. the range
+void ActarSimRangeTableService::Export(const ActarSimRangeTable* table) const {
+  const std::vector<G4double>& energy = table->GetEnergyNodes();
+  const std::vector<G4double>& dedx = table->GetDEDXNodes();
+  const std::vector<G4double>& range = table->GetRangeNodes();
+  G4int nodes = energy.size();
+  if(nodes==0) return;
+
+  G4String name = table->GetParticle()->GetParticleName() + "_on_" + table->GetMaterial()->GetName();
+  mkdir(exportDirectory.c_str(),0755);
+  G4String fileName = exportDirectory + "/" + name + ".root";
+
+  TDirectory* previousDirectory = gDirectory;
+  TFile* file = new TFile(fileName.c_str(),"RECREATE");
+  if(!file || file->IsZombie()){
+    G4cout << " ActarSimRangeTableService::Export(): ERROR, cannot create " << fileName << G4endl;
+    delete file;
+    if(previousDirectory) previousDirectory->cd();
+    return;
+  }
+
+  TGraph rangeGraph(nodes);
+  TGraph energyGraph(nodes);
+  TGraph dedxGraph(nodes);
+  for(G4int i=0;i<nodes;i++){
+    rangeGraph.SetPoint(i,energy[i]/MeV,range[i]/mm);
+    energyGraph.SetPoint(i,range[i]/mm,energy[i]/MeV);
+    dedxGraph.SetPoint(i,energy[i]/MeV,dedx[i]/(MeV/mm));
+  }
+  rangeGraph.SetNameTitle("range",(name + ";energy (MeV);range (mm)").c_str());
+  energyGraph.SetNameTitle("energy",(name + ";range (mm);energy (MeV)").c_str());
+  dedxGraph.SetNameTitle("dedx",(name + ";energy (MeV);dE/dx (MeV/mm)").c_str());
+  rangeGraph.Write();
+  energyGraph.Write();
+  dedxGraph.Write();
+  //as in the older files, energy in keV vs. range in mm
+  std::vector<G4double> splineRange(nodes);
+  std::vector<G4double> splineEnergy(nodes);
+  for(G4int i=0;i<nodes;i++){
+    splineRange[i] = range[i]/mm;
+    splineEnergy[i] = energy[i]/keV;
+  }
+  TSpline3 spline("spline",&splineRange[0],&splineEnergy[0],nodes);
+  spline.SetName("spline");
+  spline.Write();
+  TNamed physicsName("physics",physicsConfiguration.c_str());
+  physicsName.Write();
+  file->Close();
+  delete file;
+  if(previousDirectory) previousDirectory->cd();
+
+  G4cout << " ActarSimRangeTableService::Export(): range table written in " << fileName << G4endl;
+}
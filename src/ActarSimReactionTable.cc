@@ -0,0 +1,119 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimReactionTable
+/// Reaction products table read from a file (CINE output format),
+/// loaded once and kept in memory. FILE format: first row with 6
+/// integers [scattered ion Z; A; charge state; recoil ion Z; A; charge
+/// state]. Each following line contains the scattered ion angle and
+/// energy and the recoil ion angle and energy (deg, MeV) and, optionally,
+/// a fifth column with the cross section used as sampling weight.
+/// Rows are sampled uniformly or, if requested and the weights are
+/// present, with the alias method; both in constant time.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimReactionTable.hh"
+
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimReactionTable::ActarSimReactionTable()
+  :weighted(false), ion1Z(0), ion1A(0), ion1Charge(0),
+   ion2Z(0), ion2A(0), ion2Charge(0) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimReactionTable::~ActarSimReactionTable(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties the table
+void ActarSimReactionTable::Clear(){
+  fileName = "";
+  theta1.clear();
+  energy1.clear();
+  theta2.clear();
+  energy2.clear();
+  crossSection.clear();
+  weightTable.Clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Reads the file. Returns false if the file cannot be opened or
+/// contains no valid row. Incomplete rows are skipped
+G4bool ActarSimReactionTable::Load(G4String name, G4bool useWeights){
+  Clear();
+  weighted = useWeights;
+
+  std::ifstream inputFile(name.c_str());
+  if(!inputFile) {
+    G4cout << "ActarSimReactionTable::Load() - ERROR: file "
+	   << name << " not found." << G4endl;
+    return false;
+  }
+
+  if(!(inputFile >> ion1Z >> ion1A >> ion1Charge >> ion2Z >> ion2A >> ion2Charge)) {
+    G4cout << "ActarSimReactionTable::Load() - ERROR: wrong header in file "
+	   << name << G4endl;
+    return false;
+  }
+
+  G4bool allWeights = true;
+  std::string line;
+  while(std::getline(inputFile,line)) {
+    std::istringstream is(line);
+    G4double t1, e1, t2, e2, xs;
+    if(!(is >> t1 >> e1 >> t2 >> e2)) continue;
+    theta1.push_back(t1);
+    energy1.push_back(e1);
+    theta2.push_back(t2);
+    energy2.push_back(e2);
+    if(is >> xs) crossSection.push_back(xs);
+    else {
+      crossSection.push_back(0.);
+      allWeights = false;
+    }
+  }
+
+  if(theta1.empty()) {
+    G4cout << "ActarSimReactionTable::Load() - ERROR: no rows in file "
+	   << name << G4endl;
+    return false;
+  }
+
+  if(weighted) {
+    if(!allWeights || !weightTable.Build(crossSection)) {
+      G4cout << "ActarSimReactionTable::Load() - WARNING: no valid cross section"
+	     << " column in " << name << ". Rows sampled uniformly." << G4endl;
+      weightTable.Clear();
+    }
+  }
+
+  fileName = name;
+  G4cout << "ActarSimReactionTable::Load() - " << theta1.size()
+	 << " rows loaded from " << name
+	 << (weightTable.IsEmpty() ? " (uniform sampling)" : " (weighted sampling)")
+	 << G4endl;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Returns a random row, uniformly or weighted by the cross section
+G4int ActarSimReactionTable::SampleRow() const {
+  if(!weightTable.IsEmpty()) return weightTable.Sample();
+  G4int nbRows = (G4int)theta1.size();
+  G4int row = (G4int)(G4UniformRand()*nbRows);
+  return (row<nbRows) ? row : nbRows-1;
+}
@@ -0,0 +1,200 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimRegionSettings
+/// Production cuts and step limits of the regions of the detector:
+/// gas (ActiveGas), silicon (SiliconWalls), scintillator
+/// (ScintillatorWalls), chamber (Chamber, the chamber volume and the
+/// volumes in it not in other regions) and world (the default region,
+/// whose cuts are also used by the regions without cuts of their own).
+/// The settings are kept until the regions exist and applied at each
+/// run initialization (ActarSimRunManager::RunInitialization()). The
+/// step limits are applied by G4StepLimiterPerRegion from the user
+/// limits of the regions.
+/// Optionally, the steps, tracks (by the region of their first step)
+/// and CPU time of each region are counted during the run and
+/// reported at the end of the run. The time between two steps is
+/// charged to the region of the second one, except at the first step
+/// of the event.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimRegionSettings.hh"
+#include "ActarSimROOTAnalysis.hh"
+
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4UserLimits.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ios.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+#include <iomanip>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimRegionSettings::ActarSimRegionSettings()
+  :reportFlag(false), lastRegion(0), lastCost(0), lastClock(0) {
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor. The user limits can be still used by the regions
+ActarSimRegionSettings::~ActarSimRegionSettings(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Name of the G4Region of a region of the detector (gas, silicon,
+/// scintillator, chamber or world)
+G4String ActarSimRegionSettings::GetRegionName(const G4String& region){
+  if(region=="gas") return "ActiveGas";
+  if(region=="silicon") return "SiliconWalls";
+  if(region=="scintillator") return "ScintillatorWalls";
+  if(region=="chamber") return "Chamber";
+  return "DefaultRegionForTheWorld";
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the production cut of gammas, electrons and positrons in the
+/// region
+void ActarSimRegionSettings::SetCut(const G4String& region, G4double cut){
+  cuts[GetRegionName(region)] = cut;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the maximum step length of the charged particles in the region
+void ActarSimRegionSettings::SetMaxStep(const G4String& region, G4double step){
+  maxSteps[GetRegionName(region)] = step;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Applies the cuts and step limits to the regions
+void ActarSimRegionSettings::Apply(){
+  G4RegionStore* regions = G4RegionStore::GetInstance();
+
+  std::map<G4String,G4double>::iterator it;
+  for(it=cuts.begin();it!=cuts.end();++it){
+    G4Region* region = regions->GetRegion(it->first,false);
+    if(!region){
+      G4cout << "ActarSimRegionSettings::Apply(): no region " << it->first
+	     << " in the geometry; its cuts are not applied" << G4endl;
+      continue;
+    }
+    G4ProductionCuts* productionCuts = region->GetProductionCuts();
+    G4ProductionCuts* defaultCuts =
+      G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+    //the world region uses the default cuts
+    if(!productionCuts || (productionCuts==defaultCuts && it->first!="DefaultRegionForTheWorld")){
+      productionCuts = new G4ProductionCuts(*defaultCuts);
+      region->SetProductionCuts(productionCuts);
+    }
+    if(productionCuts->GetProductionCut("gamma")!=it->second)
+      productionCuts->SetProductionCut(it->second,"gamma");
+    if(productionCuts->GetProductionCut("e-")!=it->second)
+      productionCuts->SetProductionCut(it->second,"e-");
+    if(productionCuts->GetProductionCut("e+")!=it->second)
+      productionCuts->SetProductionCut(it->second,"e+");
+  }
+
+  for(it=maxSteps.begin();it!=maxSteps.end();++it){
+    G4Region* region = regions->GetRegion(it->first,false);
+    if(!region){
+      G4cout << "ActarSimRegionSettings::Apply(): no region " << it->first
+	     << " in the geometry; its step limit is not applied" << G4endl;
+      continue;
+    }
+    G4UserLimits*& limits = userLimits[it->first];
+    if(!limits) limits = new G4UserLimits(it->second);
+    else limits->SetMaxAllowedStep(it->second);
+    region->SetUserLimits(limits);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Resets the cost counters at the beginning of the run
+void ActarSimRegionSettings::BeginOfRunAction(){
+  costs.clear();
+  lastRegion = 0;
+  lastCost = 0;
+  lastClock = std::clock();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Counts the step (and the track, if it is its first step) and the
+/// CPU time since the previous step in the region of the step
+void ActarSimRegionSettings::UserSteppingAction(const G4Step* aStep){
+  if(!reportFlag) return;
+  std::clock_t now = std::clock();
+  const G4Track* track = aStep->GetTrack();
+  G4bool firstStep = (track->GetCurrentStepNumber()==1);
+
+  const G4Region* region = 0;
+  G4VPhysicalVolume* volume = aStep->GetPreStepPoint()->GetPhysicalVolume();
+  if(volume) region = volume->GetLogicalVolume()->GetRegion();
+  if(region!=lastRegion || !lastCost){
+    lastCost = &costs[region];
+    lastRegion = region;
+  }
+
+  lastCost->steps++;
+  if(firstStep){
+    lastCost->tracks++;
+    //the time before the event is not charged
+    if(track->GetTrackID()==1) lastClock = now;
+  }
+  lastCost->time += now - lastClock;
+  lastClock = now;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Prints the cost of each region in the run, also stored in the
+/// directory of the run of the output file (regionReport)
+void ActarSimRegionSettings::EndOfRunAction(){
+  if(!reportFlag) return;
+
+  G4long totalSteps = 0;
+  std::clock_t totalTime = 0;
+  std::map<const G4Region*,RegionCost>::iterator it;
+  for(it=costs.begin();it!=costs.end();++it){
+    totalSteps += it->second.steps;
+    totalTime += it->second.time;
+  }
+
+  std::ostringstream report;
+  report << std::setw(26) << std::left << "region" << std::right
+	 << std::setw(12) << "steps" << std::setw(10) << "tracks"
+	 << std::setw(12) << "CPU (s)" << std::setw(9) << "CPU (%)"
+	 << std::setw(14) << "us per step" << std::endl;
+  for(it=costs.begin();it!=costs.end();++it){
+    G4double seconds = (G4double)it->second.time/CLOCKS_PER_SEC;
+    report << std::setw(26) << std::left
+	   << (it->first ? it->first->GetName() : G4String("OutOfWorld")) << std::right
+	   << std::setw(12) << it->second.steps << std::setw(10) << it->second.tracks
+	   << std::setw(12) << std::setprecision(4) << seconds
+	   << std::setw(9) << std::setprecision(3)
+	   << (totalTime>0 ? 100.*it->second.time/totalTime : 0.)
+	   << std::setw(14) << std::setprecision(4)
+	   << (it->second.steps>0 ? 1.e6*seconds/it->second.steps : 0.) << std::endl;
+  }
+  report << std::setw(26) << std::left << "total" << std::right
+	 << std::setw(12) << totalSteps << std::setw(10) << ""
+	 << std::setw(12) << std::setprecision(4) << (G4double)totalTime/CLOCKS_PER_SEC << std::endl;
+
+  G4cout << "##################################################################" << G4endl
+	 << "########  ActarSimRegionSettings: cost of the regions  ###########" << G4endl
+	 << report.str()
+	 << "##################################################################" << G4endl;
+
+  if(gActarSimROOTAnalysis)
+    gActarSimROOTAnalysis->StoreRunInfo("regionReport",report.str());
+}
@@ -14,13 +14,18 @@
 #include "ActarSimRunAction.hh"
 
 #include "ActarSimROOTAnalysis.hh"
+#include "ActarSimPrimaryGeneratorAction.hh"
+#include "ActarSimRegionSettings.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
 
 //////////////////////////////////////////////////////////////////
-/// Constructor. Makes nothing
-ActarSimRunAction::ActarSimRunAction(){
+/// Constructor. The primary generator and the region settings (cost
+/// report) are informed of the run start and end
+ActarSimRunAction::ActarSimRunAction(ActarSimPrimaryGeneratorAction* gen,
+				     ActarSimRegionSettings* regions)
+  :primaryGenerator(gen), regionSettings(regions){
 }
 
 //////////////////////////////////////////////////////////////////
@@ -46,6 +51,12 @@ void ActarSimRunAction::BeginOfRunAction(const G4Run* aRun) {
   //inform the runManager to save random number seed
   G4RunManager::GetRunManager()->SetRandomNumberStore(true);
 
+  //the reaction kinematics tables are rebuilt for the new run parameters
+  if(primaryGenerator) primaryGenerator->BeginOfRunAction();
+
+  //the cost of the regions is counted from zero
+  if(regionSettings) regionSettings->BeginOfRunAction();
+
   // Histogramming
   if (gActarSimROOTAnalysis) gActarSimROOTAnalysis->BeginOfRunAction(aRun);
 }
@@ -53,6 +64,12 @@ void ActarSimRunAction::BeginOfRunAction(const G4Run* aRun) {
 //////////////////////////////////////////////////////////////////
 /// Actions to perform at the end of the run
 void ActarSimRunAction::EndOfRunAction(const G4Run* aRun) {
+  //the beam trajectories recorded in the run are written
+  if(primaryGenerator) primaryGenerator->EndOfRunAction();
+
+  //the cost of the regions in the run is reported
+  if(regionSettings) regionSettings->EndOfRunAction();
+
   // Histogramming
   if(gActarSimROOTAnalysis) gActarSimROOTAnalysis->EndOfRunAction(aRun);
 }
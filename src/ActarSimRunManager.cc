@@ -0,0 +1,68 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimRunManager
+/// Run manager. Applies the cuts and step limits of the regions
+/// (ActarSimRegionSettings) and retrieves the physics tables from the physics table
+/// cache (ActarSimPhysicsTableCache) before they are built at the run
+/// initialization, and stores them after it if they were not there.
+/// Then the range tables in the gas (ActarSimRangeTableService) are
+/// prepared.
+/// The cache is prepared at each run initialization, since the
+/// materials (gas, pressure) and cuts can change between runs.
+/// Owns the scan driver (ActarSimScanDriver), which makes several
+/// runs with different configurations in the same process.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimRunManager.hh"
+#include "ActarSimPhysicsList.hh"
+#include "ActarSimPhysicsTableCache.hh"
+#include "ActarSimRegionSettings.hh"
+#include "ActarSimRangeTableService.hh"
+#include "ActarSimDetectorConstruction.hh"
+#include "ActarSimGasDetectorConstruction.hh"
+#include "ActarSimScanDriver.hh"
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimRunManager::ActarSimRunManager():G4RunManager(){
+  scanDriver = new ActarSimScanDriver();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimRunManager::~ActarSimRunManager(){
+  delete scanDriver;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Run initialization, with the cuts and step limits of the regions
+/// and the physics tables retrieved from or stored in the cache.
+/// The range tables of the gas are prepared after the physics tables
+void ActarSimRunManager::RunInitialization(){
+  ActarSimPhysicsList* physicsList =
+    dynamic_cast<ActarSimPhysicsList*>(const_cast<G4VUserPhysicsList*>(GetUserPhysicsList()));
+  if(physicsList){
+    physicsList->GetRegionSettings()->Apply();
+    physicsList->GetPhysicsTableCache()->Prepare(physicsList,physicsList->GetPhysicsConfiguration());
+  }
+
+  G4RunManager::RunInitialization();
+
+  if(physicsList){
+    physicsList->GetPhysicsTableCache()->Store(physicsList);
+
+    //the range tables in the gas use the physics tables just built
+    G4Material* gas = 0;
+    ActarSimDetectorConstruction* detector =
+      dynamic_cast<ActarSimDetectorConstruction*>(const_cast<G4VUserDetectorConstruction*>(GetUserDetectorConstruction()));
+    if(detector && detector->GetGasDetector())
+      gas = detector->GetGasDetector()->GetGasMaterial();
+    physicsList->GetRangeTableService()->BeginOfRun(physicsList->GetPhysicsConfiguration(),gas);
+  }
+}
@@ -0,0 +1,134 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimSDFilter
+/// Step filter for the sensitive detectors. It is evaluated at the
+/// beginning of the ProcessHits() method of the SD, before any hit is
+/// allocated, and rejects the step by parentID, particle type or
+/// kinetic energy. Each SD owns one filter, controlled from the
+/// /ActarSim/filter/<SDname>/ directory. Inactive by default.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimSDFilter.hh"
+#include "ActarSimSDFilterMessenger.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4ios.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <sstream>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor. The filter is created inactive, accepting everything
+ActarSimSDFilter::ActarSimSDFilter(G4String name)
+  :G4VSDFilter(name), filterActive(false),
+   maxParentID(-1), minKineticEnergy(0.) {
+  filterMessenger = new ActarSimSDFilterMessenger(this, name);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimSDFilter::~ActarSimSDFilter(){
+  delete filterMessenger;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Returns true if the step should produce a hit. The cheapest
+/// checks (integer and double comparisons) are done first
+G4bool ActarSimSDFilter::Accept(const G4Step* aStep) const {
+  if(!filterActive) return true;
+  return Accept(aStep->GetTrack(),aStep->GetPreStepPoint()->GetKineticEnergy());
+}
+
+//////////////////////////////////////////////////////////////////
+/// Same selection for the hits not coming from a G4Step (fast
+/// simulation strides), given the track and its initial kinetic energy
+G4bool ActarSimSDFilter::Accept(const G4Track* track, G4double kineticEnergy) const {
+  if(!filterActive) return true;
+
+  if(maxParentID>=0 && track->GetParentID()>maxParentID) return false;
+
+  if(minKineticEnergy>0. && kineticEnergy<minKineticEnergy) return false;
+
+  if(!acceptedPDG.empty() || !rejectedPDG.empty()){
+    G4int pdg = track->GetDefinition()->GetPDGEncoding();
+    if(!rejectedPDG.empty() &&
+       std::find(rejectedPDG.begin(),rejectedPDG.end(),pdg)!=rejectedPDG.end())
+      return false;
+    if(!acceptedPDG.empty() &&
+       std::find(acceptedPDG.begin(),acceptedPDG.end(),pdg)==acceptedPDG.end())
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Translates a particle name (or directly a PDG code, useful for ions
+/// not yet created in the G4IonTable) to the PDG code. Returns 0 if unknown
+G4int ActarSimSDFilter::ParticleNameToPDG(G4String particleName){
+  G4ParticleDefinition* pd =
+    G4ParticleTable::GetParticleTable()->FindParticle(particleName);
+  if(pd) return pd->GetPDGEncoding();
+  G4int pdg = 0;
+  std::istringstream is(particleName);
+  if(is >> pdg && is.eof()) return pdg;
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds a particle to the list of accepted particles. If the list is
+/// not empty, only the particles in the list produce hits
+void ActarSimSDFilter::AddAcceptedParticle(G4String particleName){
+  G4int pdg = ParticleNameToPDG(particleName);
+  if(pdg==0){
+    G4cout << "ActarSimSDFilter::AddAcceptedParticle() - WARNING: particle "
+	   << particleName << " not found. Filter not modified." << G4endl;
+    return;
+  }
+  acceptedPDG.push_back(pdg);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds a particle to the list of rejected particles
+void ActarSimSDFilter::AddRejectedParticle(G4String particleName){
+  G4int pdg = ParticleNameToPDG(particleName);
+  if(pdg==0){
+    G4cout << "ActarSimSDFilter::AddRejectedParticle() - WARNING: particle "
+	   << particleName << " not found. Filter not modified." << G4endl;
+    return;
+  }
+  rejectedPDG.push_back(pdg);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties both the accepted and the rejected particle lists
+void ActarSimSDFilter::ClearParticles(){
+  acceptedPDG.clear();
+  rejectedPDG.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Prints the filter parameters
+void ActarSimSDFilter::PrintFilterParameters(){
+  G4cout << "##################################################################" << G4endl
+	 << "## ActarSimSDFilter::PrintFilterParameters() for " << GetName() << G4endl
+	 << "##    -filter active       : " << (filterActive ? "on" : "off") << G4endl
+	 << "##    -max parentID        : " << maxParentID << G4endl
+	 << "##    -min kinetic energy  : " << minKineticEnergy/MeV << " MeV" << G4endl
+	 << "##    -accepted PDG codes  :";
+  for(size_t i=0;i<acceptedPDG.size();i++) G4cout << " " << acceptedPDG[i];
+  G4cout << G4endl << "##    -rejected PDG codes  :";
+  for(size_t i=0;i<rejectedPDG.size();i++) G4cout << " " << rejectedPDG[i];
+  G4cout << G4endl
+	 << "##################################################################" << G4endl;
+}
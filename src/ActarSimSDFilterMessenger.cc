@@ -0,0 +1,120 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimSDFilterMessenger
+/// Messenger for the sensitive detector step filters
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimSDFilterMessenger.hh"
+
+#include "ActarSimSDFilter.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "globals.hh"
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+/// command included in this SDFilterMessenger (one directory per SD):
+/// - /ActarSim/filter/<SDname>/active
+/// - /ActarSim/filter/<SDname>/maxParentID
+/// - /ActarSim/filter/<SDname>/minKineticEnergy
+/// - /ActarSim/filter/<SDname>/acceptParticle
+/// - /ActarSim/filter/<SDname>/rejectParticle
+/// - /ActarSim/filter/<SDname>/clearParticles
+/// - /ActarSim/filter/<SDname>/print
+ActarSimSDFilterMessenger::ActarSimSDFilterMessenger(ActarSimSDFilter* fil, G4String name)
+  :filter(fil) {
+  G4String dirName = "/ActarSim/filter/" + name + "/";
+
+  filterDir = new G4UIdirectory(dirName);
+  G4String dirGuidance = "Step filter of the sensitive detector " + name;
+  filterDir->SetGuidance(dirGuidance);
+
+  activeCmd = new G4UIcmdWithAString(G4String(dirName+"active"),this);
+  activeCmd->SetGuidance("Evaluates the step filter before creating any hit.");
+  activeCmd->SetGuidance("  Choice : on, off(default)");
+  activeCmd->SetParameterName("choice",true);
+  activeCmd->SetDefaultValue("off");
+  activeCmd->SetCandidates("on off");
+  activeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  maxParentIDCmd = new G4UIcmdWithAnInteger(G4String(dirName+"maxParentID"),this);
+  maxParentIDCmd->SetGuidance("Rejects the steps of tracks with parentID above the value.");
+  maxParentIDCmd->SetGuidance("  0 keeps only the primaries, -1 (default) disables the cut.");
+  maxParentIDCmd->SetParameterName("parentID",false);
+  maxParentIDCmd->SetRange("parentID>=-1");
+  maxParentIDCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  minEnergyCmd = new G4UIcmdWithADoubleAndUnit(G4String(dirName+"minKineticEnergy"),this);
+  minEnergyCmd->SetGuidance("Rejects the steps with kinetic energy (pre-step) below the value.");
+  minEnergyCmd->SetParameterName("energy",false);
+  minEnergyCmd->SetRange("energy>=0.");
+  minEnergyCmd->SetUnitCategory("Energy");
+  minEnergyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  acceptParticleCmd = new G4UIcmdWithAString(G4String(dirName+"acceptParticle"),this);
+  acceptParticleCmd->SetGuidance("Adds a particle (name or PDG code) to the accepted list.");
+  acceptParticleCmd->SetGuidance("If the list is not empty, only those particles produce hits.");
+  acceptParticleCmd->SetParameterName("particle",false);
+  acceptParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  rejectParticleCmd = new G4UIcmdWithAString(G4String(dirName+"rejectParticle"),this);
+  rejectParticleCmd->SetGuidance("Adds a particle (name or PDG code) to the rejected list.");
+  rejectParticleCmd->SetParameterName("particle",false);
+  rejectParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  clearParticlesCmd = new G4UIcmdWithoutParameter(G4String(dirName+"clearParticles"),this);
+  clearParticlesCmd->SetGuidance("Empties the accepted and rejected particle lists.");
+  clearParticlesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  printCmd = new G4UIcmdWithoutParameter(G4String(dirName+"print"),this);
+  printCmd->SetGuidance("Prints the filter parameters.");
+  printCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimSDFilterMessenger::~ActarSimSDFilterMessenger() {
+  delete activeCmd;
+  delete maxParentIDCmd;
+  delete minEnergyCmd;
+  delete acceptParticleCmd;
+  delete rejectParticleCmd;
+  delete clearParticlesCmd;
+  delete printCmd;
+  delete filterDir;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Setting the values using the ActarSimSDFilter interface
+void ActarSimSDFilterMessenger::SetNewValue(G4UIcommand* command,
+					    G4String newValue) {
+  if(command == activeCmd)
+    filter->SetFilterActive(newValue=="on");
+
+  if(command == maxParentIDCmd)
+    filter->SetMaxParentID(maxParentIDCmd->GetNewIntValue(newValue));
+
+  if(command == minEnergyCmd)
+    filter->SetMinKineticEnergy(minEnergyCmd->GetNewDoubleValue(newValue));
+
+  if(command == acceptParticleCmd)
+    filter->AddAcceptedParticle(newValue);
+
+  if(command == rejectParticleCmd)
+    filter->AddRejectedParticle(newValue);
+
+  if(command == clearParticlesCmd)
+    filter->ClearParticles();
+
+  if(command == printCmd)
+    filter->PrintFilterParameters();
+}
@@ -0,0 +1,212 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimScanDriver
+/// Scan of several configurations in a single process. Each parameter
+/// of the scan (axis) is a UI command, with the placeholder % for the
+/// value (appended at the end if there is no placeholder), and the
+/// list of its values; the points are all the combinations of values,
+/// the last axis changing faster. For each point only the commands of
+/// the axes whose value changed are applied, followed by their update
+/// commands (e.g. /ActarSim/det/update for the geometry; the gas
+/// pressure, the beam and the analysis parameters do not need any),
+/// and a run is made. Each run is stored in its directory of the
+/// output file (HistosN), with the point in the TNamed scanPoint.
+/// The scan is defined with the /ActarSim/scan/ commands or in a
+/// file, with one keyword per line (# for comments):
+///   axis /ActarSim/det/gas/setGasPressure % bar
+///   values 0.5 1.0 1.5
+///   axis /gun/energy % MeV
+///   values 10 20
+///   update /ActarSim/det/update
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimScanDriver.hh"
+#include "ActarSimScanMessenger.hh"
+#include "ActarSimROOTAnalysis.hh"
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4ios.hh"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimScanDriver::ActarSimScanDriver(){
+  messenger = new ActarSimScanMessenger(this);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimScanDriver::~ActarSimScanDriver(){
+  delete messenger;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds a parameter to the scan, with the command setting it
+void ActarSimScanDriver::AddAxis(const G4String& command){
+  ScanAxis axis;
+  axis.command = command;
+  axes.push_back(axis);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds values (separated by spaces) to the last parameter
+void ActarSimScanDriver::AddValues(const G4String& values){
+  if(axes.empty()){
+    G4cout << "ActarSimScanDriver::AddValues(): no parameter in the scan; add one first"
+	   << G4endl;
+    return;
+  }
+  std::istringstream list(values);
+  std::string value;
+  while(list >> value) axes.back().values.push_back(value);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds a command to apply after the value of the last parameter
+/// changes
+void ActarSimScanDriver::AddUpdate(const G4String& command){
+  if(axes.empty()){
+    G4cout << "ActarSimScanDriver::AddUpdate(): no parameter in the scan; add one first"
+	   << G4endl;
+    return;
+  }
+  axes.back().updates.push_back(command);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Removes all the parameters
+void ActarSimScanDriver::Clear(){
+  axes.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Reads the parameters of the scan from a file, adding them to the
+/// present ones. Returns false if the file cannot be opened or has
+/// an unknown keyword
+G4bool ActarSimScanDriver::Load(const G4String& name){
+  std::ifstream inputFile(name.c_str());
+  if(!inputFile) {
+    G4cout << "ActarSimScanDriver::Load() - ERROR: file "
+	   << name << " not found." << G4endl;
+    return false;
+  }
+
+  std::string line;
+  while(std::getline(inputFile,line)) {
+    std::istringstream is(line);
+    std::string keyword;
+    if(!(is >> keyword) || keyword[0]=='#') continue;
+    std::string argument;
+    std::getline(is >> std::ws,argument);
+    if(keyword=="axis") AddAxis(argument);
+    else if(keyword=="values") AddValues(argument);
+    else if(keyword=="update") AddUpdate(argument);
+    else {
+      G4cout << "ActarSimScanDriver::Load() - ERROR: unknown keyword "
+	     << keyword << " in file " << name << G4endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Number of points (combinations of values) of the scan
+G4int ActarSimScanDriver::GetNumberOfPoints() const {
+  if(axes.empty()) return 0;
+  G4int points = 1;
+  for(size_t i=0;i<axes.size();i++) points *= axes[i].values.size();
+  return points;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Command setting the value index of the parameter axis
+G4String ActarSimScanDriver::GetCommand(G4int axis, G4int index) const {
+  G4String command = axes[axis].command;
+  const G4String& value = axes[axis].values[index];
+  size_t position = command.find('%');
+  if(position==std::string::npos) return command + " " + value;
+  return command.substr(0,position) + value + command.substr(position+1);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Makes a run of numberOfEvents events for each point of the scan.
+/// The scan stops if a command fails
+void ActarSimScanDriver::BeamOn(G4int numberOfEvents){
+  G4int points = GetNumberOfPoints();
+  if(points==0){
+    G4cout << "ActarSimScanDriver::BeamOn(): the scan has no points" << G4endl;
+    return;
+  }
+
+  G4UImanager* UI = G4UImanager::GetUIpointer();
+  G4int numberOfAxes = axes.size();
+  std::vector<G4int> index(numberOfAxes,0);
+  std::vector<G4int> previous(numberOfAxes,-1);
+
+  for(G4int point=0;point<points;point++){
+    G4int rest = point;
+    for(G4int i=numberOfAxes-1;i>=0;i--){
+      index[i] = rest % axes[i].values.size();
+      rest /= axes[i].values.size();
+    }
+
+    //only the parameters that changed are set
+    std::ostringstream description;
+    std::vector<G4String> updates;
+    for(G4int i=0;i<numberOfAxes;i++){
+      G4String command = GetCommand(i,index[i]);
+      description << (i ? "; " : "") << command;
+      if(index[i]==previous[i]) continue;
+      if(UI->ApplyCommand(command)!=0){
+	G4cout << "ActarSimScanDriver::BeamOn(): command " << command
+	       << " failed; scan stopped" << G4endl;
+	return;
+      }
+      for(size_t j=0;j<axes[i].updates.size();j++){
+	G4bool found = false;
+	for(size_t k=0;k<updates.size() && !found;k++) found = (updates[k]==axes[i].updates[j]);
+	if(!found) updates.push_back(axes[i].updates[j]);
+      }
+    }
+    for(size_t j=0;j<updates.size();j++){
+      if(UI->ApplyCommand(updates[j])!=0){
+	G4cout << "ActarSimScanDriver::BeamOn(): command " << updates[j]
+	       << " failed; scan stopped" << G4endl;
+	return;
+      }
+    }
+    previous = index;
+
+    G4cout << "ActarSimScanDriver::BeamOn(): point " << point+1 << " of " << points
+	   << ": " << description.str() << G4endl;
+    G4RunManager::GetRunManager()->BeamOn(numberOfEvents);
+
+    if(gActarSimROOTAnalysis)
+      gActarSimROOTAnalysis->StoreRunInfo("scanPoint",description.str());
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Prints the parameters of the scan
+void ActarSimScanDriver::Print() const {
+  G4cout << "ActarSimScanDriver: " << axes.size() << " parameters, "
+	 << GetNumberOfPoints() << " points" << G4endl;
+  for(size_t i=0;i<axes.size();i++){
+    G4cout << "  " << axes[i].command << " :";
+    for(size_t j=0;j<axes[i].values.size();j++) G4cout << " " << axes[i].values[j];
+    G4cout << G4endl;
+    for(size_t j=0;j<axes[i].updates.size();j++)
+      G4cout << "    update: " << axes[i].updates[j] << G4endl;
+  }
+}
@@ -0,0 +1,113 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimScanMessenger
+/// Messenger of the scan driver
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimScanMessenger.hh"
+#include "ActarSimScanDriver.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+/// command included in this ScanMessenger:
+/// - /ActarSim/scan/addAxis
+/// - /ActarSim/scan/addValues
+/// - /ActarSim/scan/addUpdate
+/// - /ActarSim/scan/file
+/// - /ActarSim/scan/clear
+/// - /ActarSim/scan/print
+/// - /ActarSim/scan/beamOn
+ActarSimScanMessenger::ActarSimScanMessenger(ActarSimScanDriver* driver)
+  :scanDriver(driver){
+
+  scanDir = new G4UIdirectory("/ActarSim/scan/");
+  scanDir->SetGuidance("Scan of configurations in a single process");
+
+  addAxisCmd = new G4UIcmdWithAString("/ActarSim/scan/addAxis",this);
+  addAxisCmd->SetGuidance("Adds a parameter to the scan: the command setting it,");
+  addAxisCmd->SetGuidance("with % in the place of the value (appended if there is no %).");
+  addAxisCmd->SetGuidance("Example: /ActarSim/scan/addAxis /ActarSim/det/gas/setGasPressure % bar");
+  addAxisCmd->SetParameterName("command",false);
+  addAxisCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  addValuesCmd = new G4UIcmdWithAString("/ActarSim/scan/addValues",this);
+  addValuesCmd->SetGuidance("Adds values (separated by spaces) to the last parameter.");
+  addValuesCmd->SetParameterName("values",false);
+  addValuesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  addUpdateCmd = new G4UIcmdWithAString("/ActarSim/scan/addUpdate",this);
+  addUpdateCmd->SetGuidance("Adds a command to apply when the value of the last parameter changes");
+  addUpdateCmd->SetGuidance("(e.g. /ActarSim/det/update after a geometry parameter).");
+  addUpdateCmd->SetParameterName("command",false);
+  addUpdateCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fileCmd = new G4UIcmdWithAString("/ActarSim/scan/file",this);
+  fileCmd->SetGuidance("Reads the parameters of the scan from a file, with the keywords");
+  fileCmd->SetGuidance("axis, values and update (one per line) as the commands above.");
+  fileCmd->SetParameterName("fileName",false);
+  fileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  clearCmd = new G4UIcmdWithoutParameter("/ActarSim/scan/clear",this);
+  clearCmd->SetGuidance("Removes all the parameters of the scan.");
+  clearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  printCmd = new G4UIcmdWithoutParameter("/ActarSim/scan/print",this);
+  printCmd->SetGuidance("Prints the parameters of the scan.");
+  printCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  beamOnCmd = new G4UIcmdWithAnInteger("/ActarSim/scan/beamOn",this);
+  beamOnCmd->SetGuidance("Makes a run with the given number of events for each point of the scan.");
+  beamOnCmd->SetGuidance("Only the parameters changed from the previous point are set.");
+  beamOnCmd->SetParameterName("numberOfEvents",false);
+  beamOnCmd->SetRange("numberOfEvents>=0");
+  beamOnCmd->AvailableForStates(G4State_Idle);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimScanMessenger::~ActarSimScanMessenger(){
+  delete addAxisCmd;
+  delete addValuesCmd;
+  delete addUpdateCmd;
+  delete fileCmd;
+  delete clearCmd;
+  delete printCmd;
+  delete beamOnCmd;
+  delete scanDir;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Setting the values using the ActarSimScanDriver interface
+void ActarSimScanMessenger::SetNewValue(G4UIcommand* command, G4String newValue){
+  if(command == addAxisCmd)
+    scanDriver->AddAxis(newValue);
+
+  if(command == addValuesCmd)
+    scanDriver->AddValues(newValue);
+
+  if(command == addUpdateCmd)
+    scanDriver->AddUpdate(newValue);
+
+  if(command == fileCmd)
+    scanDriver->Load(newValue);
+
+  if(command == clearCmd)
+    scanDriver->Clear();
+
+  if(command == printCmd)
+    scanDriver->Print();
+
+  if(command == beamOnCmd)
+    scanDriver->BeamOn(beamOnCmd->GetNewIntValue(newValue));
+}
@@ -17,6 +17,7 @@
 #include "ActarSimSciDetectorMessenger.hh"
 #include "ActarSimROOTAnalysis.hh"
 #include "ActarSimSciSD.hh"
+#include "ActarSimWallParameterisation.hh"
 
 #include "G4Material.hh"
 #include "G4Box.hh"
@@ -174,6 +175,7 @@ G4VPhysicalVolume* ActarSimSciDetectorConstruction::ConstructSci(G4LogicalVolume
 
   //   G4int	checker = sideCoverage;
   if(sideCoverage & 0x0001){ // bit1 (lsb) beam output wall
+    ActarSimWallParameterisation* sciWall = new ActarSimWallParameterisation();
     //iteration on Scintillator elements
     /*
     for(G4int rowX=0;rowX<numberOfRowsX;rowX++){  //maybe is rowX=1 the first??
@@ -190,44 +192,44 @@ G4VPhysicalVolume* ActarSimSciDetectorConstruction::ConstructSci(G4LogicalVolume
     for(G4int rowX=0;rowX<4;rowX++){  //maybe is rowX=1 the first??
       for(G4int rowY=0;rowY<4;rowY++){
         iterationNumber++;
-        sciPhys =
-          new G4PVPlacement(0,G4ThreeVector( (rowX-1.5)*2*(sciBulk_x+defectHalfLength),
+        sciWall->AddElement(0,G4ThreeVector( (rowX-1.5)*2*(sciBulk_x+defectHalfLength),
 					     (rowY-1.5)*2*(sciBulk_x+defectHalfLength),
-					     2*zBoxSciHalfLength + separationFromBox + sciBulk_z - zGasBoxPosition),
-			    sciLog, "sciPhys", worldLog, false, iterationNumber);
+					     2*zBoxSciHalfLength + separationFromBox + sciBulk_z - zGasBoxPosition), iterationNumber);
       }
     }
+    sciPhys = sciWall->Place("sciPhys", sciLog, "sciWallOutput", worldLog);
   }
 
   //PLANES ZX
   //a different rotation has to be introduced on each side...
   if((sideCoverage >> 1) & 0x0001){ // bit2 lower [bottom] (gravity based) wall
+    ActarSimWallParameterisation* sciWall = new ActarSimWallParameterisation();
     for(G4int rowZ=0;rowZ<numberOfRowsZ;rowZ++){
       for(G4int rowX=0;rowX<numberOfRowsX;rowX++){
 	iterationNumber++;
-	sciPhys =
-	  new G4PVPlacement(rotBottom,G4ThreeVector(-xBoxSciHalfLength + ((rowX+1)*2-1)*(sciBulk_x+defectHalfLength),
+	sciWall->AddElement(rotBottom,G4ThreeVector(-xBoxSciHalfLength + ((rowX+1)*2-1)*(sciBulk_x+defectHalfLength),
 						    -(yBoxSciHalfLength + separationFromBox + sciBulk_z),
-						    ((rowZ+1)*2-1)*(sciBulk_x+defectHalfLength) - zGasBoxPosition),
-			    sciLog, "sciPhys", worldLog, false, iterationNumber);
+						    ((rowZ+1)*2-1)*(sciBulk_x+defectHalfLength) - zGasBoxPosition), iterationNumber);
       }
     }
+    sciPhys = sciWall->Place("sciPhys", sciLog, "sciWallBottom", worldLog);
   }
   if((sideCoverage >> 2) & 0x0001){ // bit3 upper [top] (gravity based) wall
+    ActarSimWallParameterisation* sciWall = new ActarSimWallParameterisation();
     for(G4int rowZ=0;rowZ<numberOfRowsZ;rowZ++){
       for(G4int rowX=0;rowX<numberOfRowsX;rowX++){
 	iterationNumber++;
-	sciPhys =
-	  new G4PVPlacement(rotTop,G4ThreeVector(-xBoxSciHalfLength + ((rowX+1)*2-1)*(sciBulk_x+defectHalfLength),
+	sciWall->AddElement(rotTop,G4ThreeVector(-xBoxSciHalfLength + ((rowX+1)*2-1)*(sciBulk_x+defectHalfLength),
 	 				         yBoxSciHalfLength + separationFromBox + sciBulk_z,
-					         ((rowZ+1)*2-1)*(sciBulk_x+defectHalfLength) - zGasBoxPosition),
-			    sciLog, "sciPhys", worldLog, false, iterationNumber);
+					         ((rowZ+1)*2-1)*(sciBulk_x+defectHalfLength) - zGasBoxPosition), iterationNumber);
       }
     }
+    sciPhys = sciWall->Place("sciPhys", sciLog, "sciWallTop", worldLog);
   }
 
   //PLANES ZY
   if((sideCoverage >> 3) & 0x0001){ // bit4 left (from beam point of view) wall
+    ActarSimWallParameterisation* sciWall = new ActarSimWallParameterisation();
     /*
     for(G4int rowZ=0;rowZ<numberOfRowsZ;rowZ++){
       for(G4int rowY=0;rowY<numberOfRowsY;rowY++){
@@ -243,16 +245,16 @@ G4VPhysicalVolume* ActarSimSciDetectorConstruction::ConstructSci(G4LogicalVolume
     for(G4int rowZ=0;rowZ<6;rowZ++){
       for(G4int rowY=0;rowY<4;rowY++){
         iterationNumber++;
-        sciPhys =
-          new G4PVPlacement(rotLeft,G4ThreeVector(xBoxSciHalfLength + separationFromBox + sciBulk_z,
+        sciWall->AddElement(rotLeft,G4ThreeVector(xBoxSciHalfLength + separationFromBox + sciBulk_z,
 						  (rowY-1.5)*2*(sciBulk_x+defectHalfLength),
-						  zBoxSciHalfLength+(rowZ-2.5)*2*(sciBulk_x+defectHalfLength) - zGasBoxPosition),
-			    sciLog, "sciPhys", worldLog, false, iterationNumber);
+						  zBoxSciHalfLength+(rowZ-2.5)*2*(sciBulk_x+defectHalfLength) - zGasBoxPosition), iterationNumber);
       }
     }
+    sciPhys = sciWall->Place("sciPhys", sciLog, "sciWallLeft", worldLog);
   }
 
   if((sideCoverage >> 4) & 0x0001){ // bit5 right (from beam point of view) wall
+    ActarSimWallParameterisation* sciWall = new ActarSimWallParameterisation();
     /*
     for(G4int rowZ=0;rowZ<numberOfRowsZ;rowZ++){
       for(G4int rowY=0;rowY<numberOfRowsY;rowY++){
@@ -269,27 +271,26 @@ G4VPhysicalVolume* ActarSimSciDetectorConstruction::ConstructSci(G4LogicalVolume
     for(G4int rowZ=0;rowZ<2;rowZ++){
       for(G4int rowY=0;rowY<2;rowY++){
 	iterationNumber++;
-        sciPhys =
-          new G4PVPlacement(rotRight,G4ThreeVector(-(xBoxSciHalfLength + separationFromBox + sciBulk_z),
+        sciWall->AddElement(rotRight,G4ThreeVector(-(xBoxSciHalfLength + separationFromBox + sciBulk_z),
 						   (rowY-0.5)*2*(sciBulk_y+defectHalfLength),
-						   zBoxSciHalfLength+(rowZ-0.5)*2*(sciBulk_x+defectHalfLength) - zGasBoxPosition),
-			    sciLog, "sciPhys", worldLog, false, iterationNumber);
+						   zBoxSciHalfLength+(rowZ-0.5)*2*(sciBulk_x+defectHalfLength) - zGasBoxPosition), iterationNumber);
 
       }
     }
+    sciPhys = sciWall->Place("sciPhys", sciLog, "sciWallRight", worldLog);
   }
 
   if((sideCoverage >> 5) & 0x0001){ // bit6 (msb) beam entrance wall
+    ActarSimWallParameterisation* sciWall = new ActarSimWallParameterisation();
     for(G4int rowX=0;rowX<numberOfRowsX;rowX++){
       for(G4int rowY=0;rowY<numberOfRowsY;rowY++){
         iterationNumber++;
-        sciPhys =
-          new G4PVPlacement(rotBack,G4ThreeVector(-xBoxSciHalfLength + ((rowX+1)*2-1)*(sciBulk_x+defectHalfLength),
+        sciWall->AddElement(rotBack,G4ThreeVector(-xBoxSciHalfLength + ((rowX+1)*2-1)*(sciBulk_x+defectHalfLength),
 	 				          -yBoxSciHalfLength + ((rowY+1)*2-1)*(sciBulk_x+defectHalfLength),
-					          -separationFromBox - sciBulk_z - zGasBoxPosition),
-			    sciLog, "sciPhys", worldLog, false, iterationNumber);
+					          -separationFromBox - sciBulk_z - zGasBoxPosition), iterationNumber);
       }
     }
+    sciPhys = sciWall->Place("sciPhys", sciLog, "sciWallEntrance", worldLog);
   }
 
   //------------------------------------------------
@@ -297,6 +298,9 @@ G4VPhysicalVolume* ActarSimSciDetectorConstruction::ConstructSci(G4LogicalVolume
   //------------------------------------------------
   sciLog->SetSensitiveDetector( detConstruction->GetSciSD() );
 
+  //region of the parameterized response (ActarSimSilSciFastModel)
+  detConstruction->AddToSilSciWalls(sciLog,"ScintillatorWalls");
+
   //------------------------------------------------------------------
   // Visualization attributes
   //------------------------------------------------------------------
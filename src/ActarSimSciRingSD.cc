@@ -12,6 +12,7 @@
 /////////////////////////////////////////////////////////////////
 
 #include "ActarSimSciRingSD.hh"
+#include "ActarSimSDFilter.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
@@ -31,11 +32,13 @@ ActarSimSciRingSD::ActarSimSciRingSD(G4String name)
   :G4VSensitiveDetector(name){
   G4String HCname;
   collectionName.insert(HCname="SciRingCollection");
+  stepFilter = new ActarSimSDFilter(name);
 }
 
 //////////////////////////////////////////////////////////////////
-/// Destructor, nothing to do
+/// Destructor
 ActarSimSciRingSD::~ActarSimSciRingSD(){
+  delete stepFilter;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -55,6 +58,9 @@ void ActarSimSciRingSD::Initialize(G4HCofThisEvent* HCE){
 /// Filling the ActarSimSciGeantHit information with the step info
 /// Invoked by G4SteppingManager for each step
 G4bool ActarSimSciRingSD::ProcessHits(G4Step* aStep,G4TouchableHistory*){
+  //Optional rejection (parentID, particle, energy) before allocating the hit
+  if(!stepFilter->Accept(aStep)) return false;
+
   G4double edep = aStep->GetTotalEnergyDeposit();
 
   if(edep==0.) return false;
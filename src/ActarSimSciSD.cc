@@ -12,9 +12,12 @@
 /////////////////////////////////////////////////////////////////
 
 #include "ActarSimSciSD.hh"
+#include "ActarSimSDFilter.hh"
+#include "ActarSimWallParameterisation.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
+#include "G4Track.hh"
 #include "G4ThreeVector.hh"
 #include "G4SDManager.hh"
 #include "G4ios.hh"
@@ -24,6 +27,7 @@
 #include "G4VPhysicalVolume.hh"
 #include "G4TouchableHistory.hh"
 #include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
 
 //////////////////////////////////////////////////////////////////
 /// Constructor, just naming the Hit collection
@@ -31,11 +35,13 @@ ActarSimSciSD::ActarSimSciSD(G4String name)
   :G4VSensitiveDetector(name){
   G4String HCname;
   collectionName.insert(HCname="SciCollection");
+  stepFilter = new ActarSimSDFilter(name);
 }
 
 //////////////////////////////////////////////////////////////////
-/// Destructor, nothing to do
+/// Destructor
 ActarSimSciSD::~ActarSimSciSD(){
+  delete stepFilter;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -55,6 +61,9 @@ void ActarSimSciSD::Initialize(G4HCofThisEvent* HCE){
 /// Filling the ActarSimSciGeantHit information with the step info
 /// Invoked by G4SteppingManager for each step
 G4bool ActarSimSciSD::ProcessHits(G4Step* aStep,G4TouchableHistory*){
+  //Optional rejection (parentID, particle, energy) before allocating the hit
+  if(!stepFilter->Accept(aStep)) return false;
+
   G4double edep = aStep->GetTotalEnergyDeposit();
 
   if(edep==0.) return false;
@@ -68,21 +77,23 @@ G4bool ActarSimSciSD::ProcessHits(G4Step* aStep,G4TouchableHistory*){
   //interaction. The PreStep keeps record of where the particle comes from
   newHit->SetPrePos(aStep->GetPreStepPoint()->GetPosition());
 
-  //for the local translation, x = R-1 (x_m - T)
+  //for the local translation, x = R-1 (x_m - T), from the touchables: the
+  //elements of the walls are parameterised and their volume does not
+  //keep the placement of each element
   G4ThreeVector theLocalPos =
-    (aStep->GetPostStepPoint()->GetPhysicalVolume()->GetObjectRotationValue().inverse()) *
-    (aStep->GetPostStepPoint()->GetPosition()-aStep->GetPostStepPoint()->GetPhysicalVolume()->GetObjectTranslation());
+    aStep->GetPostStepPoint()->GetTouchable()->GetHistory()->GetTopTransform().
+    TransformPoint(aStep->GetPostStepPoint()->GetPosition());
   newHit->SetLocalPos(theLocalPos);
 
   theLocalPos = //just using the same variable...
-    (aStep->GetPreStepPoint()->GetPhysicalVolume()->GetObjectRotationValue().inverse())*
-    (aStep->GetPreStepPoint()->GetPosition()-aStep->GetPreStepPoint()->GetPhysicalVolume()->GetObjectTranslation());
+    aStep->GetPreStepPoint()->GetTouchable()->GetHistory()->GetTopTransform().
+    TransformPoint(aStep->GetPreStepPoint()->GetPosition());
   newHit->SetLocalPrePos(theLocalPos);
 
   newHit->SetDetName(aStep->GetTrack()->GetVolume()->GetName());
   newHit->SetPreDetName(aStep->GetPreStepPoint()->GetPhysicalVolume()->GetName());
   newHit->SetPostDetName(aStep->GetPostStepPoint()->GetPhysicalVolume()->GetName());
-  newHit->SetDetID(aStep->GetTrack()->GetVolume()->GetCopyNo());
+  newHit->SetDetID(ActarSimWallParameterisation::GetCopyNumber(aStep->GetPreStepPoint()->GetTouchable()));
 
   newHit->SetToF(aStep->GetPostStepPoint()->GetGlobalTime());
 
@@ -100,6 +111,50 @@ G4bool ActarSimSciSD::ProcessHits(G4Step* aStep,G4TouchableHistory*){
   return true;
 }
 
+//////////////////////////////////////////////////////////////////
+/// Filling the ActarSimSciGeantHit information with the single step
+/// of the fast simulation (ActarSimSilSciFastModel), which does not
+/// produce a G4Step. postTouchable is the touchable after the post point
+/// (0 if the particle stops in the element or leaves the world). Same
+/// fields than ProcessHits()
+G4bool ActarSimSciSD::ProcessFastStep(const G4Track* track,
+				      const G4ThreeVector& prePos, const G4ThreeVector& postPos,
+				      const G4VTouchable* postTouchable, G4double postTime,
+				      G4double preEnergy, G4double postEnergy){
+  if(!stepFilter->Accept(track,preEnergy)) return false;
+
+  G4double edep = preEnergy - postEnergy;
+  if(edep==0.) return false;
+
+  const G4VTouchable* touchable = track->GetTouchable();
+  if(!postTouchable) postTouchable = touchable;
+
+  ActarSimSciGeantHit* newHit = new ActarSimSciGeantHit();
+
+  newHit->SetEdep(edep);
+
+  newHit->SetPos(postPos);
+  newHit->SetPrePos(prePos);
+  newHit->SetLocalPos(postTouchable->GetHistory()->GetTopTransform().TransformPoint(postPos));
+  newHit->SetLocalPrePos(touchable->GetHistory()->GetTopTransform().TransformPoint(prePos));
+
+  newHit->SetDetName(touchable->GetVolume()->GetName());
+  newHit->SetPreDetName(touchable->GetVolume()->GetName());
+  newHit->SetPostDetName(postTouchable->GetVolume()->GetName());
+  newHit->SetDetID(ActarSimWallParameterisation::GetCopyNumber(touchable));
+
+  newHit->SetToF(postTime);
+
+  newHit->SetTrackID(track->GetTrackID());
+  newHit->SetParentID(track->GetParentID());
+  newHit->SetParticleID(track->GetDefinition()->GetPDGEncoding());
+  newHit->SetParticleCharge(track->GetDefinition()->GetPDGCharge());
+  newHit->SetParticleMass(track->GetDefinition()->GetPDGMass());
+
+  hitsCollection->insert(newHit);
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////
 ///  Just prints and draws the event hits (class ActarSimSciGeantHit)
 /// The recollection of the hits energy deposition in the plastic
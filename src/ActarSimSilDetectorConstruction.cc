@@ -17,6 +17,7 @@
 #include "ActarSimSilDetectorMessenger.hh"
 #include "ActarSimROOTAnalysis.hh"
 #include "ActarSimSilSD.hh"
+#include "ActarSimWallParameterisation.hh"
 
 #include "G4Material.hh"
 #include "G4Box.hh"
@@ -155,7 +156,6 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
 
   //DSSD detector
   G4LogicalVolume* silDSSDLog(0);
-  G4VPhysicalVolume* silDSSDPhys(0);
 
   G4Box* silDSSDBox =
     new G4Box("silDSSDBox", silDSSDBulk_x, silDSSDBulk_y, silDSSDBulk_z);
@@ -256,6 +256,7 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
   // 				  AlLayerLog,"Al_layer",chamberLog,false,0);
 
   if(sideCoverage & 0x0001){ // bit1 (lsb) beam output wall
+    ActarSimWallParameterisation* silDSSDWall = new ActarSimWallParameterisation();
     //iteration on Silicon elements
     /*
     for(G4int rowX=0;rowX<numberOfRowsX;rowX++){  //maybe is rowX=1 the first??
@@ -282,12 +283,10 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
 			    silDSSDLog, "silDSSDPhys", chamberLog, false, iterationDSSDNumber);
 	*/
         iterationNumber++;
-        silPhys =
-          new G4PVPlacement(0,G4ThreeVector( (rowX-0.5)*2*(silDSSDBulk_x+defectHalfLength),
+        silDSSDWall->AddElement(0,G4ThreeVector( (rowX-0.5)*2*(silDSSDBulk_x+defectHalfLength),
 					     (rowY-0.5)*2*(silDSSDBulk_x+defectHalfLength),
 					     //zBoxSilHalfLength - separationFromBox - silDSSDBulk_z),
-					     zGasBox + zBoxSilHalfLength),
-			    silDSSDLog, "silPhys", chamberLog, false, iterationNumber);
+					     zGasBox + zBoxSilHalfLength), iterationNumber);
 
 	DSSDAlIterationNumber++;
 	//Al Layers
@@ -313,47 +312,47 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
 					2*zBoxSilHalfLength + separationFromBox + silBulk_z),
 			silLog, "silPhys", chamberLog, false, iterationNumber);
     */
+    silPhys = silDSSDWall->Place("silPhys", silDSSDLog, "silWallOutput", chamberLog);
   }
 
   //PLANES ZX
   //a different rotation has to be introduced on each side...
   if((sideCoverage >> 1) & 0x0001){ // bit2 lower [bottom] (gravity based) wall
+    ActarSimWallParameterisation* silWall = new ActarSimWallParameterisation();
     for(G4int rowZ=0;rowZ<numberOfRowsZ;rowZ++){
       for(G4int rowX=0;rowX<numberOfRowsX;rowX++){
 	iterationNumber++;
-	silPhys =
-	  new G4PVPlacement(rotBottom,G4ThreeVector(-xBoxSilHalfLength + ((rowX+1)*2-1)*(silBulk_x+defectHalfLength),
+	silWall->AddElement(rotBottom,G4ThreeVector(-xBoxSilHalfLength + ((rowX+1)*2-1)*(silBulk_x+defectHalfLength),
 						    -(yBoxSilHalfLength + separationFromBox + silBulk_z),
-						    ((rowZ+1)*2-1)*(silBulk_x+defectHalfLength)),
-			    silLog, "silPhys", chamberLog, false, iterationNumber);
+						    ((rowZ+1)*2-1)*(silBulk_x+defectHalfLength)), iterationNumber);
       }
     }
+    silPhys = silWall->Place("silPhys", silLog, "silWallBottom", chamberLog);
   }
   if((sideCoverage >> 2) & 0x0001){ // bit3 upper [top] (gravity based) wall
+    ActarSimWallParameterisation* silWall = new ActarSimWallParameterisation();
     for(G4int rowZ=0;rowZ<numberOfRowsZ;rowZ++){
       for(G4int rowX=0;rowX<numberOfRowsX;rowX++){
 	iterationNumber++;
-	silPhys =
-	  new G4PVPlacement(rotTop,G4ThreeVector(-xBoxSilHalfLength + ((rowX+1)*2-1)*(silBulk_x+defectHalfLength),
+	silWall->AddElement(rotTop,G4ThreeVector(-xBoxSilHalfLength + ((rowX+1)*2-1)*(silBulk_x+defectHalfLength),
 	 				         yBoxSilHalfLength + separationFromBox + silBulk_z,
-					         ((rowZ+1)*2-1)*(silBulk_x+defectHalfLength)),
-			    silLog, "silPhys", chamberLog, false, iterationNumber);
+					         ((rowZ+1)*2-1)*(silBulk_x+defectHalfLength)), iterationNumber);
       }
     }
+    silPhys = silWall->Place("silPhys", silLog, "silWallTop", chamberLog);
   }
 
   //PLANES ZY
   if((sideCoverage >> 3) & 0x0001){ // bit4 left (from beam point of view) wall
+    ActarSimWallParameterisation* silWall = new ActarSimWallParameterisation();
 
     for(G4int rowZ=0;rowZ<3;rowZ++){
       for(G4int rowY=0;rowY<2;rowY++){
         iterationNumber++;
-        silPhys =
-          //new G4PVPlacement(rotLeft,G4ThreeVector(xBoxSilHalfLength - separationFromBox - silBulk_z,
-          new G4PVPlacement(rotLeft,G4ThreeVector(xGasBox + xBoxSilHalfLength,
+        //silWall->AddElement(rotLeft,G4ThreeVector(xBoxSilHalfLength - separationFromBox - silBulk_z,
+        silWall->AddElement(rotLeft,G4ThreeVector(xGasBox + xBoxSilHalfLength,
 						  (rowY-0.5)*2*(silBulk_y+defectHalfLength),
-						  (rowZ-1)*2*(silBulk_x+defectHalfLength)),
-			    silLog, "silPhys", chamberLog, false, iterationNumber);
+						  (rowZ-1)*2*(silBulk_x+defectHalfLength)), iterationNumber);
 	/*
 	MAYAAlIterationNumber++;
 	//Al Layers
@@ -365,9 +364,11 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
 	*/
       }
     }
+    silPhys = silWall->Place("silPhys", silLog, "silWallLeft", chamberLog);
   }
 
   if((sideCoverage >> 4) & 0x0001){ // bit5 right (from beam point of view) wall
+    ActarSimWallParameterisation* silWall = new ActarSimWallParameterisation();
     /*
     iterationNumber++;
     silPhys = new G4PVPlacement(rotRight,G4ThreeVector(-(xBoxSilHalfLength - separationFromBox - silBulk_z),
@@ -378,12 +379,10 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
     for(G4int rowZ=0;rowZ<3;rowZ++){
       for(G4int rowY=0;rowY<2;rowY++){
         iterationNumber++;
-        silPhys =
-          //new G4PVPlacement(rotRight,G4ThreeVector(-(xBoxSilHalfLength - separationFromBox - silBulk_z),
-          new G4PVPlacement(rotRight,G4ThreeVector(-(xGasBox + xBoxSilHalfLength),
+        //silWall->AddElement(rotRight,G4ThreeVector(-(xBoxSilHalfLength - separationFromBox - silBulk_z),
+        silWall->AddElement(rotRight,G4ThreeVector(-(xGasBox + xBoxSilHalfLength),
 						   (rowY-0.5)*2*(silBulk_y+defectHalfLength),
-						   (rowZ-1)*2*(silBulk_x+defectHalfLength)),
-			    silLog, "silPhys", chamberLog, false, iterationNumber);
+						   (rowZ-1)*2*(silBulk_x+defectHalfLength)), iterationNumber);
 	/*
 	MAYAAlIterationNumber++;
 	//Al Layers
@@ -395,19 +394,20 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
 	*/
       }
     }
+    silPhys = silWall->Place("silPhys", silLog, "silWallRight", chamberLog);
   }
 
   if((sideCoverage >> 5) & 0x0001){ // bit6 (msb) beam entrance wall
+    ActarSimWallParameterisation* silWall = new ActarSimWallParameterisation();
     for(G4int rowX=0;rowX<numberOfRowsX;rowX++){
       for(G4int rowY=0;rowY<numberOfRowsY;rowY++){
         iterationNumber++;
-        silPhys =
-          new G4PVPlacement(rotBack,G4ThreeVector(-xBoxSilHalfLength + ((rowX+1)*2-1)*(silBulk_y+defectHalfLength),
+        silWall->AddElement(rotBack,G4ThreeVector(-xBoxSilHalfLength + ((rowX+1)*2-1)*(silBulk_y+defectHalfLength),
 	 				          -yBoxSilHalfLength + ((rowY+1)*2-1)*(silBulk_x+defectHalfLength),
-					          -separationFromBox - silBulk_z),
-			    silLog, "silPhys", chamberLog, false, iterationNumber);
+					          -separationFromBox - silBulk_z), iterationNumber);
       }
     }
+    silPhys = silWall->Place("silPhys", silLog, "silWallEntrance", chamberLog);
   }
 
   //------------------------------------------------
@@ -416,6 +416,10 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
   silLog->SetSensitiveDetector( detConstruction->GetSilSD() );
   silDSSDLog->SetSensitiveDetector( detConstruction->GetSilSD() );
 
+  //region of the parameterized response (ActarSimSilSciFastModel)
+  detConstruction->AddToSilSciWalls(silLog,"SiliconWalls");
+  detConstruction->AddToSilSciWalls(silDSSDLog,"SiliconWalls");
+
   //------------------------------------------------------------------
   // Visualization attributes
   //------------------------------------------------------------------
@@ -436,7 +440,6 @@ G4VPhysicalVolume* ActarSimSilDetectorConstruction::ConstructSil(G4LogicalVolume
   */
 
   return silPhys;
-  return silDSSDPhys;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -12,6 +12,7 @@
 /////////////////////////////////////////////////////////////////
 
 #include "ActarSimSilRingSD.hh"
+#include "ActarSimSDFilter.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
@@ -34,11 +35,13 @@ ActarSimSilRingSD::ActarSimSilRingSD(G4String name)
   :G4VSensitiveDetector(name){
   G4String HCname;
   collectionName.insert(HCname="SilRingCollection");
+  stepFilter = new ActarSimSDFilter(name);
 }
 
 //////////////////////////////////////////////////////////////////
-/// Destructor, nothing to do
+/// Destructor
 ActarSimSilRingSD::~ActarSimSilRingSD(){
+  delete stepFilter;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -58,6 +61,9 @@ void ActarSimSilRingSD::Initialize(G4HCofThisEvent* HCE){
 /// Filling the ActarSimSilRingGeantHit information with the step info
 /// Invoked by G4SteppingManager for each step
 G4bool ActarSimSilRingSD::ProcessHits(G4Step* aStep,G4TouchableHistory*){
+  //Optional rejection (parentID, particle, energy) before allocating the hit
+  if(!stepFilter->Accept(aStep)) return false;
+
   G4double edep = aStep->GetTotalEnergyDeposit();
 
   if(edep==0.) return false;
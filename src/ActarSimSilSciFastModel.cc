@@ -0,0 +1,210 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimSilSciFastModel
+/// Parameterized response of the silicon and scintillator walls.
+/// Attached to the SiliconWalls and ScintillatorWalls regions, it
+/// replaces the tracking of the
+/// charged hadrons and ions inside a silicon or scintillator element
+/// by a single step: the path to the exit of the element is compared
+/// with the tabulated range (ActarSimRangeTable) of the particle in the
+/// element material. If the particle stops, all its energy is
+/// deposited and it is killed; otherwise the exit energy is taken from
+/// the range table (with Bohr energy straggling and Highland angular
+/// deflection, if required) and the tracking continues at the exit
+/// point. One ActarSimSilGeantHit or ActarSimSciGeantHit, with the
+/// same fields than the full tracking, is given to the corresponding
+/// SD. No secondaries are produced. Inactive by default.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimSilSciFastModel.hh"
+#include "ActarSimSilSD.hh"
+#include "ActarSimSciSD.hh"
+#include "ActarSimRangeTable.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Material.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4TouchableHistory.hh"
+#include "G4TransportationManager.hh"
+#include "Randomize.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor. The model is created inactive
+ActarSimSilSciFastModel::ActarSimSilSciFastModel(G4String name,
+						 ActarSimSilSD* sil, ActarSimSciSD* sci)
+  :G4VFastSimulationModel(name), silSD(sil), sciSD(sci),
+   activeFlag(false), stragglingFlag(true), minimumLength(1.*um), nBins(500) {
+  navigator = new G4Navigator();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimSilSciFastModel::~ActarSimSilSciFastModel(){
+  ClearTables();
+  delete navigator;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Deletes the range tables (they are built again when needed)
+void ActarSimSilSciFastModel::ClearTables(){
+  std::map<TableKey,ActarSimRangeTable*>::iterator it;
+  for(it=rangeTables.begin();it!=rangeTables.end();++it) delete it->second;
+  rangeTables.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Charged hadrons and ions (the electrons and gammas keep the full
+/// physics, their range is not a good description)
+G4bool ActarSimSilSciFastModel::IsApplicable(const G4ParticleDefinition& particle){
+  return particle.GetPDGCharge()!=0. &&
+    (particle.GetParticleType()=="nucleus" || particle.GetParticleType()=="baryon");
+}
+
+//////////////////////////////////////////////////////////////////
+/// Range table of the particle in the material, built (up to twice
+/// the energy) the first time or when the energy is above the table.
+/// Returns 0 if the table cannot be built
+ActarSimRangeTable* ActarSimSilSciFastModel::GetRangeTable(const G4ParticleDefinition* particle,
+							   const G4Material* material,
+							   G4double energy){
+  ActarSimRangeTable*& table = rangeTables[TableKey(particle,material)];
+  if(!table) table = new ActarSimRangeTable();
+  if(!table->IsBuilt(particle,material,energy))
+    if(!table->Build(particle,material,2.e-4*energy,2.*energy,nBins)) return 0;
+  return table;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Distance along the direction to the next boundary of the mass
+/// geometry, up to maxLength (kInfinity if there is no boundary)
+G4double ActarSimSilSciFastModel::DistanceToBoundary(const G4ThreeVector& position,
+						     const G4ThreeVector& direction,
+						     G4double maxLength){
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()->
+    GetNavigatorForTracking()->GetWorldVolume();
+  if(navigator->GetWorldVolume()!=world) navigator->SetWorldVolume(world);
+
+  navigator->LocateGlobalPointAndSetup(position,&direction,false,false);
+  G4double safety = 0.;
+  return navigator->ComputeStep(position,direction,maxLength,safety);
+}
+
+//////////////////////////////////////////////////////////////////
+/// The model is triggered in the volumes of the silicon and
+/// scintillator SDs (not in their daughters), if the particle is not
+/// already on the exit boundary
+G4bool ActarSimSilSciFastModel::ModelTrigger(const G4FastTrack& fastTrack){
+  if(!activeFlag) return false;
+
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  G4VSensitiveDetector* detector = track->GetVolume()->GetLogicalVolume()->GetSensitiveDetector();
+  if(!detector || (detector!=silSD && detector!=sciSD)) return false;
+
+  G4double energy = track->GetKineticEnergy();
+  if(energy<=0. || !GetRangeTable(track->GetDefinition(),track->GetMaterial(),energy))
+    return false;
+
+  return DistanceToBoundary(track->GetPosition(),track->GetMomentumDirection(),
+			    minimumLength) > 0.;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Moves the particle to the exit of the element or to its stopping
+/// point in a single step and fills the hit
+void ActarSimSilSciFastModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep){
+  const G4Track* track = fastTrack.GetPrimaryTrack();
+  const G4ParticleDefinition* particle = track->GetDefinition();
+  const G4Material* material = track->GetMaterial();
+
+  G4ThreeVector position = track->GetPosition();
+  G4ThreeVector direction = track->GetMomentumDirection();
+  G4double energy = track->GetKineticEnergy();
+  G4double time = track->GetGlobalTime();
+
+  ActarSimRangeTable* table = GetRangeTable(particle,material,energy);
+  G4double range = table->GetRange(energy);
+
+  //distance to the exit of the element (or a daughter) within the range
+  G4double length = DistanceToBoundary(position,direction,range);
+
+  G4bool stopped = (length>=range);
+  G4double newEnergy = 0.;
+  if(stopped)
+    length = range;
+  else {
+    newEnergy = table->GetEnergy(range-length);
+    if(stragglingFlag) {
+      G4double charge = particle->GetPDGCharge()/eplus;
+      G4double sigmaE2 = 2.*twopi_mc2_rcl2*electron_mass_c2*material->GetElectronDensity()*
+	charge*charge*(table->GetStragglingIntegral(energy)-table->GetStragglingIntegral(newEnergy));
+      newEnergy += table->GetDEDX(newEnergy)*std::sqrt(sigmaE2)*G4RandGauss::shoot();
+      if(newEnergy>energy) newEnergy = energy;
+      if(newEnergy<=0.) {
+	newEnergy = 0.;
+	stopped = true;
+      }
+    }
+  }
+
+  G4ThreeVector newPosition = position + length*direction;
+  G4double newTime = time + table->GetTime(energy) - table->GetTime(newEnergy);
+  G4TouchableHistory* postTouchable = 0;
+  if(!stopped) {
+    //volume after the exit point, as in the post step point of the tracking
+    navigator->SetGeometricallyLimitedStep();
+    if(navigator->LocateGlobalPointAndSetup(newPosition,&direction,true))
+      postTouchable = navigator->CreateTouchableHistory();
+  }
+
+  if(track->GetVolume()->GetLogicalVolume()->GetSensitiveDetector()==silSD)
+    silSD->ProcessFastStep(track,position,newPosition,postTouchable,newTime,energy,newEnergy);
+  else
+    sciSD->ProcessFastStep(track,position,newPosition,postTouchable,newTime,energy,newEnergy);
+  delete postTouchable;
+
+  if(stragglingFlag && !stopped) {
+    //Highland multiple scattering, with the geometric mean of p*beta
+    G4double charge = particle->GetPDGCharge()/eplus;
+    G4double mass = particle->GetPDGMass();
+    G4double pIn2 = energy*(energy+2.*mass);
+    G4double pOut2 = newEnergy*(newEnergy+2.*mass);
+    G4double pBeta = std::sqrt(pIn2/(energy+mass)*pOut2/(newEnergy+mass));
+    G4double beta2 = pOut2/((newEnergy+mass)*(newEnergy+mass));
+    G4double thickness = length/material->GetRadlen();
+    G4double theta0 = 13.6*MeV/pBeta*std::fabs(charge)*std::sqrt(thickness)*
+      (1.+0.038*std::log(thickness*charge*charge/beta2));
+    if(theta0>0.){
+      G4ThreeVector u = direction.orthogonal().unit();
+      G4ThreeVector v = direction.cross(u);
+      direction = (direction + G4RandGauss::shoot()*theta0*u +
+		   G4RandGauss::shoot()*theta0*v).unit();
+    }
+  }
+
+  fastStep.ProposePrimaryTrackFinalPosition(newPosition,false);
+  fastStep.ProposePrimaryTrackFinalTime(newTime);
+  fastStep.ProposePrimaryTrackPathLength(length);
+  fastStep.ProposeTotalEnergyDeposited(energy-newEnergy);
+  //the hit is already in the SD
+  fastStep.ProposeSteppingControl(AvoidHitInvocation);
+  if(stopped)
+    fastStep.KillPrimaryTrack();
+  else
+    fastStep.ProposePrimaryTrackFinalKineticEnergyAndDirection(newEnergy,direction,false);
+}
@@ -0,0 +1,225 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimStackingAction
+/// Classification of the new tracks, to avoid spending tracking time
+/// in secondaries not producing detector signals. Secondaries can be
+/// killed or deferred by type, energy and region:
+///  - electrons below gasElectronCut created in the ActiveGas region
+///    are killed. The energy is not lost for the analysis, as the gas
+///    SD counts the kinetic energy lost by the parent in the step,
+///    including the energy given to the secondary (local deposition).
+///  - secondaries of the selected types (below a maximum energy) are
+///    killed or sent to the waiting stack.
+///  - neutral tracks outside the chamber and any track in the kill
+///    volumes are killed, at birth here and while stepping (see
+///    ActarSimSteppingAction).
+/// Primaries are never touched. Inactive by default.
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimStackingAction.hh"
+#include "ActarSimStackingActionMessenger.hh"
+#include "ActarSimSDFilter.hh"
+
+#include "ActarSimROOTAnalysis.hh"
+
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Electron.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4RunManager.hh"
+#include "G4ios.hh"
+
+#include "G4SystemOfUnits.hh"
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimStackingAction::ActarSimStackingAction()
+  :stackingActive(false), gasElectronCut(0.), killNeutrals(false),
+   activeGasRegion(0), worldLog(0), nKilled(0), nDeferred(0) {
+  stackingMessenger = new ActarSimStackingActionMessenger(this);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimStackingAction::~ActarSimStackingAction(){
+  delete stackingMessenger;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Classification of the new tracks. The cheapest checks go first
+G4ClassificationOfNewTrack ActarSimStackingAction::ClassifyNewTrack(const G4Track* aTrack){
+  G4ClassificationOfNewTrack classification = fUrgent;
+
+  // Histogramming and other ROOT related actions
+  if (gActarSimROOTAnalysis) gActarSimROOTAnalysis->ClassifyNewTrack(aTrack,&classification);
+
+  if(!stackingActive || aTrack->GetParentID()==0) return classification;
+
+  const G4ParticleDefinition* particle = aTrack->GetDefinition();
+  G4double energy = aTrack->GetKineticEnergy();
+
+  //Secondaries are created with the touchable of the parent post-step point
+  const G4VPhysicalVolume* volume = aTrack->GetVolume();
+  const G4LogicalVolume* logical = volume ? volume->GetLogicalVolume() : 0;
+
+  if(gasElectronCut>0. && energy<gasElectronCut &&
+     particle==G4Electron::Definition() &&
+     logical && logical->GetRegion()==activeGasRegion){
+    nKilled++;
+    return fKill;
+  }
+
+  if(!killPDG.empty() || !deferPDG.empty()){
+    G4int pdg = particle->GetPDGEncoding();
+    for(size_t i=0;i<killPDG.size();i++){
+      if(killPDG[i]==pdg && (killMaxEnergy[i]<=0. || energy<killMaxEnergy[i])){
+	nKilled++;
+	return fKill;
+      }
+    }
+    for(size_t i=0;i<deferPDG.size();i++){
+      if(deferPDG[i]==pdg){
+	nDeferred++;
+	return fWaiting;
+      }
+    }
+  }
+
+  if(logical){
+    if(killNeutrals && logical==worldLog && particle->GetPDGCharge()==0.){
+      nKilled++;
+      return fKill;
+    }
+    if(IsKillVolume(logical)){
+      nKilled++;
+      return fKill;
+    }
+  }
+
+  return classification;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Called when the urgent stack is empty and the waiting stack is
+/// moved to the urgent stack. Nothing to do but keeping the tracks
+void ActarSimStackingAction::NewStage(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Resolves the region and volume pointers at the beginning of each
+/// event (the geometry may change between runs with /ActarSim/det/update)
+void ActarSimStackingAction::PrepareNewEvent(){
+  const G4int verboseLevel = G4RunManager::GetRunManager()->GetVerboseLevel();
+  if(verboseLevel>1 && stackingActive)
+    G4cout << "ActarSimStackingAction::PrepareNewEvent() - previous event: "
+	   << nKilled << " secondaries killed, "
+	   << nDeferred << " secondaries deferred." << G4endl;
+  nKilled = 0;
+  nDeferred = 0;
+
+  if(!stackingActive) return;
+
+  activeGasRegion = G4RegionStore::GetInstance()->GetRegion("ActiveGas",false);
+
+  G4VPhysicalVolume* worldPhys = G4TransportationManager::GetTransportationManager()->
+    GetNavigatorForTracking()->GetWorldVolume();
+  worldLog = worldPhys ? worldPhys->GetLogicalVolume() : 0;
+
+  killVolumes.clear();
+  for(size_t i=0;i<killVolumeNames.size();i++){
+    G4LogicalVolume* vol = G4LogicalVolumeStore::GetInstance()->GetVolume(killVolumeNames[i],false);
+    if(vol) killVolumes.push_back(vol);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// Checks if a logical volume is in the kill list
+G4bool ActarSimStackingAction::IsKillVolume(const G4LogicalVolume* logical) const {
+  for(size_t i=0;i<killVolumes.size();i++)
+    if(killVolumes[i]==logical) return true;
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Kills the track if the step ends in a kill volume or, for neutral
+/// particles, if the step leaves the chamber (ends in the world volume).
+/// Called from ActarSimSteppingAction only if IsStepKillActive()
+void ActarSimStackingAction::KillTrackOutOfInterest(const G4Step* aStep){
+  const G4VPhysicalVolume* postVolume = aStep->GetPostStepPoint()->GetPhysicalVolume();
+  if(!postVolume) return; //leaving the world, nothing to do
+
+  G4Track* track = aStep->GetTrack();
+  if(track->GetParentID()==0) return;
+
+  const G4LogicalVolume* logical = postVolume->GetLogicalVolume();
+  if((killNeutrals && logical==worldLog && track->GetDefinition()->GetPDGCharge()==0.)
+     || IsKillVolume(logical))
+    track->SetTrackStatus(fStopAndKill);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds a particle type to be killed if below the given energy
+void ActarSimStackingAction::AddKillParticle(G4String particleName, G4double maxEnergy){
+  G4int pdg = ActarSimSDFilter::ParticleNameToPDG(particleName);
+  if(pdg==0){
+    G4cout << "ActarSimStackingAction::AddKillParticle() - WARNING: particle "
+	   << particleName << " not found. Stacking not modified." << G4endl;
+    return;
+  }
+  killPDG.push_back(pdg);
+  killMaxEnergy.push_back(maxEnergy);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds a particle type to be sent to the waiting stack
+void ActarSimStackingAction::AddDeferParticle(G4String particleName){
+  G4int pdg = ActarSimSDFilter::ParticleNameToPDG(particleName);
+  if(pdg==0){
+    G4cout << "ActarSimStackingAction::AddDeferParticle() - WARNING: particle "
+	   << particleName << " not found. Stacking not modified." << G4endl;
+    return;
+  }
+  deferPDG.push_back(pdg);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Empties the kill and defer particle lists and the kill volumes
+void ActarSimStackingAction::ClearLists(){
+  killPDG.clear();
+  killMaxEnergy.clear();
+  deferPDG.clear();
+  killVolumeNames.clear();
+  killVolumes.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+/// Prints the stacking parameters
+void ActarSimStackingAction::PrintStackingParameters(){
+  G4cout << "##################################################################" << G4endl
+	 << "## ActarSimStackingAction::PrintStackingParameters()" << G4endl
+	 << "##    -stacking active           : " << (stackingActive ? "on" : "off") << G4endl
+	 << "##    -gas electron cut          : " << gasElectronCut/keV << " keV" << G4endl
+	 << "##    -kill neutrals out chamber : " << (killNeutrals ? "on" : "off") << G4endl
+	 << "##    -killed PDG codes (max E)  :";
+  for(size_t i=0;i<killPDG.size();i++)
+    G4cout << " " << killPDG[i] << " (" << killMaxEnergy[i]/MeV << " MeV)";
+  G4cout << G4endl << "##    -deferred PDG codes        :";
+  for(size_t i=0;i<deferPDG.size();i++) G4cout << " " << deferPDG[i];
+  G4cout << G4endl << "##    -kill volumes              :";
+  for(size_t i=0;i<killVolumeNames.size();i++) G4cout << " " << killVolumeNames[i];
+  G4cout << G4endl
+	 << "##################################################################" << G4endl;
+}
@@ -0,0 +1,152 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimStackingActionMessenger
+/// Messenger for the stacking action
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimStackingActionMessenger.hh"
+
+#include "ActarSimStackingAction.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "globals.hh"
+
+#include <sstream>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+/// command included in this StackingActionMessenger:
+/// - /ActarSim/stack/active
+/// - /ActarSim/stack/gasElectronCut
+/// - /ActarSim/stack/killNeutralsOutOfChamber
+/// - /ActarSim/stack/killParticle
+/// - /ActarSim/stack/deferParticle
+/// - /ActarSim/stack/addKillVolume
+/// - /ActarSim/stack/clear
+/// - /ActarSim/stack/print
+ActarSimStackingActionMessenger::ActarSimStackingActionMessenger(ActarSimStackingAction* stack)
+  :stackingAction(stack) {
+  G4bool omitable;
+  G4UIparameter* parameter;
+
+  stackDir = new G4UIdirectory("/ActarSim/stack/");
+  stackDir->SetGuidance("Stacking (classification of secondary tracks) control");
+
+  activeCmd = new G4UIcmdWithAString("/ActarSim/stack/active",this);
+  activeCmd->SetGuidance("Classifies the secondaries to kill or defer them.");
+  activeCmd->SetGuidance("  Choice : on, off(default)");
+  activeCmd->SetParameterName("choice",true);
+  activeCmd->SetDefaultValue("off");
+  activeCmd->SetCandidates("on off");
+  activeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  gasElectronCutCmd = new G4UIcmdWithADoubleAndUnit("/ActarSim/stack/gasElectronCut",this);
+  gasElectronCutCmd->SetGuidance("Kills the secondary electrons created in the ActiveGas region");
+  gasElectronCutCmd->SetGuidance("with energy below the value (energy deposited locally). 0 disables.");
+  gasElectronCutCmd->SetParameterName("energy",false);
+  gasElectronCutCmd->SetRange("energy>=0.");
+  gasElectronCutCmd->SetUnitCategory("Energy");
+  gasElectronCutCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  killNeutralsCmd = new G4UIcmdWithAString("/ActarSim/stack/killNeutralsOutOfChamber",this);
+  killNeutralsCmd->SetGuidance("Kills the neutral secondaries created or entering outside the chamber.");
+  killNeutralsCmd->SetGuidance("  Choice : on, off(default)");
+  killNeutralsCmd->SetParameterName("choice",true);
+  killNeutralsCmd->SetDefaultValue("off");
+  killNeutralsCmd->SetCandidates("on off");
+  killNeutralsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  killParticleCmd = new G4UIcommand("/ActarSim/stack/killParticle",this);
+  killParticleCmd->SetGuidance("Kills the secondaries of the given type below the given energy.");
+  killParticleCmd->SetGuidance("[usage] /ActarSim/stack/killParticle particle energy unit");
+  killParticleCmd->SetGuidance("        particle: name or PDG code; energy 0 kills at any energy");
+  parameter = new G4UIparameter("particle", 's', omitable = false);
+  killParticleCmd->SetParameter(parameter);
+  parameter = new G4UIparameter("energy", 'd', omitable = true);
+  parameter->SetDefaultValue(0.);
+  parameter->SetParameterRange("energy>=0.");
+  killParticleCmd->SetParameter(parameter);
+  parameter = new G4UIparameter("unit", 's', omitable = true);
+  parameter->SetDefaultValue("MeV");
+  killParticleCmd->SetParameter(parameter);
+  killParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  deferParticleCmd = new G4UIcmdWithAString("/ActarSim/stack/deferParticle",this);
+  deferParticleCmd->SetGuidance("Sends the secondaries of the given type (name or PDG code)");
+  deferParticleCmd->SetGuidance("to the waiting stack, tracked after all the urgent tracks.");
+  deferParticleCmd->SetParameterName("particle",false);
+  deferParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  killVolumeCmd = new G4UIcmdWithAString("/ActarSim/stack/addKillVolume",this);
+  killVolumeCmd->SetGuidance("Adds a logical volume (for instance, World) where the secondaries");
+  killVolumeCmd->SetGuidance("are killed, at creation or when entering the volume.");
+  killVolumeCmd->SetParameterName("volume",false);
+  killVolumeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  clearCmd = new G4UIcmdWithoutParameter("/ActarSim/stack/clear",this);
+  clearCmd->SetGuidance("Empties the kill and defer particle lists and the kill volumes.");
+  clearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  printCmd = new G4UIcmdWithoutParameter("/ActarSim/stack/print",this);
+  printCmd->SetGuidance("Prints the stacking parameters.");
+  printCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor
+ActarSimStackingActionMessenger::~ActarSimStackingActionMessenger() {
+  delete activeCmd;
+  delete gasElectronCutCmd;
+  delete killNeutralsCmd;
+  delete killParticleCmd;
+  delete deferParticleCmd;
+  delete killVolumeCmd;
+  delete clearCmd;
+  delete printCmd;
+  delete stackDir;
+}
+
+//////////////////////////////////////////////////////////////////
+/// Setting the values using the ActarSimStackingAction interface
+void ActarSimStackingActionMessenger::SetNewValue(G4UIcommand* command,
+						  G4String newValues) {
+  if(command == activeCmd)
+    stackingAction->SetStackingActive(newValues=="on");
+
+  if(command == gasElectronCutCmd)
+    stackingAction->SetGasElectronCut(gasElectronCutCmd->GetNewDoubleValue(newValues));
+
+  if(command == killNeutralsCmd)
+    stackingAction->SetKillNeutrals(newValues=="on");
+
+  if(command == killParticleCmd){
+    G4double x = 0.;
+    char names[30], unts[30];
+    std::istringstream is(newValues);
+    is >> names >> x >> unts;
+    G4String unt = unts;
+    stackingAction->AddKillParticle(names, x*G4UIcommand::ValueOf(unt));
+  }
+
+  if(command == deferParticleCmd)
+    stackingAction->AddDeferParticle(newValues);
+
+  if(command == killVolumeCmd)
+    stackingAction->AddKillVolume(newValues);
+
+  if(command == clearCmd)
+    stackingAction->ClearLists();
+
+  if(command == printCmd)
+    stackingAction->PrintStackingParameters();
+}
@@ -18,14 +18,18 @@
 
 #include "ActarSimDetectorConstruction.hh"
 #include "ActarSimEventAction.hh"
+#include "ActarSimStackingAction.hh"
+#include "ActarSimRegionSettings.hh"
 
 #include "G4Track.hh"
 
 //////////////////////////////////////////////////////////////////
 /// Constructor
 ActarSimSteppingAction::ActarSimSteppingAction(ActarSimDetectorConstruction* det,
-					       ActarSimEventAction* evt)
-  :detector(det), eventaction(evt){
+					       ActarSimEventAction* evt,
+					       ActarSimStackingAction* stack,
+					       ActarSimRegionSettings* regionSettings)
+  :detector(det), eventaction(evt), stacking(stack), regions(regionSettings){
   if(detector){	; }
   if(eventaction){ ; }
 }
@@ -53,6 +57,14 @@ void ActarSimSteppingAction::UserSteppingAction(const G4Step* aStep) {
     stepl = aStep->GetStepLength();
   else stepl = 0;
 
+  // Kill the secondaries leaving the region of interest (if selected)
+  if (stacking && stacking->IsStepKillActive())
+    stacking->KillTrackOutOfInterest(aStep);
+
+  // Cost of the regions (if selected)
+  if (regions && regions->GetReportFlag())
+    regions->UserSteppingAction(aStep);
+
   // Histogramming
   if (gActarSimROOTAnalysis)
     gActarSimROOTAnalysis->UserSteppingAction(aStep); // original
@@ -8,15 +8,29 @@
  ******************************************************************/
 //////////////////////////////////////////////////////////////////
 /// \class ActarSimUniformEMField
-/// Uniform electric and magnetic fields definition
+/// Uniform electric and magnetic fields definition. The propagation
+/// installed in the global field manager depends on the field: none
+/// for a zero field (the tracks are not propagated in field), a
+/// G4UniformMagField with a helix stepper for a pure magnetic field,
+/// and this field with G4EqMagElectricField and a Runge-Kutta stepper
+/// when there is an electric component. The equation, stepper and
+/// chord finder are only rebuilt when the kind of field or the stepper
+/// change, and the previous ones are deleted.
 /////////////////////////////////////////////////////////////////
 
 #include "ActarSimUniformEMField.hh"
 #include "G4FieldManager.hh"
 #include "G4MagneticField.hh"
+#include "G4UniformMagField.hh"
 #include "G4MagIntegratorStepper.hh"
 #include "G4EqMagElectricField.hh"
+#include "G4Mag_UsualEqRhs.hh"
 #include "G4ClassicalRK4.hh"
+#include "G4SimpleRunge.hh"
+#include "G4CashKarpRKF45.hh"
+#include "G4HelixExplicitEuler.hh"
+#include "G4HelixSimpleRunge.hh"
+#include "G4ExactHelixStepper.hh"
 #include "G4ChordFinder.hh"
 #include "G4TransportationManager.hh"
 
@@ -25,27 +39,26 @@
 
 //////////////////////////////////////////////////////////////////
 ///  Default zero field constructor
-ActarSimUniformEMField::ActarSimUniformEMField() {
+ActarSimUniformEMField::ActarSimUniformEMField()
+  :fieldType(zeroField), stepperType("auto"), stepperName("none"),
+   deltaChord(1.0e-2 * mm), minEpsilonStep(5.0e-5), maxEpsilonStep(1.0e-3),
+   magField(0), theChordFinder(0), stepper(0), equation(0) {
   fieldComponents[0] = fieldComponents[1] = fieldComponents[2] = 0.;
   fieldComponents[3] = fieldComponents[4] = fieldComponents[5] = 0.;
 
-  equation = new G4EqMagElectricField(this);
-  stepper = new G4ClassicalRK4(equation);
-  GetGlobalFieldManager()->SetDetectorField(this);
-  theChordFinder = new G4ChordFinder((G4MagneticField*)this, 1.0e-2 * mm, stepper);
-  GetGlobalFieldManager()->SetChordFinder(theChordFinder);
+  UpdateFieldManager(true);
   //DefineUnits();
 }
 
 //////////////////////////////////////////////////////////////////
 ///  Constructor with initial values for the electric an magnetic fields
 ActarSimUniformEMField::ActarSimUniformEMField(const G4ThreeVector magFieldVector,
-					       const G4ThreeVector elecFieldVector) {
-  equation = new G4EqMagElectricField(this);
-  stepper = new G4ClassicalRK4(equation);
-  GetGlobalFieldManager()->SetDetectorField(this);
-  theChordFinder = new G4ChordFinder((G4MagneticField*)this, 1.0e-2 * mm, stepper);
-  GetGlobalFieldManager()->SetChordFinder(theChordFinder);
+					       const G4ThreeVector elecFieldVector)
+  :fieldType(zeroField), stepperType("auto"), stepperName("none"),
+   deltaChord(1.0e-2 * mm), minEpsilonStep(5.0e-5), maxEpsilonStep(1.0e-3),
+   magField(0), theChordFinder(0), stepper(0), equation(0) {
+  fieldComponents[0] = fieldComponents[1] = fieldComponents[2] = 0.;
+  fieldComponents[3] = fieldComponents[4] = fieldComponents[5] = 0.;
 
   SetFieldValue(magFieldVector, elecFieldVector);
   //DefineUnits();
@@ -54,86 +67,198 @@ ActarSimUniformEMField::ActarSimUniformEMField(const G4ThreeVector magFieldVecto
 //////////////////////////////////////////////////////////////////
 ///  Copy constructor
 ActarSimUniformEMField::ActarSimUniformEMField(const  ActarSimUniformEMField &p)
-  : G4ElectroMagneticField(p) {
+  : G4ElectroMagneticField(p), fieldType(zeroField), stepperType(p.stepperType),
+    stepperName("none"), deltaChord(p.deltaChord), minEpsilonStep(p.minEpsilonStep),
+    maxEpsilonStep(p.maxEpsilonStep), magField(0), theChordFinder(0), stepper(0), equation(0) {
   for(G4int i=0;i<6;i++)
     fieldComponents[i] = p.fieldComponents[i];
 
-  equation = new G4EqMagElectricField(this);
-  stepper = new G4ClassicalRK4(equation);
-  GetGlobalFieldManager()->SetDetectorField(this);
-  theChordFinder = new G4ChordFinder((G4MagneticField*)this, 1.0e-2 * mm, stepper);
-  GetGlobalFieldManager()->SetChordFinder(theChordFinder);
+  UpdateFieldManager(true);
 }
 
 //////////////////////////////////////////////////////////////////
 ///  Operator =
-ActarSimUniformEMField ActarSimUniformEMField::operator = (const ActarSimUniformEMField &p) {
+ActarSimUniformEMField& ActarSimUniformEMField::operator = (const ActarSimUniformEMField &p) {
   if (&p == this) return *this;
   for (G4int i=0; i<6; i++)
     fieldComponents[i] = p.fieldComponents[i];
+  stepperType = p.stepperType;
+  deltaChord = p.deltaChord;
+  minEpsilonStep = p.minEpsilonStep;
+  maxEpsilonStep = p.maxEpsilonStep;
+  UpdateFieldManager(true);
   return *this;
 }
 
 //////////////////////////////////////////////////////////////////
-///  Destructor
+///  Destructor. The field manager is released if it uses this field
 ActarSimUniformEMField::~ActarSimUniformEMField() {
-  GetGlobalFieldManager()->SetDetectorField(0);
+  G4FieldManager* fieldManager = GetGlobalFieldManager();
+  if(fieldManager->GetDetectorField()==this ||
+     (magField && fieldManager->GetDetectorField()==magField)){
+    fieldManager->SetDetectorField(0);
+    fieldManager->SetChordFinder(0);
+  }
+  DeletePropagation();
+  delete magField;
 }
 
 //////////////////////////////////////////////////////////////////
-/// Set the value of the Global Field to fieldVector along Y
-void ActarSimUniformEMField::SetFieldValue(const G4ThreeVector magFieldVector,
-					   const G4ThreeVector elecFieldVector) {
-  if(elecFieldVector!=G4ThreeVector(0.,0.,0.) ||
-     magFieldVector!=G4ThreeVector(0.,0.,0.) ) {
-    fieldComponents[0] = magFieldVector.x();
-    fieldComponents[1] = magFieldVector.y();
-    fieldComponents[2] = magFieldVector.z();
-    fieldComponents[3] = elecFieldVector.x();
-    fieldComponents[4] = elecFieldVector.y();
-    fieldComponents[5] = elecFieldVector.z();
-  }
-  else {
+/// Deletes the chord finder, stepper and equation
+void ActarSimUniformEMField::DeletePropagation() {
+  delete theChordFinder;
+  delete stepper;
+  delete equation;
+  theChordFinder = 0;
+  stepper = 0;
+  equation = 0;
+  stepperName = "none";
+}
+
+//////////////////////////////////////////////////////////////////
+/// Installs in the global field manager the propagation for the
+/// present field. The equation, stepper and chord finder are rebuilt
+/// if the field changes between pure magnetic and with an electric
+/// component, or if rebuild is true
+void ActarSimUniformEMField::UpdateFieldManager(G4bool rebuild) {
+  G4ThreeVector magFieldVector = GetMagneticFieldValue();
+  G4ThreeVector elecFieldVector = GetElectricFieldValue();
+  FieldType type = zeroField;
+  if(elecFieldVector!=G4ThreeVector(0.,0.,0.))
+    type = (magFieldVector!=G4ThreeVector(0.,0.,0.)) ? electroMagneticField : electricField;
+  else if(magFieldVector!=G4ThreeVector(0.,0.,0.))
+    type = magneticField;
+
+  G4FieldManager* fieldManager = GetGlobalFieldManager();
+
+  if(type==zeroField) {
     // If the new field's value is Zero, then it is best to
     //  insure that it is not used for propagation.
-    GetGlobalFieldManager()->SetDetectorField(0);
+    fieldManager->SetDetectorField(0);
+    fieldManager->SetChordFinder(0);
+    DeletePropagation();
+    fieldType = type;
+    return;
   }
+
+  if(type==magneticField) {
+    if(magField) magField->SetFieldValue(magFieldVector);
+    else magField = new G4UniformMagField(magFieldVector);
+  }
+
+  if(rebuild || !theChordFinder || (type==magneticField)!=(fieldType==magneticField)) {
+    fieldManager->SetChordFinder(0);
+    DeletePropagation();
+
+    G4bool helix = (stepperType=="HelixExplicitEuler" || stepperType=="HelixSimpleRunge" ||
+		    stepperType=="ExactHelix");
+    if(type==magneticField) {
+      G4Mag_UsualEqRhs* magEquation = new G4Mag_UsualEqRhs(magField);
+      equation = magEquation;
+      if(stepperType=="auto" || stepperType=="ExactHelix"){
+	stepper = new G4ExactHelixStepper(magEquation);
+	stepperName = "ExactHelix";
+      }
+      else if(stepperType=="HelixExplicitEuler"){
+	stepper = new G4HelixExplicitEuler(magEquation);
+	stepperName = "HelixExplicitEuler";
+      }
+      else if(stepperType=="HelixSimpleRunge"){
+	stepper = new G4HelixSimpleRunge(magEquation);
+	stepperName = "HelixSimpleRunge";
+      }
+    }
+    else {
+      // the electric field changes the energy: 8 variables
+      equation = new G4EqMagElectricField(this);
+      if(helix)
+	G4cout << "ActarSimUniformEMField::UpdateFieldManager(): the " << stepperType
+	       << " stepper needs a pure magnetic field; ClassicalRK4 is used" << G4endl;
+    }
+    if(!stepper){
+      G4int numberOfVariables = (type==magneticField) ? 6 : 8;
+      if(stepperType=="SimpleRunge"){
+	stepper = new G4SimpleRunge(equation, numberOfVariables);
+	stepperName = "SimpleRunge";
+      }
+      else if(stepperType=="CashKarpRKF45"){
+	stepper = new G4CashKarpRKF45(equation, numberOfVariables);
+	stepperName = "CashKarpRKF45";
+      }
+      else {
+	stepper = new G4ClassicalRK4(equation, numberOfVariables);
+	stepperName = "ClassicalRK4";
+      }
+    }
+
+    if(type==magneticField)
+      theChordFinder = new G4ChordFinder(magField, deltaChord, stepper);
+    else
+      theChordFinder = new G4ChordFinder((G4MagneticField*)this, deltaChord, stepper);
+    fieldManager->SetChordFinder(theChordFinder);
+  }
+  fieldType = type;
+
+  if(type==magneticField) fieldManager->SetDetectorField(magField);
+  else fieldManager->SetDetectorField(this);
+  fieldManager->SetMinimumEpsilonStep(minEpsilonStep);
+  fieldManager->SetMaximumEpsilonStep(maxEpsilonStep);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Set the value of the Global Field to fieldVector along Y
+void ActarSimUniformEMField::SetFieldValue(const G4ThreeVector magFieldVector,
+					   const G4ThreeVector elecFieldVector) {
+  fieldComponents[0] = magFieldVector.x();
+  fieldComponents[1] = magFieldVector.y();
+  fieldComponents[2] = magFieldVector.z();
+  fieldComponents[3] = elecFieldVector.x();
+  fieldComponents[4] = elecFieldVector.y();
+  fieldComponents[5] = elecFieldVector.z();
+  UpdateFieldManager();
 }
 
 //////////////////////////////////////////////////////////////////
 /// Set the value of the Electric Field to fieldVector
 void ActarSimUniformEMField::SetPureElectricFieldValue(G4ThreeVector fieldVector) {
-  if(fieldVector!=G4ThreeVector(0.,0.,0.) ) {
-    fieldComponents[0] = 0.;
-    fieldComponents[1] = 0.;
-    fieldComponents[2] = 0.;
-    fieldComponents[3] = fieldVector.x();
-    fieldComponents[4] = fieldVector.y();
-    fieldComponents[5] = fieldVector.z();
-  }
-  else {
-    // If the new field's value is Zero, then it is best to
-    //  insure that it is not used for propagation.
-    GetGlobalFieldManager()->SetDetectorField(0);
-  }
+  SetFieldValue(G4ThreeVector(0.,0.,0.), fieldVector);
 }
 
 //////////////////////////////////////////////////////////////////
 /// Set the value of the Magnetic Field to fieldVector
 void ActarSimUniformEMField::SetPureMagneticFieldValue(G4ThreeVector fieldVector) {
-  if(fieldVector!=G4ThreeVector(0.,0.,0.) ) {
-    fieldComponents[0] = fieldVector.x();
-    fieldComponents[1] = fieldVector.y();
-    fieldComponents[2] = fieldVector.z();
-    fieldComponents[3] = 0.;
-    fieldComponents[4] = 0.;
-    fieldComponents[5] = 0.;
-  }
-  else {
-    // If the new field's value is Zero, then it is best to
-    //  insure that it is not used for propagation.
-    GetGlobalFieldManager()->SetDetectorField(0);
-  }
+  SetFieldValue(fieldVector, G4ThreeVector(0.,0.,0.));
+}
+
+//////////////////////////////////////////////////////////////////
+/// Selects the stepper: auto (ExactHelix for a pure magnetic field,
+/// ClassicalRK4 otherwise), ClassicalRK4, SimpleRunge, CashKarpRKF45,
+/// or, only for a pure magnetic field, ExactHelix, HelixExplicitEuler
+/// and HelixSimpleRunge
+void ActarSimUniformEMField::SetStepperType(const G4String& type) {
+  stepperType = type;
+  UpdateFieldManager(true);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the miss distance of the chords
+void ActarSimUniformEMField::SetDeltaChord(G4double val) {
+  deltaChord = val;
+  if(theChordFinder) theChordFinder->SetDeltaChord(deltaChord);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the minimum relative accuracy of the steps
+void ActarSimUniformEMField::SetMinEpsilonStep(G4double val) {
+  minEpsilonStep = val;
+  if(fieldType!=zeroField) GetGlobalFieldManager()->SetMinimumEpsilonStep(minEpsilonStep);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Sets the maximum relative accuracy of the steps
+void ActarSimUniformEMField::SetMaxEpsilonStep(G4double val) {
+  maxEpsilonStep = val;
+  if(fieldType!=zeroField) GetGlobalFieldManager()->SetMaximumEpsilonStep(maxEpsilonStep);
 }
 
 //////////////////////////////////////////////////////////////////
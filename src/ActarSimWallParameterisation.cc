@@ -0,0 +1,123 @@
+/******************************************************************
+ * Copyright (C) 2005-2016, Hector Alvarez-Pol                     *
+ * All rights reserved.                                            *
+ *                                                                 *
+ * License according to GNU LESSER GPL (see lgpl-3.0.txt).         *
+ * For the list of contributors see CREDITS.                       *
+ ******************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \class ActarSimWallParameterisation
+/// Parameterisation of the elements (pads, crystals) of a silicon or
+/// scintillator wall. The elements of the wall are one G4PVParameterised
+/// instead of one G4PVPlacement each: each element keeps the rotation
+/// and position of its former placement and its copy number, so the
+/// detector ID given by the SDs does not change (the G4PVParameterised
+/// numbers its elements from 0, see GetCopyNumber(const G4VTouchable*)).
+/// A parameterised volume must be the only daughter of its mother, so
+/// each wall is placed in an envelope box of the mother material,
+/// fitted to the elements (see Place()).
+/////////////////////////////////////////////////////////////////
+
+#include "ActarSimWallParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4PVParameterised.hh"
+#include "G4Box.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4VisAttributes.hh"
+#include "G4VTouchable.hh"
+
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////
+/// Constructor
+ActarSimWallParameterisation::ActarSimWallParameterisation(){
+}
+
+//////////////////////////////////////////////////////////////////
+/// Destructor. Deletes the copies of the element rotations
+ActarSimWallParameterisation::~ActarSimWallParameterisation(){
+  for(size_t i=0;i<rotations.size();i++) delete rotations[i];
+}
+
+//////////////////////////////////////////////////////////////////
+/// Adds an element, with the arguments of its G4PVPlacement (frame
+/// rotation, position in the mother and copy number). The rotation
+/// is copied, the caller keeps the ownership of rot
+void ActarSimWallParameterisation::AddElement(const G4RotationMatrix* rot,
+					      const G4ThreeVector& pos, G4int copyNo){
+  rotations.push_back(rot ? new G4RotationMatrix(*rot) : 0);
+  translations.push_back(pos);
+  copyNumbers.push_back(copyNo);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Places the wall in the mother: an envelope box (envelopeName)
+/// containing all the elements is placed in the mother and the
+/// elements (name, elementLog) are parameterised in the envelope.
+/// Returns the parameterised volume, or 0 if the wall has no elements
+G4VPhysicalVolume* ActarSimWallParameterisation::Place(const G4String& name,
+							G4LogicalVolume* elementLog,
+							const G4String& envelopeName,
+							G4LogicalVolume* motherLog){
+  if(copyNumbers.empty()) return 0;
+
+  //limits of the wall in the mother, from the corners of the elements
+  G4VisExtent extent = elementLog->GetSolid()->GetExtent();
+  G4ThreeVector wallMin(kInfinity,kInfinity,kInfinity);
+  G4ThreeVector wallMax(-kInfinity,-kInfinity,-kInfinity);
+  for(size_t i=0;i<copyNumbers.size();i++){
+    G4RotationMatrix objectRotation;
+    if(rotations[i]) objectRotation = rotations[i]->inverse();
+    for(G4int corner=0;corner<8;corner++){
+      G4ThreeVector point((corner&1) ? extent.GetXmax() : extent.GetXmin(),
+			  (corner&2) ? extent.GetYmax() : extent.GetYmin(),
+			  (corner&4) ? extent.GetZmax() : extent.GetZmin());
+      point = objectRotation*point + translations[i];
+      wallMin.set(std::min(wallMin.x(),point.x()),std::min(wallMin.y(),point.y()),
+		  std::min(wallMin.z(),point.z()));
+      wallMax.set(std::max(wallMax.x(),point.x()),std::max(wallMax.y(),point.y()),
+		  std::max(wallMax.z(),point.z()));
+    }
+  }
+  G4ThreeVector center = 0.5*(wallMin + wallMax);
+  G4ThreeVector halfSize = 0.5*(wallMax - wallMin);
+
+  G4Box* envelopeBox = new G4Box(envelopeName,halfSize.x(),halfSize.y(),halfSize.z());
+  G4LogicalVolume* envelopeLog =
+    new G4LogicalVolume(envelopeBox,motherLog->GetMaterial(),envelopeName);
+  envelopeLog->SetVisAttributes(G4VisAttributes::Invisible);
+  new G4PVPlacement(0,center,envelopeLog,envelopeName,motherLog,false,0);
+
+  //the elements are positioned in the envelope
+  for(size_t i=0;i<translations.size();i++) translations[i] -= center;
+
+  return new G4PVParameterised(name,elementLog,envelopeLog,kUndefined,
+			       copyNumbers.size(),this);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Places the element index
+void ActarSimWallParameterisation::ComputeTransformation(const G4int index,
+							 G4VPhysicalVolume* physVol) const {
+  physVol->SetTranslation(translations[index]);
+  physVol->SetRotation(rotations[index]);
+}
+
+//////////////////////////////////////////////////////////////////
+/// Copy number of the volume of the touchable: the copy number of the
+/// element for the walls, the volume copy number otherwise. To be
+/// used instead of G4VPhysicalVolume::GetCopyNo(), which is not
+/// defined for a parameterised volume outside the navigation
+G4int ActarSimWallParameterisation::GetCopyNumber(const G4VTouchable* touchable){
+  G4VPhysicalVolume* volume = touchable->GetVolume();
+  if(volume && volume->IsParameterised()){
+    ActarSimWallParameterisation* wall =
+      dynamic_cast<ActarSimWallParameterisation*>(volume->GetParameterisation());
+    if(wall) return wall->GetCopyNumber(touchable->GetReplicaNumber());
+  }
+  return touchable->GetCopyNumber();
+}
@@ -29,6 +29,8 @@
 #include "G4StepLimiterPerRegion.hh"
 #include "G4StepLimiterMessenger.hh"
 #include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4UserLimits.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -63,7 +65,7 @@ void G4StepLimiterPerRegion::SetMaxStep(G4double step)
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G4double G4StepLimiterPerRegion::PostStepGetPhysicalInteractionLength(
-                                              const G4Track&,
+                                              const G4Track& track,
                                                     G4double,
                                                     G4ForceCondition* condition )
 {
@@ -71,6 +73,16 @@ G4double G4StepLimiterPerRegion::PostStepGetPhysicalInteractionLength(
   *condition = NotForced;
   ProposedStep = MaxChargedStep;
 
+  // the step limit of the region (or volume) is applied if tighter
+  G4VPhysicalVolume* volume = track.GetVolume();
+  if(volume) {
+    G4UserLimits* limits = volume->GetLogicalVolume()->GetUserLimits();
+    if(limits) {
+      G4double regionStep = limits->GetMaxAllowedStep(track);
+      if(regionStep < ProposedStep) ProposedStep = regionStep;
+    }
+  }
+
   return ProposedStep;
 }
 